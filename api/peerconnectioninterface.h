@@ -460,6 +460,14 @@ class PeerConnectionInterface : public rtc::RefCountInterface {
     // interval specified in milliseconds by the uniform distribution [a, b].
     rtc::Optional<rtc::IntervalRange> ice_regather_interval_range;
 
+    // If set, the sizes in bytes of the send and receive buffers of the SCTP
+    // socket carrying the data channels. Larger buffers allow more throughput
+    // over paths with a large bandwidth-delay product, at the cost of memory.
+    // If unset, the usrsctp defaults are used. Can't be changed with
+    // SetConfiguration().
+    rtc::Optional<int> sctp_send_buffer_size;
+    rtc::Optional<int> sctp_receive_buffer_size;
+
     //
     // Don't forget to update operator== if adding something.
     //
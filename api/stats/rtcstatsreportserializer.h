@@ -0,0 +1,82 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_API_STATS_RTCSTATSREPORTSERIALIZER_H_
+#define WEBRTC_API_STATS_RTCSTATSREPORTSERIALIZER_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "webrtc/api/stats/rtcstats.h"
+#include "webrtc/api/stats/rtcstatsreport.h"
+#include "webrtc/rtc_base/bytebuffer.h"
+#include "webrtc/rtc_base/scoped_ref_ptr.h"
+
+namespace webrtc {
+
+// Compact binary encoding of |RTCStatsReport|s, for exporting stats without
+// the cost of their string representations.
+//
+// Stats members are identified by their index in |RTCStats::Members|, which
+// is stable for a given class as long as new members are added at the end.
+// Integers are varint-encoded. A report can be encoded in full, or as a delta
+// against a previous report: then only the members that changed are encoded,
+// integers as the difference to their previous value, and stats objects of
+// the previous report are referenced by index instead of by id and type.
+//
+// Appends the encoding of |report| to |buffer|. If |previous| is not null,
+// |report| is encoded as a delta against |previous|.
+void SerializeRTCStatsReport(const RTCStatsReport& report,
+                             const RTCStatsReport* previous,
+                             rtc::ByteBufferWriter* buffer);
+
+// Parses reports encoded by |SerializeRTCStatsReport|. Stats objects are
+// created by the factories of their types, the types of rtcstats_objects.h are
+// registered by default. Members that are defined by the constructor of a
+// stats class are expected to stay defined.
+class RTCStatsReportParser {
+ public:
+  RTCStatsReportParser();
+  ~RTCStatsReportParser();
+
+  // Makes stats of type |T| parseable. |T| must be constructible from an id
+  // and a timestamp.
+  template<typename T>
+  void RegisterStatsType() {
+    RegisterStatsType(T::kType, [](const std::string& id,
+                                   int64_t timestamp_us) {
+      return std::unique_ptr<RTCStats>(new T(id, timestamp_us));
+    });
+  }
+
+  // Parses a report encoded by |SerializeRTCStatsReport|. |previous| must be
+  // the report that was passed to it when encoding, or null. Returns null if
+  // |data| is malformed or contains stats of an unregistered type.
+  rtc::scoped_refptr<RTCStatsReport> Parse(
+      const char* data, size_t size, const RTCStatsReport* previous) const;
+
+ private:
+  typedef std::function<std::unique_ptr<RTCStats>(const std::string& id,
+                                                  int64_t timestamp_us)>
+      StatsFactory;
+
+  void RegisterStatsType(const char* type, const StatsFactory& factory);
+  std::unique_ptr<RTCStats> CreateStats(const std::string& type,
+                                        const std::string& id,
+                                        int64_t timestamp_us) const;
+
+  std::map<std::string, StatsFactory> factories_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_API_STATS_RTCSTATSREPORTSERIALIZER_H_
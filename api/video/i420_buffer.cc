@@ -57,9 +57,33 @@ I420Buffer::I420Buffer(int width,
   RTC_DCHECK_GE(stride_v, (width + 1) / 2);
 }
 
+I420Buffer::I420Buffer(int width,
+                       int height,
+                       int stride_y,
+                       int stride_u,
+                       int stride_v,
+                       std::unique_ptr<uint8_t, AlignedFreeDeleter> data)
+    : width_(width),
+      height_(height),
+      stride_y_(stride_y),
+      stride_u_(stride_u),
+      stride_v_(stride_v),
+      data_(std::move(data)) {
+  RTC_DCHECK(data_);
+  RTC_DCHECK_GT(width, 0);
+  RTC_DCHECK_GT(height, 0);
+  RTC_DCHECK_GE(stride_y, width);
+  RTC_DCHECK_GE(stride_u, (width + 1) / 2);
+  RTC_DCHECK_GE(stride_v, (width + 1) / 2);
+}
+
 I420Buffer::~I420Buffer() {
 }
 
+std::unique_ptr<uint8_t, AlignedFreeDeleter> I420Buffer::ReleaseData() {
+  return std::move(data_);
+}
+
 // static
 rtc::scoped_refptr<I420Buffer> I420Buffer::Create(int width, int height) {
   return new rtc::RefCountedObject<I420Buffer>(width, height);
@@ -94,16 +94,29 @@ class I420Buffer : public I420BufferInterface {
  protected:
   I420Buffer(int width, int height);
   I420Buffer(int width, int height, int stride_y, int stride_u, int stride_v);
+  // Uses |data| instead of allocating, e.g. memory recycled by a pool. It must
+  // hold at least |stride_y * height + (stride_u + stride_v) * ((height + 1) /
+  // 2)| bytes.
+  I420Buffer(int width,
+             int height,
+             int stride_y,
+             int stride_u,
+             int stride_v,
+             std::unique_ptr<uint8_t, AlignedFreeDeleter> data);
 
   ~I420Buffer() override;
 
+  // Gives up ownership of the pixel data, so that a subclass can recycle it
+  // when destroyed. The buffer must not be used afterwards.
+  std::unique_ptr<uint8_t, AlignedFreeDeleter> ReleaseData();
+
  private:
   const int width_;
   const int height_;
   const int stride_y_;
   const int stride_u_;
   const int stride_v_;
-  const std::unique_ptr<uint8_t, AlignedFreeDeleter> data_;
+  std::unique_ptr<uint8_t, AlignedFreeDeleter> data_;
 };
 
 }  // namespace webrtc
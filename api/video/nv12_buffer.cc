@@ -0,0 +1,197 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "webrtc/api/video/nv12_buffer.h"
+
+#include <utility>
+#include <vector>
+
+#include "libyuv/planar_functions.h"
+#include "libyuv/scale.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/refcountedobject.h"
+
+// Aligning pointer to 64 bytes for improved performance, e.g. use SIMD.
+static const int kBufferAlignment = 64;
+
+namespace webrtc {
+
+namespace {
+
+int NV12DataSize(int height, int stride_y, int stride_uv) {
+  return stride_y * height + stride_uv * ((height + 1) / 2);
+}
+
+}  // namespace
+
+NV12Buffer::NV12Buffer(int width, int height, int stride_y, int stride_uv)
+    : NV12Buffer(width,
+                 height,
+                 stride_y,
+                 stride_uv,
+                 std::unique_ptr<uint8_t, AlignedFreeDeleter>(
+                     static_cast<uint8_t*>(AlignedMalloc(
+                         NV12DataSize(height, stride_y, stride_uv),
+                         kBufferAlignment)))) {}
+
+NV12Buffer::NV12Buffer(int width,
+                       int height,
+                       int stride_y,
+                       int stride_uv,
+                       std::unique_ptr<uint8_t, AlignedFreeDeleter> data)
+    : width_(width),
+      height_(height),
+      stride_y_(stride_y),
+      stride_uv_(stride_uv),
+      data_(std::move(data)) {
+  RTC_DCHECK(data_);
+  RTC_DCHECK_GT(width, 0);
+  RTC_DCHECK_GT(height, 0);
+  RTC_DCHECK_GE(stride_y, width);
+  RTC_DCHECK_GE(stride_uv, (width + 1) / 2 * 2);
+}
+
+NV12Buffer::~NV12Buffer() {
+}
+
+// static
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Create(int width, int height) {
+  return new rtc::RefCountedObject<NV12Buffer>(width, height, width,
+                                               (width + 1) / 2 * 2);
+}
+
+// static
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Create(int width,
+                                                  int height,
+                                                  int stride_y,
+                                                  int stride_uv) {
+  return new rtc::RefCountedObject<NV12Buffer>(width, height, stride_y,
+                                               stride_uv);
+}
+
+// static
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Copy(
+    const NV12BufferInterface& source) {
+  return Copy(source.width(), source.height(), source.DataY(),
+              source.StrideY(), source.DataUV(), source.StrideUV());
+}
+
+// static
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Copy(int width,
+                                                int height,
+                                                const uint8_t* data_y,
+                                                int stride_y,
+                                                const uint8_t* data_uv,
+                                                int stride_uv) {
+  rtc::scoped_refptr<NV12Buffer> buffer = Create(width, height);
+  libyuv::CopyPlane(data_y, stride_y, buffer->MutableDataY(),
+                    buffer->StrideY(), width, height);
+  libyuv::CopyPlane(data_uv, stride_uv, buffer->MutableDataUV(),
+                    buffer->StrideUV(), buffer->ChromaWidth() * 2,
+                    buffer->ChromaHeight());
+  return buffer;
+}
+
+int NV12Buffer::width() const {
+  return width_;
+}
+
+int NV12Buffer::height() const {
+  return height_;
+}
+
+const uint8_t* NV12Buffer::DataY() const {
+  return data_.get();
+}
+const uint8_t* NV12Buffer::DataUV() const {
+  return data_.get() + stride_y_ * height_;
+}
+
+int NV12Buffer::StrideY() const {
+  return stride_y_;
+}
+int NV12Buffer::StrideUV() const {
+  return stride_uv_;
+}
+
+uint8_t* NV12Buffer::MutableDataY() {
+  return const_cast<uint8_t*>(DataY());
+}
+uint8_t* NV12Buffer::MutableDataUV() {
+  return const_cast<uint8_t*>(DataUV());
+}
+
+std::unique_ptr<uint8_t, AlignedFreeDeleter> NV12Buffer::ReleaseData() {
+  return std::move(data_);
+}
+
+void NV12Buffer::CropAndScaleFrom(const NV12BufferInterface& src,
+                                  int offset_x,
+                                  int offset_y,
+                                  int crop_width,
+                                  int crop_height) {
+  RTC_CHECK_LE(crop_width, src.width());
+  RTC_CHECK_LE(crop_height, src.height());
+  RTC_CHECK_LE(crop_width + offset_x, src.width());
+  RTC_CHECK_LE(crop_height + offset_y, src.height());
+  RTC_CHECK_GE(offset_x, 0);
+  RTC_CHECK_GE(offset_y, 0);
+
+  // Make sure offset is even so that u/v plane becomes aligned.
+  const int uv_offset_x = offset_x / 2;
+  const int uv_offset_y = offset_y / 2;
+  offset_x = uv_offset_x * 2;
+  offset_y = uv_offset_y * 2;
+
+  const uint8_t* y_plane = src.DataY() + src.StrideY() * offset_y + offset_x;
+  const uint8_t* uv_plane =
+      src.DataUV() + src.StrideUV() * uv_offset_y + uv_offset_x * 2;
+
+  if (crop_width == width() && crop_height == height()) {
+    libyuv::CopyPlane(y_plane, src.StrideY(), MutableDataY(), StrideY(),
+                      width(), height());
+    libyuv::CopyPlane(uv_plane, src.StrideUV(), MutableDataUV(), StrideUV(),
+                      ChromaWidth() * 2, ChromaHeight());
+    return;
+  }
+
+  // libyuv can only scale planar chroma, so the interleaved plane is split
+  // into separate U and V planes, scaled, and merged again.
+  const int src_chroma_width = (crop_width + 1) / 2;
+  const int src_chroma_height = (crop_height + 1) / 2;
+  const int src_chroma_size = src_chroma_width * src_chroma_height;
+  const int dst_chroma_size = ChromaWidth() * ChromaHeight();
+  std::vector<uint8_t> tmp_buffer(2 * (src_chroma_size + dst_chroma_size));
+  uint8_t* const src_u = tmp_buffer.data();
+  uint8_t* const src_v = src_u + src_chroma_size;
+  uint8_t* const dst_u = src_v + src_chroma_size;
+  uint8_t* const dst_v = dst_u + dst_chroma_size;
+
+  libyuv::SplitUVPlane(uv_plane, src.StrideUV(), src_u, src_chroma_width,
+                       src_v, src_chroma_width, src_chroma_width,
+                       src_chroma_height);
+  int res = libyuv::I420Scale(y_plane, src.StrideY(),
+                              src_u, src_chroma_width,
+                              src_v, src_chroma_width,
+                              crop_width, crop_height,
+                              MutableDataY(), StrideY(),
+                              dst_u, ChromaWidth(),
+                              dst_v, ChromaWidth(),
+                              width(), height(), libyuv::kFilterBox);
+  RTC_DCHECK_EQ(res, 0);
+  libyuv::MergeUVPlane(dst_u, ChromaWidth(), dst_v, ChromaWidth(),
+                       MutableDataUV(), StrideUV(), ChromaWidth(),
+                       ChromaHeight());
+}
+
+void NV12Buffer::ScaleFrom(const NV12BufferInterface& src) {
+  CropAndScaleFrom(src, 0, 0, src.width(), src.height());
+}
+
+}  // namespace webrtc
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_API_VIDEO_NV12_BUFFER_H_
+#define WEBRTC_API_VIDEO_NV12_BUFFER_H_
+
+#include <memory>
+
+#include "webrtc/api/video/video_frame_buffer.h"
+#include "webrtc/system_wrappers/include/aligned_malloc.h"
+
+namespace webrtc {
+
+// Plain NV12 buffer in standard memory. Lets frames from sources that produce
+// NV12 be cropped and scaled without first being converted to I420.
+class NV12Buffer : public NV12BufferInterface {
+ public:
+  static rtc::scoped_refptr<NV12Buffer> Create(int width, int height);
+  static rtc::scoped_refptr<NV12Buffer> Create(int width,
+                                               int height,
+                                               int stride_y,
+                                               int stride_uv);
+
+  // Create a new buffer and copy the pixel data.
+  static rtc::scoped_refptr<NV12Buffer> Copy(const NV12BufferInterface& buffer);
+
+  static rtc::scoped_refptr<NV12Buffer> Copy(int width,
+                                             int height,
+                                             const uint8_t* data_y,
+                                             int stride_y,
+                                             const uint8_t* data_uv,
+                                             int stride_uv);
+
+  int width() const override;
+  int height() const override;
+  const uint8_t* DataY() const override;
+  const uint8_t* DataUV() const override;
+
+  int StrideY() const override;
+  int StrideUV() const override;
+
+  uint8_t* MutableDataY();
+  uint8_t* MutableDataUV();
+
+  // Scale the cropped area of |src| to the size of |this| buffer, and
+  // write the result into |this|.
+  void CropAndScaleFrom(const NV12BufferInterface& src,
+                        int offset_x,
+                        int offset_y,
+                        int crop_width,
+                        int crop_height);
+
+  // Scale all of |src| to the size of |this| buffer, with no cropping.
+  void ScaleFrom(const NV12BufferInterface& src);
+
+ protected:
+  NV12Buffer(int width, int height, int stride_y, int stride_uv);
+  // Uses |data| instead of allocating, e.g. memory recycled by a pool. It must
+  // hold at least |stride_y * height + stride_uv * ((height + 1) / 2)| bytes.
+  NV12Buffer(int width,
+             int height,
+             int stride_y,
+             int stride_uv,
+             std::unique_ptr<uint8_t, AlignedFreeDeleter> data);
+
+  ~NV12Buffer() override;
+
+  // Gives up ownership of the pixel data, so that a subclass can recycle it
+  // when destroyed. The buffer must not be used afterwards.
+  std::unique_ptr<uint8_t, AlignedFreeDeleter> ReleaseData();
+
+ private:
+  const int width_;
+  const int height_;
+  const int stride_y_;
+  const int stride_uv_;
+  std::unique_ptr<uint8_t, AlignedFreeDeleter> data_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_API_VIDEO_NV12_BUFFER_H_
@@ -10,6 +10,8 @@
 
 #include "webrtc/api/video/video_frame.h"
 
+#include <utility>
+
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/timeutils.h"
 
@@ -63,4 +65,13 @@ int64_t VideoFrame::render_time_ms() const {
   return timestamp_us() / rtc::kNumMicrosecsPerMillisec;
 }
 
+const std::vector<VideoFrame::UpdateRect>& VideoFrame::update_rects() const {
+  RTC_DCHECK(update_rects_);
+  return *update_rects_;
+}
+
+void VideoFrame::set_update_rects(std::vector<UpdateRect> update_rects) {
+  update_rects_.emplace(std::move(update_rects));
+}
+
 }  // namespace webrtc
@@ -13,13 +13,24 @@
 
 #include <stdint.h>
 
+#include <vector>
+
 #include "webrtc/api/video/video_rotation.h"
 #include "webrtc/api/video/video_frame_buffer.h"
+#include "webrtc/rtc_base/optional.h"
 
 namespace webrtc {
 
 class VideoFrame {
  public:
+  // A rectangle of the frame, in pixels.
+  struct UpdateRect {
+    int offset_x;
+    int offset_y;
+    int width;
+    int height;
+  };
+
   // TODO(nisse): This constructor is consistent with the now deleted
   // cricket::WebRtcVideoFrame. We should consider whether or not we
   // want to stick to this style and deprecate the other constructor.
@@ -95,6 +106,15 @@ class VideoFrame {
   // initialized VideoFrame.
   rtc::scoped_refptr<webrtc::VideoFrameBuffer> video_frame_buffer() const;
 
+  // The parts of the frame that changed since the previous frame from the
+  // same source, e.g. as reported by a screen capturer. When not set, any part
+  // of the frame may have changed. Encoders may use this to skip unchanged
+  // macroblocks, so the rectangles must cover every changed pixel.
+  bool has_update_rects() const { return static_cast<bool>(update_rects_); }
+  const std::vector<UpdateRect>& update_rects() const;
+  void set_update_rects(std::vector<UpdateRect> update_rects);
+  void clear_update_rects() { update_rects_.reset(); }
+
   // TODO(nisse): Deprecated.
   // Return true if the frame is stored in a texture.
   bool is_texture() const {
@@ -108,6 +128,7 @@ class VideoFrame {
   int64_t ntp_time_ms_;
   int64_t timestamp_us_;
   VideoRotation rotation_;
+  rtc::Optional<std::vector<UpdateRect>> update_rects_;
 };
 
 }  // namespace webrtc
@@ -12,10 +12,17 @@
 
 #include "libyuv/convert.h"
 #include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/rtc_base/atomicops.h"
 #include "webrtc/rtc_base/checks.h"
 
 namespace webrtc {
 
+namespace {
+
+volatile int num_nv12_to_i420_conversions = 0;
+
+}  // namespace
+
 rtc::scoped_refptr<I420BufferInterface> VideoFrameBuffer::GetI420() {
   RTC_CHECK(type() == Type::kI420);
   return static_cast<I420BufferInterface*>(this);
@@ -37,6 +44,16 @@ const I444BufferInterface* VideoFrameBuffer::GetI444() const {
   return static_cast<const I444BufferInterface*>(this);
 }
 
+NV12BufferInterface* VideoFrameBuffer::GetNV12() {
+  RTC_CHECK(type() == Type::kNV12);
+  return static_cast<NV12BufferInterface*>(this);
+}
+
+const NV12BufferInterface* VideoFrameBuffer::GetNV12() const {
+  RTC_CHECK(type() == Type::kNV12);
+  return static_cast<const NV12BufferInterface*>(this);
+}
+
 VideoFrameBuffer::Type I420BufferInterface::type() const {
   return Type::kI420;
 }
@@ -76,4 +93,42 @@ rtc::scoped_refptr<I420BufferInterface> I444BufferInterface::ToI420() {
   return i420_buffer;
 }
 
+VideoFrameBuffer::Type NV12BufferInterface::type() const {
+  return Type::kNV12;
+}
+
+int NV12BufferInterface::ChromaWidth() const {
+  return (width() + 1) / 2;
+}
+
+int NV12BufferInterface::ChromaHeight() const {
+  return (height() + 1) / 2;
+}
+
+rtc::scoped_refptr<I420BufferInterface> NV12BufferInterface::ToI420() {
+  rtc::scoped_refptr<I420Buffer> i420_buffer =
+      I420Buffer::Create(width(), height());
+  ConvertToI420(i420_buffer->MutableDataY(), i420_buffer->StrideY(),
+                i420_buffer->MutableDataU(), i420_buffer->StrideU(),
+                i420_buffer->MutableDataV(), i420_buffer->StrideV());
+  return i420_buffer;
+}
+
+void NV12BufferInterface::ConvertToI420(uint8_t* dst_y,
+                                        int dst_stride_y,
+                                        uint8_t* dst_u,
+                                        int dst_stride_u,
+                                        uint8_t* dst_v,
+                                        int dst_stride_v) const {
+  rtc::AtomicOps::Increment(&num_nv12_to_i420_conversions);
+  libyuv::NV12ToI420(DataY(), StrideY(), DataUV(), StrideUV(), dst_y,
+                     dst_stride_y, dst_u, dst_stride_u, dst_v, dst_stride_v,
+                     width(), height());
+}
+
+// static
+int NV12BufferInterface::NumI420Conversions() {
+  return rtc::AtomicOps::AcquireLoad(&num_nv12_to_i420_conversions);
+}
+
 }  // namespace webrtc
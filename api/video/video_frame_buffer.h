@@ -20,6 +20,7 @@ namespace webrtc {
 
 class I420BufferInterface;
 class I444BufferInterface;
+class NV12BufferInterface;
 
 // Base class for frame buffers of different types of pixel format and storage.
 // The tag in type() indicates how the data is represented, and each type is
@@ -45,6 +46,7 @@ class VideoFrameBuffer : public rtc::RefCountInterface {
     kNative,
     kI420,
     kI444,
+    kNV12,
   };
 
   // This function specifies in what pixel format the data is stored in.
@@ -69,6 +71,8 @@ class VideoFrameBuffer : public rtc::RefCountInterface {
   rtc::scoped_refptr<const I420BufferInterface> GetI420() const;
   I444BufferInterface* GetI444();
   const I444BufferInterface* GetI444() const;
+  NV12BufferInterface* GetNV12();
+  const NV12BufferInterface* GetNV12() const;
 
  protected:
   ~VideoFrameBuffer() override {}
@@ -121,6 +125,57 @@ class I444BufferInterface : public PlanarYuvBuffer {
   ~I444BufferInterface() override {}
 };
 
+// Formats with a full resolution Y plane and a single plane of interleaved
+// chroma samples.
+class BiplanarYuvBuffer : public VideoFrameBuffer {
+ public:
+  virtual int ChromaWidth() const = 0;
+  virtual int ChromaHeight() const = 0;
+
+  // Returns pointer to the pixel data for a given plane. The memory is owned by
+  // the VideoFrameBuffer object and must not be freed by the caller.
+  virtual const uint8_t* DataY() const = 0;
+  virtual const uint8_t* DataUV() const = 0;
+
+  // Returns the number of bytes between successive rows for a given plane.
+  virtual int StrideY() const = 0;
+  virtual int StrideUV() const = 0;
+
+ protected:
+  ~BiplanarYuvBuffer() override {}
+};
+
+// This interface represents Type::kNV12, where the chroma plane holds U and V
+// samples interleaved, subsampled by two in both directions. It is what most
+// cameras and hardware decoders produce.
+class NV12BufferInterface : public BiplanarYuvBuffer {
+ public:
+  Type type() const final;
+
+  int ChromaWidth() const final;
+  int ChromaHeight() const final;
+
+  rtc::scoped_refptr<I420BufferInterface> ToI420() final;
+
+  // Converts to I420 into planes owned by the caller, e.g. pooled memory,
+  // instead of allocating like ToI420() does. The destination must have the
+  // same resolution as this buffer.
+  void ConvertToI420(uint8_t* dst_y,
+                     int dst_stride_y,
+                     uint8_t* dst_u,
+                     int dst_stride_u,
+                     uint8_t* dst_v,
+                     int dst_stride_v) const;
+
+  // Number of NV12 to I420 conversions done in this process by ToI420() and
+  // ConvertToI420(). Used to verify that frames stay NV12 on their way from
+  // the source to the sinks.
+  static int NumI420Conversions();
+
+ protected:
+  ~NV12BufferInterface() override {}
+};
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_API_VIDEO_VIDEO_FRAME_BUFFER_H_
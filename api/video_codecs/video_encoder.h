@@ -175,6 +175,9 @@ class VideoEncoder {
 
   virtual int32_t SetPeriodicKeyFrames(bool enable) { return -1; }
   virtual bool SupportsNativeHandle() const { return false; }
+  // Whether Encode() accepts kNV12 frame buffers. If not, NV12 frames are
+  // converted to I420 before they are passed to the encoder.
+  virtual bool SupportsNV12() const { return false; }
   virtual const char* ImplementationName() const { return "unknown"; }
 };
 
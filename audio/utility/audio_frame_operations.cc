@@ -12,6 +12,7 @@
 
 #include <algorithm>
 
+#include "webrtc/common_audio/include/audio_util.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/safe_conversions.h"
@@ -59,11 +60,7 @@ void AudioFrameOperations::Add(const AudioFrame& frame_to_add,
     if (no_previous_data) {
       std::copy(in_data, in_data + length, out_data);
     } else {
-      for (size_t i = 0; i < length; i++) {
-        const int32_t wrap_guard = static_cast<int32_t>(out_data[i]) +
-                                   static_cast<int32_t>(in_data[i]);
-        out_data[i] = rtc::saturated_cast<int16_t>(wrap_guard);
-      }
+      AddWithSaturation(in_data, length, out_data);
     }
   }
 }
@@ -71,10 +68,9 @@ void AudioFrameOperations::Add(const AudioFrame& frame_to_add,
 void AudioFrameOperations::MonoToStereo(const int16_t* src_audio,
                                         size_t samples_per_channel,
                                         int16_t* dst_audio) {
-  for (size_t i = 0; i < samples_per_channel; i++) {
-    dst_audio[2 * i] = src_audio[i];
-    dst_audio[2 * i + 1] = src_audio[i];
-  }
+  UpmixMonoToInterleaved(src_audio,
+                         rtc::checked_cast<int>(samples_per_channel), 2,
+                         dst_audio);
 }
 
 int AudioFrameOperations::MonoToStereo(AudioFrame* frame) {
@@ -101,10 +97,7 @@ int AudioFrameOperations::MonoToStereo(AudioFrame* frame) {
 void AudioFrameOperations::StereoToMono(const int16_t* src_audio,
                                         size_t samples_per_channel,
                                         int16_t* dst_audio) {
-  for (size_t i = 0; i < samples_per_channel; i++) {
-    dst_audio[i] =
-        (static_cast<int32_t>(src_audio[2 * i]) + src_audio[2 * i + 1]) >> 1;
-  }
+  AverageInterleavedStereoToMono(src_audio, samples_per_channel, dst_audio);
 }
 
 int AudioFrameOperations::StereoToMono(AudioFrame* frame) {
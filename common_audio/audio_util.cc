@@ -10,23 +10,122 @@
 
 #include "webrtc/common_audio/include/audio_util.h"
 
+#include "webrtc/common_audio/audio_util_simd.h"
+#include "webrtc/rtc_base/safe_conversions.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 
+namespace {
+
+void FloatS16ToS16_C(const float* src, size_t size, int16_t* dest) {
+  for (size_t i = 0; i < size; ++i)
+    dest[i] = FloatS16ToS16(src[i]);
+}
+
+void S16ToFloat_C(const int16_t* src, size_t size, float* dest) {
+  for (size_t i = 0; i < size; ++i)
+    dest[i] = S16ToFloat(src[i]);
+}
+
+void DownmixInterleavedStereoToMono_C(const int16_t* interleaved,
+                                      size_t num_frames,
+                                      int16_t* mono) {
+  DownmixInterleavedToMonoImpl<int16_t, int32_t>(interleaved, num_frames, 2,
+                                                 mono);
+}
+
+void AverageInterleavedStereoToMono_C(const int16_t* interleaved,
+                                      size_t num_frames,
+                                      int16_t* mono) {
+  for (size_t i = 0; i < num_frames; ++i) {
+    mono[i] = (static_cast<int32_t>(interleaved[2 * i]) +
+               interleaved[2 * i + 1]) >> 1;
+  }
+}
+
+void UpmixMonoToInterleavedStereo_C(const int16_t* mono,
+                                    size_t num_frames,
+                                    int16_t* interleaved) {
+  for (size_t i = 0; i < num_frames; ++i) {
+    interleaved[2 * i] = mono[i];
+    interleaved[2 * i + 1] = mono[i];
+  }
+}
+
+void AddWithSaturation_C(const int16_t* src, size_t size, int16_t* dest) {
+  for (size_t i = 0; i < size; ++i) {
+    dest[i] = rtc::saturated_cast<int16_t>(static_cast<int32_t>(src[i]) +
+                                           dest[i]);
+  }
+}
+
+// The implementations of the array functions that are used on this CPU.
+struct AudioUtilFunctions {
+  AudioUtilFunctions()
+      : float_s16_to_s16(FloatS16ToS16_C),
+        s16_to_float(S16ToFloat_C),
+        downmix_stereo_to_mono(DownmixInterleavedStereoToMono_C),
+        average_stereo_to_mono(AverageInterleavedStereoToMono_C),
+        upmix_mono_to_stereo(UpmixMonoToInterleavedStereo_C),
+        add_with_saturation(AddWithSaturation_C) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (WebRtc_GetCPUInfo(kSSE2)) {
+      float_s16_to_s16 = FloatS16ToS16_SSE2;
+      s16_to_float = S16ToFloat_SSE2;
+      downmix_stereo_to_mono = DownmixInterleavedStereoToMono_SSE2;
+      average_stereo_to_mono = AverageInterleavedStereoToMono_SSE2;
+      upmix_mono_to_stereo = UpmixMonoToInterleavedStereo_SSE2;
+      add_with_saturation = AddWithSaturation_SSE2;
+    }
+    if (WebRtc_GetCPUInfo(kAVX2)) {
+      float_s16_to_s16 = FloatS16ToS16_AVX2;
+      s16_to_float = S16ToFloat_AVX2;
+      downmix_stereo_to_mono = DownmixInterleavedStereoToMono_AVX2;
+    }
+#elif defined(WEBRTC_HAS_NEON)
+    float_s16_to_s16 = FloatS16ToS16_NEON;
+    s16_to_float = S16ToFloat_NEON;
+    downmix_stereo_to_mono = DownmixInterleavedStereoToMono_NEON;
+    average_stereo_to_mono = AverageInterleavedStereoToMono_NEON;
+    upmix_mono_to_stereo = UpmixMonoToInterleavedStereo_NEON;
+    add_with_saturation = AddWithSaturation_NEON;
+#endif
+  }
+
+  void (*float_s16_to_s16)(const float* src, size_t size, int16_t* dest);
+  void (*s16_to_float)(const int16_t* src, size_t size, float* dest);
+  void (*downmix_stereo_to_mono)(const int16_t* interleaved,
+                                 size_t num_frames,
+                                 int16_t* mono);
+  void (*average_stereo_to_mono)(const int16_t* interleaved,
+                                 size_t num_frames,
+                                 int16_t* mono);
+  void (*upmix_mono_to_stereo)(const int16_t* mono,
+                               size_t num_frames,
+                               int16_t* interleaved);
+  void (*add_with_saturation)(const int16_t* src, size_t size, int16_t* dest);
+};
+
+const AudioUtilFunctions& GetFunctions() {
+  static const AudioUtilFunctions functions;
+  return functions;
+}
+
+}  // namespace
+
 void FloatToS16(const float* src, size_t size, int16_t* dest) {
   for (size_t i = 0; i < size; ++i)
     dest[i] = FloatToS16(src[i]);
 }
 
 void S16ToFloat(const int16_t* src, size_t size, float* dest) {
-  for (size_t i = 0; i < size; ++i)
-    dest[i] = S16ToFloat(src[i]);
+  GetFunctions().s16_to_float(src, size, dest);
 }
 
 void FloatS16ToS16(const float* src, size_t size, int16_t* dest) {
-  for (size_t i = 0; i < size; ++i)
-    dest[i] = FloatS16ToS16(src[i]);
+  GetFunctions().float_s16_to_s16(src, size, dest);
 }
 
 void FloatToFloatS16(const float* src, size_t size, float* dest) {
@@ -39,13 +138,46 @@ void FloatS16ToFloat(const float* src, size_t size, float* dest) {
     dest[i] = FloatS16ToFloat(src[i]);
 }
 
+void AddWithSaturation(const int16_t* src, size_t size, int16_t* dest) {
+  GetFunctions().add_with_saturation(src, size, dest);
+}
+
+template <>
+void UpmixMonoToInterleaved<int16_t>(const int16_t* mono,
+                                     int num_frames,
+                                     int num_channels,
+                                     int16_t* interleaved) {
+  if (num_channels == 2) {
+    GetFunctions().upmix_mono_to_stereo(mono, num_frames, interleaved);
+    return;
+  }
+  int interleaved_idx = 0;
+  for (int i = 0; i < num_frames; ++i) {
+    for (int j = 0; j < num_channels; ++j) {
+      interleaved[interleaved_idx++] = mono[i];
+    }
+  }
+}
+
 template <>
 void DownmixInterleavedToMono<int16_t>(const int16_t* interleaved,
                                        size_t num_frames,
                                        int num_channels,
                                        int16_t* deinterleaved) {
+  RTC_DCHECK_GT(num_frames, 0);
+  if (num_channels == 2) {
+    GetFunctions().downmix_stereo_to_mono(interleaved, num_frames,
+                                          deinterleaved);
+    return;
+  }
   DownmixInterleavedToMonoImpl<int16_t, int32_t>(interleaved, num_frames,
                                                  num_channels, deinterleaved);
 }
 
+void AverageInterleavedStereoToMono(const int16_t* interleaved,
+                                    size_t num_frames,
+                                    int16_t* mono) {
+  GetFunctions().average_stereo_to_mono(interleaved, num_frames, mono);
+}
+
 }  // namespace webrtc
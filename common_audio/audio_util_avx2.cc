@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/audio_util_simd.h"
+
+#include <immintrin.h>
+
+#include "webrtc/common_audio/include/audio_util.h"
+
+namespace webrtc {
+
+// _mm256_packs_epi32() packs within each 128-bit lane; this permutation puts
+// the 64-bit blocks back in order.
+#define PACKS_PERMUTATION 0xD8
+
+void FloatS16ToS16_AVX2(const float* src, size_t size, int16_t* dest) {
+  const __m256 kHalf = _mm256_set1_ps(0.5f);
+  const __m256 kSignMask = _mm256_set1_ps(-0.f);
+  const __m256 kMax = _mm256_set1_ps(limits_int16::max());
+  const __m256 kMin = _mm256_set1_ps(limits_int16::min());
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m256 v0 = _mm256_loadu_ps(src + i);
+    __m256 v1 = _mm256_loadu_ps(src + i + 8);
+    // See FloatS16ToS16_SSE2().
+    v0 = _mm256_add_ps(v0, _mm256_or_ps(kHalf, _mm256_and_ps(v0, kSignMask)));
+    v1 = _mm256_add_ps(v1, _mm256_or_ps(kHalf, _mm256_and_ps(v1, kSignMask)));
+    v0 = _mm256_max_ps(_mm256_min_ps(v0, kMax), kMin);
+    v1 = _mm256_max_ps(_mm256_min_ps(v1, kMax), kMin);
+    const __m256i packed =
+        _mm256_packs_epi32(_mm256_cvttps_epi32(v0), _mm256_cvttps_epi32(v1));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i),
+                        _mm256_permute4x64_epi64(packed, PACKS_PERMUTATION));
+  }
+  for (; i < size; ++i)
+    dest[i] = FloatS16ToS16(src[i]);
+}
+
+void S16ToFloat_AVX2(const int16_t* src, size_t size, float* dest) {
+  const __m256 kMaxInt16Inverse = _mm256_set1_ps(1.f / limits_int16::max());
+  const __m256 kMinInt16Inverse = _mm256_set1_ps(-1.f / limits_int16::min());
+  const __m256i kZero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m256i v0 = _mm256_cvtepi16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    const __m256i v1 = _mm256_cvtepi16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8)));
+    const __m256 scale0 = _mm256_blendv_ps(
+        kMinInt16Inverse, kMaxInt16Inverse,
+        _mm256_castsi256_ps(_mm256_cmpgt_epi32(v0, kZero)));
+    const __m256 scale1 = _mm256_blendv_ps(
+        kMinInt16Inverse, kMaxInt16Inverse,
+        _mm256_castsi256_ps(_mm256_cmpgt_epi32(v1, kZero)));
+    _mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v0), scale0));
+    _mm256_storeu_ps(dest + i + 8,
+                     _mm256_mul_ps(_mm256_cvtepi32_ps(v1), scale1));
+  }
+  for (; i < size; ++i)
+    dest[i] = S16ToFloat(src[i]);
+}
+
+void DownmixInterleavedStereoToMono_AVX2(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono) {
+  const __m256i kOnes = _mm256_set1_epi16(1);
+  size_t i = 0;
+  for (; i + 16 <= num_frames; i += 16) {
+    const __m256i v0 = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(interleaved + 2 * i));
+    const __m256i v1 = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(interleaved + 2 * i + 16));
+    // See DownmixInterleavedStereoToMono_SSE2().
+    __m256i sum0 = _mm256_madd_epi16(v0, kOnes);
+    __m256i sum1 = _mm256_madd_epi16(v1, kOnes);
+    sum0 = _mm256_srai_epi32(
+        _mm256_add_epi32(sum0, _mm256_srli_epi32(sum0, 31)), 1);
+    sum1 = _mm256_srai_epi32(
+        _mm256_add_epi32(sum1, _mm256_srli_epi32(sum1, 31)), 1);
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(mono + i),
+        _mm256_permute4x64_epi64(_mm256_packs_epi32(sum0, sum1),
+                                 PACKS_PERMUTATION));
+  }
+  DownmixInterleavedStereoToMono_SSE2(interleaved + 2 * i, num_frames - i,
+                                      mono + i);
+}
+
+#undef PACKS_PERMUTATION
+
+}  // namespace webrtc
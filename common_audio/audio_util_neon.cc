@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/audio_util_simd.h"
+
+#include <arm_neon.h>
+
+#include "webrtc/common_audio/include/audio_util.h"
+#include "webrtc/rtc_base/safe_conversions.h"
+
+namespace webrtc {
+
+void FloatS16ToS16_NEON(const float* src, size_t size, int16_t* dest) {
+  const uint32x4_t kHalf = vreinterpretq_u32_f32(vdupq_n_f32(0.5f));
+  const uint32x4_t kSignMask = vdupq_n_u32(0x80000000);
+  const float32x4_t kMax = vdupq_n_f32(limits_int16::max());
+  const float32x4_t kMin = vdupq_n_f32(limits_int16::min());
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    float32x4_t v0 = vld1q_f32(src + i);
+    float32x4_t v1 = vld1q_f32(src + i + 4);
+    // Round half away from zero by adding +-0.5 and truncating. Clamping
+    // before the conversion makes the result saturate like FloatS16ToS16().
+    v0 = vaddq_f32(v0, vreinterpretq_f32_u32(vorrq_u32(
+                           kHalf, vandq_u32(vreinterpretq_u32_f32(v0),
+                                            kSignMask))));
+    v1 = vaddq_f32(v1, vreinterpretq_f32_u32(vorrq_u32(
+                           kHalf, vandq_u32(vreinterpretq_u32_f32(v1),
+                                            kSignMask))));
+    v0 = vmaxq_f32(vminq_f32(v0, kMax), kMin);
+    v1 = vmaxq_f32(vminq_f32(v1, kMax), kMin);
+    vst1q_s16(dest + i, vcombine_s16(vmovn_s32(vcvtq_s32_f32(v0)),
+                                     vmovn_s32(vcvtq_s32_f32(v1))));
+  }
+  for (; i < size; ++i)
+    dest[i] = FloatS16ToS16(src[i]);
+}
+
+void S16ToFloat_NEON(const int16_t* src, size_t size, float* dest) {
+  const float32x4_t kMaxInt16Inverse = vdupq_n_f32(1.f / limits_int16::max());
+  const float32x4_t kMinInt16Inverse =
+      vdupq_n_f32(-1.f / limits_int16::min());
+  const int32x4_t kZero = vdupq_n_s32(0);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const int16x8_t v = vld1q_s16(src + i);
+    const int32x4_t v0 = vmovl_s16(vget_low_s16(v));
+    const int32x4_t v1 = vmovl_s16(vget_high_s16(v));
+    const float32x4_t scale0 =
+        vbslq_f32(vcgtq_s32(v0, kZero), kMaxInt16Inverse, kMinInt16Inverse);
+    const float32x4_t scale1 =
+        vbslq_f32(vcgtq_s32(v1, kZero), kMaxInt16Inverse, kMinInt16Inverse);
+    vst1q_f32(dest + i, vmulq_f32(vcvtq_f32_s32(v0), scale0));
+    vst1q_f32(dest + i + 4, vmulq_f32(vcvtq_f32_s32(v1), scale1));
+  }
+  for (; i < size; ++i)
+    dest[i] = S16ToFloat(src[i]);
+}
+
+void DownmixInterleavedStereoToMono_NEON(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono) {
+  size_t i = 0;
+  for (; i + 8 <= num_frames; i += 8) {
+    const int16x8x2_t v = vld2q_s16(interleaved + 2 * i);
+    int32x4_t sum0 = vaddl_s16(vget_low_s16(v.val[0]), vget_low_s16(v.val[1]));
+    int32x4_t sum1 =
+        vaddl_s16(vget_high_s16(v.val[0]), vget_high_s16(v.val[1]));
+    // Divide by two, rounding towards zero.
+    sum0 = vshrq_n_s32(
+        vaddq_s32(sum0, vreinterpretq_s32_u32(
+                            vshrq_n_u32(vreinterpretq_u32_s32(sum0), 31))),
+        1);
+    sum1 = vshrq_n_s32(
+        vaddq_s32(sum1, vreinterpretq_s32_u32(
+                            vshrq_n_u32(vreinterpretq_u32_s32(sum1), 31))),
+        1);
+    vst1q_s16(mono + i, vcombine_s16(vmovn_s32(sum0), vmovn_s32(sum1)));
+  }
+  for (; i < num_frames; ++i) {
+    mono[i] = (static_cast<int32_t>(interleaved[2 * i]) +
+               interleaved[2 * i + 1]) / 2;
+  }
+}
+
+void AverageInterleavedStereoToMono_NEON(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono) {
+  size_t i = 0;
+  for (; i + 8 <= num_frames; i += 8) {
+    const int16x8x2_t v = vld2q_s16(interleaved + 2 * i);
+    // The halving add computes (left + right) >> 1 without overflow.
+    vst1q_s16(mono + i, vhaddq_s16(v.val[0], v.val[1]));
+  }
+  for (; i < num_frames; ++i) {
+    mono[i] = (static_cast<int32_t>(interleaved[2 * i]) +
+               interleaved[2 * i + 1]) >> 1;
+  }
+}
+
+void UpmixMonoToInterleavedStereo_NEON(const int16_t* mono,
+                                       size_t num_frames,
+                                       int16_t* interleaved) {
+  size_t i = 0;
+  for (; i + 8 <= num_frames; i += 8) {
+    int16x8x2_t v;
+    v.val[0] = vld1q_s16(mono + i);
+    v.val[1] = v.val[0];
+    vst2q_s16(interleaved + 2 * i, v);
+  }
+  for (; i < num_frames; ++i) {
+    interleaved[2 * i] = mono[i];
+    interleaved[2 * i + 1] = mono[i];
+  }
+}
+
+void AddWithSaturation_NEON(const int16_t* src, size_t size, int16_t* dest) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+    vst1q_s16(dest + i, vqaddq_s16(vld1q_s16(src + i), vld1q_s16(dest + i)));
+  for (; i < size; ++i) {
+    dest[i] = rtc::saturated_cast<int16_t>(static_cast<int32_t>(src[i]) +
+                                           dest[i]);
+  }
+}
+
+}  // namespace webrtc
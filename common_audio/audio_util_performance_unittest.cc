@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "webrtc/common_audio/audio_util_simd.h"
+#include "webrtc/common_audio/include/audio_util.h"
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+// 10 ms of 48 kHz stereo audio.
+const size_t kNumSamples = 960;
+
+// Runs |function| on |kNumSamples| samples repeatedly and reports the
+// throughput in samples per nanosecond.
+void ReportThroughput(const std::string& function_name,
+                      const std::string& implementation,
+                      const std::function<void()>& function) {
+  const int num_iterations =
+      field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 1000 : 100000;
+  // Warm up.
+  for (int i = 0; i < 100; ++i)
+    function();
+  const int64_t start_time_ns = rtc::TimeNanos();
+  for (int i = 0; i < num_iterations; ++i)
+    function();
+  const int64_t elapsed_ns = rtc::TimeNanos() - start_time_ns;
+  ASSERT_GT(elapsed_ns, 0);
+  test::PrintResult(function_name, "", implementation,
+                    std::to_string(static_cast<double>(kNumSamples) *
+                                   num_iterations / elapsed_ns),
+                    "samples/ns", false);
+}
+
+class AudioUtilPerformanceTest : public ::testing::Test {
+ protected:
+  AudioUtilPerformanceTest()
+      : float_s16_(kNumSamples),
+        s16_(kNumSamples),
+        output_s16_(kNumSamples),
+        output_float_(kNumSamples) {
+    Random random(42);
+    for (size_t i = 0; i < kNumSamples; ++i) {
+      float_s16_[i] = random.Gaussian(0, 10000.f);
+      s16_[i] = random.Rand<int16_t>();
+    }
+  }
+
+  std::vector<float> float_s16_;
+  std::vector<int16_t> s16_;
+  std::vector<int16_t> output_s16_;
+  std::vector<float> output_float_;
+};
+
+}  // namespace
+
+TEST_F(AudioUtilPerformanceTest, FloatS16ToS16) {
+  ReportThroughput("float_s16_to_s16", "scalar", [this] {
+    for (size_t i = 0; i < kNumSamples; ++i)
+      output_s16_[i] = FloatS16ToS16(float_s16_[i]);
+  });
+  ReportThroughput("float_s16_to_s16", "dispatched", [this] {
+    FloatS16ToS16(float_s16_.data(), kNumSamples, output_s16_.data());
+  });
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    ReportThroughput("float_s16_to_s16", "sse2", [this] {
+      FloatS16ToS16_SSE2(float_s16_.data(), kNumSamples, output_s16_.data());
+    });
+  }
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    ReportThroughput("float_s16_to_s16", "avx2", [this] {
+      FloatS16ToS16_AVX2(float_s16_.data(), kNumSamples, output_s16_.data());
+    });
+  }
+#endif
+}
+
+TEST_F(AudioUtilPerformanceTest, S16ToFloat) {
+  ReportThroughput("s16_to_float", "scalar", [this] {
+    for (size_t i = 0; i < kNumSamples; ++i)
+      output_float_[i] = S16ToFloat(s16_[i]);
+  });
+  ReportThroughput("s16_to_float", "dispatched", [this] {
+    S16ToFloat(s16_.data(), kNumSamples, output_float_.data());
+  });
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    ReportThroughput("s16_to_float", "sse2", [this] {
+      S16ToFloat_SSE2(s16_.data(), kNumSamples, output_float_.data());
+    });
+  }
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    ReportThroughput("s16_to_float", "avx2", [this] {
+      S16ToFloat_AVX2(s16_.data(), kNumSamples, output_float_.data());
+    });
+  }
+#endif
+}
+
+TEST_F(AudioUtilPerformanceTest, DownmixInterleavedToMono) {
+  // Throughput is counted in input samples.
+  const size_t kNumFrames = kNumSamples / 2;
+  ReportThroughput("downmix_interleaved_to_mono", "scalar", [this] {
+    DownmixInterleavedToMonoImpl<int16_t, int32_t>(s16_.data(), kNumFrames, 2,
+                                                   output_s16_.data());
+  });
+  ReportThroughput("downmix_interleaved_to_mono", "dispatched", [this] {
+    DownmixInterleavedToMono(s16_.data(), kNumFrames, 2, output_s16_.data());
+  });
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    ReportThroughput("downmix_interleaved_to_mono", "sse2", [this] {
+      DownmixInterleavedStereoToMono_SSE2(s16_.data(), kNumFrames,
+                                          output_s16_.data());
+    });
+  }
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    ReportThroughput("downmix_interleaved_to_mono", "avx2", [this] {
+      DownmixInterleavedStereoToMono_AVX2(s16_.data(), kNumFrames,
+                                          output_s16_.data());
+    });
+  }
+#endif
+}
+
+TEST_F(AudioUtilPerformanceTest, FrameOperations) {
+  const size_t kNumFrames = kNumSamples / 2;
+  ReportThroughput("average_interleaved_stereo_to_mono", "dispatched", [this] {
+    AverageInterleavedStereoToMono(s16_.data(), kNumFrames,
+                                   output_s16_.data());
+  });
+  ReportThroughput("upmix_mono_to_interleaved", "dispatched", [this] {
+    UpmixMonoToInterleaved(s16_.data(), static_cast<int>(kNumFrames), 2,
+                           output_s16_.data());
+  });
+  ReportThroughput("add_with_saturation", "dispatched", [this] {
+    AddWithSaturation(s16_.data(), kNumSamples, output_s16_.data());
+  });
+}
+
+}  // namespace webrtc
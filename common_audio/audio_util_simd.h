@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_AUDIO_UTIL_SIMD_H_
+#define WEBRTC_COMMON_AUDIO_AUDIO_UTIL_SIMD_H_
+
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
+// Vectorized versions of the array functions in include/audio_util.h. They
+// are bit-exact with the scalar versions and are selected at run time by
+// audio_util.cc; use the functions in include/audio_util.h instead.
+
+namespace webrtc {
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void FloatS16ToS16_SSE2(const float* src, size_t size, int16_t* dest);
+void S16ToFloat_SSE2(const int16_t* src, size_t size, float* dest);
+void DownmixInterleavedStereoToMono_SSE2(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono);
+void AverageInterleavedStereoToMono_SSE2(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono);
+void UpmixMonoToInterleavedStereo_SSE2(const int16_t* mono,
+                                       size_t num_frames,
+                                       int16_t* interleaved);
+void AddWithSaturation_SSE2(const int16_t* src, size_t size, int16_t* dest);
+
+// Only to be called after checking WebRtc_GetCPUInfo(kAVX2).
+void FloatS16ToS16_AVX2(const float* src, size_t size, int16_t* dest);
+void S16ToFloat_AVX2(const int16_t* src, size_t size, float* dest);
+void DownmixInterleavedStereoToMono_AVX2(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono);
+#elif defined(WEBRTC_HAS_NEON)
+void FloatS16ToS16_NEON(const float* src, size_t size, int16_t* dest);
+void S16ToFloat_NEON(const int16_t* src, size_t size, float* dest);
+void DownmixInterleavedStereoToMono_NEON(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono);
+void AverageInterleavedStereoToMono_NEON(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono);
+void UpmixMonoToInterleavedStereo_NEON(const int16_t* mono,
+                                       size_t num_frames,
+                                       int16_t* interleaved);
+void AddWithSaturation_NEON(const int16_t* src, size_t size, int16_t* dest);
+#endif
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_AUDIO_UTIL_SIMD_H_
@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/audio_util_simd.h"
+
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/include/audio_util.h"
+#include "webrtc/rtc_base/safe_conversions.h"
+
+namespace webrtc {
+
+void FloatS16ToS16_SSE2(const float* src, size_t size, int16_t* dest) {
+  const __m128 kHalf = _mm_set1_ps(0.5f);
+  const __m128 kSignMask = _mm_set1_ps(-0.f);
+  const __m128 kMax = _mm_set1_ps(limits_int16::max());
+  const __m128 kMin = _mm_set1_ps(limits_int16::min());
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m128 v0 = _mm_loadu_ps(src + i);
+    __m128 v1 = _mm_loadu_ps(src + i + 4);
+    // Round half away from zero by adding +-0.5 and truncating. Clamping
+    // before the conversion makes the result saturate like FloatS16ToS16().
+    v0 = _mm_add_ps(v0, _mm_or_ps(kHalf, _mm_and_ps(v0, kSignMask)));
+    v1 = _mm_add_ps(v1, _mm_or_ps(kHalf, _mm_and_ps(v1, kSignMask)));
+    v0 = _mm_max_ps(_mm_min_ps(v0, kMax), kMin);
+    v1 = _mm_max_ps(_mm_min_ps(v1, kMax), kMin);
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dest + i),
+        _mm_packs_epi32(_mm_cvttps_epi32(v0), _mm_cvttps_epi32(v1)));
+  }
+  for (; i < size; ++i)
+    dest[i] = FloatS16ToS16(src[i]);
+}
+
+void S16ToFloat_SSE2(const int16_t* src, size_t size, float* dest) {
+  const __m128 kMaxInt16Inverse = _mm_set1_ps(1.f / limits_int16::max());
+  const __m128 kMinInt16Inverse = _mm_set1_ps(-1.f / limits_int16::min());
+  const __m128i kZero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    // Sign extend to 32 bits.
+    const __m128i v0 = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+    const __m128i v1 = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+    const __m128 positive0 = _mm_castsi128_ps(_mm_cmpgt_epi32(v0, kZero));
+    const __m128 positive1 = _mm_castsi128_ps(_mm_cmpgt_epi32(v1, kZero));
+    const __m128 scale0 = _mm_or_ps(_mm_and_ps(positive0, kMaxInt16Inverse),
+                                    _mm_andnot_ps(positive0, kMinInt16Inverse));
+    const __m128 scale1 = _mm_or_ps(_mm_and_ps(positive1, kMaxInt16Inverse),
+                                    _mm_andnot_ps(positive1, kMinInt16Inverse));
+    _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(v0), scale0));
+    _mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(v1), scale1));
+  }
+  for (; i < size; ++i)
+    dest[i] = S16ToFloat(src[i]);
+}
+
+void DownmixInterleavedStereoToMono_SSE2(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono) {
+  const __m128i kOnes = _mm_set1_epi16(1);
+  size_t i = 0;
+  for (; i + 8 <= num_frames; i += 8) {
+    const __m128i v0 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(interleaved + 2 * i));
+    const __m128i v1 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(interleaved + 2 * i + 8));
+    // Sums of left and right in 32 bits.
+    __m128i sum0 = _mm_madd_epi16(v0, kOnes);
+    __m128i sum1 = _mm_madd_epi16(v1, kOnes);
+    // Divide by two, rounding towards zero.
+    sum0 = _mm_srai_epi32(_mm_add_epi32(sum0, _mm_srli_epi32(sum0, 31)), 1);
+    sum1 = _mm_srai_epi32(_mm_add_epi32(sum1, _mm_srli_epi32(sum1, 31)), 1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(mono + i),
+                     _mm_packs_epi32(sum0, sum1));
+  }
+  for (; i < num_frames; ++i) {
+    mono[i] = (static_cast<int32_t>(interleaved[2 * i]) +
+               interleaved[2 * i + 1]) / 2;
+  }
+}
+
+void AverageInterleavedStereoToMono_SSE2(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono) {
+  const __m128i kOnes = _mm_set1_epi16(1);
+  size_t i = 0;
+  for (; i + 8 <= num_frames; i += 8) {
+    const __m128i v0 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(interleaved + 2 * i));
+    const __m128i v1 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(interleaved + 2 * i + 8));
+    const __m128i sum0 = _mm_srai_epi32(_mm_madd_epi16(v0, kOnes), 1);
+    const __m128i sum1 = _mm_srai_epi32(_mm_madd_epi16(v1, kOnes), 1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(mono + i),
+                     _mm_packs_epi32(sum0, sum1));
+  }
+  for (; i < num_frames; ++i) {
+    mono[i] = (static_cast<int32_t>(interleaved[2 * i]) +
+               interleaved[2 * i + 1]) >> 1;
+  }
+}
+
+void UpmixMonoToInterleavedStereo_SSE2(const int16_t* mono,
+                                       size_t num_frames,
+                                       int16_t* interleaved) {
+  size_t i = 0;
+  for (; i + 8 <= num_frames; i += 8) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(mono + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(interleaved + 2 * i),
+                     _mm_unpacklo_epi16(v, v));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(interleaved + 2 * i + 8),
+                     _mm_unpackhi_epi16(v, v));
+  }
+  for (; i < num_frames; ++i) {
+    interleaved[2 * i] = mono[i];
+    interleaved[2 * i + 1] = mono[i];
+  }
+}
+
+void AddWithSaturation_SSE2(const int16_t* src, size_t size, int16_t* dest) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_adds_epi16(a, b));
+  }
+  for (; i < size; ++i) {
+    dest[i] = rtc::saturated_cast<int16_t>(static_cast<int32_t>(src[i]) +
+                                           dest[i]);
+  }
+}
+
+}  // namespace webrtc
@@ -9,6 +9,15 @@
  */
 
 #include "webrtc/common_audio/include/audio_util.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "webrtc/common_audio/audio_util_simd.h"
+#include "webrtc/rtc_base/arraysize.h"
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/rtc_base/safe_conversions.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 #include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
 #include "webrtc/typedefs.h"
@@ -227,5 +236,146 @@ TEST(AudioUtilTest, DownmixToMonoTest) {
   }
 }
 
+// Sizes covering the vector loops as well as their scalar tails.
+const size_t kExactnessTestSizes[] = {0, 1, 7, 8, 15, 16, 17, 31, 33, 160, 479};
+
+std::vector<float> CreateFloatS16TestVector(size_t size, Random* random) {
+  // Values close to rounding and saturation boundaries, then random values
+  // beyond the int16_t range.
+  const float kSpecialValues[] = {0.f,       -0.f,      0.5f,     -0.5f,
+                                  0.49999f,  -0.49999f, 1.5f,     -1.5f,
+                                  32766.5f,  32766.49f, 32767.f,  32767.5f,
+                                  -32767.5f, -32767.4f, -32768.f, -32768.5f,
+                                  1e10f,     -1e10f};
+  std::vector<float> v(size);
+  for (size_t i = 0; i < size; ++i) {
+    v[i] = i < arraysize(kSpecialValues)
+               ? kSpecialValues[i]
+               : random->Gaussian(0, 20000.f);
+  }
+  return v;
+}
+
+std::vector<int16_t> CreateS16TestVector(size_t size, Random* random) {
+  const int16_t kSpecialValues[] = {0, 1, -1, 32767, -32768, 32766, -32767};
+  std::vector<int16_t> v(size);
+  for (size_t i = 0; i < size; ++i) {
+    v[i] = i < arraysize(kSpecialValues) ? kSpecialValues[i]
+                                         : random->Rand<int16_t>();
+  }
+  return v;
+}
+
+typedef void (*FloatS16ToS16Function)(const float*, size_t, int16_t*);
+typedef void (*S16ToFloatFunction)(const int16_t*, size_t, float*);
+typedef void (*StereoToMonoFunction)(const int16_t*, size_t, int16_t*);
+
+void ExpectFloatS16ToS16Exact(FloatS16ToS16Function function) {
+  Random random(42);
+  for (size_t size : kExactnessTestSizes) {
+    const std::vector<float> input = CreateFloatS16TestVector(size, &random);
+    std::vector<int16_t> output(size);
+    function(input.data(), size, output.data());
+    for (size_t i = 0; i < size; ++i)
+      EXPECT_EQ(FloatS16ToS16(input[i]), output[i]) << input[i];
+  }
+}
+
+void ExpectS16ToFloatExact(S16ToFloatFunction function) {
+  Random random(42);
+  for (size_t size : kExactnessTestSizes) {
+    const std::vector<int16_t> input = CreateS16TestVector(size, &random);
+    std::vector<float> output(size);
+    function(input.data(), size, output.data());
+    for (size_t i = 0; i < size; ++i)
+      EXPECT_EQ(S16ToFloat(input[i]), output[i]) << input[i];
+  }
+}
+
+// Also checks that the function works in place.
+void ExpectStereoToMonoExact(StereoToMonoFunction function, bool floor) {
+  Random random(42);
+  for (size_t num_frames : kExactnessTestSizes) {
+    std::vector<int16_t> data = CreateS16TestVector(2 * num_frames, &random);
+    std::vector<int16_t> expected(num_frames);
+    for (size_t i = 0; i < num_frames; ++i) {
+      const int32_t sum = static_cast<int32_t>(data[2 * i]) + data[2 * i + 1];
+      expected[i] = floor ? sum >> 1 : sum / 2;
+    }
+    function(data.data(), num_frames, data.data());
+    for (size_t i = 0; i < num_frames; ++i)
+      EXPECT_EQ(expected[i], data[i]);
+  }
+}
+
 }  // namespace
+
+TEST(AudioUtilTest, UpmixMonoToInterleaved) {
+  const int16_t kMono[] = {1, -2, 3, -4, 5, -6, 7, -8, 9};
+  const int kNumFrames = arraysize(kMono);
+  for (int num_channels = 1; num_channels <= 3; ++num_channels) {
+    std::vector<int16_t> interleaved(kNumFrames * num_channels);
+    UpmixMonoToInterleaved(kMono, kNumFrames, num_channels,
+                           interleaved.data());
+    for (size_t i = 0; i < interleaved.size(); ++i)
+      EXPECT_EQ(kMono[i / num_channels], interleaved[i]);
+  }
+}
+
+TEST(AudioUtilTest, AverageInterleavedStereoToMono) {
+  const int16_t kInterleaved[] = {10, 20, -10, -31, 32767, 32767, -32768, 1};
+  const int16_t kExpected[] = {15, -21, 32767, -16384};
+  int16_t mono[arraysize(kExpected)];
+  AverageInterleavedStereoToMono(kInterleaved, arraysize(kExpected), mono);
+  EXPECT_THAT(mono, ElementsAreArray(kExpected));
+}
+
+TEST(AudioUtilTest, AddWithSaturation) {
+  Random random(42);
+  for (size_t size : kExactnessTestSizes) {
+    const std::vector<int16_t> src = CreateS16TestVector(size, &random);
+    std::vector<int16_t> dest = CreateS16TestVector(size, &random);
+    std::reverse(dest.begin(), dest.end());
+    std::vector<int16_t> expected(size);
+    for (size_t i = 0; i < size; ++i) {
+      expected[i] = rtc::saturated_cast<int16_t>(
+          static_cast<int32_t>(src[i]) + dest[i]);
+    }
+    AddWithSaturation(src.data(), size, dest.data());
+    EXPECT_EQ(expected, dest);
+  }
+}
+
+// The vectorized implementations must match the scalar versions exactly.
+TEST(AudioUtilTest, ArrayFunctionsMatchScalarVersions) {
+  ExpectFloatS16ToS16Exact(FloatS16ToS16);
+  ExpectS16ToFloatExact(S16ToFloat);
+  ExpectStereoToMonoExact(
+      [](const int16_t* interleaved, size_t num_frames, int16_t* mono) {
+        if (num_frames > 0)
+          DownmixInterleavedToMono(interleaved, num_frames, 2, mono);
+      },
+      false);
+  ExpectStereoToMonoExact(AverageInterleavedStereoToMono, true);
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(AudioUtilTest, SSE2MatchesScalarVersions) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  ExpectFloatS16ToS16Exact(FloatS16ToS16_SSE2);
+  ExpectS16ToFloatExact(S16ToFloat_SSE2);
+  ExpectStereoToMonoExact(DownmixInterleavedStereoToMono_SSE2, false);
+  ExpectStereoToMonoExact(AverageInterleavedStereoToMono_SSE2, true);
+}
+
+TEST(AudioUtilTest, AVX2MatchesScalarVersions) {
+  if (!WebRtc_GetCPUInfo(kAVX2))
+    return;
+  ExpectFloatS16ToS16Exact(FloatS16ToS16_AVX2);
+  ExpectS16ToFloatExact(S16ToFloat_AVX2);
+  ExpectStereoToMonoExact(DownmixInterleavedStereoToMono_AVX2, false);
+}
+#endif
+
 }  // namespace webrtc
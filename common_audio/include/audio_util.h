@@ -59,12 +59,16 @@ static inline float FloatS16ToFloat(float v) {
   return v * (v > 0 ? kMaxInt16Inverse : -kMinInt16Inverse);
 }
 
+// S16ToFloat() and FloatS16ToS16() use SIMD instructions where available.
 void FloatToS16(const float* src, size_t size, int16_t* dest);
 void S16ToFloat(const int16_t* src, size_t size, float* dest);
 void FloatS16ToS16(const float* src, size_t size, int16_t* dest);
 void FloatToFloatS16(const float* src, size_t size, float* dest);
 void FloatS16ToFloat(const float* src, size_t size, float* dest);
 
+// Adds |src| to |dest|, saturating each sum to the int16_t range.
+void AddWithSaturation(const int16_t* src, size_t size, int16_t* dest);
+
 // Copy audio from |src| channels to |dest| channels unless |src| and |dest|
 // point to the same address. |src| and |dest| must have the same number of
 // channels, and there must be sufficient space allocated in |dest|.
@@ -133,6 +137,12 @@ void UpmixMonoToInterleaved(const T* mono,
   }
 }
 
+template <>
+void UpmixMonoToInterleaved<int16_t>(const int16_t* mono,
+                                     int num_frames,
+                                     int num_channels,
+                                     int16_t* interleaved);
+
 template <typename T, typename Intermediate>
 void DownmixToMono(const T* const* input_channels,
                    size_t num_frames,
@@ -183,6 +193,13 @@ void DownmixInterleavedToMono<int16_t>(const int16_t* interleaved,
                                        int num_channels,
                                        int16_t* deinterleaved);
 
+// Downmixes interleaved stereo to mono as (left + right) >> 1, i.e. rounding
+// towards negative infinity, where DownmixInterleavedToMono() rounds towards
+// zero. |interleaved| and |mono| may point to the same buffer.
+void AverageInterleavedStereoToMono(const int16_t* interleaved,
+                                    size_t num_frames,
+                                    int16_t* mono);
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_COMMON_AUDIO_INCLUDE_AUDIO_UTIL_H_
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/common_audio/resampler/include/push_resampler.h"
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const size_t kNumStreams = 100;
+
+std::string TestLabel(int src_sample_rate_hz,
+                      int dst_sample_rate_hz,
+                      size_t num_channels) {
+  return std::to_string(src_sample_rate_hz / 1000) + "k_to_" +
+         std::to_string(dst_sample_rate_hz / 1000) + "k_" +
+         std::to_string(num_channels) + "ch";
+}
+
+// Resamples 10 ms frames of noise with |kNumStreams| PushResamplers, as a
+// mixer or ACM would for that many streams, and reports the time to set the
+// resamplers up as well as the time per resampled frame.
+void RunPushResamplerPerformanceTest(int src_sample_rate_hz,
+                                     int dst_sample_rate_hz,
+                                     size_t num_channels) {
+  const int num_frames =
+      field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 100 : 3000;
+  const size_t src_length = src_sample_rate_hz / 100 * num_channels;
+  const size_t dst_length = dst_sample_rate_hz / 100 * num_channels;
+  const std::string label =
+      TestLabel(src_sample_rate_hz, dst_sample_rate_hz, num_channels);
+
+  int64_t start_time_us = rtc::TimeMicros();
+  std::vector<std::unique_ptr<PushResampler<int16_t>>> resamplers;
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    resamplers.emplace_back(new PushResampler<int16_t>());
+    ASSERT_EQ(0, resamplers.back()->InitializeIfNeeded(
+                     src_sample_rate_hz, dst_sample_rate_hz, num_channels));
+  }
+  const int64_t init_time_us = rtc::TimeMicros() - start_time_us;
+
+  Random random(42);
+  std::vector<int16_t> src(src_length);
+  for (int16_t& sample : src)
+    sample = random.Rand<int16_t>();
+  std::vector<int16_t> dst(dst_length);
+
+  start_time_us = rtc::TimeMicros();
+  for (int frame = 0; frame < num_frames; ++frame) {
+    for (auto& resampler : resamplers) {
+      ASSERT_EQ(static_cast<int>(dst_length),
+                resampler->Resample(src.data(), src.size(), dst.data(),
+                                    dst.size()));
+    }
+  }
+  const int64_t process_time_us = rtc::TimeMicros() - start_time_us;
+
+  test::PrintResult(
+      "push_resampler_init_time", "", label,
+      std::to_string(static_cast<double>(init_time_us) / kNumStreams), "us",
+      false);
+  test::PrintResult("push_resampler_frame_time", "", label,
+                    std::to_string(static_cast<double>(process_time_us) /
+                                   (num_frames * kNumStreams)),
+                    "us", true);
+}
+
+}  // namespace
+
+TEST(PushResamplerPerformanceTest, 8kTo48kMono) {
+  RunPushResamplerPerformanceTest(8000, 48000, 1);
+}
+
+TEST(PushResamplerPerformanceTest, 48kTo8kMono) {
+  RunPushResamplerPerformanceTest(48000, 8000, 1);
+}
+
+TEST(PushResamplerPerformanceTest, 16kTo48kMono) {
+  RunPushResamplerPerformanceTest(16000, 48000, 1);
+}
+
+TEST(PushResamplerPerformanceTest, 48kTo16kMono) {
+  RunPushResamplerPerformanceTest(48000, 16000, 1);
+}
+
+TEST(PushResamplerPerformanceTest, 32kTo48kStereo) {
+  RunPushResamplerPerformanceTest(32000, 48000, 2);
+}
+
+TEST(PushResamplerPerformanceTest, 44kTo48kStereo) {
+  RunPushResamplerPerformanceTest(44100, 48000, 2);
+}
+
+TEST(PushResamplerPerformanceTest, 48kTo8kStereo) {
+  RunPushResamplerPerformanceTest(48000, 8000, 2);
+}
+
+}  // namespace webrtc
@@ -91,8 +91,11 @@
 #include <string.h>
 
 #include <limits>
+#include <map>
 
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/thread_annotations.h"
 #include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 #include "webrtc/typedefs.h"
 
@@ -116,25 +119,121 @@ double SincScaleFactor(double io_ratio) {
   return sinc_scale_factor;
 }
 
+// Process-wide cache of kernels, keyed by |sinc_scale_factor|.  PushResampler
+// and friends are created per stream, so without the cache every stream would
+// build (and hold) identical tables for its (source rate, destination rate)
+// pair.  Entries are only weakly referenced and are released together with the
+// last SincResampler using them.
+class KernelCache {
+ public:
+  static KernelCache* Instance() {
+    // Intentionally leaked; SincResamplers may outlive static destructors.
+    static KernelCache* const instance = new KernelCache();
+    return instance;
+  }
+
+  std::shared_ptr<const float> GetKernel(double sinc_scale_factor) {
+    rtc::CritScope lock(&crit_);
+    auto it = kernels_.find(sinc_scale_factor);
+    if (it != kernels_.end()) {
+      std::shared_ptr<const float> kernel = it->second.lock();
+      if (kernel)
+        return kernel;
+    }
+    // Drop kernels nobody uses anymore, e.g. after a series of SetRatio().
+    for (auto expired = kernels_.begin(); expired != kernels_.end();) {
+      if (expired->second.expired())
+        expired = kernels_.erase(expired);
+      else
+        ++expired;
+    }
+    std::shared_ptr<const float> kernel = CreateKernel(sinc_scale_factor);
+    kernels_[sinc_scale_factor] = kernel;
+    return kernel;
+  }
+
+ private:
+  KernelCache()
+      : kernel_pre_sinc_storage_(static_cast<float*>(AlignedMalloc(
+            sizeof(float) * SincResampler::kKernelStorageSize, 16))),
+        kernel_window_storage_(static_cast<float*>(AlignedMalloc(
+            sizeof(float) * SincResampler::kKernelStorageSize, 16))) {
+    // Blackman window parameters.
+    static const double kAlpha = 0.16;
+    static const double kA0 = 0.5 * (1.0 - kAlpha);
+    static const double kA1 = 0.5;
+    static const double kA2 = 0.5 * kAlpha;
+    const size_t kKernelSize = SincResampler::kKernelSize;
+    const size_t kKernelOffsetCount = SincResampler::kKernelOffsetCount;
+
+    // The pre-sinc and window values are independent of |sinc_scale_factor|
+    // and shared by all kernels.  We generate a range of sub-sample offsets
+    // from 0.0 to 1.0.
+    for (size_t offset_idx = 0; offset_idx <= kKernelOffsetCount;
+         ++offset_idx) {
+      const float subsample_offset =
+          static_cast<float>(offset_idx) / kKernelOffsetCount;
+
+      for (size_t i = 0; i < kKernelSize; ++i) {
+        const size_t idx = i + offset_idx * kKernelSize;
+        const float pre_sinc = static_cast<float>(M_PI *
+            (static_cast<int>(i) - static_cast<int>(kKernelSize / 2) -
+             subsample_offset));
+        kernel_pre_sinc_storage_[idx] = pre_sinc;
+
+        // Compute Blackman window, matching the offset of the sinc().
+        const float x = (i - subsample_offset) / kKernelSize;
+        const float window = static_cast<float>(kA0 -
+            kA1 * cos(2.0 * M_PI * x) + kA2 * cos(4.0 * M_PI * x));
+        kernel_window_storage_[idx] = window;
+      }
+    }
+  }
+
+  // Generates a set of windowed sinc() kernels.
+  std::shared_ptr<const float> CreateKernel(double sinc_scale_factor) const {
+    // Aligned to 32 bytes for AVX2; since kKernelSize is a multiple of 8 every
+    // kernel offset inside the storage is aligned as well.
+    float* kernel_storage = static_cast<float*>(
+        AlignedMalloc(sizeof(float) * SincResampler::kKernelStorageSize, 32));
+    for (size_t idx = 0; idx < SincResampler::kKernelStorageSize; ++idx) {
+      const float window = kernel_window_storage_[idx];
+      const float pre_sinc = kernel_pre_sinc_storage_[idx];
+
+      // Window the sinc() function with offset.
+      kernel_storage[idx] = static_cast<float>(window *
+          ((pre_sinc == 0) ?
+              sinc_scale_factor :
+              (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
+    }
+    return std::shared_ptr<const float>(kernel_storage, AlignedFreeDeleter());
+  }
+
+  const std::unique_ptr<float[], AlignedFreeDeleter> kernel_pre_sinc_storage_;
+  const std::unique_ptr<float[], AlignedFreeDeleter> kernel_window_storage_;
+  rtc::CriticalSection crit_;
+  std::map<double, std::weak_ptr<const float>> kernels_ GUARDED_BY(crit_);
+};
+
 }  // namespace
 
 const size_t SincResampler::kKernelSize;
 
 // If we know the minimum architecture at compile time, avoid CPU detection.
 #if defined(WEBRTC_ARCH_X86_FAMILY)
-#if defined(__SSE2__)
-#define CONVOLVE_FUNC Convolve_SSE
-void SincResampler::InitializeCPUSpecificFeatures() {}
-#else
 // x86 CPU detection required.  Function will be set by
-// InitializeCPUSpecificFeatures().
-// TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be removed.
+// InitializeCPUSpecificFeatures().  Even with an SSE2 baseline we look for
+// AVX2 at run time.
 #define CONVOLVE_FUNC convolve_proc_
 
 void SincResampler::InitializeCPUSpecificFeatures() {
-  convolve_proc_ = WebRtc_GetCPUInfo(kSSE2) ? Convolve_SSE : Convolve_C;
+  if (WebRtc_GetCPUInfo(kAVX2))
+    convolve_proc_ = Convolve_AVX2;
+  else if (WebRtc_GetCPUInfo(kSSE2))
+    convolve_proc_ = Convolve_SSE;
+  else
+    convolve_proc_ = Convolve_C;
 }
-#endif
 #elif defined(WEBRTC_HAS_NEON)
 #define CONVOLVE_FUNC Convolve_NEON
 void SincResampler::InitializeCPUSpecificFeatures() {}
@@ -151,36 +250,23 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
       read_cb_(read_cb),
       request_frames_(request_frames),
       input_buffer_size_(request_frames_ + kKernelSize),
+      kernel_storage_(KernelCache::Instance()->GetKernel(
+          SincScaleFactor(io_sample_rate_ratio_))),
       // Create input buffers with a 16-byte alignment for SSE optimizations.
-      kernel_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
-      kernel_pre_sinc_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
-      kernel_window_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
       input_buffer_(static_cast<float*>(
           AlignedMalloc(sizeof(float) * input_buffer_size_, 16))),
-#if defined(WEBRTC_CPU_DETECTION)
+#if defined(WEBRTC_ARCH_X86_FAMILY)
       convolve_proc_(nullptr),
 #endif
       r1_(input_buffer_.get()),
       r2_(input_buffer_.get() + kKernelSize / 2) {
-#if defined(WEBRTC_CPU_DETECTION)
+#if defined(WEBRTC_ARCH_X86_FAMILY)
   InitializeCPUSpecificFeatures();
   RTC_DCHECK(convolve_proc_);
 #endif
   RTC_DCHECK_GT(request_frames_, 0);
   Flush();
   RTC_DCHECK_GT(block_size_, kKernelSize);
-
-  memset(kernel_storage_.get(), 0,
-         sizeof(*kernel_storage_.get()) * kKernelStorageSize);
-  memset(kernel_pre_sinc_storage_.get(), 0,
-         sizeof(*kernel_pre_sinc_storage_.get()) * kKernelStorageSize);
-  memset(kernel_window_storage_.get(), 0,
-         sizeof(*kernel_window_storage_.get()) * kKernelStorageSize);
-
-  InitializeKernel();
 }
 
 SincResampler::~SincResampler() {}
@@ -201,43 +287,6 @@ void SincResampler::UpdateRegions(bool second_load) {
   RTC_DCHECK_LT(r2_, r3_);
 }
 
-void SincResampler::InitializeKernel() {
-  // Blackman window parameters.
-  static const double kAlpha = 0.16;
-  static const double kA0 = 0.5 * (1.0 - kAlpha);
-  static const double kA1 = 0.5;
-  static const double kA2 = 0.5 * kAlpha;
-
-  // Generates a set of windowed sinc() kernels.
-  // We generate a range of sub-sample offsets from 0.0 to 1.0.
-  const double sinc_scale_factor = SincScaleFactor(io_sample_rate_ratio_);
-  for (size_t offset_idx = 0; offset_idx <= kKernelOffsetCount; ++offset_idx) {
-    const float subsample_offset =
-        static_cast<float>(offset_idx) / kKernelOffsetCount;
-
-    for (size_t i = 0; i < kKernelSize; ++i) {
-      const size_t idx = i + offset_idx * kKernelSize;
-      const float pre_sinc = static_cast<float>(M_PI *
-          (static_cast<int>(i) - static_cast<int>(kKernelSize / 2) -
-           subsample_offset));
-      kernel_pre_sinc_storage_[idx] = pre_sinc;
-
-      // Compute Blackman window, matching the offset of the sinc().
-      const float x = (i - subsample_offset) / kKernelSize;
-      const float window = static_cast<float>(kA0 - kA1 * cos(2.0 * M_PI * x) +
-          kA2 * cos(4.0 * M_PI * x));
-      kernel_window_storage_[idx] = window;
-
-      // Compute the sinc with offset, then window the sinc() function and store
-      // at the correct offset.
-      kernel_storage_[idx] = static_cast<float>(window *
-          ((pre_sinc == 0) ?
-              sinc_scale_factor :
-              (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
-    }
-  }
-}
-
 void SincResampler::SetRatio(double io_sample_rate_ratio) {
   if (fabs(io_sample_rate_ratio_ - io_sample_rate_ratio) <
       std::numeric_limits<double>::epsilon()) {
@@ -246,21 +295,11 @@ void SincResampler::SetRatio(double io_sample_rate_ratio) {
 
   io_sample_rate_ratio_ = io_sample_rate_ratio;
 
-  // Optimize reinitialization by reusing values which are independent of
-  // |sinc_scale_factor|.  Provides a 3x speedup.
-  const double sinc_scale_factor = SincScaleFactor(io_sample_rate_ratio_);
-  for (size_t offset_idx = 0; offset_idx <= kKernelOffsetCount; ++offset_idx) {
-    for (size_t i = 0; i < kKernelSize; ++i) {
-      const size_t idx = i + offset_idx * kKernelSize;
-      const float window = kernel_window_storage_[idx];
-      const float pre_sinc = kernel_pre_sinc_storage_[idx];
-
-      kernel_storage_[idx] = static_cast<float>(window *
-          ((pre_sinc == 0) ?
-              sinc_scale_factor :
-              (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
-    }
-  }
+  // Construction reuses the values which are independent of
+  // |sinc_scale_factor|, and is skipped entirely if another SincResampler
+  // already uses the same kernels.
+  kernel_storage_ = KernelCache::Instance()->GetKernel(
+      SincScaleFactor(io_sample_rate_ratio_));
 }
 
 void SincResampler::Resample(size_t frames, float* destination) {
@@ -301,10 +340,10 @@ void SincResampler::Resample(size_t frames, float* destination) {
       const float* const k1 = kernel_ptr + offset_idx * kKernelSize;
       const float* const k2 = k1 + kKernelSize;
 
-      // Ensure |k1|, |k2| are 16-byte aligned for SIMD usage.  Should always be
-      // true so long as kKernelSize is a multiple of 16.
-      RTC_DCHECK_EQ(0, reinterpret_cast<uintptr_t>(k1) % 16);
-      RTC_DCHECK_EQ(0, reinterpret_cast<uintptr_t>(k2) % 16);
+      // Ensure |k1|, |k2| are 32-byte aligned for SIMD usage.  Should always be
+      // true so long as kKernelSize is a multiple of 32.
+      RTC_DCHECK_EQ(0, reinterpret_cast<uintptr_t>(k1) % 32);
+      RTC_DCHECK_EQ(0, reinterpret_cast<uintptr_t>(k2) % 32);
 
       // Initialize input pointer based on quantized |virtual_source_idx_|.
       const float* const input_ptr = r1_ + source_idx;
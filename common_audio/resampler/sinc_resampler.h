@@ -75,21 +75,21 @@ class SincResampler {
   // not call while Resample() is in progress.
   void Flush();
 
-  // Update |io_sample_rate_ratio_|.  SetRatio() will cause a reconstruction of
-  // the kernels used for resampling.  Not thread safe, do not call while
-  // Resample() is in progress.
+  // Update |io_sample_rate_ratio_|.  SetRatio() will switch to the kernels
+  // for the new ratio, constructing them if no other SincResampler uses them.
+  // Not thread safe, do not call while Resample() is in progress.
   //
   // TODO(ajm): Use this in PushSincResampler rather than reconstructing
   // SincResampler.  We would also need a way to update |request_frames_|.
   void SetRatio(double io_sample_rate_ratio);
 
-  float* get_kernel_for_testing() { return kernel_storage_.get(); }
+  const float* get_kernel_for_testing() const { return kernel_storage_.get(); }
 
  private:
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, Convolve);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveBenchmark);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, SharesKernels);
 
-  void InitializeKernel();
   void UpdateRegions(bool second_load);
 
   // Selects runtime specific CPU features like SSE.  Must be called before
@@ -107,6 +107,9 @@ class SincResampler {
   static float Convolve_SSE(const float* input_ptr, const float* k1,
                             const float* k2,
                             double kernel_interpolation_factor);
+  static float Convolve_AVX2(const float* input_ptr, const float* k1,
+                             const float* k2,
+                             double kernel_interpolation_factor);
 #elif defined(WEBRTC_HAS_NEON)
   static float Convolve_NEON(const float* input_ptr, const float* k1,
                              const float* k2,
@@ -137,10 +140,10 @@ class SincResampler {
 
   // Contains kKernelOffsetCount kernels back-to-back, each of size kKernelSize.
   // The kernel offsets are sub-sample shifts of a windowed sinc shifted from
-  // 0.0 to 1.0 sample.
-  std::unique_ptr<float[], AlignedFreeDeleter> kernel_storage_;
-  std::unique_ptr<float[], AlignedFreeDeleter> kernel_pre_sinc_storage_;
-  std::unique_ptr<float[], AlignedFreeDeleter> kernel_window_storage_;
+  // 0.0 to 1.0 sample.  The kernels only depend on the low-pass cutoff implied
+  // by |io_sample_rate_ratio_|; they are immutable and shared by all
+  // SincResamplers with the same cutoff.
+  std::shared_ptr<const float> kernel_storage_;
 
   // Data from the source is copied into this buffer for each processing pass.
   std::unique_ptr<float[], AlignedFreeDeleter> input_buffer_;
@@ -149,7 +152,7 @@ class SincResampler {
   // TODO(ajm): Move to using a global static which must only be initialized
   // once by the user. We're not doing this initially, because we don't have
   // e.g. a LazyInstance helper in webrtc.
-#if defined(WEBRTC_CPU_DETECTION)
+#if defined(WEBRTC_ARCH_X86_FAMILY)
   typedef float (*ConvolveProc)(const float*, const float*, const float*,
                                 double);
   ConvolveProc convolve_proc_;
@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/resampler/sinc_resampler.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+
+float SincResampler::Convolve_AVX2(const float* input_ptr, const float* k1,
+                                   const float* k2,
+                                   double kernel_interpolation_factor) {
+  __m256 m_input;
+  __m256 m_sums1 = _mm256_setzero_ps();
+  __m256 m_sums2 = _mm256_setzero_ps();
+
+  // The kernels are 32-byte aligned, |input_ptr| generally is not.  Unaligned
+  // loads of aligned data are as fast as aligned loads on AVX2 hardware.
+  for (size_t i = 0; i < kKernelSize; i += 8) {
+    m_input = _mm256_loadu_ps(input_ptr + i);
+    m_sums1 = _mm256_add_ps(m_sums1,
+                            _mm256_mul_ps(m_input, _mm256_load_ps(k1 + i)));
+    m_sums2 = _mm256_add_ps(m_sums2,
+                            _mm256_mul_ps(m_input, _mm256_load_ps(k2 + i)));
+  }
+
+  // Linearly interpolate the two "convolutions".
+  m_sums1 = _mm256_mul_ps(m_sums1, _mm256_set1_ps(
+      static_cast<float>(1.0 - kernel_interpolation_factor)));
+  m_sums2 = _mm256_mul_ps(m_sums2, _mm256_set1_ps(
+      static_cast<float>(kernel_interpolation_factor)));
+  m_sums1 = _mm256_add_ps(m_sums1, m_sums2);
+
+  // Sum components together.
+  __m128 m_sum = _mm_add_ps(_mm256_castps256_ps128(m_sums1),
+                            _mm256_extractf128_ps(m_sums1, 1));
+  m_sum = _mm_add_ps(_mm_movehl_ps(m_sum, m_sum), m_sum);
+  float result;
+  _mm_store_ss(&result, _mm_add_ss(m_sum, _mm_shuffle_ps(m_sum, m_sum, 1)));
+
+  // Avoid the AVX-SSE transition penalty in the (non-VEX encoded) caller.
+  _mm256_zeroupper();
+  return result;
+}
+
+}  // namespace webrtc
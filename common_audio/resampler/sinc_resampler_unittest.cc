@@ -161,9 +161,60 @@ TEST(SincResamplerTest, Convolve) {
       resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
       resampler.kernel_storage_.get(), kKernelInterpolationFactor);
   EXPECT_NEAR(result2, result, kEpsilon);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (!WebRtc_GetCPUInfo(kAVX2))
+    return;
+  // Test Convolve_AVX2() w/ aligned and unaligned input pointer.
+  for (size_t offset = 0; offset < 8; ++offset) {
+    result = resampler.Convolve_C(resampler.kernel_storage_.get() + offset,
+                                  resampler.kernel_storage_.get(),
+                                  resampler.kernel_storage_.get() + 8,
+                                  kKernelInterpolationFactor);
+    result2 = resampler.Convolve_AVX2(resampler.kernel_storage_.get() + offset,
+                                      resampler.kernel_storage_.get(),
+                                      resampler.kernel_storage_.get() + 8,
+                                      kKernelInterpolationFactor);
+    EXPECT_NEAR(result2, result, kEpsilon);
+  }
+#endif
 }
 #endif
 
+// Resamplers with the same low-pass cutoff use the same kernels.
+TEST(SincResamplerTest, SharesKernels) {
+  MockSource mock_source;
+  SincResampler resampler1(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                           &mock_source);
+  SincResampler resampler2(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                           &mock_source);
+  EXPECT_EQ(resampler1.get_kernel_for_testing(),
+            resampler2.get_kernel_for_testing());
+
+  // All upsampling ratios share one cutoff.
+  SincResampler upsampler1(8000.0 / 48000.0, SincResampler::kDefaultRequestSize,
+                           &mock_source);
+  SincResampler upsampler2(16000.0 / 44100.0,
+                           SincResampler::kDefaultRequestSize, &mock_source);
+  EXPECT_EQ(upsampler1.get_kernel_for_testing(),
+            upsampler2.get_kernel_for_testing());
+  EXPECT_NE(resampler1.get_kernel_for_testing(),
+            upsampler1.get_kernel_for_testing());
+
+  // Changing the ratio of one resampler leaves the other untouched.
+  const float* kernel = resampler1.get_kernel_for_testing();
+  std::unique_ptr<float[]> kernel_copy(
+      new float[SincResampler::kKernelStorageSize]);
+  memcpy(kernel_copy.get(), kernel,
+         sizeof(float) * SincResampler::kKernelStorageSize);
+  resampler2.SetRatio(8000.0 / 48000.0);
+  EXPECT_EQ(upsampler1.get_kernel_for_testing(),
+            resampler2.get_kernel_for_testing());
+  EXPECT_EQ(kernel, resampler1.get_kernel_for_testing());
+  EXPECT_EQ(0, memcmp(kernel_copy.get(), kernel,
+                      sizeof(float) * SincResampler::kKernelStorageSize));
+}
+
 // Benchmark for the various Convolve() methods.  Make sure to build with
 // branding=Chrome so that RTC_DCHECKs are compiled out when benchmarking.
 // Original benchmarks were run with --convolve-iterations=50000000.
@@ -226,6 +277,25 @@ TEST(SincResamplerTest, ConvolveBenchmark) {
          total_time_c_us / total_time_optimized_aligned_us,
          total_time_optimized_unaligned_us / total_time_optimized_aligned_us);
 #endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (!WebRtc_GetCPUInfo(kAVX2))
+    return;
+  // Benchmark Convolve_AVX2() with unaligned input pointer.
+  start = rtc::TimeNanos();
+  for (int j = 0; j < kConvolveIterations; ++j) {
+    resampler.Convolve_AVX2(
+        resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
+        resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+  }
+  double total_time_avx2_us =
+      (rtc::TimeNanos() - start) / rtc::kNumNanosecsPerMicrosec;
+  printf("Convolve_AVX2 (unaligned) took %.2fms; which is %.2fx faster than "
+         "Convolve_C and %.2fx faster than " STRINGIZE(CONVOLVE_FUNC)
+         " (unaligned).\n", total_time_avx2_us / 1000,
+         total_time_c_us / total_time_avx2_us,
+         total_time_optimized_unaligned_us / total_time_avx2_us);
+#endif
 }
 
 #undef CONVOLVE_FUNC
@@ -351,7 +421,7 @@ INSTANTIATE_TEST_CASE_P(
         std::tr1::make_tuple(16000, 44100, kResamplingRMSError, -62.54),
         std::tr1::make_tuple(22050, 44100, kResamplingRMSError, -73.53),
         std::tr1::make_tuple(32000, 44100, kResamplingRMSError, -63.32),
-        std::tr1::make_tuple(44100, 44100, kResamplingRMSError, -73.53),
+        std::tr1::make_tuple(44100, 44100, kResamplingRMSError, -73.52),
         std::tr1::make_tuple(48000, 44100, -15.01, -64.04),
         std::tr1::make_tuple(96000, 44100, -18.49, -25.51),
         std::tr1::make_tuple(192000, 44100, -20.50, -13.31),
@@ -17,8 +17,7 @@ size_t WebRtcSpl_AutoCorrelation(const int16_t* in_vector,
                                  size_t order,
                                  int32_t* result,
                                  int* scale) {
-  int32_t sum = 0;
-  size_t i = 0, j = 0;
+  size_t i = 0;
   int16_t smax = 0;
   int scaling = 0;
 
@@ -45,8 +44,18 @@ size_t WebRtcSpl_AutoCorrelation(const int16_t* in_vector,
   }
 
   // Perform the actual correlation calculation.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  // Lag |i| is a single cross-correlation of the |in_vector_length - i|
+  // overlapping samples. All x86 versions of WebRtcSpl_CrossCorrelation() are
+  // bit-exact with the C loop below, which is not the case for NEON.
   for (i = 0; i < order + 1; i++) {
-    sum = 0;
+    WebRtcSpl_CrossCorrelation(&result[i], in_vector, &in_vector[i],
+                               in_vector_length - i, 1, scaling, 0);
+  }
+#else
+  for (i = 0; i < order + 1; i++) {
+    int32_t sum = 0;
+    size_t j = 0;
     /* Unroll the loop to improve performance. */
     for (j = 0; i + j + 3 < in_vector_length; j += 4) {
       sum += (in_vector[j + 0] * in_vector[i + j + 0]) >> scaling;
@@ -57,8 +66,9 @@ size_t WebRtcSpl_AutoCorrelation(const int16_t* in_vector,
     for (; j < in_vector_length - i; j++) {
       sum += (in_vector[j] * in_vector[i + j]) >> scaling;
     }
-    *result++ = sum;
+    result[i] = sum;
   }
+#endif
 
   *scale = scaling;
   return order + 1;
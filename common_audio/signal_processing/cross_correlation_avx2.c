@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/common_audio/signal_processing/dot_product_with_scale.h"
+
+#include <immintrin.h>
+
+// Multiplies 16 pairs of int16_t samples into 32-bit products and applies
+// |shift| to each product individually, keeping the result bit-exact with the
+// C versions. The lane order of the products is not preserved, which does not
+// matter since they are only summed.
+static inline void ShiftedProductsAVX2(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       __m128i shift,
+                                       __m256i* products_low,
+                                       __m256i* products_high) {
+  const __m256i a = _mm256_loadu_si256((const __m256i*)vector1);
+  const __m256i b = _mm256_loadu_si256((const __m256i*)vector2);
+  const __m256i low = _mm256_mullo_epi16(a, b);
+  const __m256i high = _mm256_mulhi_epi16(a, b);
+  *products_low = _mm256_sra_epi32(_mm256_unpacklo_epi16(low, high), shift);
+  *products_high = _mm256_sra_epi32(_mm256_unpackhi_epi16(low, high), shift);
+}
+
+static inline int32_t HorizontalSumAVX2(__m256i sum) {
+  __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                                 _mm256_extracti128_si256(sum, 1));
+  sum128 = _mm_add_epi32(sum128,
+                         _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum128 = _mm_add_epi32(sum128,
+                         _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum128);
+}
+
+static inline int32_t DotProductWithShiftAVX2(const int16_t* vector1,
+                                              const int16_t* vector2,
+                                              size_t length,
+                                              int right_shifts) {
+  const __m128i shift = _mm_cvtsi32_si128(right_shifts);
+  __m256i sum = _mm256_setzero_si256();
+  size_t i = 0;
+  int32_t corr = 0;
+
+  // The 32-bit lanes wrap around exactly like the int32_t accumulator of the
+  // C version, so the final result is identical.
+  for (; i + 16 <= length; i += 16) {
+    __m256i products_low, products_high;
+    ShiftedProductsAVX2(&vector1[i], &vector2[i], shift, &products_low,
+                        &products_high);
+    sum = _mm256_add_epi32(sum, _mm256_add_epi32(products_low, products_high));
+  }
+  corr = HorizontalSumAVX2(sum);
+  for (; i < length; i++) {
+    corr += (vector1[i] * vector2[i]) >> right_shifts;
+  }
+  return corr;
+}
+
+/* AVX2 version of WebRtcSpl_CrossCorrelation() for x86 platforms. */
+void WebRtcSpl_CrossCorrelationAVX2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2) {
+  size_t i = 0;
+
+  for (i = 0; i < dim_cross_correlation; i++) {
+    *cross_correlation++ =
+        DotProductWithShiftAVX2(seq1, seq2, dim_seq, right_shifts);
+    seq2 += step_seq2;
+  }
+  _mm256_zeroupper();
+}
+
+/* AVX2 version of WebRtcSpl_DotProductWithScale() for x86 platforms. */
+int32_t WebRtcSpl_DotProductWithScaleAVX2(const int16_t* vector1,
+                                          const int16_t* vector2,
+                                          size_t length,
+                                          int scaling) {
+  const __m128i shift = _mm_cvtsi32_si128(scaling);
+  __m256i sum = _mm256_setzero_si256();
+  size_t i = 0;
+  int64_t sums[4];
+  int64_t result = 0;
+
+  // Products are sign extended to 64 bits before accumulation, matching the
+  // int64_t sum of the C version.
+  for (; i + 16 <= length; i += 16) {
+    __m256i products_low, products_high;
+    ShiftedProductsAVX2(&vector1[i], &vector2[i], shift, &products_low,
+                        &products_high);
+    sum = _mm256_add_epi64(
+        sum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(products_low)));
+    sum = _mm256_add_epi64(
+        sum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(products_low, 1)));
+    sum = _mm256_add_epi64(
+        sum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(products_high)));
+    sum = _mm256_add_epi64(
+        sum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(products_high, 1)));
+  }
+  _mm256_storeu_si256((__m256i*)sums, sum);
+  _mm256_zeroupper();
+  result = sums[0] + sums[1] + sums[2] + sums[3];
+  for (; i < length; i++) {
+    result += (vector1[i] * vector2[i]) >> scaling;
+  }
+
+  if (result > WEBRTC_SPL_WORD32_MAX) {
+    return WEBRTC_SPL_WORD32_MAX;
+  }
+  if (result < WEBRTC_SPL_WORD32_MIN) {
+    return WEBRTC_SPL_WORD32_MIN;
+  }
+  return (int32_t)result;
+}
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/common_audio/signal_processing/dot_product_with_scale.h"
+
+#include <emmintrin.h>
+
+// Multiplies eight pairs of int16_t samples into 32-bit products and applies
+// |shift| to each product individually, which is what makes the result
+// bit-exact with the C versions.
+static inline void ShiftedProductsSSE2(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       __m128i shift,
+                                       __m128i* products_low,
+                                       __m128i* products_high) {
+  const __m128i a = _mm_loadu_si128((const __m128i*)vector1);
+  const __m128i b = _mm_loadu_si128((const __m128i*)vector2);
+  const __m128i low = _mm_mullo_epi16(a, b);
+  const __m128i high = _mm_mulhi_epi16(a, b);
+  *products_low = _mm_sra_epi32(_mm_unpacklo_epi16(low, high), shift);
+  *products_high = _mm_sra_epi32(_mm_unpackhi_epi16(low, high), shift);
+}
+
+static inline int32_t HorizontalSumSSE2(__m128i sum) {
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+}
+
+static inline int32_t DotProductWithShiftSSE2(const int16_t* vector1,
+                                              const int16_t* vector2,
+                                              size_t length,
+                                              int right_shifts) {
+  const __m128i shift = _mm_cvtsi32_si128(right_shifts);
+  __m128i sum = _mm_setzero_si128();
+  size_t i = 0;
+  int32_t corr = 0;
+
+  // The 32-bit lanes wrap around exactly like the int32_t accumulator of the
+  // C version, so the final result is identical.
+  for (; i + 8 <= length; i += 8) {
+    __m128i products_low, products_high;
+    ShiftedProductsSSE2(&vector1[i], &vector2[i], shift, &products_low,
+                        &products_high);
+    sum = _mm_add_epi32(sum, _mm_add_epi32(products_low, products_high));
+  }
+  corr = HorizontalSumSSE2(sum);
+  for (; i < length; i++) {
+    corr += (vector1[i] * vector2[i]) >> right_shifts;
+  }
+  return corr;
+}
+
+/* SSE2 version of WebRtcSpl_CrossCorrelation() for x86 platforms. */
+void WebRtcSpl_CrossCorrelationSSE2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2) {
+  size_t i = 0;
+
+  for (i = 0; i < dim_cross_correlation; i++) {
+    *cross_correlation++ =
+        DotProductWithShiftSSE2(seq1, seq2, dim_seq, right_shifts);
+    seq2 += step_seq2;
+  }
+}
+
+/* SSE2 version of WebRtcSpl_DotProductWithScale() for x86 platforms. */
+int32_t WebRtcSpl_DotProductWithScaleSSE2(const int16_t* vector1,
+                                          const int16_t* vector2,
+                                          size_t length,
+                                          int scaling) {
+  const __m128i shift = _mm_cvtsi32_si128(scaling);
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sum = _mm_setzero_si128();
+  size_t i = 0;
+  int64_t sums[2];
+  int64_t result = 0;
+
+  // Products are sign extended to 64 bits before accumulation, matching the
+  // int64_t sum of the C version.
+  for (; i + 8 <= length; i += 8) {
+    __m128i products_low, products_high;
+    ShiftedProductsSSE2(&vector1[i], &vector2[i], shift, &products_low,
+                        &products_high);
+    const __m128i sign_low = _mm_cmpgt_epi32(zero, products_low);
+    const __m128i sign_high = _mm_cmpgt_epi32(zero, products_high);
+    sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(products_low, sign_low));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(products_low, sign_low));
+    sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(products_high, sign_high));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(products_high, sign_high));
+  }
+  _mm_storeu_si128((__m128i*)sums, sum);
+  result = sums[0] + sums[1];
+  for (; i < length; i++) {
+    result += (vector1[i] * vector2[i]) >> scaling;
+  }
+
+  if (result > WEBRTC_SPL_WORD32_MAX) {
+    return WEBRTC_SPL_WORD32_MAX;
+  }
+  if (result < WEBRTC_SPL_WORD32_MIN) {
+    return WEBRTC_SPL_WORD32_MIN;
+  }
+  return (int32_t)result;
+}
@@ -11,11 +11,42 @@
 #include "webrtc/common_audio/signal_processing/dot_product_with_scale.h"
 
 #include "webrtc/rtc_base/safe_conversions.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+namespace {
+
+typedef int32_t (*DotProductWithScaleProc)(const int16_t* vector1,
+                                           const int16_t* vector2,
+                                           size_t length,
+                                           int scaling);
+
+DotProductWithScaleProc SelectDotProductWithScale() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    return WebRtcSpl_DotProductWithScaleAVX2;
+  }
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    return WebRtcSpl_DotProductWithScaleSSE2;
+  }
+#endif
+  return WebRtcSpl_DotProductWithScaleC;
+}
+
+}  // namespace
 
 int32_t WebRtcSpl_DotProductWithScale(const int16_t* vector1,
                                       const int16_t* vector2,
                                       size_t length,
                                       int scaling) {
+  static const DotProductWithScaleProc dot_product_proc =
+      SelectDotProductWithScale();
+  return dot_product_proc(vector1, vector2, length, scaling);
+}
+
+int32_t WebRtcSpl_DotProductWithScaleC(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       size_t length,
+                                       int scaling) {
   int64_t sum = 0;
   size_t i = 0;
 
@@ -30,11 +30,29 @@ extern "C" {
 //                        output will be in Q(-|scaling|)
 //
 // Return value         : The dot product in Q(-scaling)
+//
+// On x86 the SSE2 or AVX2 version is selected at runtime; all versions are
+// bit-exact.
 int32_t WebRtcSpl_DotProductWithScale(const int16_t* vector1,
                                       const int16_t* vector2,
                                       size_t length,
                                       int scaling);
 
+int32_t WebRtcSpl_DotProductWithScaleC(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       size_t length,
+                                       int scaling);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_DotProductWithScaleSSE2(const int16_t* vector1,
+                                          const int16_t* vector2,
+                                          size_t length,
+                                          int scaling);
+int32_t WebRtcSpl_DotProductWithScaleAVX2(const int16_t* vector1,
+                                          const int16_t* vector2,
+                                          size_t length,
+                                          int scaling);
+#endif
+
 #ifdef __cplusplus
 }
 #endif  // __cplusplus
@@ -12,6 +12,8 @@
 #include <sstream>
 
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 #include "webrtc/test/gtest.h"
 
 static const size_t kVector16Size = 9;
@@ -477,7 +479,7 @@ TEST_F(SplTest, CrossCorrelationTest) {
   const int32_t kExpected[kCrossCorrelationDimension] =
       {-266947903, -15579555, -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if defined(WEBRTC_HAS_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] =
       {-266947901, -15579553, -171281999};
   if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
@@ -489,6 +491,106 @@ TEST_F(SplTest, CrossCorrelationTest) {
   }
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+namespace {
+
+void FillRandom(webrtc::Random* random, int16_t* vector, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    vector[i] = random->Rand<int16_t>();
+  }
+}
+
+}  // namespace
+
+// The x86 versions must be bit-exact with the C versions, since NetEq and the
+// codecs rely on reproducible output.
+TEST_F(SplTest, CrossCorrelationX86BitExactTest) {
+  const size_t kMaxLength = 300;
+  const size_t kDimension = 20;
+  int16_t seq1[kMaxLength];
+  int16_t seq2[kMaxLength + 2 * kDimension];
+  int32_t expected[kDimension];
+  int32_t actual[kDimension];
+  webrtc::Random random(42);
+  FillRandom(&random, seq1, kMaxLength);
+  FillRandom(&random, seq2, kMaxLength + 2 * kDimension);
+  const bool has_avx2 = WebRtc_GetCPUInfo(kAVX2) != 0;
+
+  for (size_t length = 1; length <= kMaxLength; length += 7) {
+    for (int shift = 0; shift <= 16; shift += 4) {
+      for (int step = -1; step <= 1; step += 2) {
+        const int16_t* seq2_start = step < 0 ? &seq2[kDimension] : seq2;
+        WebRtcSpl_CrossCorrelationC(expected, seq1, seq2_start, length,
+                                    kDimension, shift, step);
+        WebRtcSpl_CrossCorrelationSSE2(actual, seq1, seq2_start, length,
+                                       kDimension, shift, step);
+        for (size_t i = 0; i < kDimension; ++i) {
+          EXPECT_EQ(expected[i], actual[i]);
+        }
+        if (has_avx2) {
+          WebRtcSpl_CrossCorrelationAVX2(actual, seq1, seq2_start, length,
+                                         kDimension, shift, step);
+          for (size_t i = 0; i < kDimension; ++i) {
+            EXPECT_EQ(expected[i], actual[i]);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_F(SplTest, DotProductWithScaleX86BitExactTest) {
+  const size_t kMaxLength = 300;
+  int16_t vector1[kMaxLength];
+  int16_t vector2[kMaxLength];
+  webrtc::Random random(17);
+  FillRandom(&random, vector1, kMaxLength);
+  FillRandom(&random, vector2, kMaxLength);
+  const bool has_avx2 = WebRtc_GetCPUInfo(kAVX2) != 0;
+
+  for (size_t length = 0; length <= kMaxLength; length += 5) {
+    // A scaling of 0 saturates the result for the longer vectors.
+    for (int scaling = 0; scaling <= 12; scaling += 3) {
+      const int32_t expected =
+          WebRtcSpl_DotProductWithScaleC(vector1, vector2, length, scaling);
+      EXPECT_EQ(expected, WebRtcSpl_DotProductWithScaleSSE2(vector1, vector2,
+                                                            length, scaling));
+      if (has_avx2) {
+        EXPECT_EQ(expected, WebRtcSpl_DotProductWithScaleAVX2(
+                                vector1, vector2, length, scaling));
+      }
+    }
+  }
+}
+
+TEST_F(SplTest, ScaleAndAddVectorsWithRoundX86BitExactTest) {
+  const size_t kMaxLength = 100;
+  int16_t vector1[kMaxLength];
+  int16_t vector2[kMaxLength];
+  int16_t expected[kMaxLength];
+  int16_t actual[kMaxLength];
+  webrtc::Random random(4711);
+  FillRandom(&random, vector1, kMaxLength);
+  FillRandom(&random, vector2, kMaxLength);
+
+  for (size_t length = 1; length <= kMaxLength; length += 3) {
+    for (int shift = 0; shift <= 15; shift += 5) {
+      const int16_t scale1 = random.Rand<int16_t>();
+      const int16_t scale2 = random.Rand<int16_t>();
+      EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRoundC(
+                       vector1, scale1, vector2, scale2, shift, expected,
+                       length));
+      EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(
+                       vector1, scale1, vector2, scale2, shift, actual,
+                       length));
+      for (size_t i = 0; i < length; ++i) {
+        EXPECT_EQ(expected[i], actual[i]);
+      }
+    }
+  }
+}
+#endif  // WEBRTC_ARCH_X86_FAMILY
+
 TEST_F(SplTest, AutoCorrelationTest) {
   int scale = 0;
   int32_t vector32[kVector16Size];
@@ -9,7 +9,7 @@
  */
 
 /* The global function contained in this file initializes SPL function
- * pointers, currently only for ARM platforms.
+ * pointers, currently for ARM, MIPS and x86 platforms.
  *
  * Some code came from common/rtcd.c in the WebM project.
  */
@@ -44,6 +44,22 @@ static void InitPointersToC() {
 }
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+/* Override the generic C pointers with the SSE2 or AVX2 versions, depending
+ * on what the CPU supports. All of them are bit-exact with the C versions.
+ */
+static void InitPointersToX86() {
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationSSE2;
+    WebRtcSpl_ScaleAndAddVectorsWithRound =
+        WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2;
+  }
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationAVX2;
+  }
+}
+#endif
+
 #if defined(WEBRTC_HAS_NEON)
 /* Initialize function pointers to the Neon version. */
 static void InitPointersToNeon() {
@@ -89,6 +105,9 @@ static void InitFunctionPointers(void) {
   InitPointersToMIPS();
 #else
   InitPointersToC();
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  InitPointersToX86();
+#endif
 #endif  /* WEBRTC_HAS_NEON */
 }
 
@@ -88,6 +88,7 @@ VideoCodec::VideoCodec()
       mode(kRealtimeVideo),
       expect_encode_from_texture(false),
       timing_frame_thresholds({0, 0}),
+      decoder_threading({VideoDecoderThreading::kNone, 0, 0}),
       codec_specific_() {}
 
 VideoCodecVP8* VideoCodec::VP8() {
@@ -171,6 +172,17 @@ rtc::Optional<VideoCodecType> PayloadNameToCodecType(const std::string& name) {
   return rtc::Optional<VideoCodecType>();
 }
 
+int GetDecoderThreadCount(const VideoDecoderThreadingSettings& settings,
+                          int number_of_cores) {
+  if (settings.mode == VideoDecoderThreading::kNone)
+    return 1;
+  int num_threads =
+      settings.max_threads > 0 ? settings.max_threads : number_of_cores;
+  if (settings.mode == VideoDecoderThreading::kFrame)
+    num_threads = std::min(num_threads, settings.max_latency_frames + 1);
+  return std::max(num_threads, 1);
+}
+
 const uint32_t BitrateAllocation::kMaxBitrateBps =
     std::numeric_limits<uint32_t>::max();
 
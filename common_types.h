@@ -580,6 +580,29 @@ struct SpatialLayer {
 
 enum VideoCodecMode { kRealtimeVideo, kScreensharing };
 
+// How a decoder may spread its work over several threads. Slice threading
+// decodes independent parts of one frame (slices, partitions, tiles or rows)
+// in parallel and adds no delay. Frame threading decodes consecutive frames in
+// parallel; each extra thread delays the decoded output by one frame.
+// Decoders that do not support frame threading fall back to slice threading.
+enum class VideoDecoderThreading { kNone, kSlice, kFrame };
+
+struct VideoDecoderThreadingSettings {
+  VideoDecoderThreading mode;
+  // Upper bound on the number of decoder threads. If 0, the number of cores
+  // passed to InitDecode() is used.
+  int max_threads;
+  // Number of frames the decoded output may lag behind the input. Only
+  // limits frame threading, where it caps the thread count at
+  // |max_latency_frames + 1|.
+  int max_latency_frames;
+};
+
+// Returns the number of threads a decoder should use for |settings|, given
+// |number_of_cores| cores. Always at least 1.
+int GetDecoderThreadCount(const VideoDecoderThreadingSettings& settings,
+                          int number_of_cores);
+
 // Common video codec properties
 class VideoCodec {
  public:
@@ -621,6 +644,9 @@ class VideoCodec {
     uint16_t outlier_ratio_percent;
   } timing_frame_thresholds;
 
+  // Only used by decoders. Defaults to single threaded decoding.
+  VideoDecoderThreadingSettings decoder_threading;
+
   bool operator==(const VideoCodec& other) const = delete;
   bool operator!=(const VideoCodec& other) const = delete;
 
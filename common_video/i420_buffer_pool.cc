@@ -10,14 +10,54 @@
 
 #include "webrtc/common_video/include/i420_buffer_pool.h"
 
+#include <utility>
+
 #include "webrtc/rtc_base/checks.h"
 
 namespace webrtc {
 
+class I420BufferPool::MemoryPoolI420Buffer : public I420Buffer {
+ protected:
+  MemoryPoolI420Buffer(int width,
+                       int height,
+                       int stride_y,
+                       int stride_u,
+                       int stride_v,
+                       VideoBufferMemoryPool* memory_pool,
+                       std::unique_ptr<uint8_t, AlignedFreeDeleter> data,
+                       size_t capacity)
+      : I420Buffer(width, height, stride_y, stride_u, stride_v,
+                   std::move(data)),
+        memory_pool_(memory_pool),
+        capacity_(capacity) {}
+
+  ~MemoryPoolI420Buffer() override {
+    // May run on any thread; the memory pool is thread safe.
+    memory_pool_->Recycle(ReleaseData(), capacity_);
+  }
+
+ private:
+  const rtc::scoped_refptr<VideoBufferMemoryPool> memory_pool_;
+  const size_t capacity_;
+};
+
 I420BufferPool::I420BufferPool(bool zero_initialize,
                                size_t max_number_of_buffers)
-    : zero_initialize_(zero_initialize),
-      max_number_of_buffers_(max_number_of_buffers) {}
+    : I420BufferPool(zero_initialize,
+                     max_number_of_buffers,
+                     VideoBufferMemoryPool::Default()) {}
+
+I420BufferPool::I420BufferPool(
+    bool zero_initialize,
+    size_t max_number_of_buffers,
+    rtc::scoped_refptr<VideoBufferMemoryPool> memory_pool)
+    : memory_pool_(std::move(memory_pool)),
+      zero_initialize_(zero_initialize),
+      max_number_of_buffers_(max_number_of_buffers) {
+  RTC_DCHECK(memory_pool_);
+}
+
+I420BufferPool::~I420BufferPool() = default;
 
 void I420BufferPool::Release() {
   buffers_.clear();
@@ -25,10 +65,20 @@ void I420BufferPool::Release() {
 
 rtc::scoped_refptr<I420Buffer> I420BufferPool::CreateBuffer(int width,
                                                             int height) {
+  return CreateBuffer(width, height, width, (width + 1) / 2, (width + 1) / 2);
+}
+
+rtc::scoped_refptr<I420Buffer> I420BufferPool::CreateBuffer(int width,
+                                                            int height,
+                                                            int stride_y,
+                                                            int stride_u,
+                                                            int stride_v) {
   RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
-  // Release buffers with wrong resolution.
+  // Release buffers with wrong resolution or strides.
   for (auto it = buffers_.begin(); it != buffers_.end();) {
-    if ((*it)->width() != width || (*it)->height() != height)
+    if ((*it)->width() != width || (*it)->height() != height ||
+        (*it)->StrideY() != stride_y || (*it)->StrideU() != stride_u ||
+        (*it)->StrideV() != stride_v)
       it = buffers_.erase(it);
     else
       ++it;
@@ -46,8 +96,15 @@ rtc::scoped_refptr<I420Buffer> I420BufferPool::CreateBuffer(int width,
   if (buffers_.size() >= max_number_of_buffers_)
     return nullptr;
   // Allocate new buffer.
+  const size_t size = static_cast<size_t>(stride_y) * height +
+                      static_cast<size_t>(stride_u + stride_v) *
+                          ((height + 1) / 2);
+  size_t capacity = 0;
+  std::unique_ptr<uint8_t, AlignedFreeDeleter> data =
+      memory_pool_->Allocate(size, &capacity);
   rtc::scoped_refptr<PooledI420Buffer> buffer =
-      new PooledI420Buffer(width, height);
+      new PooledI420Buffer(width, height, stride_y, stride_u, stride_v,
+                           memory_pool_.get(), std::move(data), capacity);
   if (zero_initialize_)
     buffer->InitializeData();
   buffers_.push_back(buffer);
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <deque>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/common_video/include/i420_buffer_pool.h"
+#include "webrtc/common_video/include/video_buffer_memory_pool.h"
+#include "webrtc/rtc_base/arraysize.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumStreams = 8;
+// Buffers each stream keeps alive, e.g. queued for rendering or encoding.
+const size_t kFramesInFlight = 3;
+// Streams change resolution this often, as with quality scaling or simulcast
+// layer switches.
+const int kFramesPerResolution = 10;
+const struct {
+  int width;
+  int height;
+} kResolutions[] = {{1280, 720}, {960, 540}, {640, 360}, {1280, 704},
+                    {960, 544},  {640, 352}, {320, 180}};
+
+// Each stream gets buffers from its own I420BufferPool and switches
+// resolution every |kFramesPerResolution| frames, so the pools keep purging
+// their buffers. Reports the time per CreateBuffer() call, and how many of the
+// allocations were served by |memory_pool|.
+void RunResolutionSwitchingTest(size_t max_cached_bytes,
+                                const std::string& label) {
+  const int num_frames =
+      field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 100 : 3000;
+  rtc::scoped_refptr<VideoBufferMemoryPool> memory_pool =
+      VideoBufferMemoryPool::Create(max_cached_bytes);
+  std::vector<std::unique_ptr<I420BufferPool>> pools;
+  std::vector<std::deque<rtc::scoped_refptr<I420Buffer>>> in_flight(
+      kNumStreams);
+  for (int i = 0; i < kNumStreams; ++i) {
+    pools.emplace_back(new I420BufferPool(
+        false, std::numeric_limits<size_t>::max(), memory_pool));
+  }
+
+  int64_t total_time_us = 0;
+  for (int frame = 0; frame < num_frames; ++frame) {
+    for (int i = 0; i < kNumStreams; ++i) {
+      // Offset the streams so that they do not switch in lockstep.
+      const size_t index = static_cast<size_t>(
+          (frame / kFramesPerResolution + i) % arraysize(kResolutions));
+      const int64_t start_time_us = rtc::TimeMicros();
+      rtc::scoped_refptr<I420Buffer> buffer = pools[i]->CreateBuffer(
+          kResolutions[index].width, kResolutions[index].height);
+      total_time_us += rtc::TimeMicros() - start_time_us;
+      ASSERT_TRUE(buffer);
+      // Touch the planes like a producer would.
+      memset(buffer->MutableDataY(), frame & 0xff, buffer->StrideY());
+      memset(buffer->MutableDataU(), 0x80, buffer->StrideU());
+      memset(buffer->MutableDataV(), 0x80, buffer->StrideV());
+      in_flight[i].push_back(buffer);
+      if (in_flight[i].size() > kFramesInFlight)
+        in_flight[i].pop_front();
+    }
+  }
+  in_flight.clear();
+  pools.clear();
+
+  const VideoBufferMemoryPool::Stats stats = memory_pool->GetStats();
+  const int64_t num_allocations = stats.hits + stats.misses;
+  ASSERT_GT(num_allocations, 0);
+  test::PrintResult("i420_buffer_pool_create_time", "", label,
+                    std::to_string(static_cast<double>(total_time_us) /
+                                   (num_frames * kNumStreams)),
+                    "us", true);
+  test::PrintResult(
+      "i420_buffer_pool_memory_hit_rate", "", label,
+      std::to_string(100.0 * stats.hits / num_allocations), "%", false);
+  test::PrintResult("i420_buffer_pool_allocations", "", label,
+                    std::to_string(stats.misses), "count", false);
+}
+
+}  // namespace
+
+TEST(I420BufferPoolPerformanceTest, ResolutionSwitchingWithoutMemoryPool) {
+  RunResolutionSwitchingTest(0, "no_memory_pool");
+}
+
+TEST(I420BufferPoolPerformanceTest, ResolutionSwitchingWithMemoryPool) {
+  RunResolutionSwitchingTest(VideoBufferMemoryPool::kDefaultMaxCachedBytes,
+                             "memory_pool");
+}
+
+}  // namespace webrtc
@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <limits>
 #include <string>
 
 #include "webrtc/common_video/include/i420_buffer_pool.h"
@@ -51,6 +52,25 @@ TEST(TestI420BufferPool, FailToReuse) {
   EXPECT_NE(v_ptr, buffer->DataV());
 }
 
+TEST(TestI420BufferPool, ReusesOnlyBuffersWithSameStrides) {
+  I420BufferPool pool;
+  rtc::scoped_refptr<I420Buffer> buffer = pool.CreateBuffer(20, 16, 32, 16, 16);
+  EXPECT_EQ(20, buffer->width());
+  EXPECT_EQ(32, buffer->StrideY());
+  EXPECT_EQ(16, buffer->StrideU());
+  EXPECT_EQ(16, buffer->StrideV());
+  const uint8_t* y_ptr = buffer->DataY();
+  buffer = nullptr;
+  buffer = pool.CreateBuffer(20, 16, 32, 16, 16);
+  EXPECT_EQ(y_ptr, buffer->DataY());
+  buffer = nullptr;
+  // The default strides differ, so the buffer is not reused.
+  buffer = pool.CreateBuffer(20, 16);
+  EXPECT_EQ(20, buffer->StrideY());
+  EXPECT_EQ(10, buffer->StrideU());
+  EXPECT_EQ(10, buffer->StrideV());
+}
+
 TEST(TestI420BufferPool, FrameValidAfterPoolDestruction) {
   rtc::scoped_refptr<I420Buffer> buffer;
   {
@@ -63,6 +83,32 @@ TEST(TestI420BufferPool, FrameValidAfterPoolDestruction) {
   memset(buffer->MutableDataY(), 0xA5, 16 * buffer->StrideY());
 }
 
+TEST(TestI420BufferPool, ReusesMemoryAfterResolutionChange) {
+  rtc::scoped_refptr<VideoBufferMemoryPool> memory_pool =
+      VideoBufferMemoryPool::Create(1 << 20);
+  I420BufferPool pool(false, std::numeric_limits<size_t>::max(), memory_pool);
+  rtc::scoped_refptr<I420Buffer> buffer = pool.CreateBuffer(320, 240);
+  const uint8_t* y_ptr = buffer->DataY();
+  buffer = nullptr;
+  // Purges the 320x240 buffer, whose memory is reused for 336x240 since they
+  // are in the same size class.
+  buffer = pool.CreateBuffer(336, 240);
+  EXPECT_EQ(y_ptr, buffer->DataY());
+  EXPECT_EQ(1, memory_pool->GetStats().hits);
+
+  // Memory is shared between pools, and returned when the buffer is destroyed
+  // after its pool.
+  {
+    I420BufferPool other_pool(false, std::numeric_limits<size_t>::max(),
+                              memory_pool);
+    buffer = other_pool.CreateBuffer(320, 240);
+  }
+  EXPECT_NE(0u, memory_pool->GetStats().in_use_bytes);
+  buffer = nullptr;
+  pool.Release();
+  EXPECT_EQ(0u, memory_pool->GetStats().in_use_bytes);
+}
+
 TEST(TestI420BufferPool, MaxNumberOfBuffers) {
   I420BufferPool pool(false, 1);
   rtc::scoped_refptr<I420BufferInterface> buffer1 = pool.CreateBuffer(16, 16);
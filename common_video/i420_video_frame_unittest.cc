@@ -12,6 +12,7 @@
 #include <string.h>
 
 #include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/api/video/nv12_buffer.h"
 #include "webrtc/api/video/video_frame.h"
 #include "webrtc/rtc_base/bind.h"
 #include "webrtc/rtc_base/timeutils.h"
@@ -46,6 +47,21 @@ rtc::scoped_refptr<I420Buffer> CreateGradient(int width, int height) {
   return buffer;
 }
 
+rtc::scoped_refptr<NV12Buffer> CreateNV12Gradient(int width, int height) {
+  rtc::scoped_refptr<I420Buffer> i420_buffer = CreateGradient(width, height);
+  rtc::scoped_refptr<NV12Buffer> buffer(NV12Buffer::Create(width, height));
+  memcpy(buffer->MutableDataY(), i420_buffer->DataY(), width * height);
+  for (int y = 0; y < buffer->ChromaHeight(); y++) {
+    for (int x = 0; x < buffer->ChromaWidth(); x++) {
+      buffer->MutableDataUV()[2 * x + y * buffer->StrideUV()] =
+          i420_buffer->DataU()[x + y * i420_buffer->StrideU()];
+      buffer->MutableDataUV()[2 * x + 1 + y * buffer->StrideUV()] =
+          i420_buffer->DataV()[x + y * i420_buffer->StrideV()];
+    }
+  }
+  return buffer;
+}
+
 // The offsets and sizes describe the rectangle extracted from the
 // original (gradient) frame, in relative coordinates where the
 // original frame correspond to the unit square, 0.0 <= x, y < 1.0.
@@ -186,6 +202,28 @@ TEST(TestVideoFrame, ShallowCopy) {
   EXPECT_NE(frame2.rotation(), frame1.rotation());
 }
 
+TEST(TestVideoFrame, UpdateRects) {
+  VideoFrame frame1(I420Buffer::Create(64, 48), kVideoRotation_0, 0);
+  EXPECT_FALSE(frame1.has_update_rects());
+
+  frame1.set_update_rects({{16, 8, 4, 2}});
+  VideoFrame frame2(frame1);
+  ASSERT_TRUE(frame2.has_update_rects());
+  ASSERT_EQ(1u, frame2.update_rects().size());
+  EXPECT_EQ(16, frame2.update_rects()[0].offset_x);
+  EXPECT_EQ(8, frame2.update_rects()[0].offset_y);
+  EXPECT_EQ(4, frame2.update_rects()[0].width);
+  EXPECT_EQ(2, frame2.update_rects()[0].height);
+
+  // No rects means nothing changed, unlike no update rects at all.
+  frame2.set_update_rects({});
+  EXPECT_TRUE(frame2.has_update_rects());
+  EXPECT_TRUE(frame2.update_rects().empty());
+  frame2.clear_update_rects();
+  EXPECT_FALSE(frame2.has_update_rects());
+  EXPECT_TRUE(frame1.has_update_rects());
+}
+
 TEST(TestVideoFrame, TextureInitialValues) {
   VideoFrame frame = test::FakeNativeBuffer::CreateFrame(
       640, 480, 100, 10, webrtc::kVideoRotation_0);
@@ -279,6 +317,50 @@ TEST(TestI420FrameBuffer, CropAndScale16x9) {
   CheckCrop(*scaled_buffer, 0.0, 0.125, 1.0, 0.75);
 }
 
+TEST(TestNV12FrameBuffer, ToI420) {
+  rtc::scoped_refptr<NV12Buffer> buf = CreateNV12Gradient(200, 100);
+  const int num_conversions = NV12BufferInterface::NumI420Conversions();
+  rtc::scoped_refptr<I420BufferInterface> i420_buffer = buf->ToI420();
+  EXPECT_EQ(num_conversions + 1, NV12BufferInterface::NumI420Conversions());
+  EXPECT_TRUE(test::FrameBufsEqual(CreateGradient(200, 100), i420_buffer));
+}
+
+TEST(TestNV12FrameBuffer, Copy) {
+  rtc::scoped_refptr<NV12Buffer> buf1 = CreateNV12Gradient(20, 10);
+  rtc::scoped_refptr<NV12Buffer> buf2 = NV12Buffer::Copy(*buf1);
+  EXPECT_TRUE(test::FrameBufsEqual(buf1->ToI420(), buf2->ToI420()));
+}
+
+TEST(TestNV12FrameBuffer, Scale) {
+  rtc::scoped_refptr<NV12Buffer> buf = CreateNV12Gradient(200, 100);
+
+  // Pure scaling, no cropping.
+  rtc::scoped_refptr<NV12Buffer> scaled_buffer(NV12Buffer::Create(150, 75));
+
+  scaled_buffer->ScaleFrom(*buf);
+  CheckCrop(*scaled_buffer->ToI420(), 0.0, 0.0, 1.0, 1.0);
+}
+
+TEST(TestNV12FrameBuffer, CropXNotCenter) {
+  rtc::scoped_refptr<NV12Buffer> buf = CreateNV12Gradient(200, 100);
+
+  // Non-center cropping, no scaling.
+  rtc::scoped_refptr<NV12Buffer> scaled_buffer(NV12Buffer::Create(100, 100));
+
+  scaled_buffer->CropAndScaleFrom(*buf, 25, 0, 100, 100);
+  CheckCrop(*scaled_buffer->ToI420(), 0.125, 0.0, 0.5, 1.0);
+}
+
+TEST(TestNV12FrameBuffer, CropYNotCenterAndScale) {
+  rtc::scoped_refptr<NV12Buffer> buf = CreateNV12Gradient(100, 200);
+
+  // Non-center cropping, then scale down by 2.
+  rtc::scoped_refptr<NV12Buffer> scaled_buffer(NV12Buffer::Create(50, 50));
+
+  scaled_buffer->CropAndScaleFrom(*buf, 0, 25, 100, 100);
+  CheckCrop(*scaled_buffer->ToI420(), 0.0, 0.125, 1.0, 0.5);
+}
+
 class TestI420BufferRotate
     : public ::testing::TestWithParam<webrtc::VideoRotation> {};
 
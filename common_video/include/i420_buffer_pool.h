@@ -15,7 +15,9 @@
 #include <limits>
 
 #include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/common_video/include/video_buffer_memory_pool.h"
 #include "webrtc/rtc_base/race_checker.h"
+#include "webrtc/rtc_base/refcountedobject.h"
 
 namespace webrtc {
 
@@ -23,7 +25,9 @@ namespace webrtc {
 // The pool manages the memory of the I420Buffer returned from CreateBuffer.
 // When the I420Buffer is destructed, the memory is returned to the pool for use
 // by subsequent calls to CreateBuffer. If the resolution passed to CreateBuffer
-// changes, old buffers will be purged from the pool.
+// changes, old buffers will be purged from the pool. The memory of purged and
+// destroyed buffers goes back to a VideoBufferMemoryPool, by default the
+// process-wide one, and is reused for later allocations of any pool.
 // Note that CreateBuffer will crash if more than kMaxNumberOfFramesBeforeCrash
 // are created. This is to prevent memory leaks where frames are not returned.
 class I420BufferPool {
@@ -33,21 +37,36 @@ class I420BufferPool {
   explicit I420BufferPool(bool zero_initialize)
       : I420BufferPool(zero_initialize, std::numeric_limits<size_t>::max()) {}
   I420BufferPool(bool zero_initialze, size_t max_number_of_buffers);
+  I420BufferPool(bool zero_initialize,
+                 size_t max_number_of_buffers,
+                 rtc::scoped_refptr<VideoBufferMemoryPool> memory_pool);
+  ~I420BufferPool();
 
   // Returns a buffer from the pool. If no suitable buffer exist in the pool
   // and there are less than |max_number_of_buffers| pending, a buffer is
   // created. Returns null otherwise.
   rtc::scoped_refptr<I420Buffer> CreateBuffer(int width, int height);
+  // Same as above, but with explicit strides, e.g. for encoders that want
+  // aligned rows. Only buffers with the same strides are reused.
+  rtc::scoped_refptr<I420Buffer> CreateBuffer(int width,
+                                              int height,
+                                              int stride_y,
+                                              int stride_u,
+                                              int stride_v);
   // Clears buffers_ and detaches the thread checker so that it can be reused
   // later from another thread.
   void Release();
 
  private:
+  // I420Buffer with memory from a VideoBufferMemoryPool, which gets the memory
+  // back when the buffer is destroyed.
+  class MemoryPoolI420Buffer;
   // Explicitly use a RefCountedObject to get access to HasOneRef,
   // needed by the pool to check exclusive access.
-  using PooledI420Buffer = rtc::RefCountedObject<I420Buffer>;
+  using PooledI420Buffer = rtc::RefCountedObject<MemoryPoolI420Buffer>;
 
   rtc::RaceChecker race_checker_;
+  const rtc::scoped_refptr<VideoBufferMemoryPool> memory_pool_;
   std::list<rtc::scoped_refptr<PooledI420Buffer>> buffers_;
   // If true, newly allocated buffers are zero-initialized. Note that recycled
   // buffers are not zero'd before reuse. This is required of buffers used by
@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_VIDEO_INCLUDE_NV12_BUFFER_POOL_H_
+#define WEBRTC_COMMON_VIDEO_INCLUDE_NV12_BUFFER_POOL_H_
+
+#include <limits>
+#include <list>
+
+#include "webrtc/api/video/nv12_buffer.h"
+#include "webrtc/common_video/include/video_buffer_memory_pool.h"
+#include "webrtc/rtc_base/race_checker.h"
+#include "webrtc/rtc_base/refcountedobject.h"
+
+namespace webrtc {
+
+// The NV12 counterpart of I420BufferPool, for sources that deliver NV12 and
+// for cropping and scaling such frames without converting them to I420. The
+// memory of purged and destroyed buffers goes back to a VideoBufferMemoryPool,
+// by default the process-wide one.
+class NV12BufferPool {
+ public:
+  NV12BufferPool() : NV12BufferPool(std::numeric_limits<size_t>::max()) {}
+  explicit NV12BufferPool(size_t max_number_of_buffers);
+  NV12BufferPool(size_t max_number_of_buffers,
+                 rtc::scoped_refptr<VideoBufferMemoryPool> memory_pool);
+  ~NV12BufferPool();
+
+  // Returns a buffer from the pool. If no suitable buffer exist in the pool
+  // and there are less than |max_number_of_buffers| pending, a buffer is
+  // created. Returns null otherwise.
+  rtc::scoped_refptr<NV12Buffer> CreateBuffer(int width, int height);
+  // Clears buffers_ so that the pool can be reused later from another thread.
+  void Release();
+
+ private:
+  class MemoryPoolNV12Buffer;
+  // Explicitly use a RefCountedObject to get access to HasOneRef,
+  // needed by the pool to check exclusive access.
+  using PooledNV12Buffer = rtc::RefCountedObject<MemoryPoolNV12Buffer>;
+
+  rtc::RaceChecker race_checker_;
+  const rtc::scoped_refptr<VideoBufferMemoryPool> memory_pool_;
+  std::list<rtc::scoped_refptr<PooledNV12Buffer>> buffers_;
+  // Max number of buffers this pool can have pending.
+  const size_t max_number_of_buffers_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_VIDEO_INCLUDE_NV12_BUFFER_POOL_H_
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_VIDEO_INCLUDE_VIDEO_BUFFER_MEMORY_POOL_H_
+#define WEBRTC_COMMON_VIDEO_INCLUDE_VIDEO_BUFFER_MEMORY_POOL_H_
+
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/refcount.h"
+#include "webrtc/rtc_base/scoped_ref_ptr.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+#include "webrtc/system_wrappers/include/aligned_malloc.h"
+
+namespace webrtc {
+
+// Thread safe cache of the memory behind video frame buffers. Blocks are
+// bucketed by size class, so frames of different but similar resolutions share
+// memory, and a block may be returned to the pool from any thread. Free blocks
+// are kept until their total size exceeds a cap, at which point the least
+// recently returned ones are freed.
+//
+// I420BufferPool allocates from the process-wide pool returned by Default(), so
+// the memory of buffers purged on a resolution change, or released by another
+// pool, is reused instead of going back to the system allocator.
+class VideoBufferMemoryPool : public rtc::RefCountInterface {
+ public:
+  struct Stats {
+    // Allocate() calls served by a cached block.
+    int64_t hits = 0;
+    // Allocate() calls that had to allocate a new block.
+    int64_t misses = 0;
+    // Free blocks released to stay below the cap.
+    int64_t evictions = 0;
+    // Total size of the free blocks in the pool.
+    size_t cached_bytes = 0;
+    // Total size of the blocks returned by Allocate() and not yet recycled.
+    size_t in_use_bytes = 0;
+  };
+
+  static const size_t kDefaultMaxCachedBytes;
+
+  // The process-wide pool. Never destroyed.
+  static VideoBufferMemoryPool* Default();
+
+  static rtc::scoped_refptr<VideoBufferMemoryPool> Create(
+      size_t max_cached_bytes);
+
+  // Returns a block of at least |size| bytes, aligned for SIMD use. The size
+  // of the block, which must be passed to Recycle(), is written to
+  // |capacity|.
+  std::unique_ptr<uint8_t, AlignedFreeDeleter> Allocate(size_t size,
+                                                         size_t* capacity);
+  // Returns a block obtained from Allocate() to the pool.
+  void Recycle(std::unique_ptr<uint8_t, AlignedFreeDeleter> data,
+               size_t capacity);
+
+  // Changes the cap on the memory held by free blocks, evicting blocks if
+  // needed. A cap of 0 disables caching.
+  void SetMaxCachedBytes(size_t max_cached_bytes);
+  Stats GetStats() const;
+
+  // Rounds |size| up to its size class. There are four classes per power of
+  // two, so at most a quarter of a block is unused.
+  static size_t SizeClass(size_t size);
+
+ protected:
+  explicit VideoBufferMemoryPool(size_t max_cached_bytes);
+  ~VideoBufferMemoryPool() override;
+
+ private:
+  struct Block {
+    size_t size_class;
+    std::unique_ptr<uint8_t, AlignedFreeDeleter> data;
+  };
+
+  // Moves the least recently recycled blocks to |evicted| until the cached
+  // bytes are at most |max_cached_bytes_|. The caller frees them without
+  // holding |crit_|.
+  void EvictBlocks(std::list<Block>* evicted) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  rtc::CriticalSection crit_;
+  size_t max_cached_bytes_ GUARDED_BY(crit_);
+  // Free blocks, most recently recycled first.
+  std::list<Block> blocks_ GUARDED_BY(crit_);
+  // Free blocks of each size class, most recently recycled last.
+  std::map<size_t, std::deque<std::list<Block>::iterator>> free_blocks_
+      GUARDED_BY(crit_);
+  Stats stats_ GUARDED_BY(crit_);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_VIDEO_INCLUDE_VIDEO_BUFFER_MEMORY_POOL_H_
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_video/include/nv12_buffer_pool.h"
+
+#include <utility>
+
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+
+class NV12BufferPool::MemoryPoolNV12Buffer : public NV12Buffer {
+ protected:
+  MemoryPoolNV12Buffer(int width,
+                       int height,
+                       int stride_y,
+                       int stride_uv,
+                       VideoBufferMemoryPool* memory_pool,
+                       std::unique_ptr<uint8_t, AlignedFreeDeleter> data,
+                       size_t capacity)
+      : NV12Buffer(width, height, stride_y, stride_uv, std::move(data)),
+        memory_pool_(memory_pool),
+        capacity_(capacity) {}
+
+  ~MemoryPoolNV12Buffer() override {
+    // May run on any thread; the memory pool is thread safe.
+    memory_pool_->Recycle(ReleaseData(), capacity_);
+  }
+
+ private:
+  const rtc::scoped_refptr<VideoBufferMemoryPool> memory_pool_;
+  const size_t capacity_;
+};
+
+NV12BufferPool::NV12BufferPool(size_t max_number_of_buffers)
+    : NV12BufferPool(max_number_of_buffers, VideoBufferMemoryPool::Default()) {
+}
+
+NV12BufferPool::NV12BufferPool(
+    size_t max_number_of_buffers,
+    rtc::scoped_refptr<VideoBufferMemoryPool> memory_pool)
+    : memory_pool_(std::move(memory_pool)),
+      max_number_of_buffers_(max_number_of_buffers) {
+  RTC_DCHECK(memory_pool_);
+}
+
+NV12BufferPool::~NV12BufferPool() = default;
+
+void NV12BufferPool::Release() {
+  buffers_.clear();
+}
+
+rtc::scoped_refptr<NV12Buffer> NV12BufferPool::CreateBuffer(int width,
+                                                            int height) {
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
+  // Release buffers with wrong resolution.
+  for (auto it = buffers_.begin(); it != buffers_.end();) {
+    if ((*it)->width() != width || (*it)->height() != height)
+      it = buffers_.erase(it);
+    else
+      ++it;
+  }
+  // Look for a free buffer.
+  for (const rtc::scoped_refptr<PooledNV12Buffer>& buffer : buffers_) {
+    // If the ref count is 1, the list we are looping over holds the only
+    // reference and it's safe to reuse.
+    if (buffer->HasOneRef())
+      return buffer;
+  }
+
+  if (buffers_.size() >= max_number_of_buffers_)
+    return nullptr;
+  // Allocate new buffer.
+  const int stride_y = width;
+  const int stride_uv = (width + 1) / 2 * 2;
+  const size_t size = static_cast<size_t>(stride_y) * height +
+                      static_cast<size_t>(stride_uv) * ((height + 1) / 2);
+  size_t capacity = 0;
+  std::unique_ptr<uint8_t, AlignedFreeDeleter> data =
+      memory_pool_->Allocate(size, &capacity);
+  rtc::scoped_refptr<PooledNV12Buffer> buffer =
+      new PooledNV12Buffer(width, height, stride_y, stride_uv,
+                           memory_pool_.get(), std::move(data), capacity);
+  buffers_.push_back(buffer);
+  return buffer;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_video/include/nv12_buffer_pool.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+TEST(TestNV12BufferPool, SimpleFrameReuse) {
+  NV12BufferPool pool;
+  rtc::scoped_refptr<NV12Buffer> buffer = pool.CreateBuffer(15, 16);
+  EXPECT_EQ(15, buffer->width());
+  EXPECT_EQ(16, buffer->height());
+  EXPECT_EQ(15, buffer->StrideY());
+  EXPECT_EQ(16, buffer->StrideUV());
+  // Extract non-refcounted pointers for testing.
+  const uint8_t* y_ptr = buffer->DataY();
+  const uint8_t* uv_ptr = buffer->DataUV();
+  // Release buffer so that it is returned to the pool.
+  buffer = nullptr;
+  // Check that the memory is reused.
+  buffer = pool.CreateBuffer(15, 16);
+  EXPECT_EQ(y_ptr, buffer->DataY());
+  EXPECT_EQ(uv_ptr, buffer->DataUV());
+}
+
+TEST(TestNV12BufferPool, FailToReuse) {
+  NV12BufferPool pool;
+  rtc::scoped_refptr<NV12Buffer> buffer = pool.CreateBuffer(16, 16);
+  rtc::scoped_refptr<NV12Buffer> buffer2 = pool.CreateBuffer(16, 16);
+  // The first buffer is still in use.
+  EXPECT_NE(buffer->DataY(), buffer2->DataY());
+  buffer = nullptr;
+  // Check that the pool doesn't try to reuse buffers of incorrect size.
+  buffer = pool.CreateBuffer(32, 16);
+  EXPECT_EQ(32, buffer->width());
+  EXPECT_EQ(16, buffer->height());
+}
+
+TEST(TestNV12BufferPool, MaxNumberOfBuffers) {
+  NV12BufferPool pool(1);
+  rtc::scoped_refptr<NV12Buffer> buffer = pool.CreateBuffer(16, 16);
+  EXPECT_TRUE(buffer);
+  EXPECT_FALSE(pool.CreateBuffer(16, 16));
+}
+
+TEST(TestNV12BufferPool, SharesMemoryWithOtherPools) {
+  rtc::scoped_refptr<VideoBufferMemoryPool> memory_pool =
+      VideoBufferMemoryPool::Create(1 << 20);
+  const uint8_t* y_ptr = nullptr;
+  {
+    NV12BufferPool pool(1, memory_pool);
+    y_ptr = pool.CreateBuffer(64, 64)->DataY();
+  }
+  NV12BufferPool pool(1, memory_pool);
+  rtc::scoped_refptr<NV12Buffer> buffer = pool.CreateBuffer(64, 64);
+  EXPECT_EQ(y_ptr, buffer->DataY());
+  EXPECT_EQ(1, memory_pool->GetStats().hits);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_video/include/video_buffer_memory_pool.h"
+
+#include <iterator>
+#include <utility>
+
+#include "webrtc/rtc_base/basictypes.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/refcountedobject.h"
+
+namespace webrtc {
+
+namespace {
+
+// Same alignment as I420Buffer uses for its own allocations.
+const size_t kBufferAlignment = 64;
+const size_t kMinSizeClass = 4096;
+
+}  // namespace
+
+// Room for a handful of 1080p frames.
+const size_t VideoBufferMemoryPool::kDefaultMaxCachedBytes = 32 * 1024 * 1024;
+
+// static
+VideoBufferMemoryPool* VideoBufferMemoryPool::Default() {
+  RTC_DEFINE_STATIC_LOCAL(rtc::scoped_refptr<VideoBufferMemoryPool>, pool,
+                          (Create(kDefaultMaxCachedBytes)));
+  return pool.get();
+}
+
+// static
+rtc::scoped_refptr<VideoBufferMemoryPool> VideoBufferMemoryPool::Create(
+    size_t max_cached_bytes) {
+  return new rtc::RefCountedObject<VideoBufferMemoryPool>(max_cached_bytes);
+}
+
+// static
+size_t VideoBufferMemoryPool::SizeClass(size_t size) {
+  if (size <= kMinSizeClass)
+    return kMinSizeClass;
+  size_t power_of_two = kMinSizeClass;
+  while (power_of_two * 2 <= size)
+    power_of_two *= 2;
+  const size_t step = power_of_two / 4;
+  return (size + step - 1) / step * step;
+}
+
+VideoBufferMemoryPool::VideoBufferMemoryPool(size_t max_cached_bytes)
+    : max_cached_bytes_(max_cached_bytes) {}
+
+VideoBufferMemoryPool::~VideoBufferMemoryPool() {
+  // Blocks still in use hold a reference to the pool through their buffers.
+  RTC_DCHECK_EQ(0u, stats_.in_use_bytes);
+}
+
+std::unique_ptr<uint8_t, AlignedFreeDeleter> VideoBufferMemoryPool::Allocate(
+    size_t size,
+    size_t* capacity) {
+  const size_t size_class = SizeClass(size);
+  *capacity = size_class;
+  {
+    rtc::CritScope lock(&crit_);
+    stats_.in_use_bytes += size_class;
+    auto it = free_blocks_.find(size_class);
+    if (it != free_blocks_.end()) {
+      std::list<Block>::iterator block = it->second.back();
+      it->second.pop_back();
+      if (it->second.empty())
+        free_blocks_.erase(it);
+      std::unique_ptr<uint8_t, AlignedFreeDeleter> data =
+          std::move(block->data);
+      blocks_.erase(block);
+      stats_.cached_bytes -= size_class;
+      ++stats_.hits;
+      return data;
+    }
+    ++stats_.misses;
+  }
+  return std::unique_ptr<uint8_t, AlignedFreeDeleter>(
+      static_cast<uint8_t*>(AlignedMalloc(size_class, kBufferAlignment)));
+}
+
+void VideoBufferMemoryPool::Recycle(
+    std::unique_ptr<uint8_t, AlignedFreeDeleter> data,
+    size_t capacity) {
+  RTC_DCHECK_EQ(capacity, SizeClass(capacity));
+  std::list<Block> evicted;
+  {
+    rtc::CritScope lock(&crit_);
+    RTC_DCHECK_GE(stats_.in_use_bytes, capacity);
+    stats_.in_use_bytes -= capacity;
+    blocks_.push_front(Block{capacity, std::move(data)});
+    free_blocks_[capacity].push_back(blocks_.begin());
+    stats_.cached_bytes += capacity;
+    EvictBlocks(&evicted);
+  }
+}
+
+void VideoBufferMemoryPool::SetMaxCachedBytes(size_t max_cached_bytes) {
+  std::list<Block> evicted;
+  {
+    rtc::CritScope lock(&crit_);
+    max_cached_bytes_ = max_cached_bytes;
+    EvictBlocks(&evicted);
+  }
+}
+
+VideoBufferMemoryPool::Stats VideoBufferMemoryPool::GetStats() const {
+  rtc::CritScope lock(&crit_);
+  return stats_;
+}
+
+void VideoBufferMemoryPool::EvictBlocks(std::list<Block>* evicted) {
+  while (stats_.cached_bytes > max_cached_bytes_) {
+    RTC_DCHECK(!blocks_.empty());
+    std::list<Block>::iterator oldest = std::prev(blocks_.end());
+    auto it = free_blocks_.find(oldest->size_class);
+    RTC_DCHECK(it != free_blocks_.end());
+    // Within a size class, blocks are ordered the same way as in |blocks_|.
+    RTC_DCHECK(it->second.front() == oldest);
+    it->second.pop_front();
+    if (it->second.empty())
+      free_blocks_.erase(it);
+    stats_.cached_bytes -= oldest->size_class;
+    ++stats_.evictions;
+    evicted->splice(evicted->end(), blocks_, oldest);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_video/include/video_buffer_memory_pool.h"
+
+#include <utility>
+
+#include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+struct RecycleContext {
+  VideoBufferMemoryPool* pool;
+  std::unique_ptr<uint8_t, AlignedFreeDeleter> data;
+  size_t capacity;
+};
+
+void RecycleOnThread(void* obj) {
+  RecycleContext* context = static_cast<RecycleContext*>(obj);
+  context->pool->Recycle(std::move(context->data), context->capacity);
+}
+
+}  // namespace
+
+TEST(VideoBufferMemoryPoolTest, SizeClasses) {
+  EXPECT_EQ(4096u, VideoBufferMemoryPool::SizeClass(1));
+  EXPECT_EQ(4096u, VideoBufferMemoryPool::SizeClass(4096));
+  EXPECT_EQ(5120u, VideoBufferMemoryPool::SizeClass(4097));
+  EXPECT_EQ(8192u, VideoBufferMemoryPool::SizeClass(8192));
+  // 1280x720 I420.
+  EXPECT_EQ(1572864u, VideoBufferMemoryPool::SizeClass(1382400));
+  // 1280x704 I420 shares the size class.
+  EXPECT_EQ(1572864u, VideoBufferMemoryPool::SizeClass(1351680));
+}
+
+TEST(VideoBufferMemoryPoolTest, ReusesBlocksOfTheSameSizeClass) {
+  rtc::scoped_refptr<VideoBufferMemoryPool> pool =
+      VideoBufferMemoryPool::Create(1 << 20);
+  size_t capacity = 0;
+  std::unique_ptr<uint8_t, AlignedFreeDeleter> data =
+      pool->Allocate(5000, &capacity);
+  EXPECT_EQ(5120u, capacity);
+  const uint8_t* ptr = data.get();
+  pool->Recycle(std::move(data), capacity);
+
+  data = pool->Allocate(5100, &capacity);
+  EXPECT_EQ(ptr, data.get());
+  VideoBufferMemoryPool::Stats stats = pool->GetStats();
+  EXPECT_EQ(1, stats.hits);
+  EXPECT_EQ(1, stats.misses);
+  EXPECT_EQ(0u, stats.cached_bytes);
+  EXPECT_EQ(5120u, stats.in_use_bytes);
+
+  // A different size class does not get the block.
+  pool->Recycle(std::move(data), capacity);
+  data = pool->Allocate(8000, &capacity);
+  EXPECT_NE(ptr, data.get());
+  stats = pool->GetStats();
+  EXPECT_EQ(2, stats.misses);
+  EXPECT_EQ(5120u, stats.cached_bytes);
+  pool->Recycle(std::move(data), capacity);
+}
+
+TEST(VideoBufferMemoryPoolTest, EvictsLeastRecentlyRecycledBlocks) {
+  rtc::scoped_refptr<VideoBufferMemoryPool> pool =
+      VideoBufferMemoryPool::Create(3 * 4096);
+  size_t capacity = 0;
+  std::unique_ptr<uint8_t, AlignedFreeDeleter> blocks[4];
+  const uint8_t* ptrs[4];
+  for (int i = 0; i < 4; ++i) {
+    blocks[i] = pool->Allocate(4096, &capacity);
+    ptrs[i] = blocks[i].get();
+  }
+  for (int i = 0; i < 4; ++i)
+    pool->Recycle(std::move(blocks[i]), capacity);
+
+  VideoBufferMemoryPool::Stats stats = pool->GetStats();
+  EXPECT_EQ(1, stats.evictions);
+  EXPECT_EQ(3u * 4096, stats.cached_bytes);
+  // The most recently recycled block is handed out first, and the first one
+  // was evicted.
+  for (int i = 3; i > 0; --i) {
+    blocks[i] = pool->Allocate(4096, &capacity);
+    EXPECT_EQ(ptrs[i], blocks[i].get());
+  }
+  EXPECT_EQ(3, pool->GetStats().hits);
+  for (int i = 1; i < 4; ++i)
+    pool->Recycle(std::move(blocks[i]), capacity);
+
+  pool->SetMaxCachedBytes(0);
+  stats = pool->GetStats();
+  EXPECT_EQ(4, stats.evictions);
+  EXPECT_EQ(0u, stats.cached_bytes);
+}
+
+TEST(VideoBufferMemoryPoolTest, RecyclesFromOtherThreads) {
+  rtc::scoped_refptr<VideoBufferMemoryPool> pool =
+      VideoBufferMemoryPool::Create(1 << 20);
+  RecycleContext context;
+  context.pool = pool.get();
+  context.data = pool->Allocate(10000, &context.capacity);
+  const uint8_t* ptr = context.data.get();
+
+  rtc::PlatformThread thread(&RecycleOnThread, &context, "RecycleThread");
+  thread.Start();
+  thread.Stop();
+
+  size_t capacity = 0;
+  std::unique_ptr<uint8_t, AlignedFreeDeleter> data =
+      pool->Allocate(10000, &capacity);
+  EXPECT_EQ(ptr, data.get());
+  pool->Recycle(std::move(data), capacity);
+}
+
+}  // namespace webrtc
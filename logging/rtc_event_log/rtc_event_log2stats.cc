@@ -159,6 +159,8 @@ std::string EventTypeToString(webrtc::rtclog::Event::EventType event_type) {
       return "BWE_PROBE_CREATED";
     case webrtc::rtclog::Event::BWE_PROBE_RESULT_EVENT:
       return "BWE_PROBE_RESULT";
+    case webrtc::rtclog::Event::EVENT_BLOCK:
+      return "EVENT_BLOCK";
   }
   RTC_NOTREACHED();
   return "UNKNOWN_EVENT";
@@ -345,7 +345,7 @@ int main(int argc, char* argv[]) {
     RTC_CHECK(ParseSsrc(FLAGS_ssrc)) << "Flag verification has failed.";
 
   webrtc::ParsedRtcEventLog parsed_stream;
-  if (!parsed_stream.ParseFile(input_file)) {
+  if (!parsed_stream.MapFile(input_file)) {
     std::cerr << "Error while parsing input file: " << input_file << std::endl;
     return -1;
   }
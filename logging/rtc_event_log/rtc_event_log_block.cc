@@ -0,0 +1,449 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/logging/rtc_event_log/rtc_event_log_block.h"
+
+#include <limits>
+
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+const size_t kFixedRtpHeaderSize = 12;
+
+// Upper bounds of the serialized size of a column entry.
+const size_t kMaxVarint32Size = 5;
+const size_t kMaxVarint64Size = 10;
+// Field tags and lengths of the columns, and the fields of the enclosing
+// Event, as long as the block is smaller than 2 MB.
+const size_t kMaxBlockOverhead = 128;
+const size_t kMaxBlockSize = 1 << 21;
+
+template <typename T>
+bool ReadColumn(const google::protobuf::RepeatedField<T>& column,
+                int* index,
+                T* value) {
+  if (*index >= column.size())
+    return false;
+  *value = column.Get((*index)++);
+  return true;
+}
+
+bool ReadBytes(const ProtoString& bytes,
+               size_t length,
+               size_t* offset,
+               ProtoString* value) {
+  if (length > bytes.size() - *offset)
+    return false;
+  value->assign(bytes, *offset, length);
+  *offset += length;
+  return true;
+}
+
+bool ReadBitrate(const google::protobuf::RepeatedField<int64_t>& column,
+                 int* index,
+                 int64_t* bitrate_bps) {
+  int64_t delta_bps;
+  if (!ReadColumn(column, index, &delta_bps) ||
+      delta_bps < -(int64_t{1} << 32) || delta_bps > (int64_t{1} << 32)) {
+    return false;
+  }
+  *bitrate_bps += delta_bps;
+  return *bitrate_bps >= std::numeric_limits<int32_t>::min() &&
+         *bitrate_bps <= std::numeric_limits<int32_t>::max();
+}
+
+struct SsrcDecoderState {
+  bool has_rtp_packet = false;
+  uint16_t sequence_number = 0;
+  uint32_t rtp_timestamp = 0;
+};
+
+// Decodes |block| starting at |timestamp_us|. Appends the events to |events|,
+// also if decoding fails.
+bool DecodeEvents(const rtclog::EventBlock& block,
+                  int64_t timestamp_us,
+                  std::vector<rtclog::Event>* events) {
+  if (block.timestamp_delta_us_size() != block.type_size())
+    return false;
+  std::vector<SsrcDecoderState> ssrcs(block.ssrcs_size());
+  int rtp_index = 0;
+  int rtcp_index = 0;
+  int audio_playout_index = 0;
+  int loss_based_index = 0;
+  int delay_based_index = 0;
+  size_t rtp_header_tails_offset = 0;
+  size_t rtcp_packets_offset = 0;
+  int64_t loss_based_bitrate_bps = 0;
+  int64_t delay_based_bitrate_bps = 0;
+
+  for (int i = 0; i < block.type_size(); ++i) {
+    timestamp_us += block.timestamp_delta_us(i);
+    events->emplace_back();
+    rtclog::Event& event = events->back();
+    event.set_timestamp_us(timestamp_us);
+    switch (block.type(i)) {
+      case rtclog::Event::RTP_EVENT: {
+        const int index = rtp_index++;
+        if (index >= block.rtp_incoming_size() ||
+            index >= block.rtp_packet_length_size() ||
+            index >= block.rtp_header_flags_size() ||
+            index >= block.rtp_ssrc_index_size() ||
+            index >= block.rtp_sequence_number_delta_size() ||
+            index >= block.rtp_timestamp_delta_size() ||
+            index >= block.rtp_header_tail_length_size() ||
+            index >= block.rtp_probe_cluster_id_size()) {
+          return false;
+        }
+        const uint32_t header_flags = block.rtp_header_flags(index);
+        const uint32_t ssrc_index = block.rtp_ssrc_index(index);
+        if (header_flags > 0xffff || ssrc_index >= ssrcs.size())
+          return false;
+        SsrcDecoderState& ssrc = ssrcs[ssrc_index];
+        const int32_t sequence_number_delta =
+            block.rtp_sequence_number_delta(index);
+        const int64_t rtp_timestamp_delta = block.rtp_timestamp_delta(index);
+        if (ssrc.has_rtp_packet) {
+          if (sequence_number_delta < std::numeric_limits<int16_t>::min() ||
+              sequence_number_delta > std::numeric_limits<int16_t>::max() ||
+              rtp_timestamp_delta < std::numeric_limits<int32_t>::min() ||
+              rtp_timestamp_delta > std::numeric_limits<int32_t>::max()) {
+            return false;
+          }
+          ssrc.sequence_number += sequence_number_delta;
+          ssrc.rtp_timestamp += static_cast<uint32_t>(rtp_timestamp_delta);
+        } else {
+          if (sequence_number_delta < 0 ||
+              sequence_number_delta > std::numeric_limits<uint16_t>::max() ||
+              rtp_timestamp_delta < 0 ||
+              rtp_timestamp_delta > std::numeric_limits<uint32_t>::max()) {
+            return false;
+          }
+          ssrc.has_rtp_packet = true;
+          ssrc.sequence_number = static_cast<uint16_t>(sequence_number_delta);
+          ssrc.rtp_timestamp = static_cast<uint32_t>(rtp_timestamp_delta);
+        }
+        uint8_t fixed_header[kFixedRtpHeaderSize];
+        fixed_header[0] = static_cast<uint8_t>(header_flags >> 8);
+        fixed_header[1] = static_cast<uint8_t>(header_flags);
+        ByteWriter<uint16_t>::WriteBigEndian(&fixed_header[2],
+                                             ssrc.sequence_number);
+        ByteWriter<uint32_t>::WriteBigEndian(&fixed_header[4],
+                                             ssrc.rtp_timestamp);
+        ByteWriter<uint32_t>::WriteBigEndian(&fixed_header[8],
+                                             block.ssrcs(ssrc_index));
+        ProtoString header_tail;
+        if (!ReadBytes(block.rtp_header_tails(),
+                       block.rtp_header_tail_length(index),
+                       &rtp_header_tails_offset, &header_tail)) {
+          return false;
+        }
+
+        event.set_type(rtclog::Event::RTP_EVENT);
+        rtclog::RtpPacket* packet = event.mutable_rtp_packet();
+        packet->set_incoming(block.rtp_incoming(index));
+        packet->set_packet_length(block.rtp_packet_length(index));
+        ProtoString* header = packet->mutable_header();
+        header->reserve(kFixedRtpHeaderSize + header_tail.size());
+        header->assign(reinterpret_cast<const char*>(fixed_header),
+                       kFixedRtpHeaderSize);
+        header->append(header_tail);
+        if (block.rtp_probe_cluster_id(index) != 0)
+          packet->set_probe_cluster_id(block.rtp_probe_cluster_id(index) - 1);
+        break;
+      }
+      case rtclog::Event::RTCP_EVENT: {
+        const int index = rtcp_index++;
+        if (index >= block.rtcp_incoming_size() ||
+            index >= block.rtcp_packet_length_size()) {
+          return false;
+        }
+        event.set_type(rtclog::Event::RTCP_EVENT);
+        rtclog::RtcpPacket* packet = event.mutable_rtcp_packet();
+        packet->set_incoming(block.rtcp_incoming(index));
+        if (!ReadBytes(block.rtcp_packets(), block.rtcp_packet_length(index),
+                       &rtcp_packets_offset, packet->mutable_packet_data())) {
+          return false;
+        }
+        break;
+      }
+      case rtclog::Event::AUDIO_PLAYOUT_EVENT: {
+        uint32_t ssrc_index;
+        if (!ReadColumn(block.audio_playout_ssrc_index(), &audio_playout_index,
+                        &ssrc_index) ||
+            ssrc_index >= ssrcs.size()) {
+          return false;
+        }
+        event.set_type(rtclog::Event::AUDIO_PLAYOUT_EVENT);
+        event.mutable_audio_playout_event()->set_local_ssrc(
+            block.ssrcs(ssrc_index));
+        break;
+      }
+      case rtclog::Event::LOSS_BASED_BWE_UPDATE: {
+        const int index = loss_based_index;
+        if (!ReadBitrate(block.loss_based_bitrate_delta_bps(),
+                         &loss_based_index, &loss_based_bitrate_bps) ||
+            index >= block.loss_based_fraction_loss_size() ||
+            index >= block.loss_based_total_packets_size()) {
+          return false;
+        }
+        event.set_type(rtclog::Event::LOSS_BASED_BWE_UPDATE);
+        rtclog::LossBasedBweUpdate* update =
+            event.mutable_loss_based_bwe_update();
+        update->set_bitrate_bps(static_cast<int32_t>(loss_based_bitrate_bps));
+        update->set_fraction_loss(block.loss_based_fraction_loss(index));
+        update->set_total_packets(block.loss_based_total_packets(index));
+        break;
+      }
+      case rtclog::Event::DELAY_BASED_BWE_UPDATE: {
+        const int index = delay_based_index;
+        if (!ReadBitrate(block.delay_based_bitrate_delta_bps(),
+                         &delay_based_index, &delay_based_bitrate_bps) ||
+            index >= block.delay_based_detector_state_size() ||
+            !rtclog::DelayBasedBweUpdate::DetectorState_IsValid(
+                block.delay_based_detector_state(index))) {
+          return false;
+        }
+        event.set_type(rtclog::Event::DELAY_BASED_BWE_UPDATE);
+        rtclog::DelayBasedBweUpdate* update =
+            event.mutable_delay_based_bwe_update();
+        update->set_bitrate_bps(static_cast<int32_t>(delay_based_bitrate_bps));
+        update->set_detector_state(
+            static_cast<rtclog::DelayBasedBweUpdate::DetectorState>(
+                block.delay_based_detector_state(index)));
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+
+  // All columns must have been consumed.
+  return rtp_index == block.rtp_incoming_size() &&
+         rtp_index == block.rtp_packet_length_size() &&
+         rtp_index == block.rtp_header_flags_size() &&
+         rtp_index == block.rtp_ssrc_index_size() &&
+         rtp_index == block.rtp_sequence_number_delta_size() &&
+         rtp_index == block.rtp_timestamp_delta_size() &&
+         rtp_index == block.rtp_header_tail_length_size() &&
+         rtp_index == block.rtp_probe_cluster_id_size() &&
+         rtp_header_tails_offset == block.rtp_header_tails().size() &&
+         rtcp_index == block.rtcp_incoming_size() &&
+         rtcp_index == block.rtcp_packet_length_size() &&
+         rtcp_packets_offset == block.rtcp_packets().size() &&
+         audio_playout_index == block.audio_playout_ssrc_index_size() &&
+         loss_based_index == block.loss_based_fraction_loss_size() &&
+         loss_based_index == block.loss_based_total_packets_size() &&
+         delay_based_index == block.delay_based_detector_state_size();
+}
+}  // namespace
+
+RtcEventBlockEncoder::RtcEventBlockEncoder() {
+  Reset();
+}
+
+RtcEventBlockEncoder::~RtcEventBlockEncoder() {}
+
+// static
+bool RtcEventBlockEncoder::CanEncode(const rtclog::Event& event) {
+  if (!event.has_timestamp_us() || !event.has_type())
+    return false;
+  switch (event.type()) {
+    case rtclog::Event::RTP_EVENT: {
+      const rtclog::RtpPacket& packet = event.rtp_packet();
+      return event.has_rtp_packet() && packet.has_incoming() &&
+             packet.has_packet_length() && packet.has_header() &&
+             !packet.has_type() &&
+             packet.header().size() >= kFixedRtpHeaderSize &&
+             (!packet.has_probe_cluster_id() ||
+              packet.probe_cluster_id() <
+                  std::numeric_limits<uint32_t>::max());
+    }
+    case rtclog::Event::RTCP_EVENT: {
+      const rtclog::RtcpPacket& packet = event.rtcp_packet();
+      return event.has_rtcp_packet() && packet.has_incoming() &&
+             packet.has_packet_data() && !packet.has_type();
+    }
+    case rtclog::Event::AUDIO_PLAYOUT_EVENT:
+      return event.has_audio_playout_event() &&
+             event.audio_playout_event().has_local_ssrc();
+    case rtclog::Event::LOSS_BASED_BWE_UPDATE: {
+      const rtclog::LossBasedBweUpdate& update = event.loss_based_bwe_update();
+      return event.has_loss_based_bwe_update() && update.has_bitrate_bps() &&
+             update.has_fraction_loss() && update.has_total_packets();
+    }
+    case rtclog::Event::DELAY_BASED_BWE_UPDATE: {
+      const rtclog::DelayBasedBweUpdate& update =
+          event.delay_based_bwe_update();
+      return event.has_delay_based_bwe_update() && update.has_bitrate_bps() &&
+             update.has_detector_state();
+    }
+    default:
+      return false;
+  }
+}
+
+// static
+size_t RtcEventBlockEncoder::MaxEncodedSize(const rtclog::Event& event) {
+  // The type and the timestamp delta.
+  size_t size = 1 + kMaxVarint64Size;
+  switch (event.type()) {
+    case rtclog::Event::RTP_EVENT:
+      // Each column, plus the SSRC if it is new to the block.
+      size += 1 + 3 * kMaxVarint32Size + 3 + 3 + kMaxVarint64Size +
+              kMaxVarint32Size + kMaxVarint32Size +
+              event.rtp_packet().header().size() - kFixedRtpHeaderSize;
+      break;
+    case rtclog::Event::RTCP_EVENT:
+      size += 1 + kMaxVarint32Size + event.rtcp_packet().packet_data().size();
+      break;
+    case rtclog::Event::AUDIO_PLAYOUT_EVENT:
+      size += 2 * kMaxVarint32Size;
+      break;
+    case rtclog::Event::LOSS_BASED_BWE_UPDATE:
+      size += kMaxVarint64Size + 2 * kMaxVarint32Size;
+      break;
+    case rtclog::Event::DELAY_BASED_BWE_UPDATE:
+      size += kMaxVarint64Size + kMaxVarint32Size;
+      break;
+    default:
+      RTC_NOTREACHED();
+  }
+  return size;
+}
+
+void RtcEventBlockEncoder::Add(const rtclog::Event& event) {
+  RTC_DCHECK(CanEncode(event));
+  if (empty()) {
+    first_timestamp_us_ = event.timestamp_us();
+    last_timestamp_us_ = event.timestamp_us();
+  }
+  max_encoded_size_ += MaxEncodedSize(event);
+  RTC_DCHECK_LT(max_encoded_size_, kMaxBlockSize);
+  block_.add_type(event.type());
+  block_.add_timestamp_delta_us(event.timestamp_us() - last_timestamp_us_);
+  last_timestamp_us_ = event.timestamp_us();
+
+  switch (event.type()) {
+    case rtclog::Event::RTP_EVENT: {
+      const rtclog::RtpPacket& packet = event.rtp_packet();
+      const ProtoString& header = packet.header();
+      const uint8_t* data = reinterpret_cast<const uint8_t*>(header.data());
+      const uint16_t sequence_number =
+          ByteReader<uint16_t>::ReadBigEndian(&data[2]);
+      const uint32_t rtp_timestamp =
+          ByteReader<uint32_t>::ReadBigEndian(&data[4]);
+      SsrcState* ssrc =
+          GetSsrcState(ByteReader<uint32_t>::ReadBigEndian(&data[8]));
+      block_.add_rtp_incoming(packet.incoming());
+      block_.add_rtp_packet_length(packet.packet_length());
+      block_.add_rtp_header_flags(data[0] << 8 | data[1]);
+      block_.add_rtp_ssrc_index(ssrc->index);
+      if (ssrc->has_rtp_packet) {
+        block_.add_rtp_sequence_number_delta(
+            static_cast<int16_t>(sequence_number - ssrc->sequence_number));
+        block_.add_rtp_timestamp_delta(
+            static_cast<int32_t>(rtp_timestamp - ssrc->rtp_timestamp));
+      } else {
+        block_.add_rtp_sequence_number_delta(sequence_number);
+        block_.add_rtp_timestamp_delta(rtp_timestamp);
+      }
+      ssrc->has_rtp_packet = true;
+      ssrc->sequence_number = sequence_number;
+      ssrc->rtp_timestamp = rtp_timestamp;
+      block_.add_rtp_header_tail_length(header.size() - kFixedRtpHeaderSize);
+      block_.mutable_rtp_header_tails()->append(header, kFixedRtpHeaderSize,
+                                                ProtoString::npos);
+      block_.add_rtp_probe_cluster_id(
+          packet.has_probe_cluster_id() ? packet.probe_cluster_id() + 1 : 0);
+      break;
+    }
+    case rtclog::Event::RTCP_EVENT: {
+      const rtclog::RtcpPacket& packet = event.rtcp_packet();
+      block_.add_rtcp_incoming(packet.incoming());
+      block_.add_rtcp_packet_length(packet.packet_data().size());
+      block_.mutable_rtcp_packets()->append(packet.packet_data());
+      break;
+    }
+    case rtclog::Event::AUDIO_PLAYOUT_EVENT:
+      block_.add_audio_playout_ssrc_index(
+          GetSsrcState(event.audio_playout_event().local_ssrc())->index);
+      break;
+    case rtclog::Event::LOSS_BASED_BWE_UPDATE: {
+      const rtclog::LossBasedBweUpdate& update = event.loss_based_bwe_update();
+      block_.add_loss_based_bitrate_delta_bps(update.bitrate_bps() -
+                                              last_loss_based_bitrate_bps_);
+      last_loss_based_bitrate_bps_ = update.bitrate_bps();
+      block_.add_loss_based_fraction_loss(update.fraction_loss());
+      block_.add_loss_based_total_packets(update.total_packets());
+      break;
+    }
+    case rtclog::Event::DELAY_BASED_BWE_UPDATE: {
+      const rtclog::DelayBasedBweUpdate& update =
+          event.delay_based_bwe_update();
+      block_.add_delay_based_bitrate_delta_bps(update.bitrate_bps() -
+                                               last_delay_based_bitrate_bps_);
+      last_delay_based_bitrate_bps_ = update.bitrate_bps();
+      block_.add_delay_based_detector_state(update.detector_state());
+      break;
+    }
+    default:
+      RTC_NOTREACHED();
+  }
+}
+
+void RtcEventBlockEncoder::Encode(rtclog::Event* event) {
+  RTC_DCHECK(!empty());
+  event->Clear();
+  event->set_timestamp_us(first_timestamp_us_);
+  event->set_type(rtclog::Event::EVENT_BLOCK);
+  // Copy rather than swap, so that |block_| keeps its allocated columns.
+  *event->mutable_event_block() = block_;
+  RTC_DCHECK_LE(static_cast<size_t>(event->ByteSize()), max_encoded_size_);
+  Reset();
+}
+
+RtcEventBlockEncoder::SsrcState* RtcEventBlockEncoder::GetSsrcState(
+    uint32_t ssrc) {
+  auto it = ssrcs_.find(ssrc);
+  if (it == ssrcs_.end()) {
+    it = ssrcs_.insert(std::make_pair(ssrc, SsrcState(block_.ssrcs_size())))
+             .first;
+    block_.add_ssrcs(ssrc);
+  }
+  return &it->second;
+}
+
+void RtcEventBlockEncoder::Reset() {
+  block_.Clear();
+  first_timestamp_us_ = 0;
+  last_timestamp_us_ = 0;
+  ssrcs_.clear();
+  last_loss_based_bitrate_bps_ = 0;
+  last_delay_based_bitrate_bps_ = 0;
+  max_encoded_size_ = kMaxBlockOverhead;
+}
+
+bool DecodeRtcEventBlock(const rtclog::Event& event,
+                         std::vector<rtclog::Event>* events) {
+  RTC_DCHECK_EQ(rtclog::Event::EVENT_BLOCK, event.type());
+  if (!event.has_event_block() || !event.has_timestamp_us())
+    return false;
+  const size_t num_events = events->size();
+  if (!DecodeEvents(event.event_block(), event.timestamp_us(), events)) {
+    events->resize(num_events);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace webrtc
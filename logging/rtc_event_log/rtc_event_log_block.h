@@ -0,0 +1,92 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_BLOCK_H_
+#define WEBRTC_LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_BLOCK_H_
+
+#include <map>
+#include <vector>
+
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/ignore_wundef.h"
+#include "webrtc/rtc_base/protobuf_utils.h"
+
+// *.pb.h files are generated at build-time by the protobuf compiler.
+RTC_PUSH_IGNORING_WUNDEF()
+#ifdef WEBRTC_ANDROID_PLATFORM_BUILD
+#include "external/webrtc/webrtc/logging/rtc_event_log/rtc_event_log.pb.h"
+#else
+#include "webrtc/logging/rtc_event_log/rtc_event_log.pb.h"
+#endif
+RTC_POP_IGNORING_WUNDEF()
+
+namespace webrtc {
+
+// Collects RTP, RTCP, audio playout and BWE update events into a single
+// EVENT_BLOCK event, see rtclog::EventBlock. Events are appended to the
+// columns of the block as they are added, so that adding an event does not
+// allocate once the columns have grown.
+class RtcEventBlockEncoder {
+ public:
+  RtcEventBlockEncoder();
+  ~RtcEventBlockEncoder();
+
+  // Whether |event| can be stored in a block, and decoded to an equal event.
+  static bool CanEncode(const rtclog::Event& event);
+
+  // Upper bound of the number of bytes that adding |event| adds to the
+  // serialized block.
+  static size_t MaxEncodedSize(const rtclog::Event& event);
+
+  // Adds |event| to the block. CanEncode(event) must be true.
+  void Add(const rtclog::Event& event);
+
+  // Moves the added events into |event|, which becomes an EVENT_BLOCK event,
+  // and starts a new block.
+  void Encode(rtclog::Event* event);
+
+  bool empty() const { return block_.type_size() == 0; }
+  int64_t first_timestamp_us() const { return first_timestamp_us_; }
+
+  // Upper bound of the size of the Event produced by Encode(), including the
+  // field tag and length it is prefixed with in an EventStream.
+  size_t max_encoded_size() const { return max_encoded_size_; }
+
+ private:
+  struct SsrcState {
+    explicit SsrcState(int index) : index(index) {}
+    const int index;
+    bool has_rtp_packet = false;
+    uint16_t sequence_number = 0;
+    uint32_t rtp_timestamp = 0;
+  };
+
+  SsrcState* GetSsrcState(uint32_t ssrc);
+  void Reset();
+
+  rtclog::EventBlock block_;
+  int64_t first_timestamp_us_;
+  int64_t last_timestamp_us_;
+  std::map<uint32_t, SsrcState> ssrcs_;
+  int64_t last_loss_based_bitrate_bps_;
+  int64_t last_delay_based_bitrate_bps_;
+  size_t max_encoded_size_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtcEventBlockEncoder);
+};
+
+// Appends the events stored in the EVENT_BLOCK |event| to |events|. Returns
+// false if the block is malformed, in which case |events| is left unchanged.
+bool DecodeRtcEventBlock(const rtclog::Event& event,
+                         std::vector<rtclog::Event>* events);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_BLOCK_H_
@@ -0,0 +1,247 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "webrtc/logging/rtc_event_log/rtc_event_log_block.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+const uint32_t kSsrcs[] = {0x12345678, 0x23456789, 0x3456789a};
+const size_t kNumSsrcs = 3;
+
+rtclog::Event CreateRtpEvent(int64_t timestamp_us,
+                             bool incoming,
+                             uint16_t sequence_number,
+                             uint32_t rtp_timestamp,
+                             uint32_t ssrc,
+                             Random* prng) {
+  // A fixed header followed by a one-byte header extension with an absolute
+  // send time.
+  uint8_t header[20];
+  header[0] = 0x90;
+  header[1] = prng->Rand(127);
+  ByteWriter<uint16_t>::WriteBigEndian(&header[2], sequence_number);
+  ByteWriter<uint32_t>::WriteBigEndian(&header[4], rtp_timestamp);
+  ByteWriter<uint32_t>::WriteBigEndian(&header[8], ssrc);
+  ByteWriter<uint16_t>::WriteBigEndian(&header[12], 0xbede);
+  ByteWriter<uint16_t>::WriteBigEndian(&header[14], 1);
+  header[16] = 0x32;
+  ByteWriter<uint32_t, 3>::WriteBigEndian(&header[17], prng->Rand(0xffffff));
+
+  rtclog::Event event;
+  event.set_timestamp_us(timestamp_us);
+  event.set_type(rtclog::Event::RTP_EVENT);
+  event.mutable_rtp_packet()->set_incoming(incoming);
+  event.mutable_rtp_packet()->set_packet_length(prng->Rand(100, 1200));
+  event.mutable_rtp_packet()->set_header(header, sizeof(header));
+  return event;
+}
+
+// Generates the events of a call: RTP packets of a few streams, interleaved
+// with RTCP packets, audio playouts and BWE updates.
+std::vector<rtclog::Event> GenerateEvents(size_t num_events, Random* prng) {
+  std::vector<rtclog::Event> events;
+  uint16_t sequence_numbers[kNumSsrcs];
+  uint32_t rtp_timestamps[kNumSsrcs];
+  for (size_t i = 0; i < kNumSsrcs; ++i) {
+    sequence_numbers[i] = prng->Rand<uint16_t>();
+    rtp_timestamps[i] = prng->Rand<uint32_t>();
+  }
+  int64_t timestamp_us = prng->Rand<uint32_t>();
+  int32_t bitrate_bps = 300000;
+  while (events.size() < num_events) {
+    timestamp_us += prng->Rand(1, 1000);
+    const uint32_t choice = prng->Rand(99);
+    if (choice < 85) {
+      const size_t stream = prng->Rand(kNumSsrcs - 1);
+      // Reordered packets now and then.
+      sequence_numbers[stream] += prng->Rand(10) == 0 ? -1 : 1;
+      rtp_timestamps[stream] += prng->Rand(0, 3000);
+      events.push_back(CreateRtpEvent(
+          timestamp_us, stream != 0, sequence_numbers[stream],
+          rtp_timestamps[stream], kSsrcs[stream], prng));
+      if (choice < 5)
+        events.back().mutable_rtp_packet()->set_probe_cluster_id(choice);
+    } else if (choice < 90) {
+      events.emplace_back();
+      events.back().set_timestamp_us(timestamp_us);
+      events.back().set_type(rtclog::Event::RTCP_EVENT);
+      rtclog::RtcpPacket* packet = events.back().mutable_rtcp_packet();
+      packet->set_incoming(prng->Rand<bool>());
+      std::vector<char> data(prng->Rand(4, 80));
+      for (char& byte : data)
+        byte = prng->Rand<char>();
+      packet->set_packet_data(data.data(), data.size());
+    } else if (choice < 95) {
+      events.emplace_back();
+      events.back().set_timestamp_us(timestamp_us);
+      events.back().set_type(rtclog::Event::AUDIO_PLAYOUT_EVENT);
+      events.back().mutable_audio_playout_event()->set_local_ssrc(kSsrcs[0]);
+    } else if (choice < 97) {
+      bitrate_bps += prng->Rand(-20000, 20000);
+      events.emplace_back();
+      events.back().set_timestamp_us(timestamp_us);
+      events.back().set_type(rtclog::Event::LOSS_BASED_BWE_UPDATE);
+      rtclog::LossBasedBweUpdate* update =
+          events.back().mutable_loss_based_bwe_update();
+      update->set_bitrate_bps(bitrate_bps);
+      update->set_fraction_loss(prng->Rand<uint8_t>());
+      update->set_total_packets(prng->Rand(0, 1000));
+    } else {
+      bitrate_bps += prng->Rand(-20000, 20000);
+      events.emplace_back();
+      events.back().set_timestamp_us(timestamp_us);
+      events.back().set_type(rtclog::Event::DELAY_BASED_BWE_UPDATE);
+      rtclog::DelayBasedBweUpdate* update =
+          events.back().mutable_delay_based_bwe_update();
+      update->set_bitrate_bps(bitrate_bps);
+      update->set_detector_state(rtclog::DelayBasedBweUpdate::BWE_OVERUSING);
+    }
+  }
+  return events;
+}
+
+rtclog::Event EncodeBlock(const std::vector<rtclog::Event>& events) {
+  RtcEventBlockEncoder encoder;
+  for (const rtclog::Event& event : events) {
+    EXPECT_TRUE(RtcEventBlockEncoder::CanEncode(event));
+    encoder.Add(event);
+  }
+  rtclog::Event block;
+  encoder.Encode(&block);
+  EXPECT_TRUE(encoder.empty());
+  return block;
+}
+
+void ExpectEqualEvents(const std::vector<rtclog::Event>& expected,
+                       const std::vector<rtclog::Event>& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i].SerializeAsString(), actual[i].SerializeAsString())
+        << "Event " << i << " differs.";
+  }
+}
+
+}  // namespace
+
+TEST(RtcEventBlockTest, EncodeAndDecode) {
+  Random prng(4711);
+  const std::vector<rtclog::Event> events = GenerateEvents(1000, &prng);
+  rtclog::Event block = EncodeBlock(events);
+  EXPECT_EQ(rtclog::Event::EVENT_BLOCK, block.type());
+  EXPECT_EQ(events.front().timestamp_us(), block.timestamp_us());
+
+  std::vector<rtclog::Event> decoded;
+  ASSERT_TRUE(DecodeRtcEventBlock(block, &decoded));
+  ExpectEqualEvents(events, decoded);
+}
+
+TEST(RtcEventBlockTest, EncoderIsReusable) {
+  Random prng(1234);
+  const std::vector<rtclog::Event> events = GenerateEvents(300, &prng);
+  RtcEventBlockEncoder encoder;
+  std::vector<rtclog::Event> decoded;
+  for (size_t i = 0; i < events.size(); ++i) {
+    encoder.Add(events[i]);
+    if (i % 100 == 99) {
+      rtclog::Event block;
+      encoder.Encode(&block);
+      ASSERT_TRUE(DecodeRtcEventBlock(block, &decoded));
+    }
+  }
+  ExpectEqualEvents(events, decoded);
+}
+
+TEST(RtcEventBlockTest, MaxEncodedSizeIsUpperBound) {
+  Random prng(5678);
+  const std::vector<rtclog::Event> events = GenerateEvents(500, &prng);
+  RtcEventBlockEncoder encoder;
+  for (const rtclog::Event& event : events)
+    encoder.Add(event);
+  const size_t max_encoded_size = encoder.max_encoded_size();
+  rtclog::EventStream stream;
+  encoder.Encode(stream.add_stream());
+  EXPECT_LE(static_cast<size_t>(stream.ByteSize()), max_encoded_size);
+}
+
+TEST(RtcEventBlockTest, SmallerThanEventStream) {
+  Random prng(8765);
+  const std::vector<rtclog::Event> events = GenerateEvents(1000, &prng);
+  size_t event_stream_size = 0;
+  for (const rtclog::Event& event : events) {
+    rtclog::EventStream stream;
+    *stream.add_stream() = event;
+    event_stream_size += stream.ByteSize();
+  }
+  rtclog::EventStream stream;
+  *stream.add_stream() = EncodeBlock(events);
+  EXPECT_LT(static_cast<size_t>(stream.ByteSize()), event_stream_size * 2 / 3);
+}
+
+TEST(RtcEventBlockTest, CannotEncodeConfigEvents) {
+  rtclog::Event event;
+  event.set_timestamp_us(1000);
+  event.set_type(rtclog::Event::LOG_START);
+  EXPECT_FALSE(RtcEventBlockEncoder::CanEncode(event));
+
+  event.set_type(rtclog::Event::VIDEO_RECEIVER_CONFIG_EVENT);
+  event.mutable_video_receiver_config()->set_remote_ssrc(1);
+  EXPECT_FALSE(RtcEventBlockEncoder::CanEncode(event));
+
+  Random prng(1);
+  event = CreateRtpEvent(1000, true, 1, 1, kSsrcs[0], &prng);
+  EXPECT_TRUE(RtcEventBlockEncoder::CanEncode(event));
+  event.mutable_rtp_packet()->mutable_header()->resize(11);
+  EXPECT_FALSE(RtcEventBlockEncoder::CanEncode(event));
+}
+
+TEST(RtcEventBlockTest, RejectsMalformedBlocks) {
+  Random prng(2718);
+  const std::vector<rtclog::Event> events = GenerateEvents(100, &prng);
+  const rtclog::Event block = EncodeBlock(events);
+  std::vector<rtclog::Event> decoded(1);
+
+  // Missing column entries.
+  rtclog::Event malformed = block;
+  malformed.mutable_event_block()->mutable_rtp_ssrc_index()->RemoveLast();
+  EXPECT_FALSE(DecodeRtcEventBlock(malformed, &decoded));
+
+  // Truncated RTP headers.
+  malformed = block;
+  malformed.mutable_event_block()->mutable_rtp_header_tails()->resize(
+      block.event_block().rtp_header_tails().size() - 1);
+  EXPECT_FALSE(DecodeRtcEventBlock(malformed, &decoded));
+
+  // Unused column entries.
+  malformed = block;
+  malformed.mutable_event_block()->add_rtcp_incoming(true);
+  EXPECT_FALSE(DecodeRtcEventBlock(malformed, &decoded));
+
+  // SSRC index out of range.
+  malformed = block;
+  malformed.mutable_event_block()->set_audio_playout_ssrc_index(0, kNumSsrcs);
+  EXPECT_FALSE(DecodeRtcEventBlock(malformed, &decoded));
+
+  // Event type that can't be stored in blocks.
+  malformed = block;
+  malformed.mutable_event_block()->set_type(0, rtclog::Event::LOG_START);
+  EXPECT_FALSE(DecodeRtcEventBlock(malformed, &decoded));
+
+  // Failures leave the decoded events untouched.
+  EXPECT_EQ(1u, decoded.size());
+}
+
+}  // namespace webrtc
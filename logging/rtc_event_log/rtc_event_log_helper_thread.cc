@@ -15,13 +15,21 @@
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 
 #ifdef ENABLE_RTC_EVENT_LOG
 
 namespace webrtc {
 
 namespace {
-const int kEventsInHistory = 10000;
+const size_t kEventsInHistory = 10000;
+
+// Blocks are written once they reach this size or age, which bounds the memory
+// used for them and the events lost if the process dies.
+const size_t kMaxBlockSizeBytes = 32 * 1024;
+const int64_t kMaxBlockDurationUs = 1000000;
+
+const char kEventBlocksFieldTrial[] = "WebRTC-EventLogEventBlocks";
 
 bool IsConfigEvent(const rtclog::Event& event) {
   rtclog::Event_EventType event_type = event.type();
@@ -38,6 +46,9 @@ RtcEventLogHelperThread::RtcEventLogHelperThread(
     SwapQueue<std::unique_ptr<rtclog::Event>>* event_queue)
     : message_queue_(message_queue),
       event_queue_(event_queue),
+      history_(kEventsInHistory),
+      history_start_(0),
+      history_size_(0),
       file_(FileWrapper::Create()),
       thread_(&ThreadOutputFunction, this, "RtcEventLog thread"),
       max_size_bytes_(std::numeric_limits<int64_t>::max()),
@@ -45,6 +56,9 @@ RtcEventLogHelperThread::RtcEventLogHelperThread(
       start_time_(0),
       stop_time_(std::numeric_limits<int64_t>::max()),
       has_recent_event_(false),
+      block_encoder_(field_trial::IsEnabled(kEventBlocksFieldTrial)
+                         ? new RtcEventBlockEncoder()
+                         : nullptr),
       wake_periodically_(false, false),
       wake_from_hibernation_(false, false),
       file_finished_(false, false) {
@@ -82,6 +96,13 @@ void RtcEventLogHelperThread::SignalNewEvent() {
 }
 
 bool RtcEventLogHelperThread::AppendEventToString(rtclog::Event* event) {
+  if (block_encoder_) {
+    if (RtcEventBlockEncoder::CanEncode(*event))
+      return AppendEventToBlock(*event);
+    // Keep the events in order.
+    AppendBlockToString();
+  }
+
   rtclog::EventStream event_stream;
   event_stream.add_stream();
   event_stream.mutable_stream(0)->Swap(event);
@@ -100,6 +121,42 @@ bool RtcEventLogHelperThread::AppendEventToString(rtclog::Event* event) {
   return stop;
 }
 
+bool RtcEventLogHelperThread::AppendEventToBlock(const rtclog::Event& event) {
+  // The pending block counts towards the file size, so that it can always be
+  // written.
+  if (written_bytes_ + static_cast<int64_t>(output_string_.size()) +
+          static_cast<int64_t>(block_encoder_->max_encoded_size() +
+                               RtcEventBlockEncoder::MaxEncodedSize(event)) >
+      max_size_bytes_) {
+    return true;
+  }
+  block_encoder_->Add(event);
+  if (block_encoder_->max_encoded_size() >= kMaxBlockSizeBytes)
+    AppendBlockToString();
+  return false;
+}
+
+void RtcEventLogHelperThread::AppendBlockToString() {
+  if (!block_encoder_ || block_encoder_->empty())
+    return;
+  rtclog::EventStream event_stream;
+  block_encoder_->Encode(event_stream.add_stream());
+  event_stream.AppendToString(&output_string_);
+}
+
+void RtcEventLogHelperThread::AddToHistory(
+    std::unique_ptr<rtclog::Event> event) {
+  if (history_size_ < history_.size()) {
+    history_[(history_start_ + history_size_) % history_.size()] =
+        std::move(event);
+    ++history_size_;
+  } else {
+    // Replace the oldest event.
+    history_[history_start_] = std::move(event);
+    history_start_ = (history_start_ + 1) % history_.size();
+  }
+}
+
 bool RtcEventLogHelperThread::LogToMemory() {
   RTC_DCHECK(!file_->is_open());
   bool message_received = false;
@@ -115,9 +172,7 @@ bool RtcEventLogHelperThread::LogToMemory() {
     if (IsConfigEvent(*most_recent_event_)) {
       config_history_.push_back(std::move(most_recent_event_));
     } else {
-      history_.push_back(std::move(most_recent_event_));
-      if (history_.size() > kEventsInHistory)
-        history_.pop_front();
+      AddToHistory(std::move(most_recent_event_));
     }
     has_recent_event_ = event_queue_->Remove(&most_recent_event_);
     message_received = true;
@@ -142,10 +197,12 @@ void RtcEventLogHelperThread::StartLogFile() {
   }
 
   // Serialize the events in the event queue.
-  while (!history_.empty() && !stop) {
-    stop = AppendEventToString(history_.front().get());
+  while (history_size_ > 0 && !stop) {
+    stop = AppendEventToString(history_[history_start_].get());
     if (!stop) {
-      history_.pop_front();
+      history_[history_start_].reset();
+      history_start_ = (history_start_ + 1) % history_.size();
+      --history_size_;
     }
   }
 
@@ -193,6 +250,13 @@ bool RtcEventLogHelperThread::LogToFile() {
     }
     message_received = true;
   }
+  // Write the pending block once it gets old, so that it is not kept in
+  // memory for long when there are few events.
+  if (block_encoder_ && !block_encoder_->empty() &&
+      current_time - block_encoder_->first_timestamp_us() >=
+          kMaxBlockDurationUs) {
+    AppendBlockToString();
+  }
 
   // Write string to file.
   if (!file_->Write(output_string_.data(), output_string_.size())) {
@@ -11,7 +11,6 @@
 #ifndef WEBRTC_LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_HELPER_THREAD_H_
 #define WEBRTC_LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_HELPER_THREAD_H_
 
-#include <deque>
 #include <limits>
 #include <memory>
 #include <utility>
@@ -34,6 +33,7 @@ RTC_PUSH_IGNORING_WUNDEF()
 #include "webrtc/logging/rtc_event_log/rtc_event_log.pb.h"
 #endif
 RTC_POP_IGNORING_WUNDEF()
+#include "webrtc/logging/rtc_event_log/rtc_event_log_block.h"
 #endif
 
 #ifdef ENABLE_RTC_EVENT_LOG
@@ -84,6 +84,9 @@ class RtcEventLogHelperThread final {
   static void ThreadOutputFunction(void* obj);
 
   bool AppendEventToString(rtclog::Event* event);
+  bool AppendEventToBlock(const rtclog::Event& event);
+  void AppendBlockToString();
+  void AddToHistory(std::unique_ptr<rtclog::Event> event);
   bool LogToMemory();
   void StartLogFile();
   bool LogToFile();
@@ -94,8 +97,11 @@ class RtcEventLogHelperThread final {
   SwapQueue<ControlMessage>* message_queue_;
   SwapQueue<std::unique_ptr<rtclog::Event>>* event_queue_;
 
-  // History containing the most recent events (~ 10 s).
-  std::deque<std::unique_ptr<rtclog::Event>> history_;
+  // Ring buffer containing the most recent events (~ 10 s), starting at
+  // |history_start_|.
+  std::vector<std::unique_ptr<rtclog::Event>> history_;
+  size_t history_start_;
+  size_t history_size_;
 
   // History containing all past configuration events.
   std::vector<std::unique_ptr<rtclog::Event>> config_history_;
@@ -114,6 +120,10 @@ class RtcEventLogHelperThread final {
   // Temporary space for serializing profobuf data.
   ProtoString output_string_;
 
+  // Collects events into blocks before they are appended to |output_string_|,
+  // if event blocks are enabled.
+  std::unique_ptr<RtcEventBlockEncoder> block_encoder_;
+
   rtc::Event wake_periodically_;
   rtc::Event wake_from_hibernation_;
   rtc::Event file_finished_;
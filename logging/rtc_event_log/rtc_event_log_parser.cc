@@ -13,17 +13,29 @@
 #include <stdint.h>
 #include <string.h>
 
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
 #include <fstream>
 #include <istream>
+#include <limits>
 #include <map>
 #include <utility>
 
 #include "webrtc/logging/rtc_event_log/rtc_event_log.h"
+#include "webrtc/logging/rtc_event_log/rtc_event_log_block.h"
 #include "webrtc/modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/bwe_defines.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/protobuf_utils.h"
 
@@ -74,6 +86,9 @@ ParsedRtcEventLog::EventType GetRuntimeEventType(
       return ParsedRtcEventLog::EventType::BWE_PROBE_CLUSTER_CREATED_EVENT;
     case rtclog::Event::BWE_PROBE_RESULT_EVENT:
       return ParsedRtcEventLog::EventType::BWE_PROBE_RESULT_EVENT;
+    case rtclog::Event::EVENT_BLOCK:
+      // Blocks are expanded into the events they contain when parsing.
+      return ParsedRtcEventLog::EventType::UNKNOWN_EVENT;
   }
   RTC_NOTREACHED();
   return ParsedRtcEventLog::EventType::UNKNOWN_EVENT;
@@ -113,6 +128,22 @@ std::pair<uint64_t, bool> ParseVarInt(std::istream& stream) {
   return std::make_pair(varint, false);
 }
 
+// Like ParseVarInt(), but reads from |data| at |*offset| and advances it.
+bool ReadVarInt(const uint8_t* data,
+                size_t size,
+                size_t* offset,
+                uint64_t* varint) {
+  *varint = 0;
+  for (size_t bytes_read = 0; bytes_read < 10 && *offset < size;
+       ++bytes_read) {
+    uint8_t byte = data[(*offset)++];
+    *varint |= static_cast<uint64_t>(byte & 0x7F) << (7 * bytes_read);
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
 void GetHeaderExtensions(
     std::vector<RtpExtension>* header_extensions,
     const RepeatedPtrField<rtclog::RtpHeaderExtension>&
@@ -127,8 +158,111 @@ void GetHeaderExtensions(
   }
 }
 
+// The tag of the events of an EventStream. The tag number is defined as
+// (fieldnumber << 3) | wire_type. In our case, the field number is supposed to
+// be 1 and the wire type for an length-delimited field is 2.
+const uint64_t kExpectedTag = (1 << 3) | 2;
+const size_t kMaxEventSize = (1u << 16) - 1;
+
+// Number of events between the entries of the index of a mapped file.
+const size_t kEventsPerIndexEntry = 4096;
+
 }  // namespace
 
+class ParsedRtcEventLog::MappedFile {
+ public:
+  static std::unique_ptr<MappedFile> Open(const std::string& file_name);
+  ~MappedFile();
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  MappedFile(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  const uint8_t* const data_;
+  const size_t size_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+#if defined(WEBRTC_WIN)
+std::unique_ptr<ParsedRtcEventLog::MappedFile>
+ParsedRtcEventLog::MappedFile::Open(const std::string& file_name) {
+  HANDLE file = ::CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return nullptr;
+  LARGE_INTEGER size;
+  if (!::GetFileSizeEx(file, &size) ||
+      static_cast<uint64_t>(size.QuadPart) >
+          std::numeric_limits<size_t>::max()) {
+    ::CloseHandle(file);
+    return nullptr;
+  }
+  if (size.QuadPart == 0) {
+    ::CloseHandle(file);
+    return std::unique_ptr<MappedFile>(new MappedFile(nullptr, 0));
+  }
+  HANDLE mapping =
+      ::CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  ::CloseHandle(file);
+  if (!mapping)
+    return nullptr;
+  void* data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  // The view keeps the mapping alive.
+  ::CloseHandle(mapping);
+  if (!data)
+    return nullptr;
+  return std::unique_ptr<MappedFile>(new MappedFile(
+      static_cast<const uint8_t*>(data), static_cast<size_t>(size.QuadPart)));
+}
+
+ParsedRtcEventLog::MappedFile::~MappedFile() {
+  if (data_)
+    ::UnmapViewOfFile(data_);
+}
+#else
+std::unique_ptr<ParsedRtcEventLog::MappedFile>
+ParsedRtcEventLog::MappedFile::Open(const std::string& file_name) {
+  int fd = ::open(file_name.c_str(), O_RDONLY);
+  if (fd < 0)
+    return nullptr;
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) != 0 ||
+      static_cast<uint64_t>(file_stat.st_size) >
+          std::numeric_limits<size_t>::max()) {
+    ::close(fd);
+    return nullptr;
+  }
+  const size_t size = static_cast<size_t>(file_stat.st_size);
+  if (size == 0) {
+    ::close(fd);
+    return std::unique_ptr<MappedFile>(new MappedFile(nullptr, 0));
+  }
+  void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps the file open.
+  ::close(fd);
+  if (data == MAP_FAILED)
+    return nullptr;
+  // The file is mostly read in order, let the kernel read ahead and drop the
+  // pages behind.
+  ::madvise(data, size, MADV_SEQUENTIAL);
+  return std::unique_ptr<MappedFile>(
+      new MappedFile(static_cast<const uint8_t*>(data), size));
+}
+
+ParsedRtcEventLog::MappedFile::~MappedFile() {
+  if (data_)
+    ::munmap(const_cast<uint8_t*>(data_), size_);
+}
+#endif
+
+ParsedRtcEventLog::ParsedRtcEventLog() {}
+
+ParsedRtcEventLog::~ParsedRtcEventLog() {}
+
 bool ParsedRtcEventLog::ParseFile(const std::string& filename) {
   std::ifstream file(filename, std::ios_base::in | std::ios_base::binary);
   if (!file.good() || !file.is_open()) {
@@ -146,7 +280,9 @@ bool ParsedRtcEventLog::ParseString(const std::string& s) {
 
 bool ParsedRtcEventLog::ParseStream(std::istream& stream) {
   events_.clear();
-  const size_t kMaxEventSize = (1u << 16) - 1;
+  mapped_file_.reset();
+  streams_.clear();
+  rtp_extensions_maps_.clear();
   std::vector<char> tmp_buffer(kMaxEventSize);
   uint64_t tag;
   uint64_t message_length;
@@ -158,20 +294,11 @@ bool ParsedRtcEventLog::ParseStream(std::istream& stream) {
     // Check whether we have reached end of file.
     stream.peek();
     if (stream.eof()) {
-      // Process all extensions maps for faster look-up later.
-      for (auto& event_stream : streams_) {
-        rtp_extensions_maps_[StreamId(event_stream.ssrc,
-                                      event_stream.direction)] =
-            &event_stream.rtp_extensions_map;
-      }
+      BuildExtensionMaps();
       return true;
     }
 
-    // Read the next message tag. The tag number is defined as
-    // (fieldnumber << 3) | wire_type. In our case, the field number is
-    // supposed to be 1 and the wire type for an
-    // length-delimited field is 2.
-    const uint64_t kExpectedTag = (1 << 3) | 2;
+    // Read the next message tag.
     std::tie(tag, success) = ParseVarInt(stream);
     if (!success) {
       LOG(LS_WARNING) << "Missing field tag from beginning of protobuf event.";
@@ -205,71 +332,234 @@ bool ParsedRtcEventLog::ParseStream(std::istream& stream) {
       return false;
     }
 
-    EventType type = GetRuntimeEventType(event.type());
-    switch (type) {
-      case VIDEO_RECEIVER_CONFIG_EVENT: {
-        rtclog::StreamConfig config = GetVideoReceiveConfig(event);
-        streams_.emplace_back(config.remote_ssrc, MediaType::VIDEO,
-                              kIncomingPacket,
-                              RtpHeaderExtensionMap(config.rtp_extensions));
-        streams_.emplace_back(config.local_ssrc, MediaType::VIDEO,
-                              kOutgoingPacket,
-                              RtpHeaderExtensionMap(config.rtp_extensions));
-        break;
+    // Blocks only contain RTP, RTCP, audio playout and BWE update events,
+    // which don't configure any streams.
+    if (event.type() == rtclog::Event::EVENT_BLOCK) {
+      if (!DecodeRtcEventBlock(event, &events_)) {
+        LOG(LS_WARNING) << "Failed to decode event block.";
+        return false;
       }
-      case VIDEO_SENDER_CONFIG_EVENT: {
-        std::vector<rtclog::StreamConfig> configs = GetVideoSendConfig(event);
-        for (size_t i = 0; i < configs.size(); i++) {
-          streams_.emplace_back(
-              configs[i].local_ssrc, MediaType::VIDEO, kOutgoingPacket,
-              RtpHeaderExtensionMap(configs[i].rtp_extensions));
-
-          streams_.emplace_back(
-              configs[i].rtx_ssrc, MediaType::VIDEO, kOutgoingPacket,
-              RtpHeaderExtensionMap(configs[i].rtp_extensions));
-        }
-        break;
-      }
-      case AUDIO_RECEIVER_CONFIG_EVENT: {
-        rtclog::StreamConfig config = GetAudioReceiveConfig(event);
-        streams_.emplace_back(config.remote_ssrc, MediaType::AUDIO,
-                              kIncomingPacket,
-                              RtpHeaderExtensionMap(config.rtp_extensions));
-        streams_.emplace_back(config.local_ssrc, MediaType::AUDIO,
-                              kOutgoingPacket,
-                              RtpHeaderExtensionMap(config.rtp_extensions));
-        break;
-      }
-      case AUDIO_SENDER_CONFIG_EVENT: {
-        rtclog::StreamConfig config = GetAudioSendConfig(event);
-        streams_.emplace_back(config.local_ssrc, MediaType::AUDIO,
-                              kOutgoingPacket,
-                              RtpHeaderExtensionMap(config.rtp_extensions));
-        break;
-      }
-      default:
-        break;
+      continue;
     }
 
+    AddStreams(event);
     events_.push_back(event);
   }
 }
 
+bool ParsedRtcEventLog::MapFile(const std::string& file_name) {
+  events_.clear();
+  index_.clear();
+  cursor_events_.clear();
+  cursor_index_ = 0;
+  cursor_offset_ = 0;
+  num_mapped_events_ = 0;
+  streams_.clear();
+  rtp_extensions_maps_.clear();
+  mapped_file_ = MappedFile::Open(file_name);
+  if (!mapped_file_) {
+    LOG(LS_WARNING) << "Could not map file for reading.";
+    return false;
+  }
+
+  std::vector<rtclog::Event> events;
+  size_t offset = 0;
+  while (offset < mapped_file_->size()) {
+    const size_t record_offset = offset;
+    if (!ReadRecord(&offset, &events)) {
+      // Keep the events read so far, like ParseStream() does.
+      BuildExtensionMaps();
+      return false;
+    }
+    if (!events.empty() &&
+        num_mapped_events_ >= index_.size() * kEventsPerIndexEntry) {
+      IndexEntry entry;
+      entry.event_index = num_mapped_events_;
+      entry.offset = record_offset;
+      entry.timestamp_us = events[0].timestamp_us();
+      index_.push_back(entry);
+    }
+    for (const rtclog::Event& event : events)
+      AddStreams(event);
+    num_mapped_events_ += events.size();
+  }
+  BuildExtensionMaps();
+  return true;
+}
+
+bool ParsedRtcEventLog::ReadRecord(size_t* offset,
+                                   std::vector<rtclog::Event>* events) const {
+  const uint8_t* data = mapped_file_->data();
+  const size_t size = mapped_file_->size();
+  uint64_t tag;
+  if (!ReadVarInt(data, size, offset, &tag)) {
+    LOG(LS_WARNING) << "Missing field tag from beginning of protobuf event.";
+    return false;
+  } else if (tag != kExpectedTag) {
+    LOG(LS_WARNING) << "Unexpected field tag at beginning of protobuf event.";
+    return false;
+  }
+  uint64_t message_length;
+  if (!ReadVarInt(data, size, offset, &message_length)) {
+    LOG(LS_WARNING) << "Missing message length after protobuf field tag.";
+    return false;
+  } else if (message_length > kMaxEventSize) {
+    LOG(LS_WARNING) << "Protobuf message length is too large.";
+    return false;
+  } else if (message_length > size - *offset) {
+    LOG(LS_WARNING) << "Failed to read protobuf message from file.";
+    return false;
+  }
+
+  // Parse into the first event to reuse its allocations.
+  events->resize(1);
+  rtclog::Event& event = events->front();
+  if (!event.ParseFromArray(data + *offset, static_cast<int>(message_length))) {
+    LOG(LS_WARNING) << "Failed to parse protobuf message.";
+    return false;
+  }
+  *offset += message_length;
+  if (event.type() == rtclog::Event::EVENT_BLOCK) {
+    rtclog::Event block;
+    block.Swap(&event);
+    events->clear();
+    if (!DecodeRtcEventBlock(block, events)) {
+      LOG(LS_WARNING) << "Failed to decode event block.";
+      return false;
+    }
+  }
+  return true;
+}
+
+void ParsedRtcEventLog::AddStreams(const rtclog::Event& event) {
+  EventType type = GetRuntimeEventType(event.type());
+  switch (type) {
+    case VIDEO_RECEIVER_CONFIG_EVENT: {
+      rtclog::StreamConfig config = GetVideoReceiveConfig(event);
+      streams_.emplace_back(config.remote_ssrc, MediaType::VIDEO,
+                            kIncomingPacket,
+                            RtpHeaderExtensionMap(config.rtp_extensions));
+      streams_.emplace_back(config.local_ssrc, MediaType::VIDEO,
+                            kOutgoingPacket,
+                            RtpHeaderExtensionMap(config.rtp_extensions));
+      break;
+    }
+    case VIDEO_SENDER_CONFIG_EVENT: {
+      std::vector<rtclog::StreamConfig> configs = GetVideoSendConfig(event);
+      for (size_t i = 0; i < configs.size(); i++) {
+        streams_.emplace_back(
+            configs[i].local_ssrc, MediaType::VIDEO, kOutgoingPacket,
+            RtpHeaderExtensionMap(configs[i].rtp_extensions));
+
+        streams_.emplace_back(
+            configs[i].rtx_ssrc, MediaType::VIDEO, kOutgoingPacket,
+            RtpHeaderExtensionMap(configs[i].rtp_extensions));
+      }
+      break;
+    }
+    case AUDIO_RECEIVER_CONFIG_EVENT: {
+      rtclog::StreamConfig config = GetAudioReceiveConfig(event);
+      streams_.emplace_back(config.remote_ssrc, MediaType::AUDIO,
+                            kIncomingPacket,
+                            RtpHeaderExtensionMap(config.rtp_extensions));
+      streams_.emplace_back(config.local_ssrc, MediaType::AUDIO,
+                            kOutgoingPacket,
+                            RtpHeaderExtensionMap(config.rtp_extensions));
+      break;
+    }
+    case AUDIO_SENDER_CONFIG_EVENT: {
+      rtclog::StreamConfig config = GetAudioSendConfig(event);
+      streams_.emplace_back(config.local_ssrc, MediaType::AUDIO,
+                            kOutgoingPacket,
+                            RtpHeaderExtensionMap(config.rtp_extensions));
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void ParsedRtcEventLog::BuildExtensionMaps() {
+  // Process all extensions maps for faster look-up later.
+  for (auto& event_stream : streams_) {
+    rtp_extensions_maps_[StreamId(event_stream.ssrc,
+                                  event_stream.direction)] =
+        &event_stream.rtp_extensions_map;
+  }
+}
+
+const rtclog::Event& ParsedRtcEventLog::GetEvent(size_t index) const {
+  RTC_CHECK_LT(index, GetNumberOfEvents());
+  if (!mapped_file_)
+    return events_[index];
+  if (index >= cursor_index_ && index - cursor_index_ < cursor_events_.size())
+    return cursor_events_[index - cursor_index_];
+
+  if (index < cursor_index_ || index - cursor_index_ >= kEventsPerIndexEntry) {
+    // Continue from the last indexed record at or before |index|.
+    auto it = std::upper_bound(
+        index_.begin(), index_.end(), index,
+        [](size_t index, const IndexEntry& entry) {
+          return index < entry.event_index;
+        });
+    RTC_DCHECK(it != index_.begin());
+    --it;
+    cursor_events_.clear();
+    cursor_index_ = it->event_index;
+    cursor_offset_ = it->offset;
+  }
+  while (true) {
+    cursor_index_ += cursor_events_.size();
+    // The records were checked by MapFile().
+    RTC_CHECK(ReadRecord(&cursor_offset_, &cursor_events_));
+    if (index - cursor_index_ < cursor_events_.size())
+      return cursor_events_[index - cursor_index_];
+  }
+}
+
 size_t ParsedRtcEventLog::GetNumberOfEvents() const {
-  return events_.size();
+  return mapped_file_ ? num_mapped_events_ : events_.size();
+}
+
+size_t ParsedRtcEventLog::FindEvent(int64_t timestamp_us) const {
+  size_t begin = 0;
+  size_t end = GetNumberOfEvents();
+  if (mapped_file_) {
+    // Scan from the last indexed record before |timestamp_us|, which
+    // parses fewer events than a binary search would.
+    auto it = std::lower_bound(
+        index_.begin(), index_.end(), timestamp_us,
+        [](const IndexEntry& entry, int64_t timestamp_us) {
+          return entry.timestamp_us < timestamp_us;
+        });
+    if (it != index_.end())
+      end = it->event_index;
+    if (it != index_.begin())
+      begin = (it - 1)->event_index;
+    while (begin < end && GetTimestamp(begin) < timestamp_us)
+      ++begin;
+    return begin;
+  }
+  while (begin < end) {
+    size_t middle = begin + (end - begin) / 2;
+    if (GetTimestamp(middle) < timestamp_us) {
+      begin = middle + 1;
+    } else {
+      end = middle;
+    }
+  }
+  return begin;
 }
 
 int64_t ParsedRtcEventLog::GetTimestamp(size_t index) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  const rtclog::Event& event = events_[index];
+  const rtclog::Event& event = GetEvent(index);
   RTC_CHECK(event.has_timestamp_us());
   return event.timestamp_us();
 }
 
 ParsedRtcEventLog::EventType ParsedRtcEventLog::GetEventType(
     size_t index) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  const rtclog::Event& event = events_[index];
+  const rtclog::Event& event = GetEvent(index);
   RTC_CHECK(event.has_type());
   return GetRuntimeEventType(event.type());
 }
@@ -281,8 +571,7 @@ webrtc::RtpHeaderExtensionMap* ParsedRtcEventLog::GetRtpHeader(
     uint8_t* header,
     size_t* header_length,
     size_t* total_length) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  const rtclog::Event& event = events_[index];
+  const rtclog::Event& event = GetEvent(index);
   RTC_CHECK(event.has_type());
   RTC_CHECK_EQ(event.type(), rtclog::Event::RTP_EVENT);
   RTC_CHECK(event.has_rtp_packet());
@@ -325,8 +614,7 @@ void ParsedRtcEventLog::GetRtcpPacket(size_t index,
                                       PacketDirection* incoming,
                                       uint8_t* packet,
                                       size_t* length) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  const rtclog::Event& event = events_[index];
+  const rtclog::Event& event = GetEvent(index);
   RTC_CHECK(event.has_type());
   RTC_CHECK_EQ(event.type(), rtclog::Event::RTCP_EVENT);
   RTC_CHECK(event.has_rtcp_packet());
@@ -352,8 +640,7 @@ void ParsedRtcEventLog::GetRtcpPacket(size_t index,
 
 rtclog::StreamConfig ParsedRtcEventLog::GetVideoReceiveConfig(
     size_t index) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  return GetVideoReceiveConfig(events_[index]);
+  return GetVideoReceiveConfig(GetEvent(index));
 }
 
 rtclog::StreamConfig ParsedRtcEventLog::GetVideoReceiveConfig(
@@ -419,8 +706,7 @@ rtclog::StreamConfig ParsedRtcEventLog::GetVideoReceiveConfig(
 
 std::vector<rtclog::StreamConfig> ParsedRtcEventLog::GetVideoSendConfig(
     size_t index) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  return GetVideoSendConfig(events_[index]);
+  return GetVideoSendConfig(GetEvent(index));
 }
 
 std::vector<rtclog::StreamConfig> ParsedRtcEventLog::GetVideoSendConfig(
@@ -462,8 +748,7 @@ std::vector<rtclog::StreamConfig> ParsedRtcEventLog::GetVideoSendConfig(
 
 rtclog::StreamConfig ParsedRtcEventLog::GetAudioReceiveConfig(
     size_t index) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  return GetAudioReceiveConfig(events_[index]);
+  return GetAudioReceiveConfig(GetEvent(index));
 }
 
 rtclog::StreamConfig ParsedRtcEventLog::GetAudioReceiveConfig(
@@ -486,8 +771,7 @@ rtclog::StreamConfig ParsedRtcEventLog::GetAudioReceiveConfig(
 }
 
 rtclog::StreamConfig ParsedRtcEventLog::GetAudioSendConfig(size_t index) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  return GetAudioSendConfig(events_[index]);
+  return GetAudioSendConfig(GetEvent(index));
 }
 
 rtclog::StreamConfig ParsedRtcEventLog::GetAudioSendConfig(
@@ -507,8 +791,7 @@ rtclog::StreamConfig ParsedRtcEventLog::GetAudioSendConfig(
 }
 
 void ParsedRtcEventLog::GetAudioPlayout(size_t index, uint32_t* ssrc) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  const rtclog::Event& event = events_[index];
+  const rtclog::Event& event = GetEvent(index);
   RTC_CHECK(event.has_type());
   RTC_CHECK_EQ(event.type(), rtclog::Event::AUDIO_PLAYOUT_EVENT);
   RTC_CHECK(event.has_audio_playout_event());
@@ -523,8 +806,7 @@ void ParsedRtcEventLog::GetLossBasedBweUpdate(size_t index,
                                               int32_t* bitrate_bps,
                                               uint8_t* fraction_loss,
                                               int32_t* total_packets) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  const rtclog::Event& event = events_[index];
+  const rtclog::Event& event = GetEvent(index);
   RTC_CHECK(event.has_type());
   RTC_CHECK_EQ(event.type(), rtclog::Event::LOSS_BASED_BWE_UPDATE);
   RTC_CHECK(event.has_loss_based_bwe_update());
@@ -545,8 +827,7 @@ void ParsedRtcEventLog::GetLossBasedBweUpdate(size_t index,
 
 ParsedRtcEventLog::BweDelayBasedUpdate
 ParsedRtcEventLog::GetDelayBasedBweUpdate(size_t index) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  const rtclog::Event& event = events_[index];
+  const rtclog::Event& event = GetEvent(index);
   RTC_CHECK(event.has_type());
   RTC_CHECK_EQ(event.type(), rtclog::Event::DELAY_BASED_BWE_UPDATE);
   RTC_CHECK(event.has_delay_based_bwe_update());
@@ -565,8 +846,7 @@ ParsedRtcEventLog::GetDelayBasedBweUpdate(size_t index) const {
 void ParsedRtcEventLog::GetAudioNetworkAdaptation(
     size_t index,
     AudioEncoderRuntimeConfig* config) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  const rtclog::Event& event = events_[index];
+  const rtclog::Event& event = GetEvent(index);
   RTC_CHECK(event.has_type());
   RTC_CHECK_EQ(event.type(), rtclog::Event::AUDIO_NETWORK_ADAPTATION_EVENT);
   RTC_CHECK(event.has_audio_network_adaptation());
@@ -589,8 +869,7 @@ void ParsedRtcEventLog::GetAudioNetworkAdaptation(
 
 ParsedRtcEventLog::BweProbeClusterCreatedEvent
 ParsedRtcEventLog::GetBweProbeClusterCreated(size_t index) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  const rtclog::Event& event = events_[index];
+  const rtclog::Event& event = GetEvent(index);
   RTC_CHECK(event.has_type());
   RTC_CHECK_EQ(event.type(), rtclog::Event::BWE_PROBE_CLUSTER_CREATED_EVENT);
   RTC_CHECK(event.has_probe_cluster());
@@ -610,8 +889,7 @@ ParsedRtcEventLog::GetBweProbeClusterCreated(size_t index) const {
 
 ParsedRtcEventLog::BweProbeResultEvent ParsedRtcEventLog::GetBweProbeResult(
     size_t index) const {
-  RTC_CHECK_LT(index, GetNumberOfEvents());
-  const rtclog::Event& event = events_[index];
+  const rtclog::Event& event = GetEvent(index);
   RTC_CHECK(event.has_type());
   RTC_CHECK_EQ(event.type(), rtclog::Event::BWE_PROBE_RESULT_EVENT);
   RTC_CHECK(event.has_probe_result());
@@ -11,6 +11,7 @@
 #define WEBRTC_LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_PARSER_H_
 
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>  // pair
 #include <vector>
@@ -39,6 +40,9 @@ class ParsedRtcEventLog {
   friend class RtcEventLogTestHelper;
 
  public:
+  ParsedRtcEventLog();
+  ~ParsedRtcEventLog();
+
   struct BweProbeClusterCreatedEvent {
     uint64_t timestamp;
     uint32_t id;
@@ -89,9 +93,24 @@ class ParsedRtcEventLog {
   // Reads an RtcEventLog from an istream and returns true if successful.
   bool ParseStream(std::istream& stream);
 
+  // Memory maps an RtcEventLog file and returns true if it is well formed.
+  // Unlike ParseFile(), events are not kept in memory: the file is scanned
+  // once to find the stream configurations and to build a sparse index, and
+  // events are parsed again from the mapped file when they are accessed. This
+  // makes accessing the events in order cheap, while random access costs up
+  // to a few thousand events being parsed. The accessors are then not thread
+  // safe, since they share the position in the file. If the file is
+  // malformed, the events before the error can still be accessed.
+  bool MapFile(const std::string& file_name);
+
   // Returns the number of events in an EventStream.
   size_t GetNumberOfEvents() const;
 
+  // Returns the index of the first event with a timestamp at or after
+  // |timestamp_us|, or GetNumberOfEvents() if there is none. The timestamps
+  // must not decrease along the log.
+  size_t FindEvent(int64_t timestamp_us) const;
+
   // Reads the arrival timestamp (in microseconds) from a rtclog::Event.
   int64_t GetTimestamp(size_t index) const;
 
@@ -175,6 +194,23 @@ class ParsedRtcEventLog {
   MediaType GetMediaType(uint32_t ssrc, PacketDirection direction) const;
 
  private:
+  class MappedFile;
+
+  // An event of the mapped file, with the offset of the record containing it.
+  // Only the first event of a record is indexed.
+  struct IndexEntry {
+    size_t event_index;
+    size_t offset;
+    int64_t timestamp_us;
+  };
+
+  const rtclog::Event& GetEvent(size_t index) const;
+  // Reads the events of the record at |*offset| of the mapped file into
+  // |events|, and advances |*offset| to the next record.
+  bool ReadRecord(size_t* offset, std::vector<rtclog::Event>* events) const;
+  void AddStreams(const rtclog::Event& event);
+  void BuildExtensionMaps();
+
   rtclog::StreamConfig GetVideoReceiveConfig(const rtclog::Event& event) const;
   std::vector<rtclog::StreamConfig> GetVideoSendConfig(
       const rtclog::Event& event) const;
@@ -183,6 +219,16 @@ class ParsedRtcEventLog {
 
   std::vector<rtclog::Event> events_;
 
+  // Set by MapFile(), in which case |events_| is empty.
+  std::unique_ptr<MappedFile> mapped_file_;
+  size_t num_mapped_events_ = 0;
+  std::vector<IndexEntry> index_;
+  // The events of the last record read from |mapped_file_|, the index of the
+  // first of them, and the offset of the next record.
+  mutable std::vector<rtclog::Event> cursor_events_;
+  mutable size_t cursor_index_ = 0;
+  mutable size_t cursor_offset_ = 0;
+
   struct Stream {
     Stream(uint32_t ssrc,
            MediaType media_type,
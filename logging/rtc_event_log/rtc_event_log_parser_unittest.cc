@@ -0,0 +1,232 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "webrtc/logging/rtc_event_log/rtc_event_log_block.h"
+#include "webrtc/logging/rtc_event_log/rtc_event_log_parser.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+namespace webrtc {
+
+namespace {
+
+const uint32_t kRemoteSsrc = 0x11223344;
+const uint32_t kLocalSsrc = 0x55667788;
+// More than fit between two entries of the index of a mapped file.
+const size_t kNumRtpEvents = 10000;
+const size_t kEventsPerBlock = 700;
+
+rtclog::Event CreateRtpEvent(int64_t timestamp_us,
+                             uint16_t sequence_number,
+                             Random* prng) {
+  uint8_t header[12];
+  header[0] = 0x80;
+  header[1] = 96;
+  ByteWriter<uint16_t>::WriteBigEndian(&header[2], sequence_number);
+  ByteWriter<uint32_t>::WriteBigEndian(&header[4], prng->Rand<uint32_t>());
+  ByteWriter<uint32_t>::WriteBigEndian(&header[8], kRemoteSsrc);
+  rtclog::Event event;
+  event.set_timestamp_us(timestamp_us);
+  event.set_type(rtclog::Event::RTP_EVENT);
+  event.mutable_rtp_packet()->set_incoming(true);
+  event.mutable_rtp_packet()->set_packet_length(prng->Rand(100, 1200));
+  event.mutable_rtp_packet()->set_header(header, sizeof(header));
+  return event;
+}
+
+void AppendEvent(const rtclog::Event& event, std::string* log) {
+  rtclog::EventStream stream;
+  *stream.add_stream() = event;
+  stream.AppendToString(log);
+}
+
+// Creates a log with a video receive stream and |kNumRtpEvents| RTP packets,
+// the second half of them in event blocks.
+std::string CreateLog() {
+  Random prng(1848);
+  std::string log;
+  int64_t timestamp_us = 1000000;
+
+  rtclog::Event event;
+  event.set_timestamp_us(timestamp_us);
+  event.set_type(rtclog::Event::LOG_START);
+  AppendEvent(event, &log);
+
+  event.Clear();
+  event.set_timestamp_us(timestamp_us);
+  event.set_type(rtclog::Event::VIDEO_RECEIVER_CONFIG_EVENT);
+  rtclog::VideoReceiveConfig* config = event.mutable_video_receiver_config();
+  config->set_remote_ssrc(kRemoteSsrc);
+  config->set_local_ssrc(kLocalSsrc);
+  config->set_rtcp_mode(rtclog::VideoReceiveConfig::RTCP_COMPOUND);
+  config->set_remb(false);
+  AppendEvent(event, &log);
+
+  RtcEventBlockEncoder encoder;
+  for (size_t i = 0; i < kNumRtpEvents; ++i) {
+    timestamp_us += prng.Rand(0, 1000);
+    event = CreateRtpEvent(timestamp_us, i, &prng);
+    if (i < kNumRtpEvents / 2) {
+      AppendEvent(event, &log);
+      continue;
+    }
+    encoder.Add(event);
+    if ((i + 1) % kEventsPerBlock == 0 || i + 1 == kNumRtpEvents) {
+      rtclog::EventStream stream;
+      encoder.Encode(stream.add_stream());
+      stream.AppendToString(&log);
+    }
+  }
+
+  event.Clear();
+  event.set_timestamp_us(timestamp_us);
+  event.set_type(rtclog::Event::LOG_END);
+  AppendEvent(event, &log);
+  return log;
+}
+
+std::string WriteTempFile(const std::string& contents) {
+  const std::string file_name =
+      test::TempFilename(test::OutputPath(), "rtc_event_log_parser");
+  FILE* file = fopen(file_name.c_str(), "wb");
+  RTC_CHECK(file);
+  RTC_CHECK_EQ(contents.size(),
+               fwrite(contents.data(), 1, contents.size(), file));
+  fclose(file);
+  return file_name;
+}
+
+void ExpectEqualEvent(const ParsedRtcEventLog& expected,
+                      const ParsedRtcEventLog& actual,
+                      size_t index) {
+  ASSERT_EQ(expected.GetEventType(index), actual.GetEventType(index));
+  EXPECT_EQ(expected.GetTimestamp(index), actual.GetTimestamp(index));
+  if (expected.GetEventType(index) != ParsedRtcEventLog::RTP_EVENT)
+    return;
+  PacketDirection expected_direction;
+  PacketDirection actual_direction;
+  uint8_t expected_header[IP_PACKET_SIZE];
+  uint8_t actual_header[IP_PACKET_SIZE];
+  size_t expected_header_length;
+  size_t actual_header_length;
+  size_t expected_total_length;
+  size_t actual_total_length;
+  RtpHeaderExtensionMap* expected_extensions = expected.GetRtpHeader(
+      index, &expected_direction, expected_header, &expected_header_length,
+      &expected_total_length);
+  RtpHeaderExtensionMap* actual_extensions =
+      actual.GetRtpHeader(index, &actual_direction, actual_header,
+                          &actual_header_length, &actual_total_length);
+  EXPECT_EQ(expected_extensions != nullptr, actual_extensions != nullptr);
+  EXPECT_EQ(expected_direction, actual_direction);
+  EXPECT_EQ(expected_total_length, actual_total_length);
+  ASSERT_EQ(expected_header_length, actual_header_length);
+  EXPECT_EQ(0, memcmp(expected_header, actual_header, actual_header_length));
+}
+
+}  // namespace
+
+TEST(RtcEventLogParserTest, MapFileMatchesParseFile) {
+  const std::string file_name = WriteTempFile(CreateLog());
+  ParsedRtcEventLog parsed_log;
+  ASSERT_TRUE(parsed_log.ParseFile(file_name));
+  ParsedRtcEventLog mapped_log;
+  ASSERT_TRUE(mapped_log.MapFile(file_name));
+  remove(file_name.c_str());
+
+  ASSERT_EQ(kNumRtpEvents + 3, parsed_log.GetNumberOfEvents());
+  ASSERT_EQ(parsed_log.GetNumberOfEvents(), mapped_log.GetNumberOfEvents());
+  for (size_t i = 0; i < parsed_log.GetNumberOfEvents(); ++i)
+    ExpectEqualEvent(parsed_log, mapped_log, i);
+  EXPECT_EQ(ParsedRtcEventLog::MediaType::VIDEO,
+            mapped_log.GetMediaType(kRemoteSsrc, kIncomingPacket));
+}
+
+TEST(RtcEventLogParserTest, MapFileRandomAccess) {
+  const std::string file_name = WriteTempFile(CreateLog());
+  ParsedRtcEventLog parsed_log;
+  ASSERT_TRUE(parsed_log.ParseFile(file_name));
+  ParsedRtcEventLog mapped_log;
+  ASSERT_TRUE(mapped_log.MapFile(file_name));
+  remove(file_name.c_str());
+
+  // Backwards, which seeks for every event, and jumping around.
+  for (size_t i = parsed_log.GetNumberOfEvents(); i > 0;
+       i -= std::min<size_t>(i, 37)) {
+    ExpectEqualEvent(parsed_log, mapped_log, i - 1);
+  }
+  Random prng(7);
+  for (int i = 0; i < 100; ++i) {
+    ExpectEqualEvent(parsed_log, mapped_log,
+                     prng.Rand(parsed_log.GetNumberOfEvents() - 1));
+  }
+}
+
+TEST(RtcEventLogParserTest, FindEvent) {
+  const std::string file_name = WriteTempFile(CreateLog());
+  ParsedRtcEventLog parsed_log;
+  ASSERT_TRUE(parsed_log.ParseFile(file_name));
+  ParsedRtcEventLog mapped_log;
+  ASSERT_TRUE(mapped_log.MapFile(file_name));
+  remove(file_name.c_str());
+
+  const size_t num_events = parsed_log.GetNumberOfEvents();
+  const int64_t first_timestamp_us = parsed_log.GetTimestamp(0);
+  const int64_t last_timestamp_us = parsed_log.GetTimestamp(num_events - 1);
+  EXPECT_EQ(0u, parsed_log.FindEvent(first_timestamp_us - 1));
+  EXPECT_EQ(0u, mapped_log.FindEvent(first_timestamp_us - 1));
+  EXPECT_EQ(num_events, parsed_log.FindEvent(last_timestamp_us + 1));
+  EXPECT_EQ(num_events, mapped_log.FindEvent(last_timestamp_us + 1));
+
+  Random prng(11);
+  for (int i = 0; i < 100; ++i) {
+    const int64_t timestamp_us =
+        first_timestamp_us +
+        prng.Rand(static_cast<uint32_t>(last_timestamp_us -
+                                        first_timestamp_us));
+    size_t expected = 0;
+    while (parsed_log.GetTimestamp(expected) < timestamp_us)
+      ++expected;
+    EXPECT_EQ(expected, parsed_log.FindEvent(timestamp_us));
+    EXPECT_EQ(expected, mapped_log.FindEvent(timestamp_us));
+  }
+}
+
+TEST(RtcEventLogParserTest, MapEmptyFile) {
+  const std::string file_name = WriteTempFile("");
+  ParsedRtcEventLog mapped_log;
+  EXPECT_TRUE(mapped_log.MapFile(file_name));
+  EXPECT_EQ(0u, mapped_log.GetNumberOfEvents());
+  EXPECT_EQ(0u, mapped_log.FindEvent(0));
+  remove(file_name.c_str());
+}
+
+TEST(RtcEventLogParserTest, MapTruncatedFile) {
+  const std::string log = CreateLog();
+  const std::string file_name = WriteTempFile(log.substr(0, log.size() - 1));
+  ParsedRtcEventLog mapped_log;
+  EXPECT_FALSE(mapped_log.MapFile(file_name));
+  remove(file_name.c_str());
+}
+
+TEST(RtcEventLogParserTest, MapMissingFile) {
+  ParsedRtcEventLog mapped_log;
+  EXPECT_FALSE(mapped_log.MapFile(test::OutputPath() + "no_such_file.rel"));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,241 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "webrtc/logging/rtc_event_log/rtc_event_log_block.h"
+#include "webrtc/logging/rtc_event_log/rtc_event_log_parser.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/rtc_base/random.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+namespace {
+
+const size_t kNumStreams = 4;
+// Number of events per block, about what fits in the 32 kB blocks written by
+// RtcEventLog.
+const size_t kEventsPerBlock = 1000;
+
+int NumEvents() {
+  return field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 20000 : 500000;
+}
+
+size_t LargeLogSizeBytes() {
+  return field_trial::IsEnabled("WebRTC-QuickPerfTest") ? (32u << 20)
+                                                        : (1u << 30);
+}
+
+// Returns the resident memory of the process that isn't backed by files, so
+// that pages of mapped files are not counted. Returns -1 if unknown.
+int64_t AnonymousMemoryBytes() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    long kilobytes;
+    if (sscanf(line.c_str(), "RssAnon: %ld kB", &kilobytes) == 1)
+      return static_cast<int64_t>(kilobytes) * 1024;
+  }
+  return -1;
+}
+
+// Generates the events of a call with |kNumStreams| RTP streams and periodic
+// RTCP, like an RtcEventLog of an ongoing session.
+std::vector<rtclog::Event> GenerateEvents(size_t num_events) {
+  Random prng(1357);
+  uint16_t sequence_numbers[kNumStreams];
+  uint32_t rtp_timestamps[kNumStreams];
+  uint32_t ssrcs[kNumStreams];
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    sequence_numbers[i] = prng.Rand<uint16_t>();
+    rtp_timestamps[i] = prng.Rand<uint32_t>();
+    ssrcs[i] = prng.Rand<uint32_t>();
+  }
+  std::vector<rtclog::Event> events(num_events);
+  int64_t timestamp_us = prng.Rand<uint32_t>();
+  for (rtclog::Event& event : events) {
+    timestamp_us += prng.Rand(1, 2000);
+    event.set_timestamp_us(timestamp_us);
+    if (prng.Rand(49) == 0) {
+      event.set_type(rtclog::Event::RTCP_EVENT);
+      event.mutable_rtcp_packet()->set_incoming(prng.Rand<bool>());
+      std::string data(prng.Rand(28, 80), 0);
+      for (char& byte : data)
+        byte = static_cast<char>(prng.Rand<uint8_t>());
+      event.mutable_rtcp_packet()->set_packet_data(data);
+      continue;
+    }
+    const size_t stream = prng.Rand(kNumStreams - 1);
+    sequence_numbers[stream]++;
+    rtp_timestamps[stream] += 3000;
+    // A fixed header and a one-byte header extension with a transport
+    // sequence number.
+    uint8_t header[20] = {0x90, 0x60};
+    ByteWriter<uint16_t>::WriteBigEndian(&header[2], sequence_numbers[stream]);
+    ByteWriter<uint32_t>::WriteBigEndian(&header[4], rtp_timestamps[stream]);
+    ByteWriter<uint32_t>::WriteBigEndian(&header[8], ssrcs[stream]);
+    ByteWriter<uint16_t>::WriteBigEndian(&header[12], 0xbede);
+    ByteWriter<uint16_t>::WriteBigEndian(&header[14], 1);
+    header[16] = 0x51;
+    ByteWriter<uint16_t>::WriteBigEndian(&header[17], prng.Rand<uint16_t>());
+    event.set_type(rtclog::Event::RTP_EVENT);
+    event.mutable_rtp_packet()->set_incoming(stream % 2 == 0);
+    event.mutable_rtp_packet()->set_packet_length(prng.Rand(200, 1200));
+    event.mutable_rtp_packet()->set_header(header, sizeof(header));
+  }
+  return events;
+}
+
+void PrintResults(const std::string& label,
+                  size_t num_events,
+                  size_t encoded_size,
+                  int64_t encode_time_ns,
+                  int64_t decode_time_ns) {
+  test::PrintResult("rtc_event_log_size", "", label,
+                    std::to_string(static_cast<double>(encoded_size) /
+                                   num_events),
+                    "bytes/event", true);
+  test::PrintResult("rtc_event_log_encode_time", "", label,
+                    std::to_string(static_cast<double>(encode_time_ns) /
+                                   num_events),
+                    "ns/event", true);
+  test::PrintResult("rtc_event_log_decode_time", "", label,
+                    std::to_string(static_cast<double>(decode_time_ns) /
+                                   num_events),
+                    "ns/event", false);
+}
+
+}  // namespace
+
+// Writes every event as its own EventStream, as RtcEventLog does without
+// event blocks.
+TEST(RtcEventLogPerformanceTest, EventStream) {
+  const std::vector<rtclog::Event> events = GenerateEvents(NumEvents());
+
+  ProtoString output;
+  int64_t start_time_ns = rtc::TimeNanos();
+  for (const rtclog::Event& event : events) {
+    rtclog::EventStream stream;
+    *stream.add_stream() = event;
+    stream.AppendToString(&output);
+  }
+  const int64_t encode_time_ns = rtc::TimeNanos() - start_time_ns;
+
+  start_time_ns = rtc::TimeNanos();
+  rtclog::EventStream parsed;
+  ASSERT_TRUE(parsed.ParseFromString(output));
+  const int64_t decode_time_ns = rtc::TimeNanos() - start_time_ns;
+  EXPECT_EQ(events.size(), static_cast<size_t>(parsed.stream_size()));
+
+  PrintResults("event_stream", events.size(), output.size(), encode_time_ns,
+               decode_time_ns);
+}
+
+TEST(RtcEventLogPerformanceTest, EventBlocks) {
+  const std::vector<rtclog::Event> events = GenerateEvents(NumEvents());
+
+  ProtoString output;
+  RtcEventBlockEncoder encoder;
+  int64_t start_time_ns = rtc::TimeNanos();
+  for (size_t i = 0; i < events.size(); ++i) {
+    encoder.Add(events[i]);
+    if ((i + 1) % kEventsPerBlock == 0 || i + 1 == events.size()) {
+      rtclog::EventStream stream;
+      encoder.Encode(stream.add_stream());
+      stream.AppendToString(&output);
+    }
+  }
+  const int64_t encode_time_ns = rtc::TimeNanos() - start_time_ns;
+
+  start_time_ns = rtc::TimeNanos();
+  rtclog::EventStream parsed;
+  ASSERT_TRUE(parsed.ParseFromString(output));
+  std::vector<rtclog::Event> decoded;
+  decoded.reserve(events.size());
+  for (const rtclog::Event& block : parsed.stream())
+    ASSERT_TRUE(DecodeRtcEventBlock(block, &decoded));
+  const int64_t decode_time_ns = rtc::TimeNanos() - start_time_ns;
+  EXPECT_EQ(events.size(), decoded.size());
+
+  PrintResults("event_blocks", events.size(), output.size(), encode_time_ns,
+               decode_time_ns);
+}
+
+// Maps a log of |LargeLogSizeBytes()| and reads it in order, as the
+// analysis tools do. The memory used must not grow with the size of the log.
+TEST(RtcEventLogPerformanceTest, MapLargeLog) {
+  const std::vector<rtclog::Event> events = GenerateEvents(kEventsPerBlock);
+  ProtoString chunk;
+  for (const rtclog::Event& event : events) {
+    rtclog::EventStream stream;
+    *stream.add_stream() = event;
+    stream.AppendToString(&chunk);
+  }
+  const std::string file_name =
+      test::TempFilename(test::OutputPath(), "rtc_event_log_large");
+  FILE* file = fopen(file_name.c_str(), "wb");
+  ASSERT_TRUE(file);
+  size_t file_size = 0;
+  size_t num_events = 0;
+  while (file_size < LargeLogSizeBytes()) {
+    ASSERT_EQ(chunk.size(), fwrite(chunk.data(), 1, chunk.size(), file));
+    file_size += chunk.size();
+    num_events += events.size();
+  }
+  fclose(file);
+
+  const int64_t memory_before_bytes = AnonymousMemoryBytes();
+  int64_t start_time_ns = rtc::TimeNanos();
+  ParsedRtcEventLog parsed_log;
+  ASSERT_TRUE(parsed_log.MapFile(file_name));
+  const int64_t map_time_ns = rtc::TimeNanos() - start_time_ns;
+  ASSERT_EQ(num_events, parsed_log.GetNumberOfEvents());
+
+  start_time_ns = rtc::TimeNanos();
+  size_t total_length = 0;
+  for (size_t i = 0; i < parsed_log.GetNumberOfEvents(); ++i) {
+    if (parsed_log.GetEventType(i) == ParsedRtcEventLog::RTP_EVENT) {
+      size_t length;
+      parsed_log.GetRtpHeader(i, nullptr, nullptr, nullptr, &length);
+      total_length += length;
+    }
+  }
+  const int64_t read_time_ns = rtc::TimeNanos() - start_time_ns;
+  EXPECT_GT(total_length, 0u);
+  const int64_t memory_after_bytes = AnonymousMemoryBytes();
+  remove(file_name.c_str());
+
+  test::PrintResult("rtc_event_log_map_time", "", "large_log",
+                    std::to_string(static_cast<double>(map_time_ns) /
+                                   rtc::kNumNanosecsPerMillisec),
+                    "ms", true);
+  test::PrintResult("rtc_event_log_read_time", "", "large_log",
+                    std::to_string(static_cast<double>(read_time_ns) /
+                                   num_events),
+                    "ns/event", true);
+  if (memory_before_bytes >= 0 && memory_after_bytes >= 0) {
+    const int64_t memory_bytes = memory_after_bytes - memory_before_bytes;
+    test::PrintResult("rtc_event_log_map_memory", "", "large_log",
+                      std::to_string(memory_bytes / 1024), "kB", true);
+    // The index takes one entry per few thousand events.
+    EXPECT_LT(memory_bytes, 16 << 20);
+  }
+}
+
+}  // namespace webrtc
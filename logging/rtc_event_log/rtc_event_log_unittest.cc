@@ -29,6 +29,7 @@
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/fakeclock.h"
 #include "webrtc/rtc_base/random.h"
+#include "webrtc/test/field_trial.h"
 #include "webrtc/test/gtest.h"
 #include "webrtc/test/testsupport/fileutils.h"
 
@@ -430,6 +431,15 @@ TEST(RtcEventLogTest, LogSessionAndReadBack) {
   }
 }
 
+TEST(RtcEventLogTest, LogSessionAndReadBackWithEventBlocks) {
+  test::ScopedFieldTrials field_trials("WebRTC-EventLogEventBlocks/Enabled/");
+  LogSessionAndReadBack(5, 2, 0, 0, 0, 0, 321);
+
+  const uint32_t extensions = (1u << kNumExtensions) - 1;
+  LogSessionAndReadBack(9, 2, 3, 2, extensions, 2, 2718281828u);
+  LogSessionAndReadBack(200, 40, 30, 20, extensions, 1, 1618033988u);
+}
+
 TEST(RtcEventLogTest, LogEventAndReadBack) {
   Random prng(987654321);
 
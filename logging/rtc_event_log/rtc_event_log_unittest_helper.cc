@@ -176,7 +176,7 @@ void RtcEventLogTestHelper::VerifyVideoReceiveStreamConfig(
     const ParsedRtcEventLog& parsed_log,
     size_t index,
     const rtclog::StreamConfig& config) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   ASSERT_EQ(rtclog::Event::VIDEO_RECEIVER_CONFIG_EVENT, event.type());
   const rtclog::VideoReceiveConfig& receiver_config =
@@ -246,7 +246,7 @@ void RtcEventLogTestHelper::VerifyVideoSendStreamConfig(
     const ParsedRtcEventLog& parsed_log,
     size_t index,
     const rtclog::StreamConfig& config) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   ASSERT_EQ(rtclog::Event::VIDEO_SENDER_CONFIG_EVENT, event.type());
   const rtclog::VideoSendConfig& sender_config = event.video_sender_config();
@@ -287,7 +287,7 @@ void RtcEventLogTestHelper::VerifyAudioReceiveStreamConfig(
     const ParsedRtcEventLog& parsed_log,
     size_t index,
     const rtclog::StreamConfig& config) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   ASSERT_EQ(rtclog::Event::AUDIO_RECEIVER_CONFIG_EVENT, event.type());
   const rtclog::AudioReceiveConfig& receiver_config =
@@ -326,7 +326,7 @@ void RtcEventLogTestHelper::VerifyAudioSendStreamConfig(
     const ParsedRtcEventLog& parsed_log,
     size_t index,
     const rtclog::StreamConfig& config) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   ASSERT_EQ(rtclog::Event::AUDIO_SENDER_CONFIG_EVENT, event.type());
   const rtclog::AudioSendConfig& sender_config = event.audio_sender_config();
@@ -355,7 +355,7 @@ void RtcEventLogTestHelper::VerifyRtpEvent(const ParsedRtcEventLog& parsed_log,
                                            const uint8_t* header,
                                            size_t header_size,
                                            size_t total_size) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   ASSERT_EQ(rtclog::Event::RTP_EVENT, event.type());
   const rtclog::RtpPacket& rtp_packet = event.rtp_packet();
@@ -386,7 +386,7 @@ void RtcEventLogTestHelper::VerifyRtcpEvent(const ParsedRtcEventLog& parsed_log,
                                             PacketDirection direction,
                                             const uint8_t* packet,
                                             size_t total_size) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   ASSERT_EQ(rtclog::Event::RTCP_EVENT, event.type());
   const rtclog::RtcpPacket& rtcp_packet = event.rtcp_packet();
@@ -413,7 +413,7 @@ void RtcEventLogTestHelper::VerifyPlayoutEvent(
     const ParsedRtcEventLog& parsed_log,
     size_t index,
     uint32_t ssrc) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   ASSERT_EQ(rtclog::Event::AUDIO_PLAYOUT_EVENT, event.type());
   const rtclog::AudioPlayoutEvent& playout_event = event.audio_playout_event();
@@ -432,7 +432,7 @@ void RtcEventLogTestHelper::VerifyBweLossEvent(
     int32_t bitrate,
     uint8_t fraction_loss,
     int32_t total_packets) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   ASSERT_EQ(rtclog::Event::LOSS_BASED_BWE_UPDATE, event.type());
   const rtclog::LossBasedBweUpdate& bwe_event = event.loss_based_bwe_update();
@@ -459,7 +459,7 @@ void RtcEventLogTestHelper::VerifyBweDelayEvent(
     size_t index,
     int32_t bitrate,
     BandwidthUsage detector_state) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   ASSERT_EQ(rtclog::Event::DELAY_BASED_BWE_UPDATE, event.type());
   const rtclog::DelayBasedBweUpdate& bwe_event = event.delay_based_bwe_update();
@@ -494,7 +494,7 @@ void RtcEventLogTestHelper::VerifyAudioNetworkAdaptation(
 void RtcEventLogTestHelper::VerifyLogStartEvent(
     const ParsedRtcEventLog& parsed_log,
     size_t index) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   EXPECT_EQ(rtclog::Event::LOG_START, event.type());
 }
@@ -502,7 +502,7 @@ void RtcEventLogTestHelper::VerifyLogStartEvent(
 void RtcEventLogTestHelper::VerifyLogEndEvent(
     const ParsedRtcEventLog& parsed_log,
     size_t index) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   EXPECT_EQ(rtclog::Event::LOG_END, event.type());
 }
@@ -514,7 +514,7 @@ void RtcEventLogTestHelper::VerifyBweProbeCluster(
     uint32_t bitrate_bps,
     uint32_t min_probes,
     uint32_t min_bytes) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   EXPECT_EQ(rtclog::Event::BWE_PROBE_CLUSTER_CREATED_EVENT, event.type());
 
@@ -536,7 +536,7 @@ void RtcEventLogTestHelper::VerifyProbeResultSuccess(
     size_t index,
     uint32_t id,
     uint32_t bitrate_bps) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   EXPECT_EQ(rtclog::Event::BWE_PROBE_RESULT_EVENT, event.type());
 
@@ -556,7 +556,7 @@ void RtcEventLogTestHelper::VerifyProbeResultFailure(
     size_t index,
     uint32_t id,
     ProbeFailureReason failure_reason) {
-  const rtclog::Event& event = parsed_log.events_[index];
+  const rtclog::Event& event = parsed_log.GetEvent(index);
   ASSERT_TRUE(IsValidBasicEvent(event));
   EXPECT_EQ(rtclog::Event::BWE_PROBE_RESULT_EVENT, event.type());
 
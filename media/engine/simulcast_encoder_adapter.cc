@@ -20,9 +20,13 @@
 #include "webrtc/modules/video_coding/codecs/vp8/simulcast_rate_allocator.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 
 namespace {
 
+const char kParallelEncodingFieldTrial[] =
+    "WebRTC-SimulcastEncoderAdapter-ParallelEncoding";
+
 const unsigned int kDefaultMinQp = 2;
 const unsigned int kDefaultMaxQp = 56;
 // Max qp for lowest spatial resolution when doing simulcast.
@@ -126,12 +130,29 @@ class TemporalLayersFactoryAdapter : public webrtc::TemporalLayersFactory {
 
 namespace webrtc {
 
+SimulcastEncoderAdapter::DeferredEncodedImage::DeferredEncodedImage(
+    size_t stream_idx,
+    const EncodedImage& encoded_image,
+    const CodecSpecificInfo& codec_specific_info,
+    const RTPFragmentationHeader* fragmentation)
+    : stream_idx(stream_idx),
+      encoded_image(encoded_image),
+      codec_specific_info(codec_specific_info) {
+  if (fragmentation) {
+    this->fragmentation.reset(new RTPFragmentationHeader());
+    this->fragmentation->CopyFrom(*fragmentation);
+  }
+}
+
 SimulcastEncoderAdapter::SimulcastEncoderAdapter(
     cricket::WebRtcVideoEncoderFactory* factory)
     : inited_(0),
+      parallel_encoding_(
+          webrtc::field_trial::IsEnabled(kParallelEncodingFieldTrial)),
       factory_(factory),
       encoded_complete_callback_(nullptr),
-      implementation_name_("SimulcastEncoderAdapter") {
+      implementation_name_("SimulcastEncoderAdapter"),
+      defer_encoded_images_(0) {
   // The adapter is typically created on the worker thread, but operated on
   // the encoder task queue.
   encoder_queue_.Detach();
@@ -157,6 +178,8 @@ int SimulcastEncoderAdapter::Release() {
     streaminfos_.pop_back();  // Deletes callback adapter.
     stored_encoders_.push(encoder);
   }
+  for (I420BufferPool& buffer_pool : buffer_pools_)
+    buffer_pool.Release();
 
   // It's legal to move the encoder to another queue now.
   encoder_queue_.Detach();
@@ -270,6 +293,16 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
   // To save memory, don't store encoders that we don't use.
   DestroyStoredEncoders();
 
+  const size_t num_worker_threads =
+      parallel_encoding_ && doing_simulcast ? number_of_streams - 1 : 0;
+  if (num_worker_threads == 0) {
+    worker_pool_.reset();
+  } else if (!worker_pool_ ||
+             worker_pool_->num_threads() != num_worker_threads) {
+    worker_pool_.reset(
+        new rtc::WorkerPool(num_worker_threads, "SimulcastEncoder"));
+  }
+
   rtc::AtomicOps::ReleaseStore(&inited_, 1);
 
   return WEBRTC_VIDEO_CODEC_OK;
@@ -307,69 +340,130 @@ int SimulcastEncoderAdapter::Encode(
     }
   }
 
-  int src_width = input_image.width();
-  int src_height = input_image.height();
-  for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
+  const std::vector<FrameType> stream_frame_types(
+      1, send_key_frame ? kVideoFrameKey : kVideoFrameDelta);
+  const int src_width = input_image.width();
+  const int src_height = input_image.height();
+
+  // Streams to encode, in stream order, with their scaled input. A null
+  // buffer means that the input image is passed on directly: either the
+  // input resolution matches the destination, or the input image is empty
+  // (e.g. a keyframe request for encoders with internal camera sources) or
+  // has a native handle.
+  // For texture frames, the underlying encoder is expected to be able to
+  // correctly sample/scale the source texture.
+  // TODO(perkj): ensure that works going forward, and figure out how this
+  // affects webrtc:5683.
+  std::vector<size_t> active_streams;
+  std::vector<rtc::scoped_refptr<I420Buffer>> scaled_buffers(
+      streaminfos_.size());
+  const bool native_input = input_image.video_frame_buffer()->type() ==
+                            VideoFrameBuffer::Type::kNative;
+  rtc::scoped_refptr<I420BufferInterface> scale_source;
+  // Going from the highest resolution down lets the parallel mode scale each
+  // stream from the next larger one, which is cheaper than scaling every
+  // stream from the full resolution input.
+  for (size_t stream_idx = streaminfos_.size(); stream_idx-- > 0;) {
     // Don't encode frames in resolutions that we don't intend to send.
     if (!streaminfos_[stream_idx].send_stream) {
       continue;
     }
-
-    std::vector<FrameType> stream_frame_types;
-    if (send_key_frame) {
-      stream_frame_types.push_back(kVideoFrameKey);
-      streaminfos_[stream_idx].key_frame_request = false;
-    } else {
-      stream_frame_types.push_back(kVideoFrameDelta);
+    active_streams.insert(active_streams.begin(), stream_idx);
+    if ((streaminfos_[stream_idx].width == src_width &&
+         streaminfos_[stream_idx].height == src_height) ||
+        native_input) {
+      continue;
     }
-
-    int dst_width = streaminfos_[stream_idx].width;
-    int dst_height = streaminfos_[stream_idx].height;
-    // If scaling isn't required, because the input resolution
-    // matches the destination or the input image is empty (e.g.
-    // a keyframe request for encoders with internal camera
-    // sources) or the source image has a native handle, pass the image on
-    // directly. Otherwise, we'll scale it to match what the encoder expects
-    // (below).
-    // For texture frames, the underlying encoder is expected to be able to
-    // correctly sample/scale the source texture.
-    // TODO(perkj): ensure that works going forward, and figure out how this
-    // affects webrtc:5683.
-    if ((dst_width == src_width && dst_height == src_height) ||
-        input_image.video_frame_buffer()->type() ==
-            VideoFrameBuffer::Type::kNative) {
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          input_image, codec_specific_info, &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
-      }
-    } else {
-      rtc::scoped_refptr<I420Buffer> dst_buffer =
-          I420Buffer::Create(dst_width, dst_height);
-      rtc::scoped_refptr<I420BufferInterface> src_buffer =
-          input_image.video_frame_buffer()->ToI420();
-      libyuv::I420Scale(src_buffer->DataY(), src_buffer->StrideY(),
-                        src_buffer->DataU(), src_buffer->StrideU(),
-                        src_buffer->DataV(), src_buffer->StrideV(), src_width,
-                        src_height, dst_buffer->MutableDataY(),
-                        dst_buffer->StrideY(), dst_buffer->MutableDataU(),
-                        dst_buffer->StrideU(), dst_buffer->MutableDataV(),
-                        dst_buffer->StrideV(), dst_width, dst_height,
-                        libyuv::kFilterBilinear);
-
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          VideoFrame(dst_buffer, input_image.timestamp(),
-                     input_image.render_time_ms(), webrtc::kVideoRotation_0),
-          codec_specific_info, &stream_frame_types);
+    if (!scale_source)
+      scale_source = input_image.video_frame_buffer()->ToI420();
+    scaled_buffers[stream_idx] = ScaleForStream(stream_idx, *scale_source);
+    if (parallel_encoding_)
+      scale_source = scaled_buffers[stream_idx];
+  }
+
+  if (!worker_pool_ || active_streams.size() < 2) {
+    for (size_t stream_idx : active_streams) {
+      int ret = EncodeStream(stream_idx, input_image,
+                             scaled_buffers[stream_idx], codec_specific_info,
+                             stream_frame_types);
       if (ret != WEBRTC_VIDEO_CODEC_OK) {
         return ret;
       }
     }
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  std::vector<int> results(active_streams.size(), WEBRTC_VIDEO_CODEC_OK);
+  rtc::AtomicOps::ReleaseStore(&defer_encoded_images_, 1);
+  worker_pool_->ParallelFor(active_streams.size(), [&](size_t i) {
+    results[i] = EncodeStream(active_streams[i], input_image,
+                              scaled_buffers[active_streams[i]],
+                              codec_specific_info, stream_frame_types);
+  });
+  rtc::AtomicOps::ReleaseStore(&defer_encoded_images_, 0);
+
+  std::vector<DeferredEncodedImage> deferred_images;
+  {
+    rtc::CritScope lock(&deferred_images_crit_);
+    deferred_images.swap(deferred_images_);
+  }
+  // Rejoin the streams in the order the sequential mode would produce them.
+  for (size_t stream_idx : active_streams) {
+    for (const DeferredEncodedImage& image : deferred_images) {
+      if (image.stream_idx != stream_idx)
+        continue;
+      DeliverEncodedImage(stream_idx, image.encoded_image,
+                          &image.codec_specific_info,
+                          image.fragmentation.get());
+    }
   }
 
+  for (int ret : results) {
+    if (ret != WEBRTC_VIDEO_CODEC_OK) {
+      return ret;
+    }
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+rtc::scoped_refptr<I420Buffer> SimulcastEncoderAdapter::ScaleForStream(
+    size_t stream_idx,
+    const I420BufferInterface& source) {
+  const int dst_width = streaminfos_[stream_idx].width;
+  const int dst_height = streaminfos_[stream_idx].height;
+  rtc::scoped_refptr<I420Buffer> dst_buffer =
+      buffer_pools_[stream_idx].CreateBuffer(dst_width, dst_height);
+  if (!dst_buffer)
+    dst_buffer = I420Buffer::Create(dst_width, dst_height);
+  libyuv::I420Scale(source.DataY(), source.StrideY(), source.DataU(),
+                    source.StrideU(), source.DataV(), source.StrideV(),
+                    source.width(), source.height(), dst_buffer->MutableDataY(),
+                    dst_buffer->StrideY(), dst_buffer->MutableDataU(),
+                    dst_buffer->StrideU(), dst_buffer->MutableDataV(),
+                    dst_buffer->StrideV(), dst_width, dst_height,
+                    libyuv::kFilterBilinear);
+  return dst_buffer;
+}
+
+int SimulcastEncoderAdapter::EncodeStream(
+    size_t stream_idx,
+    const VideoFrame& input_image,
+    const rtc::scoped_refptr<I420Buffer>& scaled_buffer,
+    const CodecSpecificInfo* codec_specific_info,
+    const std::vector<FrameType>& frame_types) {
+  StreamInfo& stream_info = streaminfos_[stream_idx];
+  if (frame_types[0] == kVideoFrameKey)
+    stream_info.key_frame_request = false;
+  if (!scaled_buffer) {
+    return stream_info.encoder->Encode(input_image, codec_specific_info,
+                                       &frame_types);
+  }
+  return stream_info.encoder->Encode(
+      VideoFrame(scaled_buffer, input_image.timestamp(),
+                 input_image.render_time_ms(), webrtc::kVideoRotation_0),
+      codec_specific_info, &frame_types);
+}
+
 int SimulcastEncoderAdapter::RegisterEncodeCompleteCallback(
     EncodedImageCallback* callback) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&encoder_queue_);
@@ -447,6 +541,23 @@ EncodedImageCallback::Result SimulcastEncoderAdapter::OnEncodedImage(
     const EncodedImage& encodedImage,
     const CodecSpecificInfo* codecSpecificInfo,
     const RTPFragmentationHeader* fragmentation) {
+  if (rtc::AtomicOps::AcquireLoad(&defer_encoded_images_)) {
+    // Called on a worker thread during a parallel Encode(), which delivers
+    // the images once all streams are done.
+    rtc::CritScope lock(&deferred_images_crit_);
+    deferred_images_.emplace_back(stream_idx, encodedImage, *codecSpecificInfo,
+                                  fragmentation);
+    return EncodedImageCallback::Result(EncodedImageCallback::Result::OK);
+  }
+  return DeliverEncodedImage(stream_idx, encodedImage, codecSpecificInfo,
+                             fragmentation);
+}
+
+EncodedImageCallback::Result SimulcastEncoderAdapter::DeliverEncodedImage(
+    size_t stream_idx,
+    const EncodedImage& encodedImage,
+    const CodecSpecificInfo* codecSpecificInfo,
+    const RTPFragmentationHeader* fragmentation) {
   CodecSpecificInfo stream_codec_specific = *codecSpecificInfo;
   stream_codec_specific.codec_name = implementation_name_.c_str();
   CodecSpecificInfoVP8* vp8Info = &(stream_codec_specific.codecSpecific.VP8);
@@ -518,6 +629,17 @@ bool SimulcastEncoderAdapter::SupportsNativeHandle() const {
   return true;
 }
 
+bool SimulcastEncoderAdapter::SupportsNV12() const {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&encoder_queue_);
+  RTC_DCHECK(!streaminfos_.empty());
+  for (const auto& streaminfo : streaminfos_) {
+    if (!streaminfo.encoder->SupportsNV12()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 VideoEncoder::ScalingSettings SimulcastEncoderAdapter::GetScalingSettings()
     const {
   // TODO(brandtr): Investigate why the sequence checker below fails on mac.
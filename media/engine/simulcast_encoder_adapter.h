@@ -18,10 +18,14 @@
 #include <utility>
 #include <vector>
 
+#include "webrtc/common_video/include/i420_buffer_pool.h"
 #include "webrtc/media/engine/webrtcvideoencoderfactory.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
 #include "webrtc/rtc_base/atomicops.h"
+#include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/sequenced_task_checker.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+#include "webrtc/rtc_base/worker_pool.h"
 
 namespace webrtc {
 
@@ -31,6 +35,12 @@ class SimulcastRateAllocator;
 // webrtc::VideoEncoder instances with the given VideoEncoderFactory.
 // The object is created and destroyed on the worker thread, but all public
 // interfaces should be called from the encoder task queue.
+//
+// With the "WebRTC-SimulcastEncoderAdapter-ParallelEncoding" field trial,
+// each stream is scaled from the next larger one instead of from the input,
+// and the streams are encoded concurrently on a pool of worker threads. The
+// encoded images are then delivered in stream order from Encode(), on the
+// encoder task queue.
 class SimulcastEncoderAdapter : public VP8Encoder {
  public:
   explicit SimulcastEncoderAdapter(cricket::WebRtcVideoEncoderFactory* factory);
@@ -61,6 +71,7 @@ class SimulcastEncoderAdapter : public VP8Encoder {
   VideoEncoder::ScalingSettings GetScalingSettings() const override;
 
   bool SupportsNativeHandle() const override;
+  bool SupportsNV12() const override;
   const char* ImplementationName() const override;
 
  private:
@@ -85,6 +96,20 @@ class SimulcastEncoderAdapter : public VP8Encoder {
     bool send_stream;
   };
 
+  // Copy of an encoded image that is held back until all streams of a
+  // parallel Encode() call are done. The payload buffer itself is not copied;
+  // it stays valid until the next Encode() call on the same encoder.
+  struct DeferredEncodedImage {
+    DeferredEncodedImage(size_t stream_idx,
+                         const EncodedImage& encoded_image,
+                         const CodecSpecificInfo& codec_specific_info,
+                         const RTPFragmentationHeader* fragmentation);
+    size_t stream_idx;
+    EncodedImage encoded_image;
+    CodecSpecificInfo codec_specific_info;
+    std::unique_ptr<RTPFragmentationHeader> fragmentation;
+  };
+
   // Populate the codec settings for each simulcast stream.
   static void PopulateStreamCodec(const webrtc::VideoCodec& inst,
                                   int stream_index,
@@ -96,7 +121,28 @@ class SimulcastEncoderAdapter : public VP8Encoder {
 
   void DestroyStoredEncoders();
 
+  // Scales |source| into a buffer from the pool of |stream_idx|.
+  rtc::scoped_refptr<I420Buffer> ScaleForStream(
+      size_t stream_idx,
+      const I420BufferInterface& source);
+
+  // Encodes |input_image|, or |scaled_buffer| if not null, on stream
+  // |stream_idx|.
+  int EncodeStream(size_t stream_idx,
+                   const VideoFrame& input_image,
+                   const rtc::scoped_refptr<I420Buffer>& scaled_buffer,
+                   const CodecSpecificInfo* codec_specific_info,
+                   const std::vector<FrameType>& frame_types);
+
+  // Forwards |encoded_image| to |encoded_complete_callback_|.
+  EncodedImageCallback::Result DeliverEncodedImage(
+      size_t stream_idx,
+      const EncodedImage& encoded_image,
+      const CodecSpecificInfo* codec_specific_info,
+      const RTPFragmentationHeader* fragmentation);
+
   volatile int inited_;  // Accessed atomically.
+  const bool parallel_encoding_;
   cricket::WebRtcVideoEncoderFactory* const factory_;
   VideoCodec codec_;
   std::vector<StreamInfo> streaminfos_;
@@ -109,6 +155,20 @@ class SimulcastEncoderAdapter : public VP8Encoder {
   // Store encoders in between calls to Release and InitEncode, so they don't
   // have to be recreated. Remaining encoders are destroyed by the destructor.
   std::stack<VideoEncoder*> stored_encoders_;
+
+  // Scaled input frames, one pool per stream since the pools only keep
+  // buffers of a single resolution.
+  I420BufferPool buffer_pools_[kMaxSimulcastStreams];
+
+  // Only created in parallel encoding mode when doing simulcast; the encoder
+  // task queue encodes one of the streams itself.
+  std::unique_ptr<rtc::WorkerPool> worker_pool_;
+  // Set while the worker pool runs, when encoded images are collected in
+  // |deferred_images_| instead of being delivered right away.
+  volatile int defer_encoded_images_;  // Accessed atomically.
+  rtc::CriticalSection deferred_images_crit_;
+  std::vector<DeferredEncodedImage> deferred_images_
+      GUARDED_BY(deferred_images_crit_);
 };
 
 }  // namespace webrtc
@@ -0,0 +1,212 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/media/engine/simulcast_encoder_adapter.h"
+#include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/modules/video_coding/codecs/vp8/temporal_layers.h"
+#include "webrtc/modules/video_coding/include/video_codec_interface.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/system_wrappers/include/field_trial_default.h"
+#include "webrtc/test/field_trial.h"
+#include "webrtc/test/frame_generator.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kFramerate = 30;
+const int kNumStreams = 3;
+
+// The resolution of the top stream, and the bitrates of the three streams,
+// lowest first. Each lower stream has half the width and height.
+struct SimulcastResolution {
+  int width;
+  int height;
+  int max_bitrates_kbps[kNumStreams];
+  int min_bitrates_kbps[kNumStreams];
+};
+
+const SimulcastResolution k1080p = {1920, 1080, {300, 900, 2500},
+                                    {50, 200, 900}};
+const SimulcastResolution k720p = {1280, 720, {150, 600, 1800},
+                                   {30, 150, 600}};
+
+class Vp8EncoderFactory : public cricket::WebRtcVideoEncoderFactory {
+ public:
+  Vp8EncoderFactory() {
+    supported_codecs_.push_back(cricket::VideoCodec("VP8"));
+  }
+
+  const std::vector<cricket::VideoCodec>& supported_codecs() const override {
+    return supported_codecs_;
+  }
+
+  VideoEncoder* CreateVideoEncoder(const cricket::VideoCodec& codec) override {
+    return VP8Encoder::Create();
+  }
+
+  void DestroyVideoEncoder(VideoEncoder* encoder) override { delete encoder; }
+
+ private:
+  std::vector<cricket::VideoCodec> supported_codecs_;
+};
+
+class CountingCallback : public EncodedImageCallback {
+ public:
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info,
+                        const RTPFragmentationHeader* fragmentation) override {
+    ++num_encoded_images_;
+    return Result(Result::OK, encoded_image._timeStamp);
+  }
+
+  int num_encoded_images() const { return num_encoded_images_; }
+
+ private:
+  int num_encoded_images_ = 0;
+};
+
+VideoCodec CreateCodec(const SimulcastResolution& resolution,
+                       TemporalLayersFactory* tl_factory) {
+  VideoCodec codec;
+  codec.codecType = kVideoCodecVP8;
+  strncpy(codec.plName, "VP8", 4);
+  codec.plType = 120;
+  codec.width = resolution.width;
+  codec.height = resolution.height;
+  codec.maxFramerate = kFramerate;
+  codec.minBitrate = resolution.min_bitrates_kbps[0];
+  codec.maxBitrate = 0;
+  codec.qpMax = 56;
+  codec.numberOfSimulcastStreams = kNumStreams;
+  int start_bitrate_kbps = 0;
+  for (int i = 0; i < kNumStreams; ++i) {
+    SimulcastStream& stream = codec.simulcastStream[i];
+    const int scale = 1 << (kNumStreams - 1 - i);
+    stream.width = resolution.width / scale;
+    stream.height = resolution.height / scale;
+    stream.numberOfTemporalLayers = 1;
+    stream.maxBitrate = resolution.max_bitrates_kbps[i];
+    stream.targetBitrate = resolution.max_bitrates_kbps[i];
+    stream.minBitrate = resolution.min_bitrates_kbps[i];
+    stream.qpMax = 56;
+    start_bitrate_kbps += resolution.max_bitrates_kbps[i];
+  }
+  // Enough to send all streams from the start.
+  codec.startBitrate = start_bitrate_kbps;
+  *codec.VP8() = VideoEncoder::GetDefaultVp8Settings();
+  codec.VP8()->tl_factory = tl_factory;
+  // Every frame should come out on every stream.
+  codec.VP8()->frameDroppingOn = false;
+  return codec;
+}
+
+// Encodes |num_frames| frames through a three stream SimulcastEncoderAdapter
+// and reports the time spent in each Encode() call, i.e. from the input frame
+// to all encoded streams having been delivered.
+void RunEncodeLatencyTest(const SimulcastResolution& resolution,
+                          bool parallel_encoding,
+                          int num_cores,
+                          int num_frames) {
+  Vp8EncoderFactory factory;
+  std::unique_ptr<SimulcastEncoderAdapter> adapter;
+  {
+    // The adapter picks its mode at construction.
+    std::string trials = field_trial::GetFieldTrialString();
+    if (parallel_encoding)
+      trials += "WebRTC-SimulcastEncoderAdapter-ParallelEncoding/Enabled/";
+    test::ScopedFieldTrials field_trials(trials);
+    adapter.reset(new SimulcastEncoderAdapter(&factory));
+  }
+  TemporalLayersFactory tl_factory;
+  const VideoCodec codec = CreateCodec(resolution, &tl_factory);
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            adapter->InitEncode(&codec, num_cores, 1200));
+  CountingCallback callback;
+  adapter->RegisterEncodeCompleteCallback(&callback);
+
+  std::unique_ptr<test::FrameGenerator> frame_generator =
+      test::FrameGenerator::CreateSquareGenerator(resolution.width,
+                                                  resolution.height);
+  std::vector<FrameType> frame_types(1, kVideoFrameKey);
+  std::vector<int64_t> latencies_us;
+  for (int i = 0; i < num_frames; ++i) {
+    VideoFrame* frame = frame_generator->NextFrame();
+    frame->set_timestamp(90000 * i / kFramerate);
+    const int64_t start_time_us = rtc::TimeMicros();
+    ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              adapter->Encode(*frame, nullptr, &frame_types));
+    latencies_us.push_back(rtc::TimeMicros() - start_time_us);
+    frame_types[0] = kVideoFrameDelta;
+  }
+  EXPECT_EQ(0, adapter->Release());
+  EXPECT_EQ(num_frames * kNumStreams, callback.num_encoded_images());
+
+  int64_t total_latency_us = 0;
+  for (int64_t latency_us : latencies_us)
+    total_latency_us += latency_us;
+  std::sort(latencies_us.begin(), latencies_us.end());
+  const std::string label =
+      std::to_string(resolution.height) + "p_" +
+      (parallel_encoding ? "parallel" : "sequential") + "_" +
+      std::to_string(num_cores) + "_cores";
+  test::PrintResult("simulcast_encode_latency", "", label,
+                    std::to_string(static_cast<double>(total_latency_us) /
+                                   (num_frames * 1000)),
+                    "ms", true);
+  test::PrintResult(
+      "simulcast_encode_latency_p95", "", label,
+      std::to_string(latencies_us[latencies_us.size() * 95 / 100] / 1000.0),
+      "ms", false);
+}
+
+}  // namespace
+
+// Parameterized on the number of cores.
+class SimulcastEncoderAdapterPerformanceTest
+    : public ::testing::TestWithParam<int> {
+ protected:
+  int NumFrames() const {
+    return field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 30 : 600;
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(NumCores,
+                        SimulcastEncoderAdapterPerformanceTest,
+                        ::testing::Values(1, 4));
+
+// 1920x1080, 960x540 and 480x270.
+TEST_P(SimulcastEncoderAdapterPerformanceTest, Sequential1080p) {
+  RunEncodeLatencyTest(k1080p, false, GetParam(), NumFrames());
+}
+
+TEST_P(SimulcastEncoderAdapterPerformanceTest, Parallel1080p) {
+  RunEncodeLatencyTest(k1080p, true, GetParam(), NumFrames());
+}
+
+// 1280x720, 640x360 and 320x180.
+TEST_P(SimulcastEncoderAdapterPerformanceTest, Sequential720p) {
+  RunEncodeLatencyTest(k720p, false, GetParam(), NumFrames());
+}
+
+TEST_P(SimulcastEncoderAdapterPerformanceTest, Parallel720p) {
+  RunEncodeLatencyTest(k720p, true, GetParam(), NumFrames());
+}
+
+}  // namespace webrtc
@@ -16,6 +16,8 @@
 #include "webrtc/media/engine/simulcast_encoder_adapter.h"
 #include "webrtc/modules/video_coding/codecs/vp8/simulcast_test_utility.h"
 #include "webrtc/modules/video_coding/include/video_codec_interface.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+#include "webrtc/test/field_trial.h"
 #include "webrtc/test/gmock.h"
 
 namespace webrtc {
@@ -110,6 +112,37 @@ TEST_F(TestSimulcastEncoderAdapter, TestSpatioTemporalLayers321PatternEncoder) {
   TestVp8Simulcast::TestSpatioTemporalLayers321PatternEncoder();
 }
 
+// Runs the adapter with per-stream encoding on a worker pool and cascaded
+// scaling.
+class TestSimulcastEncoderAdapterParallel : public TestSimulcastEncoderAdapter {
+ protected:
+  VP8Encoder* CreateEncoder() override {
+    test::ScopedFieldTrials field_trials(
+        "WebRTC-SimulcastEncoderAdapter-ParallelEncoding/Enabled/");
+    return TestSimulcastEncoderAdapter::CreateEncoder();
+  }
+};
+
+TEST_F(TestSimulcastEncoderAdapterParallel, TestKeyFrameRequestsOnAllStreams) {
+  TestVp8Simulcast::TestKeyFrameRequestsOnAllStreams();
+}
+
+TEST_F(TestSimulcastEncoderAdapterParallel, TestSendAllStreams) {
+  TestVp8Simulcast::TestSendAllStreams();
+}
+
+TEST_F(TestSimulcastEncoderAdapterParallel, TestDisablingStreams) {
+  TestVp8Simulcast::TestDisablingStreams();
+}
+
+TEST_F(TestSimulcastEncoderAdapterParallel, TestSwitchingToOneStream) {
+  TestVp8Simulcast::TestSwitchingToOneStream();
+}
+
+TEST_F(TestSimulcastEncoderAdapterParallel, TestStrideEncodeDecode) {
+  TestVp8Simulcast::TestStrideEncodeDecode();
+}
+
 class MockVideoEncoder : public VideoEncoder {
  public:
   // TODO(nisse): Valid overrides commented out, because the gmock
@@ -283,6 +316,8 @@ class TestSimulcastEncoderAdapterFake : public ::testing::Test,
     if (codec_specific_info) {
       last_encoded_image_simulcast_index_ =
           codec_specific_info->codecSpecific.VP8.simulcastIdx;
+      encoded_simulcast_indices_.push_back(
+          last_encoded_image_simulcast_index_);
     }
     return Result(Result::OK, encoded_image._timeStamp);
   }
@@ -388,6 +423,7 @@ class TestSimulcastEncoderAdapterFake : public ::testing::Test,
   int last_encoded_image_width_;
   int last_encoded_image_height_;
   int last_encoded_image_simulcast_index_;
+  std::vector<int> encoded_simulcast_indices_;
   TemporalLayersFactory tl_factory_;
   std::unique_ptr<SimulcastRateAllocator> rate_allocator_;
 };
@@ -820,5 +856,44 @@ TEST_F(TestSimulcastEncoderAdapterFake, TestInitFailureCleansUpEncoders) {
   EXPECT_TRUE(helper_->factory()->encoders().empty());
 }
 
+TEST_F(TestSimulcastEncoderAdapterFake,
+       ParallelEncodingScalesAndDeliversInStreamOrder) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-SimulcastEncoderAdapter-ParallelEncoding/Enabled/");
+  adapter_.reset();
+  helper_.reset(new TestSimulcastEncoderAdapterFakeHelper());
+  adapter_.reset(helper_->CreateMockEncoderAdapter());
+  SetupCodec();
+  adapter_->SetRateAllocation(rate_allocator_->GetAllocation(3000000, 30), 30);
+
+  std::vector<MockVideoEncoder*> encoders = helper_->factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+  for (size_t i = 0; i < encoders.size(); ++i) {
+    MockVideoEncoder* encoder = encoders[i];
+    // The lowest stream finishes last, so that the images would arrive out of
+    // order if they were not held back until all streams are done.
+    const int delay_ms = static_cast<int>(encoders.size() - i) * 10;
+    EXPECT_CALL(*encoder, Encode(_, _, _))
+        .WillOnce(::testing::Invoke(
+            [encoder, delay_ms](const VideoFrame& frame,
+                                const CodecSpecificInfo* codec_specific_info,
+                                const std::vector<FrameType>* frame_types) {
+              EXPECT_EQ(encoder->codec().width, frame.width());
+              EXPECT_EQ(encoder->codec().height, frame.height());
+              SleepMs(delay_ms);
+              encoder->SendEncodedImage(frame.width(), frame.height());
+              return WEBRTC_VIDEO_CODEC_OK;
+            }));
+  }
+
+  rtc::scoped_refptr<I420Buffer> input_buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  input_buffer->InitializeData();
+  VideoFrame input_frame(input_buffer, 0, 0, webrtc::kVideoRotation_0);
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  EXPECT_EQ(0, adapter_->Encode(input_frame, nullptr, &frame_types));
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), encoded_simulcast_indices_);
+}
+
 }  // namespace testing
 }  // namespace webrtc
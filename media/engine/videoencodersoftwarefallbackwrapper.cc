@@ -128,6 +128,16 @@ int32_t VideoEncoderSoftwareFallbackWrapper::Encode(
                       << "dropping one frame.";
       return WEBRTC_VIDEO_CODEC_ERROR;
     }
+    if (frame.video_frame_buffer()->type() == VideoFrameBuffer::Type::kNV12 &&
+        !fallback_encoder_->SupportsNV12()) {
+      VideoFrame converted_frame(frame.video_frame_buffer()->ToI420(),
+                                 frame.timestamp(), frame.render_time_ms(),
+                                 frame.rotation());
+      if (frame.has_update_rects())
+        converted_frame.set_update_rects(frame.update_rects());
+      return fallback_encoder_->Encode(converted_frame, codec_specific_info,
+                                       frame_types);
+    }
 
     // Fallback was successful, so start using it with this frame.
     return fallback_encoder_->Encode(frame, codec_specific_info, frame_types);
@@ -165,6 +175,12 @@ bool VideoEncoderSoftwareFallbackWrapper::SupportsNativeHandle() const {
   return encoder_->SupportsNativeHandle();
 }
 
+bool VideoEncoderSoftwareFallbackWrapper::SupportsNV12() const {
+  if (fallback_encoder_)
+    return fallback_encoder_->SupportsNV12();
+  return encoder_->SupportsNV12();
+}
+
 VideoEncoder::ScalingSettings
 VideoEncoderSoftwareFallbackWrapper::GetScalingSettings() const {
   return encoder_->GetScalingSettings();
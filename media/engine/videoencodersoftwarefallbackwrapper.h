@@ -43,6 +43,7 @@ class VideoEncoderSoftwareFallbackWrapper : public VideoEncoder {
   int32_t SetRateAllocation(const BitrateAllocation& bitrate_allocation,
                             uint32_t framerate) override;
   bool SupportsNativeHandle() const override;
+  bool SupportsNV12() const override;
   ScalingSettings GetScalingSettings() const override;
   const char *ImplementationName() const override;
 
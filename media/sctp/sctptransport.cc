@@ -443,6 +443,21 @@ bool SctpTransport::Start(int local_sctp_port, int remote_sctp_port) {
   return true;
 }
 
+bool SctpTransport::SetBufferSizes(int send_buffer_size,
+                                   int receive_buffer_size) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  RTC_DCHECK_GE(send_buffer_size, 0);
+  RTC_DCHECK_GE(receive_buffer_size, 0);
+  if (sock_) {
+    LOG(LS_WARNING) << debug_name_ << "->SetBufferSizes(...): "
+                    << "Can't change buffer sizes after the socket is created.";
+    return false;
+  }
+  send_buffer_size_ = send_buffer_size;
+  receive_buffer_size_ = receive_buffer_size;
+  return true;
+}
+
 bool SctpTransport::OpenStream(int sid) {
   RTC_DCHECK_RUN_ON(network_thread_);
   if (sid > kMaxSctpSid) {
@@ -652,11 +667,14 @@ bool SctpTransport::OpenSctpSocket() {
   // If kSendBufferSize isn't reflective of reality, we log an error, but we
   // still have to do something reasonable here.  Look up what the buffer's
   // real size is and set our threshold to something reasonable.
-  static const int kSendThreshold = usrsctp_sysctl_get_sctp_sendspace() / 2;
+  static const int kDefaultSendThreshold =
+      usrsctp_sysctl_get_sctp_sendspace() / 2;
+  const int send_threshold =
+      send_buffer_size_ > 0 ? send_buffer_size_ / 2 : kDefaultSendThreshold;
 
   sock_ = usrsctp_socket(
       AF_CONN, SOCK_STREAM, IPPROTO_SCTP, &UsrSctpWrapper::OnSctpInboundPacket,
-      &UsrSctpWrapper::SendThresholdCallback, kSendThreshold, this);
+      &UsrSctpWrapper::SendThresholdCallback, send_threshold, this);
   if (!sock_) {
     LOG_ERRNO(LS_ERROR) << debug_name_ << "->OpenSctpSocket(): "
                         << "Failed to create SCTP socket.";
@@ -700,6 +718,23 @@ bool SctpTransport::ConfigureSctpSocket() {
     return false;
   }
 
+  // The buffer sizes have to be set before connecting, since the receive
+  // buffer determines the window advertised in the INIT chunk.
+  if (send_buffer_size_ > 0 &&
+      usrsctp_setsockopt(sock_, SOL_SOCKET, SO_SNDBUF, &send_buffer_size_,
+                         sizeof(send_buffer_size_))) {
+    LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                        << "Failed to set SO_SNDBUF.";
+    return false;
+  }
+  if (receive_buffer_size_ > 0 &&
+      usrsctp_setsockopt(sock_, SOL_SOCKET, SO_RCVBUF, &receive_buffer_size_,
+                         sizeof(receive_buffer_size_))) {
+    LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                        << "Failed to set SO_RCVBUF.";
+    return false;
+  }
+
   // Enable stream ID resets.
   struct sctp_assoc_value stream_rst;
   stream_rst.assoc_id = SCTP_ALL_ASSOC;
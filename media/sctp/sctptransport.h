@@ -83,6 +83,14 @@ class SctpTransport : public SctpTransportInternal,
     debug_name_ = debug_name;
   }
 
+  // Sets the sizes of the SCTP socket's send and receive buffers, in bytes.
+  // The send buffer bounds how much data SendData accepts before returning
+  // SDR_BLOCK, and the receive buffer the window advertised to the peer, so
+  // both limit the throughput over paths with a large bandwidth-delay
+  // product. 0 keeps the usrsctp default. Only takes effect if called before
+  // the socket is created; returns false otherwise.
+  bool SetBufferSizes(int send_buffer_size, int receive_buffer_size);
+
   // Exposed to allow Post call from c-callbacks.
   // TODO(deadbeef): Remove this or at least make it return a const pointer.
   rtc::Thread* network_thread() const { return network_thread_; }
@@ -145,6 +153,9 @@ class SctpTransport : public SctpTransportInternal,
   int local_port_ = kSctpDefaultPort;
   int remote_port_ = kSctpDefaultPort;
   struct socket* sock_ = nullptr;  // The socket created by usrsctp_socket(...).
+  // Socket buffer sizes; 0 means the usrsctp default.
+  int send_buffer_size_ = 0;
+  int receive_buffer_size_ = 0;
 
   // Has Start been called? Don't create SCTP socket until it has.
   bool started_ = false;
@@ -177,15 +188,26 @@ class SctpTransportFactory : public SctpTransportInternalFactory {
  public:
   explicit SctpTransportFactory(rtc::Thread* network_thread)
       : network_thread_(network_thread) {}
+  // Transports created by this factory use the given socket buffer sizes (see
+  // SctpTransport::SetBufferSizes).
+  SctpTransportFactory(rtc::Thread* network_thread,
+                       int send_buffer_size,
+                       int receive_buffer_size)
+      : network_thread_(network_thread),
+        send_buffer_size_(send_buffer_size),
+        receive_buffer_size_(receive_buffer_size) {}
 
   std::unique_ptr<SctpTransportInternal> CreateSctpTransport(
       rtc::PacketTransportInternal* channel) override {
-    return std::unique_ptr<SctpTransportInternal>(
-        new SctpTransport(network_thread_, channel));
+    SctpTransport* transport = new SctpTransport(network_thread_, channel);
+    transport->SetBufferSizes(send_buffer_size_, receive_buffer_size_);
+    return std::unique_ptr<SctpTransportInternal>(transport);
   }
 
  private:
   rtc::Thread* network_thread_;
+  int send_buffer_size_ = 0;
+  int receive_buffer_size_ = 0;
 };
 
 }  // namespace cricket
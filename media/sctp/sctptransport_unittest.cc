@@ -12,6 +12,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "webrtc/rtc_base/helpers.h"
 #include "webrtc/rtc_base/ssladapter.h"
 #include "webrtc/rtc_base/thread.h"
+#include "webrtc/rtc_base/timeutils.h"
 
 namespace {
 static const int kDefaultTimeout = 10000;  // 10 seconds.
@@ -67,6 +69,23 @@ class SctpFakeDataReceiver : public sigslot::has_slots<> {
   ReceiveDataParams last_params_;
 };
 
+// Counts the received messages and bytes, without keeping the data.
+class SctpCountingDataReceiver : public sigslot::has_slots<> {
+ public:
+  void OnDataReceived(const ReceiveDataParams& params,
+                      const rtc::CopyOnWriteBuffer& data) {
+    ++messages_received_;
+    bytes_received_ += data.size();
+  }
+
+  size_t messages_received() const { return messages_received_; }
+  size_t bytes_received() const { return bytes_received_; }
+
+ private:
+  size_t messages_received_ = 0;
+  size_t bytes_received_ = 0;
+};
+
 class SignalReadyToSendObserver : public sigslot::has_slots<> {
  public:
   SignalReadyToSendObserver() : signaled_(false) {}
@@ -552,6 +571,66 @@ TEST_F(SctpTransportTest, RefusesHighNumberedTransports) {
   EXPECT_FALSE(AddStream(kMaxSctpSid + 1));
 }
 
+// Streams 16kB messages over a loopback DTLS transport with enlarged socket
+// buffers, refilling the send buffer whenever it has room, and reports the
+// throughput and message rate.
+TEST_F(SctpTransportTest, ThroughputWithLargeBuffers) {
+  static const int kBufferSize = 1024 * 1024;
+  static const size_t kMessageSize = 16 * 1024;
+  static const size_t kTotalBytes = 32 * 1024 * 1024;
+
+  FakeDtlsTransport fake_dtls1("fake dtls 1", 0);
+  FakeDtlsTransport fake_dtls2("fake dtls 2", 0);
+  SctpCountingDataReceiver recv;
+  std::unique_ptr<SctpTransport> sender(
+      new SctpTransport(rtc::Thread::Current(), &fake_dtls1));
+  std::unique_ptr<SctpTransport> receiver(
+      new SctpTransport(rtc::Thread::Current(), &fake_dtls2));
+  receiver->SignalDataReceived.connect(
+      &recv, &SctpCountingDataReceiver::OnDataReceived);
+  EXPECT_TRUE(sender->SetBufferSizes(kBufferSize, kBufferSize));
+  EXPECT_TRUE(receiver->SetBufferSizes(kBufferSize, kBufferSize));
+
+  fake_dtls1.SetDestination(&fake_dtls2, false);
+  ASSERT_TRUE(sender->OpenStream(1));
+  ASSERT_TRUE(receiver->OpenStream(1));
+  ASSERT_TRUE(sender->Start(kTransport1Port, kTransport2Port));
+  ASSERT_TRUE(receiver->Start(kTransport2Port, kTransport1Port));
+  ASSERT_TRUE_WAIT(sender->ReadyToSendData(), kDefaultTimeout);
+  // The socket exists now, so the sizes can't change anymore.
+  EXPECT_FALSE(sender->SetBufferSizes(kBufferSize / 2, kBufferSize / 2));
+
+  SendDataParams params;
+  params.sid = 1;
+  params.type = DMT_BINARY;
+  rtc::CopyOnWriteBuffer payload(kMessageSize);
+  memset(payload.data<uint8_t>(), 0, kMessageSize);
+
+  size_t bytes_sent = 0;
+  const int64_t start_ms = rtc::TimeMillis();
+  while (recv.bytes_received() < kTotalBytes) {
+    ASSERT_LT(rtc::TimeMillis() - start_ms, kDefaultTimeout);
+    SendDataResult result = SDR_SUCCESS;
+    while (bytes_sent < kTotalBytes &&
+           sender->SendData(params, payload, &result)) {
+      bytes_sent += kMessageSize;
+    }
+    ASSERT_NE(SDR_ERROR, result);
+    // Deliver the packets in flight and the SACKs they trigger.
+    rtc::Thread::Current()->ProcessMessages(1);
+  }
+  const int64_t elapsed_ms = std::max<int64_t>(rtc::TimeMillis() - start_ms, 1);
+
+  EXPECT_EQ(kTotalBytes, recv.bytes_received());
+  EXPECT_EQ(kTotalBytes / kMessageSize, recv.messages_received());
+  LOG(LS_INFO) << "Sent " << kTotalBytes << " bytes in " << elapsed_ms
+               << " ms: "
+               << static_cast<double>(kTotalBytes) / 1000 / elapsed_ms
+               << " MB/s, "
+               << recv.messages_received() * 1000 / elapsed_ms
+               << " messages/s.";
+}
+
 // Flaky, see webrtc:4453.
 TEST_F(SctpTransportTest, DISABLED_ReusesAStream) {
   // Shut down transport 1, then open it up again for reuse.
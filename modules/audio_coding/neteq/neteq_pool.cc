@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/neteq_pool.h"
+
+#include <utility>
+
+#include "webrtc/rtc_base/atomicops.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/refcount.h"
+#include "webrtc/rtc_base/refcountedobject.h"
+#include "webrtc/rtc_base/trace_event.h"
+
+namespace webrtc {
+
+struct NetEqPool::Stream : public rtc::RefCountInterface {
+  Stream(int id, NetEq* neteq) : id(id), neteq(neteq) {}
+
+  const int id;
+  const std::unique_ptr<NetEq> neteq;
+  // Only used by GetAudio().
+  AudioFrame audio_frame;
+
+ protected:
+  ~Stream() override = default;
+};
+
+NetEqPool::NetEqPool(
+    const Config& config,
+    const rtc::scoped_refptr<AudioDecoderFactory>& decoder_factory)
+    : neteq_config_(config.neteq_config),
+      decoder_factory_(decoder_factory),
+      worker_pool_(config.num_worker_threads, "NetEqPoolWorker") {}
+
+NetEqPool::~NetEqPool() = default;
+
+int NetEqPool::AddStream() {
+  std::unique_ptr<NetEq> neteq(NetEq::Create(neteq_config_, decoder_factory_));
+  rtc::CritScope lock(&crit_);
+  const int stream_id = next_stream_id_++;
+  stream_index_[stream_id] = streams_.size();
+  streams_.emplace_back(
+      new rtc::RefCountedObject<Stream>(stream_id, neteq.release()));
+  return stream_id;
+}
+
+bool NetEqPool::RemoveStream(int stream_id) {
+  rtc::scoped_refptr<Stream> removed;
+  {
+    rtc::CritScope lock(&crit_);
+    auto it = stream_index_.find(stream_id);
+    if (it == stream_index_.end())
+      return false;
+    const size_t index = it->second;
+    stream_index_.erase(it);
+    // Move the last stream into the freed slot to keep |streams_| dense.
+    removed = std::move(streams_[index]);
+    if (index + 1 != streams_.size()) {
+      streams_[index] = std::move(streams_.back());
+      stream_index_[streams_[index]->id] = index;
+    }
+    streams_.pop_back();
+  }
+  // The NetEq instance is destroyed outside of the lock, here or at the end of
+  // a concurrent GetAudio().
+  return true;
+}
+
+NetEq* NetEqPool::GetStream(int stream_id) {
+  rtc::CritScope lock(&crit_);
+  auto it = stream_index_.find(stream_id);
+  if (it == stream_index_.end())
+    return nullptr;
+  return streams_[it->second]->neteq.get();
+}
+
+size_t NetEqPool::num_streams() const {
+  rtc::CritScope lock(&crit_);
+  return streams_.size();
+}
+
+int NetEqPool::GetAudio(AudioSink* sink) {
+  TRACE_EVENT0("webrtc", "NetEqPool::GetAudio");
+  RTC_DCHECK_RUNS_SERIALIZED(&get_audio_race_checker_);
+  // Work on a copy, so that the lock isn't held while decoding or calling the
+  // sink. The references keep removed streams alive until the tick is done.
+  std::vector<rtc::scoped_refptr<Stream>> streams;
+  {
+    rtc::CritScope lock(&crit_);
+    streams = streams_;
+  }
+  volatile int num_errors = 0;
+  worker_pool_.ParallelFor(streams.size(), [&](size_t index) {
+    Stream* stream = streams[index].get();
+    bool muted = false;
+    const int error = stream->neteq->GetAudio(&stream->audio_frame, &muted);
+    if (error != NetEq::kOK)
+      rtc::AtomicOps::Increment(&num_errors);
+    if (sink)
+      sink->OnAudio(stream->id, error, stream->audio_frame, muted);
+  });
+  return rtc::AtomicOps::AcquireLoad(&num_errors);
+}
+
+}  // namespace webrtc
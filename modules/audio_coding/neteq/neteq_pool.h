@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_NETEQ_POOL_H_
+#define WEBRTC_MODULES_AUDIO_CODING_NETEQ_NETEQ_POOL_H_
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "webrtc/api/audio_codecs/audio_decoder_factory.h"
+#include "webrtc/modules/audio_coding/neteq/include/neteq.h"
+#include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/race_checker.h"
+#include "webrtc/rtc_base/scoped_ref_ptr.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+#include "webrtc/rtc_base/worker_pool.h"
+
+namespace webrtc {
+
+// Owns a large number of headless NetEq instances, e.g. for server-side
+// recording or transcription, and pulls audio from all of them on a common
+// 10 ms tick. All instances share one decoder factory, and the per-tick
+// GetAudio() calls are spread over a pool of worker threads.
+//
+// Packets are inserted directly into the NetEq instance of a stream (see
+// GetStream()); that may happen on any thread, concurrently with GetAudio().
+// Streams may also be added and removed during GetAudio(), including from the
+// sink.
+class NetEqPool {
+ public:
+  struct Config {
+    NetEq::Config neteq_config;
+    // Number of worker threads used by GetAudio(), in addition to the calling
+    // thread. With zero, all streams are processed on the calling thread.
+    size_t num_worker_threads = 0;
+  };
+
+  // Receives the output of every stream once per GetAudio() call. Called on
+  // the worker threads, possibly concurrently for different streams, so
+  // implementations must be thread-safe across streams.
+  class AudioSink {
+   public:
+    virtual void OnAudio(int stream_id,
+                         int error,
+                         const AudioFrame& audio_frame,
+                         bool muted) = 0;
+
+   protected:
+    virtual ~AudioSink() {}
+  };
+
+  NetEqPool(const Config& config,
+            const rtc::scoped_refptr<AudioDecoderFactory>& decoder_factory);
+  ~NetEqPool();
+
+  // Creates a new stream and returns its id.
+  int AddStream();
+  // Destroys the stream with id |stream_id|. Returns false if there is no such
+  // stream.
+  bool RemoveStream(int stream_id);
+  // Returns the NetEq instance of |stream_id|, or null if there is no such
+  // stream. The pointer is valid until the stream is removed, or, if it is
+  // removed during GetAudio(), until that call returns.
+  NetEq* GetStream(int stream_id);
+
+  size_t num_streams() const;
+  size_t num_worker_threads() const { return worker_pool_.num_threads(); }
+
+  // Pulls 10 ms of audio from every stream and hands it to |sink| (if not
+  // null). Blocks until all streams have been processed. Returns the number of
+  // streams for which NetEq::GetAudio() failed. Processes the streams that
+  // existed when the call started. Must not be called concurrently with
+  // itself.
+  int GetAudio(AudioSink* sink);
+
+ private:
+  struct Stream;
+
+  const NetEq::Config neteq_config_;
+  const rtc::scoped_refptr<AudioDecoderFactory> decoder_factory_;
+  rtc::CriticalSection crit_;
+  // Kept in a contiguous vector so that GetAudio() can copy it cheaply and
+  // index the copy from the worker threads; |stream_index_| maps ids to
+  // positions. Reference counted, so that a stream removed during GetAudio()
+  // lives until the call is done with it.
+  std::vector<rtc::scoped_refptr<Stream>> streams_ GUARDED_BY(crit_);
+  std::map<int, size_t> stream_index_ GUARDED_BY(crit_);
+  int next_stream_id_ GUARDED_BY(crit_) = 0;
+  rtc::RaceChecker get_audio_race_checker_;
+  rtc::WorkerPool worker_pool_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(NetEqPool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CODING_NETEQ_NETEQ_POOL_H_
@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/neteq_pool.h"
+
+#include <map>
+#include <vector>
+
+#include "webrtc/api/audio_codecs/builtin_audio_decoder_factory.h"
+#include "webrtc/common_types.h"
+#include "webrtc/modules/audio_coding/codecs/pcm16b/pcm16b.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kPayloadType = 94;
+const int kSampleRateHz = 16000;
+const size_t kFrameSamples = kSampleRateHz / 100;
+
+class CountingSink : public NetEqPool::AudioSink {
+ public:
+  void OnAudio(int stream_id,
+               int error,
+               const AudioFrame& audio_frame,
+               bool muted) override {
+    rtc::CritScope lock(&crit_);
+    EXPECT_EQ(NetEq::kOK, error);
+    EXPECT_EQ(kFrameSamples, audio_frame.samples_per_channel_);
+    calls_[stream_id]++;
+  }
+
+  std::map<int, int> calls() const {
+    rtc::CritScope lock(&crit_);
+    return calls_;
+  }
+
+ private:
+  rtc::CriticalSection crit_;
+  std::map<int, int> calls_;
+};
+
+void InsertPcm16bPacket(NetEq* neteq, uint16_t sequence_number) {
+  RTPHeader rtp_header;
+  rtp_header.payloadType = kPayloadType;
+  rtp_header.sequenceNumber = sequence_number;
+  rtp_header.timestamp = sequence_number * kFrameSamples;
+  rtp_header.ssrc = 0x1234;
+  std::vector<int16_t> samples(kFrameSamples, 1000);
+  std::vector<uint8_t> payload(kFrameSamples * sizeof(int16_t));
+  WebRtcPcm16b_Encode(samples.data(), samples.size(), payload.data());
+  ASSERT_EQ(NetEq::kOK,
+            neteq->InsertPacket(rtp_header, payload, rtp_header.timestamp));
+}
+
+NetEqPool::Config CreateConfig(size_t num_worker_threads) {
+  NetEqPool::Config config;
+  config.neteq_config.sample_rate_hz = kSampleRateHz;
+  config.num_worker_threads = num_worker_threads;
+  return config;
+}
+
+}  // namespace
+
+TEST(NetEqPoolTest, AddAndRemoveStreams) {
+  NetEqPool pool(CreateConfig(0), CreateBuiltinAudioDecoderFactory());
+  const int id1 = pool.AddStream();
+  const int id2 = pool.AddStream();
+  const int id3 = pool.AddStream();
+  EXPECT_EQ(3u, pool.num_streams());
+  NetEq* neteq3 = pool.GetStream(id3);
+  EXPECT_TRUE(pool.RemoveStream(id1));
+  EXPECT_FALSE(pool.RemoveStream(id1));
+  EXPECT_EQ(nullptr, pool.GetStream(id1));
+  EXPECT_NE(nullptr, pool.GetStream(id2));
+  // Removing a stream does not affect the instances of the others.
+  EXPECT_EQ(neteq3, pool.GetStream(id3));
+  EXPECT_EQ(2u, pool.num_streams());
+}
+
+TEST(NetEqPoolTest, GetAudioVisitsEveryStreamOncePerTick) {
+  const size_t kNumStreams = 20;
+  const int kNumTicks = 10;
+  NetEqPool pool(CreateConfig(3), CreateBuiltinAudioDecoderFactory());
+  EXPECT_EQ(3u, pool.num_worker_threads());
+  std::vector<int> ids;
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    ids.push_back(pool.AddStream());
+    ASSERT_TRUE(pool.GetStream(ids.back())
+                    ->RegisterPayloadType(
+                        kPayloadType, SdpAudioFormat("L16", kSampleRateHz, 1)));
+  }
+
+  CountingSink sink;
+  for (int tick = 0; tick < kNumTicks; ++tick) {
+    for (int id : ids)
+      InsertPcm16bPacket(pool.GetStream(id), tick);
+    EXPECT_EQ(0, pool.GetAudio(&sink));
+  }
+
+  const std::map<int, int> calls = sink.calls();
+  ASSERT_EQ(kNumStreams, calls.size());
+  for (int id : ids)
+    EXPECT_EQ(kNumTicks, calls.at(id));
+}
+
+// A sink that removes each stream after its first frame, which requires the
+// pool to be usable from within GetAudio().
+class RemovingSink : public NetEqPool::AudioSink {
+ public:
+  explicit RemovingSink(NetEqPool* pool) : pool_(pool) {}
+
+  void OnAudio(int stream_id,
+               int error,
+               const AudioFrame& audio_frame,
+               bool muted) override {
+    EXPECT_NE(nullptr, pool_->GetStream(stream_id));
+    EXPECT_TRUE(pool_->RemoveStream(stream_id));
+  }
+
+ private:
+  NetEqPool* const pool_;
+};
+
+TEST(NetEqPoolTest, SinkCanRemoveStreams) {
+  NetEqPool pool(CreateConfig(3), CreateBuiltinAudioDecoderFactory());
+  for (int i = 0; i < 20; ++i)
+    pool.AddStream();
+  RemovingSink sink(&pool);
+  pool.GetAudio(&sink);
+  EXPECT_EQ(0u, pool.num_streams());
+}
+
+}  // namespace webrtc
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include "webrtc/api/audio_codecs/builtin_audio_decoder_factory.h"
+#include "webrtc/common_types.h"
+#include "webrtc/modules/audio_coding/codecs/pcm16b/pcm16b.h"
+#include "webrtc/modules/audio_coding/neteq/neteq_pool.h"
+#include "webrtc/modules/audio_coding/neteq/tools/audio_loop.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRateHz = 32000;
+const int kPayloadType = 95;
+const size_t kPacketSamples = 20 * kSampleRateHz / 1000;  // 20 ms packets.
+
+// Decodes |num_streams| PCM16b streams through a NetEqPool with
+// |num_worker_threads| worker threads and reports how many real-time streams
+// one core can sustain.
+void RunNetEqPoolPerformanceTest(size_t num_streams,
+                                 size_t num_worker_threads) {
+  const int simulation_time_ms =
+      field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 2000 : 60000;
+  NetEqPool::Config config;
+  config.neteq_config.sample_rate_hz = kSampleRateHz;
+  config.num_worker_threads = num_worker_threads;
+  NetEqPool pool(config, CreateBuiltinAudioDecoderFactory());
+  std::vector<int> ids;
+  for (size_t i = 0; i < num_streams; ++i) {
+    ids.push_back(pool.AddStream());
+    ASSERT_TRUE(pool.GetStream(ids.back())
+                    ->RegisterPayloadType(
+                        kPayloadType, SdpAudioFormat("L16", kSampleRateHz, 1)));
+  }
+
+  test::AudioLoop audio_loop;
+  ASSERT_TRUE(audio_loop.Init(
+      test::ResourcePath("audio_coding/testfile32kHz", "pcm"),
+      10 * kSampleRateHz, kPacketSamples));
+  std::vector<uint8_t> payload(kPacketSamples * sizeof(int16_t));
+
+  RTPHeader rtp_header;
+  rtp_header.payloadType = kPayloadType;
+  rtp_header.sequenceNumber = 0;
+  rtp_header.timestamp = 0;
+  const int64_t start_time_us = rtc::TimeMicros();
+  for (int time_ms = 0; time_ms < simulation_time_ms; time_ms += 10) {
+    if (time_ms % 20 == 0) {
+      // All streams get the same audio; only the decoding cost matters here.
+      rtc::ArrayView<const int16_t> samples = audio_loop.GetNextBlock();
+      WebRtcPcm16b_Encode(samples.data(), samples.size(), payload.data());
+      for (size_t i = 0; i < ids.size(); ++i) {
+        rtp_header.ssrc = static_cast<uint32_t>(i);
+        ASSERT_EQ(NetEq::kOK,
+                  pool.GetStream(ids[i])->InsertPacket(rtp_header, payload,
+                                                       rtp_header.timestamp));
+      }
+      ++rtp_header.sequenceNumber;
+      rtp_header.timestamp += kPacketSamples;
+    }
+    ASSERT_EQ(0, pool.GetAudio(nullptr));
+  }
+  const int64_t elapsed_us = rtc::TimeMicros() - start_time_us;
+  ASSERT_GT(elapsed_us, 0);
+
+  // The calling thread takes part in the decoding, hence the + 1.
+  const double num_cores = static_cast<double>(num_worker_threads + 1);
+  const double realtime_factor =
+      simulation_time_ms * 1000.0 / static_cast<double>(elapsed_us);
+  const size_t streams_per_core =
+      static_cast<size_t>(num_streams * realtime_factor / num_cores);
+  test::PrintResult("neteq_pool_streams_per_core", "",
+                    std::to_string(num_streams) + "_streams_" +
+                        std::to_string(num_worker_threads) + "_workers",
+                    streams_per_core, "streams", true);
+}
+
+}  // namespace
+
+TEST(NetEqPoolPerformanceTest, SingleThread) {
+  RunNetEqPoolPerformanceTest(100, 0);
+}
+
+TEST(NetEqPoolPerformanceTest, FourWorkers) {
+  RunNetEqPoolPerformanceTest(500, 3);
+}
+
+}  // namespace webrtc
@@ -89,6 +89,11 @@ PacketSource* NetEqRtpDumpInput::source() {
 NetEqEventLogInput::NetEqEventLogInput(const std::string& file_name,
                                        const RtpHeaderExtensionMap& hdr_ext_map)
     : source_(RtcEventLogSource::Create(file_name)) {
+  // An unreadable log leaves the input ended.
+  if (!source_) {
+    next_output_event_ms_ = rtc::Optional<int64_t>();
+    return;
+  }
   for (const auto& ext_pair : hdr_ext_map) {
     source_->RegisterRtpHeaderExtension(ext_pair.second, ext_pair.first);
   }
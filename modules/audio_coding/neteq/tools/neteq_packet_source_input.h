@@ -63,7 +63,8 @@ class NetEqRtpDumpInput final : public NetEqPacketSourceInput {
 };
 
 // Implementation of NetEqPacketSourceInput to be used with an
-// RtcEventLogSource.
+// RtcEventLogSource. If |file_name| cannot be parsed as an event log, the
+// input is ended() from the start.
 class NetEqEventLogInput final : public NetEqPacketSourceInput {
  public:
   NetEqEventLogInput(const std::string& file_name,
@@ -15,11 +15,14 @@
 #include <stdlib.h>  // For strtoul.
 
 #include <algorithm>
+#include <fstream>
 #include <ios>
 #include <iostream>
 #include <memory>
 #include <numeric>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "gflags/gflags.h"
 #include "webrtc/modules/audio_coding/neteq/include/neteq.h"
@@ -34,6 +37,8 @@
 #include "webrtc/modules/audio_coding/neteq/tools/rtp_file_source.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/rtc_base/worker_pool.h"
 #include "webrtc/test/testsupport/fileutils.h"
 #include "webrtc/typedefs.h"
 
@@ -164,6 +169,19 @@ const bool abs_send_time_dummy =
 DEFINE_bool(matlabplot,
             false,
             "Generates a matlab script for plotting the delay profile");
+DEFINE_string(batch,
+              "",
+              "Batch mode: a text file listing one input file (RTP dump, "
+              "pcap or event log) per line. All inputs are simulated in "
+              "parallel without writing any audio, and the statistics of "
+              "each input are written as one JSON object per line");
+DEFINE_string(batch_output,
+              "",
+              "File to write the batch mode statistics to; stdout if empty");
+DEFINE_int32(batch_threads,
+             3,
+             "Number of worker threads used in batch mode, in addition to "
+             "the main thread");
 
 // Maps a codec type to a printable name string.
 std::string CodecName(NetEqDecoder codec) {
@@ -264,14 +282,13 @@ rtc::Optional<int> CodecSampleRate(uint8_t payload_type) {
 }
 
 // Class to let through only the packets with a given SSRC. Should be used as an
-// outer layer on another NetEqInput object.
+// outer layer on another NetEqInput object. NextHeader() is empty after
+// construction if |source| has no packet with the SSRC.
 class FilterSsrcInput : public NetEqInput {
  public:
   FilterSsrcInput(std::unique_ptr<NetEqInput> source, uint32_t ssrc)
       : source_(std::move(source)), ssrc_(ssrc) {
     FindNextWithCorrectSsrc();
-    RTC_CHECK(source_->NextHeader()) << "Found no packet with SSRC = 0x"
-                                     << std::hex << ssrc_;
   }
 
   // All methods but PopPacket() simply relay to the |source_| object.
@@ -402,7 +419,11 @@ class StatsGetter : public NetEqGetAudioCallback {
     return sum_speech_expand / 16384.0 / stats_.size();
   }
 
-  Stats AverageStats() const {
+  // Returns an empty value if no statistics were sampled, i.e., if less than a
+  // second of audio was produced.
+  rtc::Optional<Stats> AverageStats() const {
+    if (stats_.empty())
+      return rtc::Optional<Stats>();
     Stats sum_stats = std::accumulate(
         stats_.begin(), stats_.end(), Stats(),
         [](Stats a, NetEqNetworkStatistics b) {
@@ -442,7 +463,7 @@ class StatsGetter : public NetEqGetAudioCallback {
     sum_stats.min_waiting_time_ms /= stats_.size();
     sum_stats.max_waiting_time_ms /= stats_.size();
 
-    return sum_stats;
+    return rtc::Optional<Stats>(sum_stats);
   }
 
  private:
@@ -451,35 +472,37 @@ class StatsGetter : public NetEqGetAudioCallback {
   std::vector<NetEqNetworkStatistics> stats_;
 };
 
-int RunTest(int argc, char* argv[]) {
-  std::string program_name = argv[0];
-  std::string usage = "Tool for decoding an RTP dump file using NetEq.\n"
-      "Run " + program_name + " --helpshort for usage.\n"
-      "Example usage:\n" + program_name +
-      " input.rtp output.{pcm, wav}\n";
-  google::SetUsageMessage(usage);
-  google::ParseCommandLineFlags(&argc, &argv, true);
+struct SimulationResult {
+  // Why the input could not be simulated; empty on success.
+  std::string error;
+  int64_t output_duration_ms = 0;
+  int64_t wall_time_ms = 0;
+  // Empty if the output was too short to sample the statistics.
+  rtc::Optional<StatsGetter::Stats> stats;
+};
 
-  if (FLAGS_codec_map) {
-    PrintCodecMapping();
-  }
+SimulationResult SimulationError(const std::string& error) {
+  SimulationResult result;
+  result.error = error;
+  return result;
+}
 
-  if (argc != 3) {
-    if (FLAGS_codec_map) {
-      // We have already printed the codec map. Just end the program.
-      return 0;
-    }
-    // Print usage information.
-    std::cout << google::ProgramUsage();
-    return 0;
-  }
+// Replays |input_file_name| through NetEq. The output audio is written to
+// |output_file_name|, unless it is empty. With |verbose| set to false, nothing
+// is printed to stdout, and unusable inputs are reported in
+// SimulationResult::error instead of crashing; this is what batch mode uses,
+// since it writes its results to stdout unless --batch_output is set.
+SimulationResult RunSimulation(
+    const std::string& input_file_name,
+    const std::string& output_file_name,
+    bool verbose) {
+  const int64_t start_time_ms = rtc::TimeMillis();
 
   // Gather RTP header extensions in a map.
   NetEqPacketSourceInput::RtpHeaderExtensionMap rtp_ext_map = {
       {FLAGS_audio_level, kRtpExtensionAudioLevel},
       {FLAGS_abs_send_time, kRtpExtensionAbsoluteSendTime}};
 
-  const std::string input_file_name = argv[1];
   std::unique_ptr<NetEqInput> input;
   if (RtpFileSource::ValidRtpDump(input_file_name) ||
       RtpFileSource::ValidPcap(input_file_name)) {
@@ -488,15 +511,25 @@ int RunTest(int argc, char* argv[]) {
     input.reset(new NetEqEventLogInput(input_file_name, rtp_ext_map));
   }
 
-  std::cout << "Input file: " << input_file_name << std::endl;
-  RTC_CHECK(input) << "Cannot open input file";
-  RTC_CHECK(!input->ended()) << "Input file is empty";
+  if (verbose) {
+    std::cout << "Input file: " << input_file_name << std::endl;
+    RTC_CHECK(input) << "Cannot open input file";
+    RTC_CHECK(!input->ended()) << "Input file is empty";
+  } else if (!input || input->ended()) {
+    return SimulationError("cannot open input file or input file is empty");
+  }
 
   // Check if an SSRC value was provided.
   if (!FLAGS_ssrc.empty()) {
     uint32_t ssrc;
     RTC_CHECK(ParseSsrc(FLAGS_ssrc, &ssrc)) << "Flag verification has failed.";
     input.reset(new FilterSsrcInput(std::move(input), ssrc));
+    if (verbose) {
+      RTC_CHECK(input->NextHeader()) << "Found no packet with SSRC = 0x"
+                                     << std::hex << ssrc;
+    } else if (!input->NextHeader()) {
+      return SimulationError("found no packet with the given SSRC");
+    }
   }
 
   // Check the sample rate.
@@ -507,10 +540,12 @@ int RunTest(int argc, char* argv[]) {
     RTC_DCHECK(first_rtp_header);
     sample_rate_hz = CodecSampleRate(first_rtp_header->payloadType);
     if (sample_rate_hz) {
-      std::cout << "Found valid packet with payload type "
-                << static_cast<int>(first_rtp_header->payloadType)
-                << " and SSRC 0x" << std::hex << first_rtp_header->ssrc
-                << std::dec << std::endl;
+      if (verbose) {
+        std::cout << "Found valid packet with payload type "
+                  << static_cast<int>(first_rtp_header->payloadType)
+                  << " and SSRC 0x" << std::hex << first_rtp_header->ssrc
+                  << std::dec << std::endl;
+      }
       break;
     }
     // Discard this packet and move to the next. Keep track of discarded payload
@@ -519,7 +554,7 @@ int RunTest(int argc, char* argv[]) {
                                   first_rtp_header->ssrc);
     input->PopPacket();
   }
-  if (!discarded_pt_and_ssrc.empty()) {
+  if (verbose && !discarded_pt_and_ssrc.empty()) {
     std::cout << "Discarded initial packets with the following payload types "
                  "and SSRCs:"
               << std::endl;
@@ -529,6 +564,8 @@ int RunTest(int argc, char* argv[]) {
     }
   }
   if (!sample_rate_hz) {
+    if (!verbose)
+      return SimulationError("no packets with known payload types");
     std::cout << "Cannot find any packets with known payload types"
               << std::endl;
     RTC_NOTREACHED();
@@ -536,19 +573,20 @@ int RunTest(int argc, char* argv[]) {
 
   // Open the output file now that we know the sample rate. (Rate is only needed
   // for wav files.)
-  const std::string output_file_name = argv[2];
   std::unique_ptr<AudioSink> output;
-  if (output_file_name.size() >= 4 &&
-      output_file_name.substr(output_file_name.size() - 4) == ".wav") {
-    // Open a wav file.
-    output.reset(new OutputWavFile(output_file_name, *sample_rate_hz));
-  } else {
-    // Open a pcm file.
-    output.reset(new OutputAudioFile(output_file_name));
+  if (!output_file_name.empty()) {
+    if (output_file_name.size() >= 4 &&
+        output_file_name.substr(output_file_name.size() - 4) == ".wav") {
+      // Open a wav file.
+      output.reset(new OutputWavFile(output_file_name, *sample_rate_hz));
+    } else {
+      // Open a pcm file.
+      output.reset(new OutputAudioFile(output_file_name));
+    }
+    if (verbose)
+      std::cout << "Output file: " << output_file_name << std::endl;
   }
 
-  std::cout << "Output file: " << output_file_name << std::endl;
-
   NetEqTest::DecoderMap codecs = {
       {FLAGS_pcmu, std::make_pair(NetEqDecoder::kDecoderPCMu, "pcmu")},
       {FLAGS_pcma, std::make_pair(NetEqDecoder::kDecoderPCMa, "pcma")},
@@ -619,12 +657,16 @@ int RunTest(int argc, char* argv[]) {
 
   NetEqTest::Callbacks callbacks;
   std::unique_ptr<NetEqDelayAnalyzer> delay_analyzer;
-  if (FLAGS_matlabplot) {
+  if (FLAGS_matlabplot && !output_file_name.empty()) {
     delay_analyzer.reset(new NetEqDelayAnalyzer);
   }
 
   SsrcSwitchDetector ssrc_switch_detector(delay_analyzer.get());
-  callbacks.post_insert_packet = &ssrc_switch_detector;
+  if (verbose) {
+    callbacks.post_insert_packet = &ssrc_switch_detector;
+  } else {
+    callbacks.post_insert_packet = delay_analyzer.get();
+  }
   StatsGetter stats_getter(delay_analyzer.get());
   callbacks.get_audio_callback = &stats_getter;
   NetEq::Config config;
@@ -632,17 +674,30 @@ int RunTest(int argc, char* argv[]) {
   NetEqTest test(config, codecs, ext_codecs, std::move(input),
                  std::move(output), callbacks);
 
-  int64_t test_duration_ms = test.Run();
+  SimulationResult result;
+  result.output_duration_ms = test.Run();
 
-  if (FLAGS_matlabplot) {
-    std::cout << "Creating Matlab plot script " << output_file_name + ".m"
-              << std::endl;
+  if (delay_analyzer) {
+    if (verbose) {
+      std::cout << "Creating Matlab plot script " << output_file_name + ".m"
+                << std::endl;
+    }
     delay_analyzer->CreateMatlabScript(output_file_name + ".m");
   }
 
+  result.stats = stats_getter.AverageStats();
+  result.wall_time_ms = rtc::TimeMillis() - start_time_ms;
+  return result;
+}
+
+void PrintStats(const SimulationResult& result) {
   printf("Simulation statistics:\n");
-  printf("  output duration: %" PRId64 " ms\n", test_duration_ms);
-  auto stats = stats_getter.AverageStats();
+  printf("  output duration: %" PRId64 " ms\n", result.output_duration_ms);
+  if (!result.stats) {
+    printf("  no statistics, the output is shorter than a second\n");
+    return;
+  }
+  const StatsGetter::Stats& stats = *result.stats;
   printf("  packet_loss_rate: %f %%\n", 100.0 * stats.packet_loss_rate);
   printf("  packet_discard_rate: %f %%\n", 100.0 * stats.packet_discard_rate);
   printf("  expand_rate: %f %%\n", 100.0 * stats.expand_rate);
@@ -656,6 +711,128 @@ int RunTest(int argc, char* argv[]) {
   printf("  median_waiting_time_ms: %f ms\n", stats.median_waiting_time_ms);
   printf("  min_waiting_time_ms: %f ms\n", stats.min_waiting_time_ms);
   printf("  max_waiting_time_ms: %f ms\n", stats.max_waiting_time_ms);
+}
+
+// Escapes |str| for use as a JSON string value.
+std::string JsonEscape(const std::string& str) {
+  std::string escaped;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      escaped += buf;
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+// Formats the result for |input_file_name| as a single-line JSON object. Rates
+// are fractions in [0, 1]. Failed inputs only carry an "error" member, and
+// inputs too short for statistics an "error" member after the durations.
+std::string ResultToJson(const std::string& input_file_name,
+                         const SimulationResult& result) {
+  std::ostringstream json;
+  json << "{\"input\":\"" << JsonEscape(input_file_name) << "\"";
+  if (!result.error.empty()) {
+    json << ",\"error\":\"" << JsonEscape(result.error) << "\"}";
+    return json.str();
+  }
+  json << ",\"output_duration_ms\":" << result.output_duration_ms
+       << ",\"wall_time_ms\":" << result.wall_time_ms;
+  if (!result.stats) {
+    json << ",\"error\":\"output too short for statistics\"}";
+    return json.str();
+  }
+  const StatsGetter::Stats& stats = *result.stats;
+  json << ",\"current_buffer_size_ms\":" << stats.current_buffer_size_ms
+       << ",\"preferred_buffer_size_ms\":" << stats.preferred_buffer_size_ms
+       << ",\"jitter_peaks_found\":" << stats.jitter_peaks_found
+       << ",\"packet_loss_rate\":" << stats.packet_loss_rate
+       << ",\"packet_discard_rate\":" << stats.packet_discard_rate
+       << ",\"expand_rate\":" << stats.expand_rate
+       << ",\"speech_expand_rate\":" << stats.speech_expand_rate
+       << ",\"preemptive_rate\":" << stats.preemptive_rate
+       << ",\"accelerate_rate\":" << stats.accelerate_rate
+       << ",\"secondary_decoded_rate\":" << stats.secondary_decoded_rate
+       << ",\"clockdrift_ppm\":" << stats.clockdrift_ppm
+       << ",\"added_zero_samples\":" << stats.added_zero_samples
+       << ",\"mean_waiting_time_ms\":" << stats.mean_waiting_time_ms
+       << ",\"median_waiting_time_ms\":" << stats.median_waiting_time_ms
+       << ",\"min_waiting_time_ms\":" << stats.min_waiting_time_ms
+       << ",\"max_waiting_time_ms\":" << stats.max_waiting_time_ms << "}";
+  return json.str();
+}
+
+int RunBatch(const std::string& batch_file_name) {
+  std::ifstream batch_file(batch_file_name);
+  RTC_CHECK(batch_file.is_open()) << "Cannot open " << batch_file_name;
+  std::vector<std::string> input_file_names;
+  std::string line;
+  while (std::getline(batch_file, line)) {
+    if (!line.empty())
+      input_file_names.push_back(line);
+  }
+
+  std::ofstream output_file;
+  if (!FLAGS_batch_output.empty()) {
+    output_file.open(FLAGS_batch_output);
+    RTC_CHECK(output_file.is_open()) << "Cannot open " << FLAGS_batch_output;
+  }
+  std::ostream& output = FLAGS_batch_output.empty() ? std::cout : output_file;
+
+  std::vector<SimulationResult> results(
+      input_file_names.size());
+  const int64_t start_time_ms = rtc::TimeMillis();
+  {
+    rtc::WorkerPool worker_pool(std::max(FLAGS_batch_threads, 0),
+                                "NetEqBatchWorker");
+    worker_pool.ParallelFor(input_file_names.size(), [&](size_t i) {
+      results[i] = RunSimulation(input_file_names[i], "", false);
+    });
+  }
+  for (size_t i = 0; i < input_file_names.size(); ++i)
+    output << ResultToJson(input_file_names[i], results[i]) << std::endl;
+
+  std::cerr << "Simulated " << input_file_names.size() << " inputs in "
+            << rtc::TimeMillis() - start_time_ms << " ms" << std::endl;
+  return 0;
+}
+
+int RunTest(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage = "Tool for decoding an RTP dump file using NetEq.\n"
+      "Run " + program_name + " --helpshort for usage.\n"
+      "Example usage:\n" + program_name +
+      " input.rtp output.{pcm, wav}\n" +
+      "Batch usage (statistics only):\n" + program_name +
+      " --batch=inputs.txt [--batch_output=stats.jsonl]\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_codec_map) {
+    PrintCodecMapping();
+  }
+
+  if (!FLAGS_batch.empty()) {
+    return RunBatch(FLAGS_batch);
+  }
+
+  if (argc != 3) {
+    if (FLAGS_codec_map) {
+      // We have already printed the codec map. Just end the program.
+      return 0;
+    }
+    // Print usage information.
+    std::cout << google::ProgramUsage();
+    return 0;
+  }
+
+  PrintStats(RunSimulation(argv[1], argv[2], true));
 
   return 0;
 }
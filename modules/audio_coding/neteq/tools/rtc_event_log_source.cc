@@ -25,7 +25,10 @@ namespace test {
 
 RtcEventLogSource* RtcEventLogSource::Create(const std::string& file_name) {
   RtcEventLogSource* source = new RtcEventLogSource();
-  RTC_CHECK(source->OpenFile(file_name));
+  if (!source->OpenFile(file_name)) {
+    delete source;
+    return nullptr;
+  }
   return source;
 }
 
@@ -61,7 +64,7 @@ std::unique_ptr<Packet> RtcEventLogSource::NextPacket() {
                      static_cast<double>(timestamp_us) / 1000, *parser_.get()));
 
       if (!packet->valid_header()) {
-        std::cout << "Warning: Packet with index " << rtp_packet_index_
+        std::cerr << "Warning: Packet with index " << rtp_packet_index_
                   << " has an invalid header and will be ignored." << std::endl;
         continue;
       }
@@ -46,6 +46,15 @@ class DesktopCaptureOptions {
   void set_x_display(rtc::scoped_refptr<SharedXDisplay> x_display) {
     x_display_ = x_display;
   }
+
+  // Flag indicating that the X11 screen capturer should capture into frames
+  // backed by XShm segments, which the X server writes into directly instead
+  // of the capturer copying the pixels. Falls back to copying if the X server
+  // does not support it.
+  bool use_x_shm_frames() const { return use_x_shm_frames_; }
+  void set_use_x_shm_frames(bool use_x_shm_frames) {
+    use_x_shm_frames_ = use_x_shm_frames;
+  }
 #endif
 
 #if defined(WEBRTC_MAC) && !defined(WEBRTC_IOS)
@@ -123,6 +132,7 @@ class DesktopCaptureOptions {
   bool allow_directx_capturer_ = false;
 #endif
 #if defined(USE_X11)
+  bool use_x_shm_frames_ = false;
   bool use_update_notifications_ = false;
 #else
   bool use_update_notifications_ = true;
@@ -19,11 +19,23 @@
 #include "webrtc/modules/desktop_capture/differ_block.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 
 namespace webrtc {
 
 namespace {
 
+// Areas of at least this many pixels are compared in parallel. Smaller ones
+// are done before the worker threads would have woken up.
+const int64_t kMinPixelsForParallelCompare = 1920 * 1080;
+// The comparison is bound by memory bandwidth, which a few threads saturate.
+const size_t kMaxCompareThreads = 3;
+
+size_t DefaultNumCompareThreads() {
+  const size_t num_cores = CpuInfo::DetectNumberOfCores();
+  return std::min(kMaxCompareThreads, num_cores > 1 ? num_cores - 1 : 0);
+}
+
 // Returns true if (0, 0) - (|width|, |height|) vector in |old_buffer| and
 // |new_buffer| are equal. |width| should be less than 32
 // (defined by kBlockSize), otherwise BlockDifference() should be used.
@@ -109,10 +121,10 @@ void CompareRow(const uint8_t* old_buffer,
 
 // Compares |rect| area in |old_frame| and |new_frame|, and outputs dirty
 // regions into |output|.
-void CompareFrames(const DesktopFrame& old_frame,
-                   const DesktopFrame& new_frame,
-                   DesktopRect rect,
-                   DesktopRegion* const output) {
+void CompareRect(const DesktopFrame& old_frame,
+                 const DesktopFrame& new_frame,
+                 DesktopRect rect,
+                 DesktopRegion* const output) {
   RTC_DCHECK(old_frame.size().equals(new_frame.size()));
   RTC_DCHECK_EQ(old_frame.stride(), new_frame.stride());
   rect.IntersectWith(DesktopRect::MakeSize(old_frame.size()));
@@ -144,7 +156,15 @@ void CompareFrames(const DesktopFrame& old_frame,
 
 DesktopCapturerDifferWrapper::DesktopCapturerDifferWrapper(
     std::unique_ptr<DesktopCapturer> base_capturer)
-    : base_capturer_(std::move(base_capturer)) {
+    : DesktopCapturerDifferWrapper(std::move(base_capturer),
+                                   DefaultNumCompareThreads()) {}
+
+DesktopCapturerDifferWrapper::DesktopCapturerDifferWrapper(
+    std::unique_ptr<DesktopCapturer> base_capturer,
+    size_t num_compare_threads)
+    : base_capturer_(std::move(base_capturer)),
+      compare_pool_(num_compare_threads, "DifferCompare"),
+      band_regions_(num_compare_threads + 1) {
   RTC_DCHECK(base_capturer_);
 }
 
@@ -180,6 +200,52 @@ bool DesktopCapturerDifferWrapper::FocusOnSelectedSource() {
   return base_capturer_->FocusOnSelectedSource();
 }
 
+void DesktopCapturerDifferWrapper::CompareFrames(const DesktopRegion& hints,
+                                                 SharedDesktopFrame* frame) {
+  int64_t hint_pixels = 0;
+  for (DesktopRegion::Iterator it(hints); !it.IsAtEnd(); it.Advance())
+    hint_pixels += it.rect().width() * it.rect().height();
+  if (compare_pool_.num_threads() == 0 ||
+      hint_pixels < kMinPixelsForParallelCompare) {
+    for (DesktopRegion::Iterator it(hints); !it.IsAtEnd(); it.Advance()) {
+      CompareRect(*last_frame_, *frame, it.rect(),
+                  frame->mutable_updated_region());
+    }
+    return;
+  }
+
+  // Splits each hinted rectangle into horizontal bands of whole block-rows, one
+  // per thread. The block-rows are counted from the top of the rectangle, as
+  // in CompareRect(), so the result matches the serial comparison. Each band
+  // collects its updated areas separately.
+  const int num_bands = static_cast<int>(band_regions_.size());
+  const DesktopFrame& old_frame = *last_frame_;
+  const DesktopFrame& new_frame = *frame;
+  compare_pool_.ParallelFor(num_bands, [&](size_t band) {
+    DesktopRegion* output = &band_regions_[band];
+    output->Clear();
+    for (DesktopRegion::Iterator it(hints); !it.IsAtEnd(); it.Advance()) {
+      DesktopRect rect = it.rect();
+      rect.IntersectWith(DesktopRect::MakeSize(new_frame.size()));
+      if (rect.is_empty())
+        continue;
+      const int block_rows = (rect.height() + kBlockSize - 1) / kBlockSize;
+      const int band_height =
+          (block_rows + num_bands - 1) / num_bands * kBlockSize;
+      const int top = rect.top() + static_cast<int>(band) * band_height;
+      if (top >= rect.bottom())
+        continue;
+      CompareRect(old_frame, new_frame,
+                  DesktopRect::MakeLTRB(rect.left(), top, rect.right(),
+                                        std::min(rect.bottom(),
+                                                 top + band_height)),
+                  output);
+    }
+  });
+  for (const DesktopRegion& region : band_regions_)
+    frame->mutable_updated_region()->AddRegion(region);
+}
+
 void DesktopCapturerDifferWrapper::OnCaptureResult(
     Result result,
     std::unique_ptr<DesktopFrame> input_frame) {
@@ -201,10 +267,7 @@ void DesktopCapturerDifferWrapper::OnCaptureResult(
   if (last_frame_) {
     DesktopRegion hints;
     hints.Swap(frame->GetUnderlyingFrame()->mutable_updated_region());
-    for (DesktopRegion::Iterator it(hints); !it.IsAtEnd(); it.Advance()) {
-      CompareFrames(*last_frame_, *frame, it.rect(),
-                    frame->mutable_updated_region());
-    }
+    CompareFrames(hints, frame.get());
   } else {
     frame->mutable_updated_region()->SetRect(
         DesktopRect::MakeSize(frame->size()));
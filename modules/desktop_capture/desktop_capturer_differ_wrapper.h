@@ -12,9 +12,12 @@
 #define WEBRTC_MODULES_DESKTOP_CAPTURE_DESKTOP_CAPTURER_DIFFER_WRAPPER_H_
 
 #include <memory>
+#include <vector>
 
 #include "webrtc/modules/desktop_capture/desktop_capturer.h"
+#include "webrtc/modules/desktop_capture/desktop_region.h"
 #include "webrtc/modules/desktop_capture/shared_desktop_frame.h"
+#include "webrtc/rtc_base/worker_pool.h"
 
 namespace webrtc {
 
@@ -26,6 +29,9 @@ namespace webrtc {
 //
 // This class marks entire frame as updated if the frame size or frame stride
 // has been changed.
+//
+// Large areas, e.g. whole 4K frames, are split into bands of block-rows that
+// are compared in parallel.
 class DesktopCapturerDifferWrapper : public DesktopCapturer,
                                      public DesktopCapturer::Callback {
  public:
@@ -33,6 +39,10 @@ class DesktopCapturerDifferWrapper : public DesktopCapturer,
   // implementation, and takes its ownership.
   explicit DesktopCapturerDifferWrapper(
       std::unique_ptr<DesktopCapturer> base_capturer);
+  // Same, with |num_compare_threads| threads helping the capture thread with
+  // large areas; zero compares everything on the capture thread.
+  DesktopCapturerDifferWrapper(std::unique_ptr<DesktopCapturer> base_capturer,
+                               size_t num_compare_threads);
 
   ~DesktopCapturerDifferWrapper() override;
 
@@ -51,7 +61,15 @@ class DesktopCapturerDifferWrapper : public DesktopCapturer,
   void OnCaptureResult(Result result,
                        std::unique_ptr<DesktopFrame> frame) override;
 
+  // Compares |hints| in |last_frame_| and |frame|, and adds the updated areas
+  // to the updated region of |frame|.
+  void CompareFrames(const DesktopRegion& hints, SharedDesktopFrame* frame);
+
   const std::unique_ptr<DesktopCapturer> base_capturer_;
+  // Compares the bands of large areas; empty on single core machines.
+  rtc::WorkerPool compare_pool_;
+  // Updated region of each band.
+  std::vector<DesktopRegion> band_regions_;
   DesktopCapturer::Callback* callback_;
   std::unique_ptr<SharedDesktopFrame> last_frame_;
 };
@@ -10,6 +10,8 @@
 
 #include "webrtc/modules/desktop_capture/desktop_capturer_differ_wrapper.h"
 
+#include <string.h>
+
 #include <initializer_list>
 #include <memory>
 #include <utility>
@@ -153,7 +155,9 @@ void ExecuteCapturer(DesktopCapturerDifferWrapper* capturer,
 void ExecuteDifferWrapperTest(bool with_hints,
                               bool enlarge_updated_region,
                               bool random_updated_region,
-                              bool check_result) {
+                              bool check_result,
+                              size_t num_compare_threads,
+                              int max_frame_size) {
   const bool updated_region_should_exactly_match =
       with_hints && !enlarge_updated_region && !random_updated_region;
   BlackWhiteDesktopFramePainter frame_painter;
@@ -161,7 +165,7 @@ void ExecuteDifferWrapperTest(bool with_hints,
   frame_generator.set_desktop_frame_painter(&frame_painter);
   std::unique_ptr<FakeDesktopCapturer> fake(new FakeDesktopCapturer());
   fake->set_frame_generator(&frame_generator);
-  DesktopCapturerDifferWrapper capturer(std::move(fake));
+  DesktopCapturerDifferWrapper capturer(std::move(fake), num_compare_threads);
   MockDesktopCapturerCallback callback;
   frame_generator.set_provide_updated_region_hints(with_hints);
   frame_generator.set_enlarge_updated_region(enlarge_updated_region);
@@ -201,11 +205,13 @@ void ExecuteDifferWrapperTest(bool with_hints,
 
   Random random(rtc::TimeMillis());
   // Fuzzing tests.
-  for (int i = 0; i < 1000; i++) {
+  const int num_iterations = max_frame_size > 2000 ? 50 : 1000;
+  for (int i = 0; i < num_iterations; i++) {
     if (enlarge_updated_region) {
       frame_generator.set_enlarge_range(random.Rand(1, 50));
     }
-    frame_generator.size()->set(random.Rand(500, 2000), random.Rand(500, 2000));
+    frame_generator.size()->set(random.Rand(500, max_frame_size),
+                                random.Rand(500, max_frame_size));
     ExecuteCapturer(&capturer, &callback);
     std::vector<DesktopRect> updated_region;
     for (int j = random.Rand(50); j >= 0; j--) {
@@ -222,26 +228,102 @@ void ExecuteDifferWrapperTest(bool with_hints,
   }
 }
 
+// Paints a white frame with single black pixels at |dots()|, and reports
+// |hint()| as the updated region.
+class DotsDesktopFramePainter final : public DesktopFramePainter {
+ public:
+  std::vector<DesktopVector>* dots() { return &dots_; }
+  DesktopRect* hint() { return &hint_; }
+
+  bool Paint(DesktopFrame* frame, DesktopRegion* updated_region) override {
+    memset(frame->data(), 0xff, frame->stride() * frame->size().height());
+    for (const DesktopVector& dot : dots_)
+      memset(frame->GetFrameDataAtPos(dot), 0, DesktopFrame::kBytesPerPixel);
+    updated_region->SetRect(hint_);
+    return true;
+  }
+
+ private:
+  std::vector<DesktopVector> dots_;
+  DesktopRect hint_;
+};
+
+// Captures a frame with |capturer| and returns its updated region.
+DesktopRegion CaptureUpdatedRegion(DesktopCapturerDifferWrapper* capturer,
+                                   MockDesktopCapturerCallback* callback) {
+  DesktopRegion updated_region;
+  EXPECT_CALL(*callback,
+              OnCaptureResultPtr(DesktopCapturer::Result::SUCCESS, testing::_))
+      .WillOnce(testing::Invoke([&updated_region](
+          DesktopCapturer::Result result,
+          std::unique_ptr<DesktopFrame>* frame) {
+        updated_region = (*frame)->updated_region();
+      }));
+  capturer->CaptureFrame();
+  return updated_region;
+}
+
 }  // namespace
 
 TEST(DesktopCapturerDifferWrapperTest, CaptureWithoutHints) {
-  ExecuteDifferWrapperTest(false, false, false, true);
+  ExecuteDifferWrapperTest(false, false, false, true, 0, 2000);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, CaptureWithHints) {
-  ExecuteDifferWrapperTest(true, false, false, true);
+  ExecuteDifferWrapperTest(true, false, false, true, 0, 2000);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, CaptureWithEnlargedHints) {
-  ExecuteDifferWrapperTest(true, true, false, true);
+  ExecuteDifferWrapperTest(true, true, false, true, 0, 2000);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, CaptureWithRandomHints) {
-  ExecuteDifferWrapperTest(true, false, true, true);
+  ExecuteDifferWrapperTest(true, false, true, true, 0, 2000);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, CaptureWithEnlargedAndRandomHints) {
-  ExecuteDifferWrapperTest(true, true, true, true);
+  ExecuteDifferWrapperTest(true, true, true, true, 0, 2000);
+}
+
+TEST(DesktopCapturerDifferWrapperTest, CaptureLargeFramesInParallel) {
+  ExecuteDifferWrapperTest(false, false, false, true, 3, 5120);
+}
+
+TEST(DesktopCapturerDifferWrapperTest,
+     CaptureLargeFramesWithEnlargedAndRandomHintsInParallel) {
+  ExecuteDifferWrapperTest(true, true, true, true, 3, 5120);
+}
+
+// The block grid starts at the top-left corner of each hint, so a hint that is
+// not aligned to kBlockSize must be split into the same blocks when compared
+// in parallel.
+TEST(DesktopCapturerDifferWrapperTest, ParallelCompareMatchesSerialCompare) {
+  DotsDesktopFramePainter frame_painter;
+  PainterDesktopFrameGenerator frame_generator;
+  frame_generator.set_desktop_frame_painter(&frame_painter);
+  frame_generator.set_provide_updated_region_hints(true);
+  frame_generator.size()->set(2000, 1200);
+  std::unique_ptr<FakeDesktopCapturer> serial_fake(new FakeDesktopCapturer());
+  serial_fake->set_frame_generator(&frame_generator);
+  std::unique_ptr<FakeDesktopCapturer> parallel_fake(new FakeDesktopCapturer());
+  parallel_fake->set_frame_generator(&frame_generator);
+  DesktopCapturerDifferWrapper serial_capturer(std::move(serial_fake), 0);
+  DesktopCapturerDifferWrapper parallel_capturer(std::move(parallel_fake), 3);
+  MockDesktopCapturerCallback callback;
+  serial_capturer.Start(&callback);
+  parallel_capturer.Start(&callback);
+  CaptureUpdatedRegion(&serial_capturer, &callback);
+  CaptureUpdatedRegion(&parallel_capturer, &callback);
+
+  for (int y = 0; y < 1200; y += 37)
+    frame_painter.dots()->push_back(DesktopVector(y, y));
+  *frame_painter.hint() = DesktopRect::MakeLTRB(5, 7, 2000, 1200);
+  const DesktopRegion serial_region =
+      CaptureUpdatedRegion(&serial_capturer, &callback);
+  const DesktopRegion parallel_region =
+      CaptureUpdatedRegion(&parallel_capturer, &callback);
+  EXPECT_FALSE(serial_region.is_empty());
+  EXPECT_TRUE(serial_region.Equals(parallel_region));
 }
 
 // When hints are provided, DesktopCapturerDifferWrapper has a slightly better
@@ -259,32 +341,32 @@ TEST(DesktopCapturerDifferWrapperTest, CaptureWithEnlargedAndRandomHints) {
 // [       OK ] DISABLED_CaptureWithEnlargedAndRandomHintsPerf (6347 ms)
 TEST(DesktopCapturerDifferWrapperTest, DISABLED_CaptureWithoutHintsPerf) {
   int64_t started = rtc::TimeMillis();
-  ExecuteDifferWrapperTest(false, false, false, false);
+  ExecuteDifferWrapperTest(false, false, false, false, 0, 2000);
   ASSERT_LE(rtc::TimeMillis() - started, 15000);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, DISABLED_CaptureWithHintsPerf) {
   int64_t started = rtc::TimeMillis();
-  ExecuteDifferWrapperTest(true, false, false, false);
+  ExecuteDifferWrapperTest(true, false, false, false, 0, 2000);
   ASSERT_LE(rtc::TimeMillis() - started, 15000);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, DISABLED_CaptureWithEnlargedHintsPerf) {
   int64_t started = rtc::TimeMillis();
-  ExecuteDifferWrapperTest(true, true, false, false);
+  ExecuteDifferWrapperTest(true, true, false, false, 0, 2000);
   ASSERT_LE(rtc::TimeMillis() - started, 15000);
 }
 
 TEST(DesktopCapturerDifferWrapperTest, DISABLED_CaptureWithRandomHintsPerf) {
   int64_t started = rtc::TimeMillis();
-  ExecuteDifferWrapperTest(true, false, true, false);
+  ExecuteDifferWrapperTest(true, false, true, false, 0, 2000);
   ASSERT_LE(rtc::TimeMillis() - started, 15000);
 }
 
 TEST(DesktopCapturerDifferWrapperTest,
      DISABLED_CaptureWithEnlargedAndRandomHintsPerf) {
   int64_t started = rtc::TimeMillis();
-  ExecuteDifferWrapperTest(true, true, true, false);
+  ExecuteDifferWrapperTest(true, true, true, false, 0, 2000);
   ASSERT_LE(rtc::TimeMillis() - started, 15000);
 }
 
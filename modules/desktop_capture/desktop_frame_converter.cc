@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/desktop_frame_converter.h"
+
+#include <utility>
+
+#include "third_party/libyuv/include/libyuv/convert_from_argb.h"
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+// Output buffers kept for reuse. One is typically being encoded while the
+// next frame is converted into another.
+const size_t kMaxBuffers = 3;
+
+}  // namespace
+
+DesktopFrameConverter::DesktopFrameConverter()
+    : reset_(true), converted_pixels_(0) {}
+
+DesktopFrameConverter::~DesktopFrameConverter() {}
+
+VideoFrame DesktopFrameConverter::Convert(const DesktopFrame& frame,
+                                          int64_t timestamp_us) {
+  const DesktopRect frame_rect = DesktopRect::MakeSize(frame.size());
+  if (!frame.size().equals(frame_size_)) {
+    buffers_.clear();
+    frame_size_ = frame.size();
+    reset_ = true;
+  }
+
+  DesktopRegion updated_region;
+  if (reset_) {
+    updated_region.SetRect(frame_rect);
+    for (Buffer& buffer : buffers_)
+      buffer.stale_region.SetRect(frame_rect);
+    reset_ = false;
+  } else {
+    updated_region = frame.updated_region();
+    updated_region.IntersectWith(frame_rect);
+  }
+
+  Buffer* output = nullptr;
+  for (Buffer& buffer : buffers_) {
+    if (buffer.buffer->HasOneRef()) {
+      output = &buffer;
+      break;
+    }
+  }
+  rtc::scoped_refptr<rtc::RefCountedObject<I420Buffer>> untracked_buffer;
+  DesktopRegion region_to_convert = updated_region;
+  if (output) {
+    region_to_convert.AddRegion(output->stale_region);
+    output->stale_region.Clear();
+  } else {
+    // All buffers are still in use, e.g. queued for encoding.
+    rtc::scoped_refptr<rtc::RefCountedObject<I420Buffer>> buffer(
+        new rtc::RefCountedObject<I420Buffer>(frame.size().width(),
+                                              frame.size().height()));
+    region_to_convert.SetRect(frame_rect);
+    if (buffers_.size() < kMaxBuffers) {
+      buffers_.push_back(Buffer{buffer, DesktopRegion()});
+      output = &buffers_.back();
+    } else {
+      untracked_buffer = buffer;
+    }
+  }
+  for (Buffer& buffer : buffers_) {
+    if (&buffer != output)
+      buffer.stale_region.AddRegion(updated_region);
+  }
+
+  I420Buffer* i420_buffer =
+      output ? output->buffer.get() : untracked_buffer.get();
+  ConvertRegion(frame, region_to_convert, i420_buffer);
+
+  std::vector<VideoFrame::UpdateRect> update_rects;
+  for (DesktopRegion::Iterator it(updated_region); !it.IsAtEnd();
+       it.Advance()) {
+    const DesktopRect& rect = it.rect();
+    update_rects.push_back(
+        {rect.left(), rect.top(), rect.width(), rect.height()});
+  }
+  VideoFrame video_frame(i420_buffer, kVideoRotation_0, timestamp_us);
+  video_frame.set_update_rects(std::move(update_rects));
+  return video_frame;
+}
+
+void DesktopFrameConverter::Reset() {
+  reset_ = true;
+}
+
+void DesktopFrameConverter::ConvertRegion(const DesktopFrame& frame,
+                                          const DesktopRegion& region,
+                                          I420Buffer* buffer) {
+  const DesktopRect frame_rect = DesktopRect::MakeSize(frame.size());
+  for (DesktopRegion::Iterator it(region); !it.IsAtEnd(); it.Advance()) {
+    // The chroma planes are subsampled, so convert whole 2x2 blocks.
+    DesktopRect rect = DesktopRect::MakeLTRB(
+        it.rect().left() & ~1, it.rect().top() & ~1,
+        (it.rect().right() + 1) & ~1, (it.rect().bottom() + 1) & ~1);
+    rect.IntersectWith(frame_rect);
+    if (rect.is_empty())
+      continue;
+    const int x = rect.left();
+    const int y = rect.top();
+    libyuv::ARGBToI420(
+        frame.GetFrameDataAtPos(rect.top_left()), frame.stride(),
+        buffer->MutableDataY() + y * buffer->StrideY() + x, buffer->StrideY(),
+        buffer->MutableDataU() + y / 2 * buffer->StrideU() + x / 2,
+        buffer->StrideU(),
+        buffer->MutableDataV() + y / 2 * buffer->StrideV() + x / 2,
+        buffer->StrideV(), rect.width(), rect.height());
+    converted_pixels_ += rect.width() * rect.height();
+  }
+}
+
+}  // namespace webrtc
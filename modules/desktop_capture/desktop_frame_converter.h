@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_DESKTOP_CAPTURE_DESKTOP_FRAME_CONVERTER_H_
+#define WEBRTC_MODULES_DESKTOP_CAPTURE_DESKTOP_FRAME_CONVERTER_H_
+
+#include <vector>
+
+#include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/api/video/video_frame.h"
+#include "webrtc/modules/desktop_capture/desktop_frame.h"
+#include "webrtc/modules/desktop_capture/desktop_geometry.h"
+#include "webrtc/modules/desktop_capture/desktop_region.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/refcountedobject.h"
+#include "webrtc/rtc_base/scoped_ref_ptr.h"
+
+namespace webrtc {
+
+// Converts the frames of a DesktopCapturer to I420 VideoFrames. Only the
+// updated_region() of each frame is converted; the rest of the output buffer
+// is kept from an earlier frame. The updated region is attached to the
+// VideoFrame as update rects, so that the encoder can skip the unchanged
+// macroblocks.
+//
+// Every frame returned by the capturer must be passed to Convert(), since the
+// updated region of a frame is relative to the previous one. Call Reset()
+// after skipping a frame.
+class DesktopFrameConverter {
+ public:
+  DesktopFrameConverter();
+  ~DesktopFrameConverter();
+
+  VideoFrame Convert(const DesktopFrame& frame, int64_t timestamp_us);
+
+  // Makes the next Convert() convert the whole frame and report all of it as
+  // updated.
+  void Reset();
+
+  // Number of pixels converted from ARGB, for benchmarking.
+  int64_t converted_pixels() const { return converted_pixels_; }
+
+ private:
+  // An output buffer, and the parts of it that are older than the last frame.
+  struct Buffer {
+    rtc::scoped_refptr<rtc::RefCountedObject<I420Buffer>> buffer;
+    DesktopRegion stale_region;
+  };
+
+  void ConvertRegion(const DesktopFrame& frame,
+                     const DesktopRegion& region,
+                     I420Buffer* buffer);
+
+  // Buffers of the current frame size. A buffer is reused once the VideoFrames
+  // referencing it have been released.
+  std::vector<Buffer> buffers_;
+  DesktopSize frame_size_;
+  bool reset_;
+  int64_t converted_pixels_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(DesktopFrameConverter);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_DESKTOP_CAPTURE_DESKTOP_FRAME_CONVERTER_H_
@@ -0,0 +1,167 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/desktop_frame_converter.h"
+
+#include <string.h>
+
+#include <memory>
+
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kWidth = 64;
+const int kHeight = 48;
+
+// Fills |rect| of |frame| with a pattern that depends on |seed|, and marks it
+// as updated.
+void PaintRect(DesktopFrame* frame, const DesktopRect& rect, uint8_t seed) {
+  for (int y = rect.top(); y < rect.bottom(); ++y) {
+    uint8_t* row = frame->GetFrameDataAtPos(DesktopVector(rect.left(), y));
+    for (int x = 0; x < rect.width(); ++x) {
+      row[x * DesktopFrame::kBytesPerPixel] = seed + x;
+      row[x * DesktopFrame::kBytesPerPixel + 1] = seed + y;
+      row[x * DesktopFrame::kBytesPerPixel + 2] = seed * 3;
+      row[x * DesktopFrame::kBytesPerPixel + 3] = 0xff;
+    }
+  }
+  frame->mutable_updated_region()->AddRect(rect);
+}
+
+// Checks that |video_frame| matches a full conversion of |frame|.
+void ExpectFullyConverted(const DesktopFrame& frame,
+                          const VideoFrame& video_frame) {
+  DesktopFrameConverter reference_converter;
+  rtc::scoped_refptr<I420BufferInterface> expected =
+      reference_converter.Convert(frame, 0).video_frame_buffer()->ToI420();
+  rtc::scoped_refptr<I420BufferInterface> actual =
+      video_frame.video_frame_buffer()->ToI420();
+  ASSERT_EQ(expected->width(), actual->width());
+  ASSERT_EQ(expected->height(), actual->height());
+  for (int y = 0; y < actual->height(); ++y) {
+    EXPECT_EQ(0, memcmp(expected->DataY() + y * expected->StrideY(),
+                        actual->DataY() + y * actual->StrideY(),
+                        actual->width()));
+  }
+  for (int y = 0; y < actual->ChromaHeight(); ++y) {
+    EXPECT_EQ(0, memcmp(expected->DataU() + y * expected->StrideU(),
+                        actual->DataU() + y * actual->StrideU(),
+                        actual->ChromaWidth()));
+    EXPECT_EQ(0, memcmp(expected->DataV() + y * expected->StrideV(),
+                        actual->DataV() + y * actual->StrideV(),
+                        actual->ChromaWidth()));
+  }
+}
+
+}  // namespace
+
+TEST(DesktopFrameConverterTest, ConvertsWholeFirstFrame) {
+  BasicDesktopFrame frame(DesktopSize(kWidth, kHeight));
+  PaintRect(&frame, DesktopRect::MakeXYWH(4, 4, 8, 8), 1);
+  DesktopFrameConverter converter;
+  VideoFrame video_frame = converter.Convert(frame, 1000);
+
+  EXPECT_EQ(1000, video_frame.timestamp_us());
+  EXPECT_EQ(kWidth * kHeight, converter.converted_pixels());
+  ASSERT_TRUE(video_frame.has_update_rects());
+  ASSERT_EQ(1u, video_frame.update_rects().size());
+  EXPECT_EQ(0, video_frame.update_rects()[0].offset_x);
+  EXPECT_EQ(0, video_frame.update_rects()[0].offset_y);
+  EXPECT_EQ(kWidth, video_frame.update_rects()[0].width);
+  EXPECT_EQ(kHeight, video_frame.update_rects()[0].height);
+}
+
+TEST(DesktopFrameConverterTest, ConvertsOnlyUpdatedRegion) {
+  BasicDesktopFrame frame(DesktopSize(kWidth, kHeight));
+  PaintRect(&frame, DesktopRect::MakeSize(frame.size()), 1);
+  DesktopFrameConverter converter;
+  converter.Convert(frame, 0);
+
+  frame.mutable_updated_region()->Clear();
+  PaintRect(&frame, DesktopRect::MakeXYWH(11, 5, 10, 6), 2);
+  const int64_t converted_pixels = converter.converted_pixels();
+  VideoFrame video_frame = converter.Convert(frame, 0);
+
+  // Rounded out to even coordinates.
+  EXPECT_EQ(12 * 8, converter.converted_pixels() - converted_pixels);
+  ASSERT_TRUE(video_frame.has_update_rects());
+  ASSERT_EQ(1u, video_frame.update_rects().size());
+  EXPECT_EQ(11, video_frame.update_rects()[0].offset_x);
+  EXPECT_EQ(5, video_frame.update_rects()[0].offset_y);
+  EXPECT_EQ(10, video_frame.update_rects()[0].width);
+  EXPECT_EQ(6, video_frame.update_rects()[0].height);
+  ExpectFullyConverted(frame, video_frame);
+}
+
+TEST(DesktopFrameConverterTest, CatchesUpBuffersThatWereInUse) {
+  BasicDesktopFrame frame(DesktopSize(kWidth, kHeight));
+  PaintRect(&frame, DesktopRect::MakeSize(frame.size()), 1);
+  DesktopFrameConverter converter;
+  // Held, like a frame waiting to be encoded.
+  VideoFrame first_frame = converter.Convert(frame, 0);
+
+  frame.mutable_updated_region()->Clear();
+  PaintRect(&frame, DesktopRect::MakeXYWH(0, 0, 8, 8), 2);
+  VideoFrame second_frame = converter.Convert(frame, 0);
+  EXPECT_NE(first_frame.video_frame_buffer(),
+            second_frame.video_frame_buffer());
+  ExpectFullyConverted(frame, second_frame);
+
+  // The first buffer is free again, and misses the updates of both frames.
+  rtc::scoped_refptr<VideoFrameBuffer> first_buffer =
+      first_frame.video_frame_buffer();
+  first_frame = second_frame;
+  first_buffer = nullptr;
+  frame.mutable_updated_region()->Clear();
+  PaintRect(&frame, DesktopRect::MakeXYWH(32, 32, 8, 8), 3);
+  const int64_t converted_pixels = converter.converted_pixels();
+  VideoFrame third_frame = converter.Convert(frame, 0);
+  EXPECT_EQ(2 * 8 * 8, converter.converted_pixels() - converted_pixels);
+  ASSERT_EQ(1u, third_frame.update_rects().size());
+  EXPECT_EQ(32, third_frame.update_rects()[0].offset_x);
+  ExpectFullyConverted(frame, third_frame);
+}
+
+TEST(DesktopFrameConverterTest, ConvertsWholeFrameAfterReset) {
+  BasicDesktopFrame frame(DesktopSize(kWidth, kHeight));
+  PaintRect(&frame, DesktopRect::MakeSize(frame.size()), 1);
+  DesktopFrameConverter converter;
+  converter.Convert(frame, 0);
+
+  // A frame was skipped, so its updated region is lost.
+  PaintRect(&frame, DesktopRect::MakeXYWH(0, 0, 8, 8), 2);
+  frame.mutable_updated_region()->Clear();
+  converter.Reset();
+  VideoFrame video_frame = converter.Convert(frame, 0);
+  EXPECT_EQ(2 * kWidth * kHeight, converter.converted_pixels());
+  ASSERT_EQ(1u, video_frame.update_rects().size());
+  EXPECT_EQ(kWidth, video_frame.update_rects()[0].width);
+  ExpectFullyConverted(frame, video_frame);
+}
+
+TEST(DesktopFrameConverterTest, ConvertsWholeFrameOnSizeChange) {
+  DesktopFrameConverter converter;
+  BasicDesktopFrame frame(DesktopSize(kWidth, kHeight));
+  PaintRect(&frame, DesktopRect::MakeSize(frame.size()), 1);
+  converter.Convert(frame, 0);
+
+  BasicDesktopFrame larger_frame(DesktopSize(2 * kWidth, kHeight));
+  PaintRect(&larger_frame, DesktopRect::MakeXYWH(0, 0, 8, 8), 2);
+  VideoFrame video_frame = converter.Convert(larger_frame, 0);
+  EXPECT_EQ(2 * kWidth, video_frame.width());
+  EXPECT_EQ(3 * kWidth * kHeight, converter.converted_pixels());
+  ASSERT_EQ(1u, video_frame.update_rects().size());
+  EXPECT_EQ(2 * kWidth, video_frame.update_rects()[0].width);
+}
+
+}  // namespace webrtc
@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include "webrtc/typedefs.h"
+#include "webrtc/modules/desktop_capture/differ_vector_avx2.h"
 #include "webrtc/modules/desktop_capture/differ_vector_sse2.h"
 #include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
@@ -24,29 +25,65 @@ bool VectorDifference_C(const uint8_t* image1, const uint8_t* image2) {
   return memcmp(image1, image2, kBlockSize * kBytesPerPixel) != 0;
 }
 
-}  // namespace
+bool BlockDifference_C(const uint8_t* image1,
+                       const uint8_t* image2,
+                       int height,
+                       int stride) {
+  for (int i = 0; i < height; i++) {
+    if (VectorDifference(image1, image2)) {
+      return true;
+    }
+    image1 += stride;
+    image2 += stride;
+  }
+  return false;
+}
 
-bool VectorDifference(const uint8_t* image1, const uint8_t* image2) {
-  static bool (*diff_proc)(const uint8_t*, const uint8_t*) = nullptr;
+typedef bool (*VectorDifferenceProc)(const uint8_t*, const uint8_t*);
+typedef bool (*BlockDifferenceProc)(const uint8_t*, const uint8_t*, int, int);
 
-  if (!diff_proc) {
+VectorDifferenceProc SelectVectorDifference() {
 #if defined(WEBRTC_ARCH_ARM_FAMILY) || defined(WEBRTC_ARCH_MIPS_FAMILY)
-    // For ARM and MIPS processors, always use C version.
-    // TODO(hclam): Implement a NEON version.
-    diff_proc = &VectorDifference_C;
+  // For ARM and MIPS processors, always use C version.
+  // TODO(hclam): Implement a NEON version.
+  return &VectorDifference_C;
 #else
-    bool have_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
-    // For x86 processors, check if SSE2 is supported.
-    if (have_sse2 && kBlockSize == 32) {
-      diff_proc = &VectorDifference_SSE2_W32;
-    } else if (have_sse2 && kBlockSize == 16) {
-      diff_proc = &VectorDifference_SSE2_W16;
-    } else {
-      diff_proc = &VectorDifference_C;
-    }
+  bool have_avx2 = WebRtc_GetCPUInfo(kAVX2) != 0;
+  bool have_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
+  // For x86 processors, check if AVX2 or SSE2 is supported.
+  if (have_avx2 && kBlockSize == 32)
+    return &VectorDifference_AVX2_W32;
+  if (have_avx2 && kBlockSize == 16)
+    return &VectorDifference_AVX2_W16;
+  if (have_sse2 && kBlockSize == 32)
+    return &VectorDifference_SSE2_W32;
+  if (have_sse2 && kBlockSize == 16)
+    return &VectorDifference_SSE2_W16;
+  return &VectorDifference_C;
 #endif
-  }
+}
+
+BlockDifferenceProc SelectBlockDifference() {
+#if defined(WEBRTC_ARCH_ARM_FAMILY) || defined(WEBRTC_ARCH_MIPS_FAMILY)
+  return &BlockDifference_C;
+#else
+  // The AVX2 versions compare two rows at a time. Without AVX2, compare row by
+  // row with VectorDifference().
+  bool have_avx2 = WebRtc_GetCPUInfo(kAVX2) != 0;
+  if (have_avx2 && kBlockSize == 32)
+    return &BlockDifference_AVX2_W32;
+  if (have_avx2 && kBlockSize == 16)
+    return &BlockDifference_AVX2_W16;
+  return &BlockDifference_C;
+#endif
+}
 
+}  // namespace
+
+// The implementations are selected once, thread-safely, since frames may be
+// compared on several threads.
+bool VectorDifference(const uint8_t* image1, const uint8_t* image2) {
+  static const VectorDifferenceProc diff_proc = SelectVectorDifference();
   return diff_proc(image1, image2);
 }
 
@@ -54,14 +91,8 @@ bool BlockDifference(const uint8_t* image1,
                      const uint8_t* image2,
                      int height,
                      int stride) {
-  for (int i = 0; i < height; i++) {
-    if (VectorDifference(image1, image2)) {
-      return true;
-    }
-    image1 += stride;
-    image2 += stride;
-  }
-  return false;
+  static const BlockDifferenceProc block_diff_proc = SelectBlockDifference();
+  return block_diff_proc(image1, image2, height, stride);
 }
 
 bool BlockDifference(const uint8_t* image1, const uint8_t* image2, int stride) {
@@ -83,4 +83,23 @@ TEST(BlockDifferenceTestFirst, BlockDifference) {
   }
 }
 
+TEST(BlockDifferenceTestEachByte, BlockDifference) {
+  uint8_t* block1;
+  uint8_t* block2;
+  PrepareBuffers(block1, block2);
+
+  // Every byte of every row is checked, also for odd heights.
+  for (int height = 1; height <= kBlockSize; ++height) {
+    for (int y = 0; y < kBlockSize; ++y) {
+      for (int x = 0; x < kBlockSize * kBytesPerPixel; ++x) {
+        const int offset = y * kBlockSize * kBytesPerPixel + x;
+        block2[offset] += 1;
+        EXPECT_EQ(y < height, BlockDifference(block1, block2, height,
+                                              kBlockSize * kBytesPerPixel));
+        block2[offset] -= 1;
+      }
+    }
+  }
+}
+
 }  // namespace webrtc
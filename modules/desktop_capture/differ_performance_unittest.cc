@@ -0,0 +1,201 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "webrtc/modules/desktop_capture/desktop_capturer_differ_wrapper.h"
+#include "webrtc/modules/desktop_capture/desktop_frame.h"
+#include "webrtc/modules/desktop_capture/differ_block.h"
+#include "webrtc/modules/desktop_capture/shared_desktop_frame.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+#include "webrtc/typedefs.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "webrtc/modules/desktop_capture/differ_vector_avx2.h"
+#include "webrtc/modules/desktop_capture/differ_vector_sse2.h"
+#endif
+
+namespace webrtc {
+namespace {
+
+// Alternates between two frames that differ in a cursor-sized area, and
+// reports the whole frame as updated, which makes the differ compare all of
+// it. Mostly unchanged frames are the common case for screen content.
+class AlternatingFrameCapturer : public DesktopCapturer {
+ public:
+  explicit AlternatingFrameCapturer(const DesktopSize& size) {
+    for (std::unique_ptr<SharedDesktopFrame>& frame : frames_) {
+      frame = SharedDesktopFrame::Wrap(
+          std::unique_ptr<DesktopFrame>(new BasicDesktopFrame(size)));
+      memset(frame->data(), 0x80, frame->stride() * size.height());
+    }
+    for (int y = 0; y < 16; ++y) {
+      memset(frames_[1]->GetFrameDataAtPos(
+                 DesktopVector(size.width() / 2, size.height() / 2 + y)),
+             0xff, 16 * DesktopFrame::kBytesPerPixel);
+    }
+  }
+
+  void Start(Callback* callback) override { callback_ = callback; }
+
+  void CaptureFrame() override {
+    std::unique_ptr<DesktopFrame> frame = frames_[next_frame_]->Share();
+    next_frame_ = 1 - next_frame_;
+    frame->mutable_updated_region()->SetRect(
+        DesktopRect::MakeSize(frame->size()));
+    callback_->OnCaptureResult(Result::SUCCESS, std::move(frame));
+  }
+
+ private:
+  Callback* callback_ = nullptr;
+  std::unique_ptr<SharedDesktopFrame> frames_[2];
+  int next_frame_ = 0;
+};
+
+class DiscardingCallback : public DesktopCapturer::Callback {
+ public:
+  void OnCaptureResult(DesktopCapturer::Result result,
+                       std::unique_ptr<DesktopFrame> frame) override {
+    ASSERT_EQ(DesktopCapturer::Result::SUCCESS, result);
+    ASSERT_FALSE(frame->updated_region().is_empty());
+  }
+};
+
+int NumIterations() {
+  return field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 10 : 200;
+}
+
+void ReportThroughput(const std::string& name,
+                      const std::string& label,
+                      int64_t bytes,
+                      int64_t elapsed_ns) {
+  ASSERT_GT(elapsed_ns, 0);
+  test::PrintResult(name, "", label,
+                    std::to_string(static_cast<double>(bytes) *
+                                   rtc::kNumNanosecsPerSec / elapsed_ns /
+                                   (1 << 20)),
+                    "MB/s", true);
+}
+
+// Runs the differ wrapper on frames of |width|x|height| with
+// |num_compare_threads| helper threads, and reports the compared frame bytes
+// per second.
+void RunDifferWrapperTest(int width,
+                          int height,
+                          size_t num_compare_threads,
+                          const std::string& label) {
+  const DesktopSize size(width, height);
+  DesktopCapturerDifferWrapper capturer(
+      std::unique_ptr<DesktopCapturer>(new AlternatingFrameCapturer(size)),
+      num_compare_threads);
+  DiscardingCallback callback;
+  capturer.Start(&callback);
+  // The first frame is not compared.
+  capturer.CaptureFrame();
+
+  const int num_iterations = NumIterations();
+  const int64_t start_time_ns = rtc::TimeNanos();
+  for (int i = 0; i < num_iterations; ++i)
+    capturer.CaptureFrame();
+  const int64_t elapsed_ns = rtc::TimeNanos() - start_time_ns;
+  ReportThroughput("differ_wrapper_throughput", label,
+                   static_cast<int64_t>(width) * height *
+                       DesktopFrame::kBytesPerPixel * num_iterations,
+                   elapsed_ns);
+}
+
+// Runs |block_difference| over all blocks of two equal frames of
+// |width|x|height|, and reports the compared frame bytes per second.
+void RunBlockDifferenceTest(
+    int width,
+    int height,
+    const std::string& label,
+    const std::function<bool(const uint8_t*, const uint8_t*, int)>&
+        block_difference) {
+  BasicDesktopFrame frame1(DesktopSize(width, height));
+  BasicDesktopFrame frame2(DesktopSize(width, height));
+  memset(frame1.data(), 0x80, frame1.stride() * height);
+  memset(frame2.data(), 0x80, frame2.stride() * height);
+  const int num_iterations = NumIterations();
+  const int64_t start_time_ns = rtc::TimeNanos();
+  for (int i = 0; i < num_iterations; ++i) {
+    for (int y = 0; y + kBlockSize <= height; y += kBlockSize) {
+      for (int x = 0; x + kBlockSize <= width; x += kBlockSize) {
+        const DesktopVector pos(x, y);
+        ASSERT_FALSE(block_difference(frame1.GetFrameDataAtPos(pos),
+                                      frame2.GetFrameDataAtPos(pos),
+                                      frame1.stride()));
+      }
+    }
+  }
+  const int64_t elapsed_ns = rtc::TimeNanos() - start_time_ns;
+  ReportThroughput("block_difference_throughput", label,
+                   static_cast<int64_t>(width) * height *
+                       DesktopFrame::kBytesPerPixel * num_iterations,
+                   elapsed_ns);
+}
+
+}  // namespace
+
+TEST(DifferPerformanceTest, DifferWrapper1080p) {
+  RunDifferWrapperTest(1920, 1080, 0, "1080p_serial");
+  RunDifferWrapperTest(1920, 1080, 3, "1080p_parallel");
+}
+
+TEST(DifferPerformanceTest, DifferWrapper4K) {
+  RunDifferWrapperTest(3840, 2160, 0, "4k_serial");
+  RunDifferWrapperTest(3840, 2160, 3, "4k_parallel");
+}
+
+TEST(DifferPerformanceTest, DifferWrapper5K) {
+  RunDifferWrapperTest(5120, 2880, 0, "5k_serial");
+  RunDifferWrapperTest(5120, 2880, 3, "5k_parallel");
+}
+
+TEST(DifferPerformanceTest, BlockDifference4K) {
+  RunBlockDifferenceTest(
+      3840, 2160, "dispatched",
+      [](const uint8_t* image1, const uint8_t* image2, int stride) {
+        return BlockDifference(image1, image2, stride);
+      });
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    RunBlockDifferenceTest(
+        3840, 2160, "sse2",
+        [](const uint8_t* image1, const uint8_t* image2, int stride) {
+          for (int i = 0; i < kBlockSize; ++i) {
+            if (VectorDifference_SSE2_W32(image1 + i * stride,
+                                          image2 + i * stride)) {
+              return true;
+            }
+          }
+          return false;
+        });
+  }
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    RunBlockDifferenceTest(
+        3840, 2160, "avx2",
+        [](const uint8_t* image1, const uint8_t* image2, int stride) {
+          return BlockDifference_AVX2_W32(image1, image2, kBlockSize, stride);
+        });
+  }
+#endif
+}
+
+}  // namespace webrtc
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/differ_vector_avx2.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+
+namespace {
+
+// Returns the bitwise difference of the 64 bytes at |image1| and |image2|,
+// folded into one register. It is zero if and only if they are equal.
+inline __m256i Difference64(const uint8_t* image1, const uint8_t* image2) {
+  const __m256i* i1 = reinterpret_cast<const __m256i*>(image1);
+  const __m256i* i2 = reinterpret_cast<const __m256i*>(image2);
+  __m256i v0 = _mm256_xor_si256(_mm256_loadu_si256(i1),
+                                _mm256_loadu_si256(i2));
+  __m256i v1 = _mm256_xor_si256(_mm256_loadu_si256(i1 + 1),
+                                _mm256_loadu_si256(i2 + 1));
+  return _mm256_or_si256(v0, v1);
+}
+
+// Same for the 128 bytes of a row of a 32 pixel wide block.
+inline __m256i Difference128(const uint8_t* image1, const uint8_t* image2) {
+  return _mm256_or_si256(Difference64(image1, image2),
+                         Difference64(image1 + 64, image2 + 64));
+}
+
+}  // namespace
+
+extern bool VectorDifference_AVX2_W16(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  const __m256i diff = Difference64(image1, image2);
+  return !_mm256_testz_si256(diff, diff);
+}
+
+extern bool VectorDifference_AVX2_W32(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  const __m256i diff = Difference128(image1, image2);
+  return !_mm256_testz_si256(diff, diff);
+}
+
+extern bool BlockDifference_AVX2_W16(const uint8_t* image1,
+                                     const uint8_t* image2,
+                                     int height,
+                                     int stride) {
+  // Two rows per test, which halves the branches. Unchanged blocks are the
+  // common case, and they are always read in full.
+  int i = 0;
+  for (; i + 1 < height; i += 2) {
+    const __m256i diff =
+        _mm256_or_si256(Difference64(image1, image2),
+                        Difference64(image1 + stride, image2 + stride));
+    if (!_mm256_testz_si256(diff, diff))
+      return true;
+    image1 += 2 * stride;
+    image2 += 2 * stride;
+  }
+  if (i < height)
+    return VectorDifference_AVX2_W16(image1, image2);
+  return false;
+}
+
+extern bool BlockDifference_AVX2_W32(const uint8_t* image1,
+                                     const uint8_t* image2,
+                                     int height,
+                                     int stride) {
+  int i = 0;
+  for (; i + 1 < height; i += 2) {
+    const __m256i diff =
+        _mm256_or_si256(Difference128(image1, image2),
+                        Difference128(image1 + stride, image2 + stride));
+    if (!_mm256_testz_si256(diff, diff))
+      return true;
+    image1 += 2 * stride;
+    image2 += 2 * stride;
+  }
+  if (i < height)
+    return VectorDifference_AVX2_W32(image1, image2);
+  return false;
+}
+
+}  // namespace webrtc
@@ -10,6 +10,10 @@
 
 #include <memory>
 
+#if defined(USE_X11)
+#include <sys/shm.h>
+#endif  // defined(USE_X11)
+
 #include "webrtc/modules/desktop_capture/desktop_capture_options.h"
 #include "webrtc/modules/desktop_capture/desktop_capturer.h"
 #include "webrtc/modules/desktop_capture/desktop_frame.h"
@@ -139,6 +143,90 @@ TEST_F(ScreenCapturerTest, Capture) {
   EXPECT_TRUE(it.IsAtEnd());
 }
 
+#if defined(USE_X11)
+
+namespace {
+
+// Returns true if the RGB components of |frame| and |reference| are equal. The
+// fourth byte of each pixel is not defined by the X server.
+bool EqualPixels(const DesktopFrame& frame, const DesktopFrame& reference) {
+  if (!frame.size().equals(reference.size()))
+    return false;
+  for (int y = 0; y < frame.size().height(); ++y) {
+    const uint8_t* row = frame.GetFrameDataAtPos(DesktopVector(0, y));
+    const uint8_t* reference_row =
+        reference.GetFrameDataAtPos(DesktopVector(0, y));
+    for (int x = 0; x < frame.size().width(); ++x) {
+      const int offset = x * DesktopFrame::kBytesPerPixel;
+      if (row[offset] != reference_row[offset] ||
+          row[offset + 1] != reference_row[offset + 1] ||
+          row[offset + 2] != reference_row[offset + 2]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST_F(ScreenCapturerTest, UseXShmFrames) {
+  // A frame captured the usual way, by copying out of the X server's image.
+  std::unique_ptr<DesktopFrame> reference_frame;
+  EXPECT_CALL(callback_,
+              OnCaptureResultPtr(DesktopCapturer::Result::SUCCESS, _))
+      .WillOnce(SaveUniquePtrArg(&reference_frame));
+  capturer_->Start(&callback_);
+  capturer_->CaptureFrame();
+  ASSERT_TRUE(reference_frame);
+  ASSERT_FALSE(reference_frame->shared_memory());
+
+  DesktopCaptureOptions options(DesktopCaptureOptions::CreateDefault());
+  options.set_use_x_shm_frames(true);
+  options.set_use_update_notifications(true);
+  capturer_ = DesktopCapturer::CreateScreenCapturer(options);
+  ASSERT_TRUE(capturer_);
+  capturer_->Start(&callback_);
+
+  // The first frame is captured in full, the following ones only where the
+  // screen is damaged. Capture enough frames to reuse the queued frames.
+  const DesktopSize size = reference_frame->size();
+  for (int i = 0; i < 4; ++i) {
+    std::unique_ptr<DesktopFrame> frame;
+    EXPECT_CALL(callback_,
+                OnCaptureResultPtr(DesktopCapturer::Result::SUCCESS, _))
+        .WillOnce(SaveUniquePtrArg(&frame));
+    capturer_->CaptureFrame();
+    ASSERT_TRUE(frame);
+    if (i == 0) {
+      EXPECT_TRUE(frame->updated_region().Equals(
+          DesktopRegion(DesktopRect::MakeSize(size))));
+    }
+    EXPECT_TRUE(frame->size().equals(size));
+    EXPECT_GE(frame->stride(), size.width() * DesktopFrame::kBytesPerPixel);
+    for (DesktopRegion::Iterator it(frame->updated_region()); !it.IsAtEnd();
+         it.Advance()) {
+      EXPECT_TRUE(DesktopRect::MakeSize(size).ContainsRect(it.rect()));
+    }
+
+    // The pixels live in a SysV shared memory segment that the X server
+    // wrote into.
+    ASSERT_TRUE(frame->shared_memory());
+    EXPECT_EQ(frame->data(), frame->shared_memory()->data());
+    EXPECT_GE(frame->shared_memory()->size(),
+              static_cast<size_t>(frame->stride() * size.height()));
+    struct shmid_ds shm_info;
+    ASSERT_EQ(0, shmctl(frame->shared_memory()->id(), IPC_STAT, &shm_info));
+    EXPECT_EQ(frame->shared_memory()->size(), shm_info.shm_segsz);
+    // Attached by this process and the X server.
+    EXPECT_GE(shm_info.shm_nattch, 2U);
+
+    EXPECT_TRUE(EqualPixels(*frame, *reference_frame));
+  }
+}
+
+#endif  // defined(USE_X11)
+
 #if defined(WEBRTC_WIN)
 
 TEST_F(ScreenCapturerTest, UseSharedBuffers) {
@@ -13,6 +13,7 @@
 #include <memory>
 #include <set>
 #include <utility>
+#include <vector>
 
 #include <X11/extensions/Xdamage.h>
 #include <X11/extensions/Xfixes.h>
@@ -26,14 +27,27 @@
 #include "webrtc/modules/desktop_capture/screen_capturer_helper.h"
 #include "webrtc/modules/desktop_capture/shared_desktop_frame.h"
 #include "webrtc/modules/desktop_capture/x11/x_server_pixel_buffer.h"
+#include "webrtc/modules/desktop_capture/x11/x_shm_desktop_frame.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/constructormagic.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/metrics.h"
 
 namespace webrtc {
 namespace {
 
+int64_t RectArea(const DesktopRect& rect) {
+  return static_cast<int64_t>(rect.width()) * rect.height();
+}
+
+int64_t RegionArea(const DesktopRegion& region) {
+  int64_t area = 0;
+  for (DesktopRegion::Iterator it(region); !it.IsAtEnd(); it.Advance())
+    area += RectArea(it.rect());
+  return area;
+}
+
 // A class to perform video frame capturing for Linux.
 //
 // If XDamage is used, this class sets DesktopFrame::updated_region() according
@@ -41,6 +55,11 @@ namespace {
 // DesktopFrame::updated_region(), the field is always set to the entire frame
 // rectangle. ScreenCapturerDifferWrapper should be used if that functionality
 // is necessary.
+//
+// If DesktopCaptureOptions::use_x_shm_frames() is set, the frames in the queue
+// are XShmDesktopFrames that the X server writes into directly, so the pixels
+// are not copied through an intermediate buffer. With XDamage only the damaged
+// areas are transferred.
 class ScreenCapturerLinux : public DesktopCapturer,
                             public SharedXDisplay::XEventHandler {
  public:
@@ -81,6 +100,14 @@ class ScreenCapturerLinux : public DesktopCapturer,
   // the one prior to that (which will then be the current buffer).
   void SynchronizeFrame();
 
+  // Returns the XShmDesktopFrame underlying |frame|, or nullptr if |frame| is
+  // not one.
+  XShmDesktopFrame* GetShmFrame(SharedDesktopFrame* frame);
+
+  // Detaches the shared memory frames from the X server. Must be called
+  // before the frames in |queue_| are released.
+  void DetachShmFrames();
+
   void DeinitXlib();
 
   DesktopCaptureOptions options_;
@@ -106,6 +133,16 @@ class ScreenCapturerLinux : public DesktopCapturer,
   // Access to the X Server's pixel buffer.
   XServerPixelBuffer x_server_pixel_buffer_;
 
+  // Whether to allocate XShmDesktopFrames. Cleared if allocating one fails.
+  bool use_shm_frames_ = false;
+  // The frames in |queue_| that are XShmDesktopFrames.
+  std::vector<XShmDesktopFrame*> shm_frames_;
+
+  // Area requested from the X server and area copied by the capturer itself
+  // in the last capture, reported as capture cost metrics.
+  int64_t captured_area_ = 0;
+  int64_t copied_area_ = 0;
+
   // A thread-safe list of invalid rectangles, and the size of the most
   // recently captured screen.
   ScreenCapturerHelper helper_;
@@ -173,6 +210,8 @@ bool ScreenCapturerLinux::Init(const DesktopCaptureOptions& options) {
     InitXDamage();
   }
 
+  use_shm_frames_ = options_.use_x_shm_frames();
+
   return true;
 }
 
@@ -246,9 +285,25 @@ void ScreenCapturerLinux::CaptureFrame() {
   // Note that we can't reallocate other buffers at this point, since the caller
   // may still be reading from them.
   if (!queue_.current_frame()) {
-    queue_.ReplaceCurrentFrame(
-        SharedDesktopFrame::Wrap(std::unique_ptr<DesktopFrame>(
-            new BasicDesktopFrame(x_server_pixel_buffer_.window_size()))));
+    std::unique_ptr<DesktopFrame> frame;
+    if (use_shm_frames_) {
+      std::unique_ptr<XShmDesktopFrame> shm_frame =
+          XShmDesktopFrame::Create(display(), root_window_);
+      if (shm_frame &&
+          shm_frame->size().equals(x_server_pixel_buffer_.window_size())) {
+        shm_frames_.push_back(shm_frame.get());
+        frame = std::move(shm_frame);
+      } else {
+        LOG(LS_WARNING) << "Failed to allocate a shared memory frame, falling "
+                           "back to copying captured pixels.";
+        if (shm_frame)
+          shm_frame->Detach();
+        use_shm_frames_ = false;
+      }
+    }
+    if (!frame)
+      frame.reset(new BasicDesktopFrame(x_server_pixel_buffer_.window_size()));
+    queue_.ReplaceCurrentFrame(SharedDesktopFrame::Wrap(std::move(frame)));
   }
 
   std::unique_ptr<DesktopFrame> result = CaptureScreen();
@@ -258,8 +313,23 @@ void ScreenCapturerLinux::CaptureFrame() {
   }
 
   last_invalid_region_ = result->updated_region();
-  result->set_capture_time_ms((rtc::TimeNanos() - capture_start_time_nanos) /
+  const int64_t capture_time_nanos =
+      rtc::TimeNanos() - capture_start_time_nanos;
+  result->set_capture_time_ms(capture_time_nanos /
                               rtc::kNumNanosecsPerMillisec);
+  const int64_t screen_area =
+      RectArea(DesktopRect::MakeSize(result->size()));
+  RTC_HISTOGRAM_COUNTS_100000(
+      "WebRTC.DesktopCapture.X11.CaptureTimeUs",
+      static_cast<int>(capture_time_nanos / rtc::kNumNanosecsPerMicrosec));
+  if (screen_area > 0) {
+    RTC_HISTOGRAM_PERCENTAGE(
+        "WebRTC.DesktopCapture.X11.CapturedAreaPercent",
+        static_cast<int>(captured_area_ * 100 / screen_area));
+    RTC_HISTOGRAM_PERCENTAGE(
+        "WebRTC.DesktopCapture.X11.CopiedAreaPercent",
+        static_cast<int>(copied_area_ * 100 / screen_area));
+  }
   callback_->OnCaptureResult(Result::SUCCESS, std::move(result));
 }
 
@@ -293,6 +363,9 @@ bool ScreenCapturerLinux::HandleXEvent(const XEvent& event) {
 std::unique_ptr<DesktopFrame> ScreenCapturerLinux::CaptureScreen() {
   std::unique_ptr<SharedDesktopFrame> frame = queue_.current_frame()->Share();
   RTC_DCHECK(x_server_pixel_buffer_.window_size().equals(frame->size()));
+  XShmDesktopFrame* shm_frame = GetShmFrame(frame.get());
+  captured_area_ = 0;
+  copied_area_ = 0;
 
   // Pass the screen size to the helper, so it can clip the invalid region if it
   // expands that region to a grid.
@@ -301,13 +374,15 @@ std::unique_ptr<DesktopFrame> ScreenCapturerLinux::CaptureScreen() {
   // In the DAMAGE case, ensure the frame is up-to-date with the previous frame
   // if any.  If there isn't a previous frame, that means a screen-resolution
   // change occurred, and |invalid_rects| will be updated to include the whole
-  // screen.
-  if (use_damage_ && queue_.previous_frame())
+  // screen. Shared memory frames fetch the areas from the X server instead.
+  if (use_damage_ && queue_.previous_frame() && !shm_frame)
     SynchronizeFrame();
 
   DesktopRegion* updated_region = frame->mutable_updated_region();
+  const DesktopRect screen_rect = DesktopRect::MakeSize(frame->size());
 
-  x_server_pixel_buffer_.Synchronize();
+  if (!shm_frame)
+    x_server_pixel_buffer_.Synchronize();
   if (use_damage_ && queue_.previous_frame()) {
     // Atomically fetch and clear the damage region.
     XDamageSubtract(display(), damage_handle_, None, damage_region_);
@@ -328,20 +403,46 @@ std::unique_ptr<DesktopFrame> ScreenCapturerLinux::CaptureScreen() {
     // Clip the damaged portions to the current screen size, just in case some
     // spurious XDamage notifications were received for a previous (larger)
     // screen size.
-    updated_region->IntersectWith(
-        DesktopRect::MakeSize(x_server_pixel_buffer_.window_size()));
-
-    for (DesktopRegion::Iterator it(*updated_region);
-         !it.IsAtEnd(); it.Advance()) {
-      if (!x_server_pixel_buffer_.CaptureRect(it.rect(), frame.get()))
+    updated_region->IntersectWith(screen_rect);
+
+    if (shm_frame && shm_frame->has_pixmap()) {
+      // The frame also misses the areas updated in the previous frame, see
+      // SynchronizeFrame(). The X server copies both into the frame.
+      DesktopRegion capture_region(*updated_region);
+      capture_region.AddRegion(last_invalid_region_);
+      capture_region.IntersectWith(screen_rect);
+      for (DesktopRegion::Iterator it(capture_region);
+           !it.IsAtEnd(); it.Advance()) {
+        shm_frame->CaptureRect(it.rect());
+      }
+      shm_frame->Synchronize();
+      captured_area_ = RegionArea(capture_region);
+    } else if (shm_frame) {
+      // Without a pixmap only the whole screen can be captured.
+      if (!shm_frame->CaptureWindow())
         return nullptr;
+      captured_area_ = RectArea(screen_rect);
+    } else {
+      for (DesktopRegion::Iterator it(*updated_region);
+           !it.IsAtEnd(); it.Advance()) {
+        if (!x_server_pixel_buffer_.CaptureRect(it.rect(), frame.get()))
+          return nullptr;
+      }
+      captured_area_ = RegionArea(*updated_region);
+      copied_area_ = captured_area_ + RegionArea(last_invalid_region_);
     }
   } else {
     // Doing full-screen polling, or this is the first capture after a
     // screen-resolution change.  In either case, need a full-screen capture.
-    DesktopRect screen_rect = DesktopRect::MakeSize(frame->size());
-    if (!x_server_pixel_buffer_.CaptureRect(screen_rect, frame.get()))
-      return nullptr;
+    if (shm_frame) {
+      if (!shm_frame->CaptureWindow())
+        return nullptr;
+    } else {
+      if (!x_server_pixel_buffer_.CaptureRect(screen_rect, frame.get()))
+        return nullptr;
+      copied_area_ = RectArea(screen_rect);
+    }
+    captured_area_ = RectArea(screen_rect);
     updated_region->SetRect(screen_rect);
   }
 
@@ -350,6 +451,7 @@ std::unique_ptr<DesktopFrame> ScreenCapturerLinux::CaptureScreen() {
 
 void ScreenCapturerLinux::ScreenConfigurationChanged() {
   // Make sure the frame buffers will be reallocated.
+  DetachShmFrames();
   queue_.Reset();
 
   helper_.ClearInvalidRegion();
@@ -379,7 +481,26 @@ void ScreenCapturerLinux::SynchronizeFrame() {
   }
 }
 
+XShmDesktopFrame* ScreenCapturerLinux::GetShmFrame(SharedDesktopFrame* frame) {
+  DesktopFrame* underlying_frame = frame->GetUnderlyingFrame();
+  for (XShmDesktopFrame* shm_frame : shm_frames_) {
+    if (shm_frame == underlying_frame)
+      return shm_frame;
+  }
+  return nullptr;
+}
+
+void ScreenCapturerLinux::DetachShmFrames() {
+  // Consumers may still hold shared copies of the frames, the pixels stay
+  // valid until those are released.
+  for (XShmDesktopFrame* shm_frame : shm_frames_)
+    shm_frame->Detach();
+  shm_frames_.clear();
+}
+
 void ScreenCapturerLinux::DeinitXlib() {
+  DetachShmFrames();
+
   if (gc_) {
     XFreeGC(display(), gc_);
     gc_ = nullptr;
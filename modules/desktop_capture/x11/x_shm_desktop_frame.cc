@@ -0,0 +1,239 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/x11/x_shm_desktop_frame.h"
+
+#include <sys/shm.h>
+
+#include "webrtc/modules/desktop_capture/x11/x_error_trap.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/logging.h"
+
+namespace webrtc {
+
+namespace {
+
+// Returns true if |image| has the pixel format of DesktopFrame, so the X
+// server can write into the frame without conversion.
+bool IsDesktopFrameFormat(const XImage* image) {
+  return image->bits_per_pixel == 32 &&
+      image->red_mask == 0xff0000 &&
+      image->green_mask == 0xff00 &&
+      image->blue_mask == 0xff;
+}
+
+// Describes the segment of an XShmDesktopFrame. SysV segments have no file
+// descriptor, so only the id is set.
+class XShmSharedMemory : public SharedMemory {
+ public:
+  XShmSharedMemory(void* data, size_t size, int shmid)
+      : SharedMemory(data, size, kInvalidHandle, shmid) {}
+};
+
+void ReleaseSegment(XShmSegmentInfo* shm_segment_info) {
+  if (shm_segment_info->shmaddr != nullptr)
+    shmdt(shm_segment_info->shmaddr);
+  if (shm_segment_info->shmid != -1)
+    shmctl(shm_segment_info->shmid, IPC_RMID, 0);
+  delete shm_segment_info;
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<XShmDesktopFrame> XShmDesktopFrame::Create(Display* display,
+                                                           Window window) {
+  XWindowAttributes attributes;
+  {
+    XErrorTrap error_trap(display);
+    if (!XGetWindowAttributes(display, window, &attributes) ||
+        error_trap.GetLastErrorAndDisable() != 0) {
+      return nullptr;
+    }
+  }
+
+  int major, minor;
+  Bool have_pixmaps;
+  if (!XShmQueryVersion(display, &major, &minor, &have_pixmaps))
+    return nullptr;
+
+  XShmSegmentInfo* shm_segment_info = new XShmSegmentInfo;
+  shm_segment_info->shmid = -1;
+  shm_segment_info->shmaddr = nullptr;
+  shm_segment_info->readOnly = False;
+  XImage* x_shm_image = XShmCreateImage(
+      display, attributes.visual, attributes.depth, ZPixmap, 0,
+      shm_segment_info, attributes.width, attributes.height);
+  if (!x_shm_image) {
+    ReleaseSegment(shm_segment_info);
+    return nullptr;
+  }
+  if (!IsDesktopFrameFormat(x_shm_image)) {
+    LOG(LS_INFO) << "X server pixel format is not 32-bit RGB, not using "
+                    "shared memory frames.";
+    XDestroyImage(x_shm_image);
+    ReleaseSegment(shm_segment_info);
+    return nullptr;
+  }
+
+  bool attached = false;
+  shm_segment_info->shmid =
+      shmget(IPC_PRIVATE, x_shm_image->bytes_per_line * x_shm_image->height,
+             IPC_CREAT | 0600);
+  if (shm_segment_info->shmid != -1) {
+    void* shmat_result = shmat(shm_segment_info->shmid, 0, 0);
+    if (shmat_result != reinterpret_cast<void*>(-1)) {
+      shm_segment_info->shmaddr = reinterpret_cast<char*>(shmat_result);
+      x_shm_image->data = shm_segment_info->shmaddr;
+
+      XErrorTrap error_trap(display);
+      attached = XShmAttach(display, shm_segment_info);
+      XSync(display, False);
+      if (error_trap.GetLastErrorAndDisable() != 0)
+        attached = false;
+    }
+  }
+  if (!attached) {
+    LOG(LS_WARNING) << "Failed to attach shared memory frame.";
+    x_shm_image->data = nullptr;
+    XDestroyImage(x_shm_image);
+    ReleaseSegment(shm_segment_info);
+    return nullptr;
+  }
+
+  SharedMemory* shared_memory = new XShmSharedMemory(
+      shm_segment_info->shmaddr,
+      x_shm_image->bytes_per_line * x_shm_image->height,
+      shm_segment_info->shmid);
+
+  // The segment is freed once both the X server and this process detached.
+  shmctl(shm_segment_info->shmid, IPC_RMID, 0);
+  shm_segment_info->shmid = -1;
+
+  std::unique_ptr<XShmDesktopFrame> frame(new XShmDesktopFrame(
+      display, window, DesktopSize(attributes.width, attributes.height),
+      shm_segment_info, x_shm_image, shared_memory));
+  if (have_pixmaps && !frame->InitPixmap(attributes.depth)) {
+    LOG(LS_VERBOSE) << "Shared memory frame without pixmap, only the whole "
+                       "window can be captured.";
+  }
+  return frame;
+}
+
+XShmDesktopFrame::XShmDesktopFrame(Display* display,
+                                   Window window,
+                                   const DesktopSize& size,
+                                   XShmSegmentInfo* shm_segment_info,
+                                   XImage* x_shm_image,
+                                   SharedMemory* shared_memory)
+    : DesktopFrame(size,
+                   x_shm_image->bytes_per_line,
+                   reinterpret_cast<uint8_t*>(shm_segment_info->shmaddr),
+                   shared_memory),
+      display_(display),
+      window_(window),
+      shm_segment_info_(shm_segment_info),
+      x_shm_image_(x_shm_image) {}
+
+XShmDesktopFrame::~XShmDesktopFrame() {
+  // Detach() should have been called on the X thread already. Detaching here
+  // is a last resort to not leak the X resources.
+  RTC_DCHECK(!x_shm_image_);
+  if (x_shm_image_)
+    Detach();
+  delete shared_memory_;
+  ReleaseSegment(shm_segment_info_);
+}
+
+bool XShmDesktopFrame::InitPixmap(int depth) {
+  if (XShmPixmapFormat(display_) != ZPixmap)
+    return false;
+
+  {
+    XErrorTrap error_trap(display_);
+    shm_pixmap_ = XShmCreatePixmap(display_, window_,
+                                   shm_segment_info_->shmaddr,
+                                   shm_segment_info_, size().width(),
+                                   size().height(), depth);
+    XSync(display_, False);
+    if (error_trap.GetLastErrorAndDisable() != 0) {
+      // |shm_pixmap_| is not valid because the request was not processed by
+      // the X Server, so zero it.
+      shm_pixmap_ = 0;
+      return false;
+    }
+  }
+
+  {
+    XErrorTrap error_trap(display_);
+    XGCValues shm_gc_values;
+    shm_gc_values.subwindow_mode = IncludeInferiors;
+    shm_gc_values.graphics_exposures = False;
+    shm_gc_ = XCreateGC(display_, window_,
+                        GCSubwindowMode | GCGraphicsExposures,
+                        &shm_gc_values);
+    XSync(display_, False);
+    if (error_trap.GetLastErrorAndDisable() != 0) {
+      XFreePixmap(display_, shm_pixmap_);
+      shm_pixmap_ = 0;
+      shm_gc_ = nullptr;  // See shm_pixmap_ comment above.
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void XShmDesktopFrame::CaptureRect(const DesktopRect& rect) {
+  RTC_DCHECK(shm_pixmap_);
+  RTC_DCHECK(DesktopRect::MakeSize(size()).ContainsRect(rect));
+  XCopyArea(display_, window_, shm_pixmap_, shm_gc_, rect.left(), rect.top(),
+            rect.width(), rect.height(), rect.left(), rect.top());
+}
+
+bool XShmDesktopFrame::CaptureWindow() {
+  RTC_DCHECK(x_shm_image_);
+  if (shm_pixmap_) {
+    CaptureRect(DesktopRect::MakeSize(size()));
+    Synchronize();
+    return true;
+  }
+  // XShmGetImage can fail if the display is being reconfigured, or if the
+  // window is partially out of screen.
+  XErrorTrap error_trap(display_);
+  return XShmGetImage(display_, window_, x_shm_image_, 0, 0, AllPlanes) &&
+         error_trap.GetLastErrorAndDisable() == 0;
+}
+
+void XShmDesktopFrame::Synchronize() {
+  XSync(display_, False);
+}
+
+void XShmDesktopFrame::Detach() {
+  if (!x_shm_image_)
+    return;
+  if (shm_gc_) {
+    XFreeGC(display_, shm_gc_);
+    shm_gc_ = nullptr;
+  }
+  if (shm_pixmap_) {
+    XFreePixmap(display_, shm_pixmap_);
+    shm_pixmap_ = 0;
+  }
+  XShmDetach(display_, shm_segment_info_);
+  // The data is owned by |shm_segment_info_|, don't let XDestroyImage() free
+  // it.
+  x_shm_image_->data = nullptr;
+  XDestroyImage(x_shm_image_);
+  x_shm_image_ = nullptr;
+  display_ = nullptr;
+}
+
+}  // namespace webrtc
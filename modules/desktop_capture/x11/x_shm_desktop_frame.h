@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Don't include this file in any .h files because it pulls in some X headers.
+
+#ifndef WEBRTC_MODULES_DESKTOP_CAPTURE_X11_X_SHM_DESKTOP_FRAME_H_
+#define WEBRTC_MODULES_DESKTOP_CAPTURE_X11_X_SHM_DESKTOP_FRAME_H_
+
+#include <memory>
+
+#include "webrtc/modules/desktop_capture/desktop_frame.h"
+#include "webrtc/modules/desktop_capture/desktop_geometry.h"
+#include "webrtc/rtc_base/constructormagic.h"
+
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+
+namespace webrtc {
+
+// A DesktopFrame whose pixels live in a shared memory segment attached to the
+// X server, so that the server writes captured pixels straight into the frame
+// instead of into an intermediate buffer that is then copied.
+//
+// shared_memory() describes the segment: its id() is the SysV shared memory id
+// and it has no handle.
+//
+// The X resources must be released with Detach() on the thread that owns
+// |display|. The pixels stay mapped until the frame is destroyed, so shared
+// copies of a detached frame may be destroyed on any thread.
+class XShmDesktopFrame : public DesktopFrame {
+ public:
+  // Returns nullptr if the X server does not support shared memory, or if the
+  // pixel format of |window| is not the 32-bit RGB format of DesktopFrame.
+  static std::unique_ptr<XShmDesktopFrame> Create(Display* display,
+                                                  Window window);
+
+  ~XShmDesktopFrame() override;
+
+  // Whether the frame is backed by a shared memory pixmap, which allows
+  // capturing parts of the window.
+  bool has_pixmap() const { return shm_pixmap_ != 0; }
+
+  // Queues a copy of |rect| of the window into the frame. Requires a pixmap.
+  // The pixels are only guaranteed to be in the frame after Synchronize().
+  void CaptureRect(const DesktopRect& rect);
+
+  // Copies the whole window into the frame. Returns false on failure, e.g. if
+  // the window is partially off screen.
+  bool CaptureWindow();
+
+  // Waits until the X server has executed the copies queued by CaptureRect().
+  void Synchronize();
+
+  // Releases the X resources of the frame. No other methods may be called
+  // afterwards.
+  void Detach();
+
+ private:
+  XShmDesktopFrame(Display* display,
+                   Window window,
+                   const DesktopSize& size,
+                   XShmSegmentInfo* shm_segment_info,
+                   XImage* x_shm_image,
+                   SharedMemory* shared_memory);
+
+  bool InitPixmap(int depth);
+
+  Display* display_;
+  const Window window_;
+  // Owned. Its |shmaddr| is the frame data.
+  XShmSegmentInfo* shm_segment_info_;
+  // Owned, describes the frame data to XShmGetImage().
+  XImage* x_shm_image_;
+  Pixmap shm_pixmap_ = 0;
+  GC shm_gc_ = nullptr;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(XShmDesktopFrame);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_DESKTOP_CAPTURE_X11_X_SHM_DESKTOP_FRAME_H_
@@ -137,21 +137,24 @@ int32_t VideoCaptureModuleV4L2::StartCapture(
 
     // Supported video formats in preferred order.
     // If the requested resolution is larger than VGA, we prefer MJPEG. Go for
-    // I420 otherwise.
-    const int nFormats = 5;
+    // I420 otherwise. NV12 is delivered without conversion, so it is as cheap
+    // as I420.
+    const int nFormats = 6;
     unsigned int fmts[nFormats];
     if (capability.width > 640 || capability.height > 480) {
         fmts[0] = V4L2_PIX_FMT_MJPEG;
         fmts[1] = V4L2_PIX_FMT_YUV420;
-        fmts[2] = V4L2_PIX_FMT_YUYV;
-        fmts[3] = V4L2_PIX_FMT_UYVY;
-        fmts[4] = V4L2_PIX_FMT_JPEG;
+        fmts[2] = V4L2_PIX_FMT_NV12;
+        fmts[3] = V4L2_PIX_FMT_YUYV;
+        fmts[4] = V4L2_PIX_FMT_UYVY;
+        fmts[5] = V4L2_PIX_FMT_JPEG;
     } else {
         fmts[0] = V4L2_PIX_FMT_YUV420;
-        fmts[1] = V4L2_PIX_FMT_YUYV;
-        fmts[2] = V4L2_PIX_FMT_UYVY;
-        fmts[3] = V4L2_PIX_FMT_MJPEG;
-        fmts[4] = V4L2_PIX_FMT_JPEG;
+        fmts[1] = V4L2_PIX_FMT_NV12;
+        fmts[2] = V4L2_PIX_FMT_YUYV;
+        fmts[3] = V4L2_PIX_FMT_UYVY;
+        fmts[4] = V4L2_PIX_FMT_MJPEG;
+        fmts[5] = V4L2_PIX_FMT_JPEG;
     }
 
     // Enumerate image formats.
@@ -201,6 +204,8 @@ int32_t VideoCaptureModuleV4L2::StartCapture(
       _captureVideoType = VideoType::kYUY2;
     else if (video_fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_YUV420)
       _captureVideoType = VideoType::kI420;
+    else if (video_fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_NV12)
+      _captureVideoType = VideoType::kNV12;
     else if (video_fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_UYVY)
       _captureVideoType = VideoType::kUYVY;
     else if (video_fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_MJPEG ||
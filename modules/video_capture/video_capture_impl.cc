@@ -158,6 +158,31 @@ int32_t VideoCaptureImpl::IncomingFrame(
       }
     }
 
+    // Sinks handle NV12, so keep it as is unless the frame has to be rotated
+    // or flipped, which only the I420 conversion can do.
+    if (frameInfo.videoType == VideoType::kNV12 && height > 0 &&
+        (!apply_rotation || _rotateFrame == kVideoRotation_0)) {
+      rtc::scoped_refptr<NV12Buffer> nv12_buffer =
+          nv12_buffer_pool_.CreateBuffer(width, height);
+      if (!nv12_buffer) {
+        LOG(LS_WARNING) << "Dropping NV12 capture frame, no free buffer.";
+        return -1;
+      }
+      // Same size in and out, so this is a plain copy that needs no
+      // temporary buffer.
+      NV12Scale(nullptr, videoFrame, width, videoFrame + width * height,
+                (width + 1) / 2 * 2, width, height,
+                nv12_buffer->MutableDataY(), nv12_buffer->StrideY(),
+                nv12_buffer->MutableDataUV(), nv12_buffer->StrideUV(), width,
+                height);
+      VideoFrame captureFrame(nv12_buffer, 0, rtc::TimeMillis(),
+                              !apply_rotation ? _rotateFrame
+                                              : kVideoRotation_0);
+      captureFrame.set_ntp_time_ms(captureTime);
+      DeliverCapturedFrame(captureFrame);
+      return 0;
+    }
+
     // Setting absolute height (in case it was negative).
     // In Windows, the image starts bottom left, instead of top left.
     // Setting a negative source height, inverts the image (within LibYuv).
@@ -16,6 +16,7 @@
  */
 
 #include "webrtc/api/video/video_frame.h"
+#include "webrtc/common_video/include/nv12_buffer_pool.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/video_capture/video_capture.h"
 #include "webrtc/modules/video_capture/video_capture_config.h"
@@ -114,6 +115,10 @@ private:
 
     // Indicate whether rotation should be applied before delivered externally.
     bool apply_rotation_;
+
+    // NV12 frames that need no rotation are copied into buffers from this
+    // pool and delivered as NV12, instead of being converted to I420.
+    NV12BufferPool nv12_buffer_pool_;
 };
 }  // namespace videocapturemodule
 }  // namespace webrtc
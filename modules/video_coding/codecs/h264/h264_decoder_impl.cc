@@ -130,8 +130,12 @@ int H264DecoderImpl::AVGetBuffer2(
   // http://crbug.com/390941. Our pool is set up to zero-initialize new buffers.
   // TODO(nisse): Delete that feature from the video pool, instead add
   // an explicit call to InitializeData here.
-  rtc::scoped_refptr<I420Buffer> frame_buffer =
-      decoder->pool_.CreateBuffer(width, height);
+  rtc::scoped_refptr<I420Buffer> frame_buffer;
+  {
+    // With threaded decoding this is called on FFmpeg's decoding threads.
+    rtc::CritScope lock(&decoder->pool_crit_);
+    frame_buffer = decoder->pool_.CreateBuffer(width, height);
+  }
 
   int y_size = width * height;
   int uv_size = frame_buffer->ChromaWidth() * frame_buffer->ChromaHeight();
@@ -228,10 +232,22 @@ int32_t H264DecoderImpl::InitDecode(const VideoCodec* codec_settings,
   av_context_->extradata = nullptr;
   av_context_->extradata_size = 0;
 
-  // If this is ever increased, look at |av_context_->thread_safe_callbacks| and
-  // make it possible to disable the thread checker in the frame buffer pool.
+  // Single threaded unless |codec_settings| asks for slice or frame threading.
+  // With frame threading, the decoded output lags behind the input by up to
+  // |thread_count - 1| frames.
   av_context_->thread_count = 1;
   av_context_->thread_type = FF_THREAD_SLICE;
+  if (codec_settings) {
+    const VideoDecoderThreadingSettings& threading =
+        codec_settings->decoder_threading;
+    av_context_->thread_count =
+        GetDecoderThreadCount(threading, number_of_cores);
+    if (threading.mode == VideoDecoderThreading::kFrame)
+      av_context_->thread_type = FF_THREAD_FRAME;
+  }
+  // |AVGetBuffer2| serializes access to |pool_| with |pool_crit_|, so it may
+  // be called on FFmpeg's frame threads.
+  av_context_->thread_safe_callbacks = 1;
 
   // Function used by FFmpeg to get buffers to store decoded frames in.
   av_context_->get_buffer2 = AVGetBuffer2;
@@ -319,7 +335,9 @@ int32_t H264DecoderImpl::Decode(const EncodedImage& input_image,
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
   packet.size = static_cast<int>(input_image._length);
-  av_context_->reordered_opaque = input_image.ntp_time_ms_ * 1000;  // ms -> μs
+  // With frame threading the decoded frame may belong to an earlier input, so
+  // its RTP timestamp is carried through FFmpeg.
+  av_context_->reordered_opaque = input_image._timeStamp;
 
   int frame_decoded = 0;
   int result = avcodec_decode_video2(av_context_.get(),
@@ -354,14 +372,18 @@ int32_t H264DecoderImpl::Decode(const EncodedImage& input_image,
   RTC_CHECK_EQ(av_frame_->data[kYPlaneIndex], i420_buffer->DataY());
   RTC_CHECK_EQ(av_frame_->data[kUPlaneIndex], i420_buffer->DataU());
   RTC_CHECK_EQ(av_frame_->data[kVPlaneIndex], i420_buffer->DataV());
-  video_frame->set_timestamp(input_image._timeStamp);
+  video_frame->set_timestamp(
+      static_cast<uint32_t>(av_frame_->reordered_opaque));
 
   rtc::Optional<uint8_t> qp;
   // TODO(sakal): Maybe it is possible to get QP directly from FFmpeg.
   h264_bitstream_parser_.ParseBitstream(input_image._buffer,
                                         input_image._length);
   int qp_int;
-  if (h264_bitstream_parser_.GetLastSliceQp(&qp_int)) {
+  // The parsed QP belongs to |input_image|, which is not the decoded frame when
+  // frame threading is active.
+  if (av_context_->active_thread_type != FF_THREAD_FRAME &&
+      h264_bitstream_parser_.GetLastSliceQp(&qp_int)) {
     qp.emplace(qp_int);
   }
 
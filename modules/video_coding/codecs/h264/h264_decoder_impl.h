@@ -22,6 +22,8 @@ extern "C" {
 
 #include "webrtc/common_video/h264/h264_bitstream_parser.h"
 #include "webrtc/common_video/include/i420_buffer_pool.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/thread_annotations.h"
 
 namespace webrtc {
 
@@ -38,7 +40,8 @@ class H264DecoderImpl : public H264Decoder {
   ~H264DecoderImpl() override;
 
   // If |codec_settings| is NULL it is ignored. If it is not NULL,
-  // |codec_settings->codecType| must be |kVideoCodecH264|.
+  // |codec_settings->codecType| must be |kVideoCodecH264|, and its
+  // |decoder_threading| selects FFmpeg's slice or frame threading.
   int32_t InitDecode(const VideoCodec* codec_settings,
                      int32_t number_of_cores) override;
   int32_t Release() override;
@@ -70,7 +73,8 @@ class H264DecoderImpl : public H264Decoder {
   void ReportInit();
   void ReportError();
 
-  I420BufferPool pool_;
+  rtc::CriticalSection pool_crit_;
+  I420BufferPool pool_ GUARDED_BY(pool_crit_);
   std::unique_ptr<AVCodecContext, AVCodecContextDeleter> av_context_;
   std::unique_ptr<AVFrame, AVFrameDeleter> av_frame_;
 
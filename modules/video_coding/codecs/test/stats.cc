@@ -49,6 +49,20 @@ FrameStatistic& Stats::NewFrame(int frame_number) {
   return stats_[frame_number];
 }
 
+double Stats::DecodeFps() const {
+  int num_decoded_frames = 0;
+  int64_t total_decoding_time_in_us = 0;
+  for (const FrameStatistic& stat : stats_) {
+    if (stat.decoding_successful) {
+      ++num_decoded_frames;
+      total_decoding_time_in_us += stat.decode_time_in_us;
+    }
+  }
+  if (total_decoding_time_in_us == 0)
+    return 0.0;
+  return num_decoded_frames * 1e6 / total_decoding_time_in_us;
+}
+
 void Stats::PrintSummary() {
   printf("Processing summary:\n");
   if (stats_.empty()) {
@@ -118,6 +132,7 @@ void Stats::PrintSummary() {
            frame->frame_number);
     printf("  Average : %7d us\n",
            static_cast<int>(total_decoding_time_in_us / decoded_frames.size()));
+    printf("  Speed   : %7.1f fps\n", DecodeFps());
     printf("  Failures: %d frames failed to decode.\n",
            static_cast<int>(stats_.size() - decoded_frames.size()));
   }
@@ -60,6 +60,10 @@ class Stats {
   // processing.
   void PrintSummary();
 
+  // Returns the number of frames decoded per second of decode time, over all
+  // successfully decoded frames. Returns 0 if no frame has been decoded.
+  double DecodeFps() const;
+
   std::vector<FrameStatistic> stats_;
 };
 
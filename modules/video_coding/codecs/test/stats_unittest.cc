@@ -43,5 +43,17 @@ TEST(StatsTest, AddMultipleFrames) {
   stats.PrintSummary();  // should not crash
 }
 
+TEST(StatsTest, DecodeFpsOnlyCountsDecodedFrames) {
+  Stats stats;
+  EXPECT_EQ(0.0, stats.DecodeFps());
+  for (int i = 0; i < 3; ++i) {
+    FrameStatistic& frame_stat = stats.NewFrame(i);
+    frame_stat.decoding_successful = i != 1;
+    frame_stat.decode_time_in_us = 10000;
+  }
+  // Two frames decoded in 20 ms.
+  EXPECT_DOUBLE_EQ(100.0, stats.DecodeFps());
+}
+
 }  // namespace test
 }  // namespace webrtc
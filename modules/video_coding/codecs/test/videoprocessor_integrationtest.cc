@@ -10,6 +10,10 @@
 
 #include "webrtc/modules/video_coding/codecs/test/videoprocessor_integrationtest.h"
 
+#include <string>
+
+#include "webrtc/test/testsupport/perf_test.h"
+
 namespace webrtc {
 namespace test {
 
@@ -450,5 +454,68 @@ TEST_F(VideoProcessorIntegrationTest, MAYBE_ProcessNoLossTemporalLayersVP8) {
   ProcessFramesAndVerify(quality_thresholds, rate_profile, process_settings,
                          rc_thresholds, nullptr /* visualization_params */);
 }
+
+// Decodes foreman (CIF) with 1, 2 and 4 decoder threads and reports the
+// decoding speed. Slice threading is used since the VideoProcessor expects
+// every frame to be decoded by the Decode() call it was passed to, which frame
+// threading does not guarantee. Quality thresholds are those of the single
+// threaded tests; threading must not change the decoded output.
+class VideoProcessorDecoderThreadingTest
+    : public VideoProcessorIntegrationTest,
+      public ::testing::WithParamInterface<int> {
+ protected:
+  void RunTest(VideoCodecType codec_type,
+               const QualityThresholds& quality_thresholds) {
+    RateProfile rate_profile;
+    SetRateProfile(&rate_profile, 0, 500, 30, 0);
+    rate_profile.frame_index_rate_update[1] = kNumFramesShort + 1;
+    rate_profile.num_frames = kNumFramesShort;
+    ProcessParams process_settings(kHwCodec, kUseSingleCore, 0.0f, -1,
+                                   kForemanCif, kVerboseLogging, kBatchMode);
+    SetCodecSettings(&config_, &codec_settings_, codec_type, 1, false, false,
+                     true, false, kResilienceOn, kCifWidth, kCifHeight);
+    codec_settings_.decoder_threading = {VideoDecoderThreading::kSlice,
+                                         GetParam(), 0};
+    // Only the decoder is under test here.
+    RateControlThresholds rc_thresholds[1];
+    SetRateControlThresholds(rc_thresholds, 0, kNumFramesShort + 1, 10000,
+                             10000, 10000, kNumFramesShort + 1, 0, 1);
+    ProcessFramesAndVerify(quality_thresholds, rate_profile, process_settings,
+                           rc_thresholds, nullptr /* visualization_params */);
+
+    test::PrintResult(
+        "decode_fps",
+        std::string("_") + CodecTypeToPayloadName(codec_type).value_or(""),
+        std::to_string(GetParam()) + "_threads",
+        std::to_string(stats_.DecodeFps()), "fps", false);
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(NumThreads,
+                        VideoProcessorDecoderThreadingTest,
+                        ::testing::Values(1, 2, 4));
+
+TEST_P(VideoProcessorDecoderThreadingTest, DecodeSpeedVP8) {
+  QualityThresholds quality_thresholds;
+  SetQualityThresholds(&quality_thresholds, 34.95, 33.0, 0.90, 0.89);
+  RunTest(kVideoCodecVP8, quality_thresholds);
+}
+
+#if !defined(RTC_DISABLE_VP9)
+TEST_P(VideoProcessorDecoderThreadingTest, DecodeSpeedVP9) {
+  QualityThresholds quality_thresholds;
+  SetQualityThresholds(&quality_thresholds, 37.0, 36.0, 0.93, 0.92);
+  RunTest(kVideoCodecVP9, quality_thresholds);
+}
+#endif  // !defined(RTC_DISABLE_VP9)
+
+#if defined(WEBRTC_VIDEOPROCESSOR_H264_TESTS)
+TEST_P(VideoProcessorDecoderThreadingTest, DecodeSpeedH264) {
+  QualityThresholds quality_thresholds;
+  SetQualityThresholds(&quality_thresholds, 35.0, 25.0, 0.93, 0.70);
+  RunTest(kVideoCodecH264, quality_thresholds);
+}
+#endif  // defined(WEBRTC_VIDEOPROCESSOR_H264_TESTS)
+
 }  // namespace test
 }  // namespace webrtc
@@ -0,0 +1,181 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/api/video/nv12_buffer.h"
+#include "webrtc/common_video/include/i420_buffer_pool.h"
+#include "webrtc/common_video/include/nv12_buffer_pool.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/modules/video_coding/codecs/vp8/temporal_layers.h"
+#include "webrtc/modules/video_coding/include/video_codec_interface.h"
+#include "webrtc/modules/video_coding/video_coding_impl.h"
+#include "webrtc/rtc_base/cpu_time.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kFramerate = 30;
+const int kCaptureWidth = 1280;
+const int kCaptureHeight = 720;
+// The resolution the adapter asks for, e.g. after CPU adaptation.
+const int kEncodeWidth = 960;
+const int kEncodeHeight = 540;
+
+class CountingCallback : public EncodedImageCallback {
+ public:
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info,
+                        const RTPFragmentationHeader* fragmentation) override {
+    ++num_encoded_images_;
+    return Result(Result::OK, encoded_image._timeStamp);
+  }
+
+  int num_encoded_images() const { return num_encoded_images_; }
+
+ private:
+  int num_encoded_images_ = 0;
+};
+
+// Raw frames the way a camera delivers them, with some motion so that the
+// encoder has work to do.
+std::vector<std::vector<uint8_t>> CreateCameraFrames(int num_frames) {
+  const size_t y_size = kCaptureWidth * kCaptureHeight;
+  std::vector<std::vector<uint8_t>> frames(num_frames);
+  for (int i = 0; i < num_frames; ++i) {
+    frames[i].resize(y_size + 2 * ((kCaptureWidth + 1) / 2) *
+                                  ((kCaptureHeight + 1) / 2));
+    for (int y = 0; y < kCaptureHeight; ++y) {
+      for (int x = 0; x < kCaptureWidth; ++x)
+        frames[i][y * kCaptureWidth + x] = (x + y + 4 * i) & 0xff;
+    }
+    memset(&frames[i][y_size], 0x80 + i % 16, frames[i].size() - y_size);
+  }
+  return frames;
+}
+
+VideoCodec CreateCodec(TemporalLayersFactory* tl_factory) {
+  VideoCodec codec;
+  codec.codecType = kVideoCodecVP8;
+  strncpy(codec.plName, "VP8", 4);
+  codec.plType = 120;
+  codec.width = kEncodeWidth;
+  codec.height = kEncodeHeight;
+  codec.maxFramerate = kFramerate;
+  codec.qpMax = 56;
+  codec.startBitrate = 1200;
+  codec.maxBitrate = 1200;
+  codec.numberOfSimulcastStreams = 0;
+  *codec.VP8() = VideoEncoder::GetDefaultVp8Settings();
+  codec.VP8()->tl_factory = tl_factory;
+  codec.VP8()->frameDroppingOn = false;
+  return codec;
+}
+
+// Takes each camera frame through capture, scaling to the resolution the
+// encoder is configured for, and encoding through VideoSender, all on this
+// thread. Either the frames are converted to I420 right after capture, as all
+// frames were before NV12 buffers existed, or they stay NV12 until the encoder
+// converts them at the smaller resolution. Reports the CPU time per frame and
+// the number of NV12 to I420 conversions per frame.
+void RunCaptureToEncodeTest(bool keep_nv12, const std::string& label) {
+  const int num_frames =
+      field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 30 : 300;
+  const std::vector<std::vector<uint8_t>> camera_frames =
+      CreateCameraFrames(kFramerate);
+  TemporalLayersFactory tl_factory;
+  const VideoCodec codec = CreateCodec(&tl_factory);
+  std::unique_ptr<VP8Encoder> encoder(VP8Encoder::Create());
+  SimulatedClock clock(1000);
+  CountingCallback callback;
+  vcm::VideoSender sender(&clock, &callback, nullptr);
+  sender.RegisterExternalEncoder(encoder.get(), codec.plType, false);
+  ASSERT_EQ(VCM_OK, sender.RegisterSendCodec(&codec, 1, 1200));
+  sender.EnableFrameDropper(false);
+
+  NV12BufferPool capture_pool;
+  NV12BufferPool nv12_pool;
+  I420BufferPool i420_pool;
+  I420BufferPool scaled_i420_pool;
+  const int num_conversions = NV12BufferInterface::NumI420Conversions();
+  const int64_t start_time_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < num_frames; ++i) {
+    const std::vector<uint8_t>& camera_frame =
+        camera_frames[i % camera_frames.size()];
+    const uint8_t* data_y = camera_frame.data();
+    const uint8_t* data_uv = data_y + kCaptureWidth * kCaptureHeight;
+    const int stride_uv = (kCaptureWidth + 1) / 2 * 2;
+    // The capture module copies the frame into a pooled NV12 buffer.
+    rtc::scoped_refptr<NV12Buffer> captured =
+        capture_pool.CreateBuffer(kCaptureWidth, kCaptureHeight);
+    NV12Scale(nullptr, data_y, kCaptureWidth, data_uv, stride_uv,
+              kCaptureWidth, kCaptureHeight, captured->MutableDataY(),
+              captured->StrideY(), captured->MutableDataUV(),
+              captured->StrideUV(), kCaptureWidth, kCaptureHeight);
+    rtc::scoped_refptr<VideoFrameBuffer> buffer;
+    if (keep_nv12) {
+      rtc::scoped_refptr<NV12Buffer> scaled =
+          nv12_pool.CreateBuffer(kEncodeWidth, kEncodeHeight);
+      scaled->ScaleFrom(*captured);
+      buffer = scaled;
+    } else {
+      rtc::scoped_refptr<I420Buffer> converted =
+          i420_pool.CreateBuffer(kCaptureWidth, kCaptureHeight);
+      captured->ConvertToI420(
+          converted->MutableDataY(), converted->StrideY(),
+          converted->MutableDataU(), converted->StrideU(),
+          converted->MutableDataV(), converted->StrideV());
+      rtc::scoped_refptr<I420Buffer> scaled =
+          scaled_i420_pool.CreateBuffer(kEncodeWidth, kEncodeHeight);
+      scaled->ScaleFrom(*converted);
+      buffer = scaled;
+    }
+    clock.AdvanceTimeMilliseconds(1000 / kFramerate);
+    VideoFrame frame(buffer, 90000 * i / kFramerate,
+                     clock.TimeInMilliseconds(), kVideoRotation_0);
+    ASSERT_EQ(VCM_OK, sender.AddVideoFrame(frame, nullptr));
+  }
+  const int64_t cpu_time_ns = rtc::GetThreadCpuTimeNanos() - start_time_ns;
+  const int conversions =
+      NV12BufferInterface::NumI420Conversions() - num_conversions;
+  EXPECT_EQ(num_frames, callback.num_encoded_images());
+
+  test::PrintResult("capture_to_encode_cpu_time", "", label,
+                    std::to_string(static_cast<double>(cpu_time_ns) /
+                                   (num_frames * rtc::kNumNanosecsPerMillisec)),
+                    "ms", true);
+  test::PrintResult(
+      "capture_to_encode_i420_conversions", "", label,
+      std::to_string(static_cast<double>(conversions) / num_frames), "count",
+      false);
+}
+
+}  // namespace
+
+TEST(Vp8Nv12PerformanceTest, CaptureToEncodeConvertingAtCapture) {
+  RunCaptureToEncodeTest(false, "i420_at_capture");
+}
+
+TEST(Vp8Nv12PerformanceTest, CaptureToEncodeKeepingNv12) {
+  RunCaptureToEncodeTest(true, "nv12");
+}
+
+}  // namespace webrtc
@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/modules/video_coding/codecs/vp8/temporal_layers.h"
+#include "webrtc/modules/video_coding/include/video_codec_interface.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/test/frame_generator.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kFramerate = 30;
+const int kNumStreams = 3;
+const int kNumReinits = 20;
+
+class CountingCallback : public EncodedImageCallback {
+ public:
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info,
+                        const RTPFragmentationHeader* fragmentation) override {
+    ++num_encoded_images_;
+    return Result(Result::OK, encoded_image._timeStamp);
+  }
+
+  int num_encoded_images() const { return num_encoded_images_; }
+
+ private:
+  int num_encoded_images_ = 0;
+};
+
+// Three streams, each half the size of the next one, with bitrates loosely
+// following the resolution.
+VideoCodec CreateSimulcastCodec(int width,
+                                int height,
+                                TemporalLayersFactory* tl_factory) {
+  VideoCodec codec;
+  codec.codecType = kVideoCodecVP8;
+  strncpy(codec.plName, "VP8", 4);
+  codec.plType = 120;
+  codec.width = width;
+  codec.height = height;
+  codec.maxFramerate = kFramerate;
+  codec.qpMax = 56;
+  codec.numberOfSimulcastStreams = kNumStreams;
+  const int top_bitrate_kbps = width * height * 2 / 1000;
+  int start_bitrate_kbps = 0;
+  for (int i = 0; i < kNumStreams; ++i) {
+    SimulcastStream& stream = codec.simulcastStream[i];
+    const int scale = 1 << (kNumStreams - 1 - i);
+    stream.width = width / scale;
+    stream.height = height / scale;
+    stream.numberOfTemporalLayers = 1;
+    stream.maxBitrate = top_bitrate_kbps / (scale * scale);
+    stream.targetBitrate = stream.maxBitrate;
+    stream.minBitrate = stream.maxBitrate / 4;
+    stream.qpMax = 56;
+    start_bitrate_kbps += stream.maxBitrate;
+  }
+  codec.minBitrate = codec.simulcastStream[0].minBitrate;
+  codec.maxBitrate = start_bitrate_kbps;
+  codec.startBitrate = start_bitrate_kbps;
+  *codec.VP8() = VideoEncoder::GetDefaultVp8Settings();
+  codec.VP8()->tl_factory = tl_factory;
+  // Every frame should come out on every stream.
+  codec.VP8()->frameDroppingOn = false;
+  return codec;
+}
+
+// Reports the time per encoded simulcast frame, and the time it takes to
+// reinitialize the encoder with the same settings, which is where the
+// downscaled layers get (re)allocated.
+void RunVp8SimulcastPerformanceTest(int width, int height) {
+  const int num_frames =
+      field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 30 : 300;
+  const std::string label =
+      std::to_string(width) + "x" + std::to_string(height);
+  TemporalLayersFactory tl_factory;
+  const VideoCodec codec = CreateSimulcastCodec(width, height, &tl_factory);
+  std::unique_ptr<VP8Encoder> encoder(VP8Encoder::Create());
+  CountingCallback callback;
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->InitEncode(&codec, 1, 1200));
+  encoder->RegisterEncodeCompleteCallback(&callback);
+
+  std::unique_ptr<test::FrameGenerator> frame_generator =
+      test::FrameGenerator::CreateSquareGenerator(width, height);
+  std::vector<FrameType> frame_types(kNumStreams, kVideoFrameDelta);
+  int64_t start_time_us = rtc::TimeMicros();
+  for (int i = 0; i < num_frames; ++i) {
+    VideoFrame* frame = frame_generator->NextFrame();
+    frame->set_timestamp(90000 * i / kFramerate);
+    ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder->Encode(*frame, nullptr, &frame_types));
+  }
+  const int64_t encode_time_us = rtc::TimeMicros() - start_time_us;
+  EXPECT_EQ(num_frames * kNumStreams, callback.num_encoded_images());
+
+  start_time_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumReinits; ++i) {
+    ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Release());
+    ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->InitEncode(&codec, 1, 1200));
+  }
+  const int64_t reinit_time_us = rtc::TimeMicros() - start_time_us;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Release());
+
+  test::PrintResult("vp8_simulcast_encode_time", "", label,
+                    std::to_string(static_cast<double>(encode_time_us) /
+                                   (num_frames * 1000)),
+                    "ms", true);
+  test::PrintResult("vp8_simulcast_reinit_time", "", label,
+                    std::to_string(static_cast<double>(reinit_time_us) /
+                                   (kNumReinits * 1000)),
+                    "ms", true);
+}
+
+}  // namespace
+
+TEST(Vp8SimulcastPerformanceTest, Encode720p) {
+  RunVp8SimulcastPerformanceTest(1280, 720);
+}
+
+TEST(Vp8SimulcastPerformanceTest, Encode1080p) {
+  RunVp8SimulcastPerformanceTest(1920, 1080);
+}
+
+}  // namespace webrtc
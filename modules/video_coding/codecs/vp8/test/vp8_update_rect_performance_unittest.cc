@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/modules/desktop_capture/desktop_frame.h"
+#include "webrtc/modules/desktop_capture/desktop_frame_converter.h"
+#include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/modules/video_coding/codecs/vp8/temporal_layers.h"
+#include "webrtc/modules/video_coding/include/video_codec_interface.h"
+#include "webrtc/rtc_base/cpu_time.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kFramerate = 30;
+const int kWidth = 1920;
+const int kHeight = 1080;
+
+class CountingCallback : public EncodedImageCallback {
+ public:
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info,
+                        const RTPFragmentationHeader* fragmentation) override {
+    ++num_encoded_images_;
+    encoded_bytes_ += encoded_image._length;
+    return Result(Result::OK, encoded_image._timeStamp);
+  }
+
+  int num_encoded_images() const { return num_encoded_images_; }
+  size_t encoded_bytes() const { return encoded_bytes_; }
+
+ private:
+  int num_encoded_images_ = 0;
+  size_t encoded_bytes_ = 0;
+};
+
+VideoCodec CreateCodec(TemporalLayersFactory* tl_factory) {
+  VideoCodec codec;
+  codec.codecType = kVideoCodecVP8;
+  strncpy(codec.plName, "VP8", 4);
+  codec.plType = 120;
+  codec.mode = kScreensharing;
+  codec.width = kWidth;
+  codec.height = kHeight;
+  codec.maxFramerate = kFramerate;
+  codec.qpMax = 56;
+  codec.startBitrate = 2500;
+  codec.maxBitrate = 2500;
+  codec.numberOfSimulcastStreams = 0;
+  *codec.VP8() = VideoEncoder::GetDefaultVp8Settings();
+  codec.VP8()->tl_factory = tl_factory;
+  codec.VP8()->numberOfTemporalLayers = 1;
+  codec.VP8()->frameDroppingOn = false;
+  return codec;
+}
+
+// Draws a pattern that depends on |frame_number| into |rect| of |frame| and
+// marks it as updated.
+void PaintRect(DesktopFrame* frame, const DesktopRect& rect, int frame_number) {
+  for (int y = rect.top(); y < rect.bottom(); ++y) {
+    uint8_t* row = frame->GetFrameDataAtPos(DesktopVector(rect.left(), y));
+    for (int x = 0; x < rect.width(); ++x) {
+      row[x * DesktopFrame::kBytesPerPixel] = (x + frame_number) & 0xff;
+      row[x * DesktopFrame::kBytesPerPixel + 1] = (y * 3) & 0xff;
+      row[x * DesktopFrame::kBytesPerPixel + 2] = (x ^ y) & 0xff;
+      row[x * DesktopFrame::kBytesPerPixel + 3] = 0xff;
+    }
+  }
+  frame->mutable_updated_region()->AddRect(rect);
+}
+
+// Captures a desktop where |changed_percent| of the area changes between
+// frames, e.g. a blinking cursor or a scrolling document, and converts and
+// encodes each frame on this thread. With |use_update_rects| the converter and
+// the encoder only process the changed area; without, every frame is processed
+// in full, as if the capturer reported no updated region. Reports the CPU time
+// per frame.
+void RunScreenshareTest(int changed_percent,
+                        bool use_update_rects,
+                        const std::string& label) {
+  const int num_frames =
+      field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 30 : 300;
+  TemporalLayersFactory tl_factory;
+  const VideoCodec codec = CreateCodec(&tl_factory);
+  std::unique_ptr<VP8Encoder> encoder(VP8Encoder::Create());
+  CountingCallback callback;
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->InitEncode(&codec, 1, 1200));
+  encoder->RegisterEncodeCompleteCallback(&callback);
+
+  BasicDesktopFrame desktop_frame(DesktopSize(kWidth, kHeight));
+  PaintRect(&desktop_frame, DesktopRect::MakeSize(desktop_frame.size()), 0);
+  DesktopFrameConverter converter;
+  // A band across the screen covering |changed_percent| of it, moving down
+  // from frame to frame.
+  const int changed_height = kHeight * changed_percent / 100;
+  std::vector<FrameType> frame_types(1, kVideoFrameDelta);
+  const int64_t start_time_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < num_frames; ++i) {
+    if (i > 0) {
+      desktop_frame.mutable_updated_region()->Clear();
+      const int top = (i * 16) % (kHeight - changed_height + 1);
+      PaintRect(&desktop_frame,
+                DesktopRect::MakeXYWH(0, top, kWidth, changed_height), i);
+    }
+    if (!use_update_rects)
+      converter.Reset();
+    VideoFrame frame =
+        converter.Convert(desktop_frame, i * rtc::kNumMicrosecsPerSec /
+                                             kFramerate);
+    frame.set_timestamp(90000 * i / kFramerate);
+    if (!use_update_rects)
+      frame.clear_update_rects();
+    ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder->Encode(frame, nullptr, &frame_types));
+  }
+  const int64_t cpu_time_ns = rtc::GetThreadCpuTimeNanos() - start_time_ns;
+  EXPECT_EQ(num_frames, callback.num_encoded_images());
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Release());
+
+  test::PrintResult("screenshare_cpu_time", "", label,
+                    std::to_string(static_cast<double>(cpu_time_ns) /
+                                   (num_frames * rtc::kNumNanosecsPerMillisec)),
+                    "ms", true);
+  test::PrintResult(
+      "screenshare_encoded_size", "", label,
+      std::to_string(callback.encoded_bytes() / num_frames), "bytes", false);
+}
+
+}  // namespace
+
+TEST(Vp8UpdateRectPerformanceTest, OnePercentChangedFullFrames) {
+  RunScreenshareTest(1, false, "1_percent_full_frames");
+}
+
+TEST(Vp8UpdateRectPerformanceTest, OnePercentChangedUpdateRects) {
+  RunScreenshareTest(1, true, "1_percent_update_rects");
+}
+
+TEST(Vp8UpdateRectPerformanceTest, FiftyPercentChangedFullFrames) {
+  RunScreenshareTest(50, false, "50_percent_full_frames");
+}
+
+TEST(Vp8UpdateRectPerformanceTest, FiftyPercentChangedUpdateRects) {
+  RunScreenshareTest(50, true, "50_percent_update_rects");
+}
+
+}  // namespace webrtc
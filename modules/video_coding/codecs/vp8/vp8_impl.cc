@@ -49,7 +49,24 @@ const char kVp8GfBoostFieldTrial[] = "WebRTC-VP8-GfBoost";
 const int kTokenPartitions = VP8_ONE_TOKENPARTITION;
 enum { kVp8ErrorPropagationTh = 30 };
 enum { kVp832ByteAlign = 32 };
-
+// Frames encoded with an active map between two frames encoded in full.
+const int kMaxFramesBetweenFullEncodes = 60;
+
+
+// Points |image| at the planes of |buffer| without copying.
+void WrapI420Buffer(const I420BufferInterface& buffer, vpx_image_t* image) {
+  // Since we are extracting raw pointers from |buffer| to |image|, the
+  // resolution of these must match.
+  RTC_DCHECK_EQ(buffer.width(), image->d_w);
+  RTC_DCHECK_EQ(buffer.height(), image->d_h);
+  // VP8's raw image is not defined as const.
+  image->planes[VPX_PLANE_Y] = const_cast<uint8_t*>(buffer.DataY());
+  image->planes[VPX_PLANE_U] = const_cast<uint8_t*>(buffer.DataU());
+  image->planes[VPX_PLANE_V] = const_cast<uint8_t*>(buffer.DataV());
+  image->stride[VPX_PLANE_Y] = buffer.StrideY();
+  image->stride[VPX_PLANE_U] = buffer.StrideU();
+  image->stride[VPX_PLANE_V] = buffer.StrideV();
+}
 
 // Greatest common divisior
 int GCD(int a, int b) {
@@ -159,7 +176,9 @@ VP8EncoderImpl::VP8EncoderImpl()
       cpu_speed_default_(-6),
       number_of_cores_(0),
       rc_max_intra_target_(0),
-      key_frame_request_(kMaxSimulcastStreams, false) {
+      key_frame_request_(kMaxSimulcastStreams, false),
+      use_active_maps_(false),
+      frames_since_full_encode_(0) {
   Random random(rtc::TimeMicros());
   picture_id_.reserve(kMaxSimulcastStreams);
   for (int i = 0; i < kMaxSimulcastStreams; ++i) {
@@ -168,6 +187,7 @@ VP8EncoderImpl::VP8EncoderImpl()
   }
   temporal_layers_.reserve(kMaxSimulcastStreams);
   raw_images_.reserve(kMaxSimulcastStreams);
+  scaled_buffers_.reserve(kMaxSimulcastStreams);
   encoded_images_.reserve(kMaxSimulcastStreams);
   send_stream_.reserve(kMaxSimulcastStreams);
   cpu_speed_.assign(kMaxSimulcastStreams, cpu_speed_default_);
@@ -202,10 +222,14 @@ int VP8EncoderImpl::Release() {
     vpx_img_free(&raw_images_.back());
     raw_images_.pop_back();
   }
+  // Returns the buffers to |scaled_buffer_pools_|.
+  scaled_buffers_.clear();
   for (size_t i = 0; i < temporal_layers_.size(); ++i) {
     tl0_pic_idx_[i] = temporal_layers_[i]->Tl0PicIdx();
   }
   temporal_layers_.clear();
+  active_maps_.clear();
+  active_maps_valid_.clear();
   inited_ = false;
   return ret_val;
 }
@@ -271,6 +295,10 @@ int VP8EncoderImpl::SetRateAllocation(const BitrateAllocation& bitrate,
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+bool VP8EncoderImpl::SupportsNV12() const {
+  return true;
+}
+
 const char* VP8EncoderImpl::ImplementationName() const {
   return "libvpx";
 }
@@ -360,6 +388,7 @@ int VP8EncoderImpl::InitEncode(const VideoCodec* inst,
   configurations_.resize(number_of_streams);
   downsampling_factors_.resize(number_of_streams);
   raw_images_.resize(number_of_streams);
+  scaled_buffers_.resize(number_of_streams);
   send_stream_.resize(number_of_streams);
   send_stream_[0] = true;  // For non-simulcast case.
   cpu_speed_.resize(number_of_streams);
@@ -503,11 +532,16 @@ int VP8EncoderImpl::InitEncode(const VideoCodec* inst,
     configurations_[i].g_threads = 1;
 
     // Setting alignment to 32 - as that ensures at least 16 for all
-    // planes (32 for Y, 16 for U,V). Libvpx sets the requested stride for
-    // the y plane, but only half of it to the u and v planes.
-    vpx_img_alloc(&raw_images_[i], VPX_IMG_FMT_I420,
-                  inst->simulcastStream[stream_idx].width,
-                  inst->simulcastStream[stream_idx].height, kVp832ByteAlign);
+    // planes (32 for Y, 16 for U,V), like vpx_img_alloc() would: the
+    // requested stride for the y plane, but only half of it for the u and v
+    // planes.
+    const int width = inst->simulcastStream[stream_idx].width;
+    const int height = inst->simulcastStream[stream_idx].height;
+    const int stride_y = (width + kVp832ByteAlign - 1) & ~(kVp832ByteAlign - 1);
+    scaled_buffers_[i] = scaled_buffer_pools_[i].CreateBuffer(
+        width, height, stride_y, stride_y / 2, stride_y / 2);
+    vpx_img_wrap(&raw_images_[i], VPX_IMG_FMT_I420, width, height, 1, NULL);
+    WrapI420Buffer(*scaled_buffers_[i], &raw_images_[i]);
     SetStreamState(stream_bitrates[stream_idx] > 0, stream_idx);
     configurations_[i].rc_target_bitrate = stream_bitrates[stream_idx];
     temporal_layers_[stream_idx]->OnRatesUpdated(
@@ -515,6 +549,19 @@ int VP8EncoderImpl::InitEncode(const VideoCodec* inst,
     temporal_layers_[stream_idx]->UpdateConfiguration(&configurations_[i]);
   }
 
+  use_active_maps_ = true;
+  for (int i = 0; i < number_of_streams; ++i) {
+    if (number_of_streams > 1 &&
+        codec_.simulcastStream[i].numberOfTemporalLayers > 1) {
+      use_active_maps_ = false;
+    }
+    active_maps_.emplace_back(raw_images_[i].d_w, raw_images_[i].d_h);
+  }
+  if (number_of_streams == 1 && num_temporal_layers > 1)
+    use_active_maps_ = false;
+  active_maps_valid_.assign(number_of_streams, false);
+  frames_since_full_encode_ = 0;
+
   return InitAndSetControlSettings();
 }
 
@@ -664,25 +711,25 @@ int VP8EncoderImpl::Encode(const VideoFrame& frame,
   if (encoded_complete_callback_ == NULL)
     return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
 
-  rtc::scoped_refptr<I420BufferInterface> input_image =
-      frame.video_frame_buffer()->ToI420();
-  // Since we are extracting raw pointers from |input_image| to
-  // |raw_images_[0]|, the resolution of these frames must match.
-  RTC_DCHECK_EQ(input_image->width(), raw_images_[0].d_w);
-  RTC_DCHECK_EQ(input_image->height(), raw_images_[0].d_h);
-
-  // Image in vpx_image_t format.
-  // Input image is const. VP8's raw image is not defined as const.
-  raw_images_[0].planes[VPX_PLANE_Y] =
-      const_cast<uint8_t*>(input_image->DataY());
-  raw_images_[0].planes[VPX_PLANE_U] =
-      const_cast<uint8_t*>(input_image->DataU());
-  raw_images_[0].planes[VPX_PLANE_V] =
-      const_cast<uint8_t*>(input_image->DataV());
-
-  raw_images_[0].stride[VPX_PLANE_Y] = input_image->StrideY();
-  raw_images_[0].stride[VPX_PLANE_U] = input_image->StrideU();
-  raw_images_[0].stride[VPX_PLANE_V] = input_image->StrideV();
+  // I420 input is encoded in place; other formats are converted first. NV12
+  // is converted into pooled memory rather than a fresh buffer per frame.
+  rtc::scoped_refptr<VideoFrameBuffer> buffer = frame.video_frame_buffer();
+  rtc::scoped_refptr<I420BufferInterface> input_image;
+  if (buffer->type() == VideoFrameBuffer::Type::kNV12) {
+    rtc::scoped_refptr<I420Buffer> converted_buffer =
+        scaled_buffer_pools_[0].CreateBuffer(buffer->width(),
+                                             buffer->height());
+    if (!converted_buffer)
+      return WEBRTC_VIDEO_CODEC_MEMORY;
+    buffer->GetNV12()->ConvertToI420(
+        converted_buffer->MutableDataY(), converted_buffer->StrideY(),
+        converted_buffer->MutableDataU(), converted_buffer->StrideU(),
+        converted_buffer->MutableDataV(), converted_buffer->StrideV());
+    input_image = converted_buffer;
+  } else {
+    input_image = buffer->ToI420();
+  }
+  WrapI420Buffer(*input_image, &raw_images_[0]);
 
   for (size_t i = 1; i < encoders_.size(); ++i) {
     // Scale the image down a number of times by downsampling factor
@@ -705,7 +752,9 @@ int VP8EncoderImpl::Encode(const VideoFrame& frame,
     tl_configs[i] = temporal_layers_[i]->UpdateLayerConfig(frame.timestamp());
 
     if (tl_configs[i].drop_frame) {
-      // Drop this frame.
+      // Drop this frame. Its update rects are lost, so encode the next one in
+      // full.
+      std::fill(active_maps_valid_.begin(), active_maps_valid_.end(), false);
       return WEBRTC_VIDEO_CODEC_OK;
     }
     flags[i] = EncodeFlags(tl_configs[i]);
@@ -765,6 +814,7 @@ int VP8EncoderImpl::Encode(const VideoFrame& frame,
         &encoders_[i], VP8E_SET_TEMPORAL_LAYER_ID,
         temporal_layers_[stream_idx]->GetTemporalLayerId(tl_configs[i]));
   }
+  SetActiveMaps(frame, send_key_frame);
   // TODO(holmer): Ideally the duration should be the timestamp diff of this
   // frame and the next frame to be encoded, which we don't have. Instead we
   // would like to use the duration of the previous frame. Unfortunately the
@@ -782,13 +832,37 @@ int VP8EncoderImpl::Encode(const VideoFrame& frame,
     vpx_codec_control(&(encoders_[0]), VP8E_SET_MAX_INTRA_BITRATE_PCT,
                       rc_max_intra_target_);
   }
-  if (error)
+  if (error) {
+    std::fill(active_maps_valid_.begin(), active_maps_valid_.end(), false);
     return WEBRTC_VIDEO_CODEC_ERROR;
+  }
   timestamp_ += duration;
   // Examines frame timestamps only.
   return GetEncodedPartitions(tl_configs, frame);
 }
 
+void VP8EncoderImpl::SetActiveMaps(const VideoFrame& frame, bool key_frame) {
+  if (!use_active_maps_)
+    return;
+  // Encode in full now and then, so that the quality of static content keeps
+  // improving.
+  const bool full_encode =
+      key_frame || !frame.has_update_rects() ||
+      frames_since_full_encode_ >= kMaxFramesBetweenFullEncodes;
+  frames_since_full_encode_ = full_encode ? 0 : frames_since_full_encode_ + 1;
+  for (size_t i = 0; i < encoders_.size(); ++i) {
+    ActiveMap& active_map = active_maps_[i];
+    if (full_encode || !active_maps_valid_[i] || !active_map.Update(frame))
+      active_map.SetAllActive();
+    // A null map disables the active map.
+    vpx_active_map_t map;
+    map.active_map = active_map.all_active() ? nullptr : active_map.data();
+    map.rows = active_map.rows();
+    map.cols = active_map.cols();
+    vpx_codec_control(&encoders_[i], VP8E_SET_ACTIVEMAP, &map);
+  }
+}
+
 void VP8EncoderImpl::PopulateCodecSpecific(
     CodecSpecificInfo* codec_specific,
     const TemporalLayers::FrameConfig& tl_config,
@@ -880,6 +954,9 @@ int VP8EncoderImpl::GetEncodedPartitions(
     vpx_codec_control(&encoders_[encoder_idx], VP8E_GET_LAST_QUANTIZER_64, &qp);
     temporal_layers_[stream_idx]->FrameEncoded(
         encoded_images_[encoder_idx]._length, qp);
+    // A frame dropped by the rate control leaves the reference behind the
+    // input, which the update rects of the next frame don't account for.
+    active_maps_valid_[encoder_idx] = encoded_images_[encoder_idx]._length > 0;
     if (send_stream_[stream_idx]) {
       if (encoded_images_[encoder_idx]._length > 0) {
         TRACE_COUNTER_ID1("webrtc", "EncodedFrameSize", encoder_idx,
@@ -949,8 +1026,15 @@ int VP8DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
     memset(decoder_, 0, sizeof(*decoder_));
   }
   vpx_codec_dec_cfg_t cfg;
-  // Setting number of threads to a constant value (1)
+  // Single threaded by default. libvpx only threads within a frame, so frame
+  // threading is treated as slice threading and adds no latency.
   cfg.threads = 1;
+  if (inst) {
+    VideoDecoderThreadingSettings threading = inst->decoder_threading;
+    if (threading.mode == VideoDecoderThreading::kFrame)
+      threading.mode = VideoDecoderThreading::kSlice;
+    cfg.threads = GetDecoderThreadCount(threading, number_of_cores);
+  }
   cfg.h = cfg.w = 0;  // set after decode
 
 #if defined(WEBRTC_ARCH_ARM) || defined(WEBRTC_ARCH_ARM64) || defined(ANDROID)
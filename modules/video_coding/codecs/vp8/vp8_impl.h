@@ -29,6 +29,7 @@
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
 #include "webrtc/modules/video_coding/codecs/vp8/temporal_layers.h"
 #include "webrtc/modules/video_coding/include/video_codec_interface.h"
+#include "webrtc/modules/video_coding/utility/active_map.h"
 #include "webrtc/modules/video_coding/utility/quality_scaler.h"
 
 namespace webrtc {
@@ -60,6 +61,9 @@ class VP8EncoderImpl : public VP8Encoder {
 
   ScalingSettings GetScalingSettings() const override;
 
+  // NV12 input is converted into pooled I420 memory by Encode().
+  bool SupportsNV12() const override;
+
   const char* ImplementationName() const override;
 
   static vpx_enc_frame_flags_t EncodeFlags(
@@ -91,6 +95,10 @@ class VP8EncoderImpl : public VP8Encoder {
   // Set the stream state for stream |stream_idx|.
   void SetStreamState(bool send_stream, int stream_idx);
 
+  // Sets the active map of each encoder from the update rects of |frame|, so
+  // that unchanged macroblocks are skipped.
+  void SetActiveMaps(const VideoFrame& frame, bool key_frame);
+
   uint32_t MaxIntraTarget(uint32_t optimal_buffer_size);
 
   const bool use_gf_boost_;
@@ -110,10 +118,27 @@ class VP8EncoderImpl : public VP8Encoder {
   std::vector<bool> send_stream_;
   std::vector<int> cpu_speed_;
   std::vector<vpx_image_t> raw_images_;
+  // Backing memory of the downscaled |raw_images_|; null for the top layer,
+  // which wraps the input frame.
+  std::vector<rtc::scoped_refptr<I420Buffer>> scaled_buffers_;
+  // One pool per downscaled layer, kept across Release() so that reinits with
+  // the same resolutions reuse the memory. The pool of the top layer holds
+  // NV12 input converted to I420, since libvpx only takes planar input.
+  I420BufferPool scaled_buffer_pools_[kMaxSimulcastStreams];
   std::vector<EncodedImage> encoded_images_;
   std::vector<vpx_codec_ctx_t> encoders_;
   std::vector<vpx_codec_enc_cfg_t> configurations_;
   std::vector<vpx_rational_t> downsampling_factors_;
+  // Skipped macroblocks are copied from the last frame, so active maps are
+  // only used with a single temporal layer.
+  bool use_active_maps_;
+  int frames_since_full_encode_;
+  // One per encoder, at the resolution of its stream.
+  std::vector<ActiveMap> active_maps_;
+  // False for an encoder that missed changes signalled by the update rects of
+  // earlier frames, e.g. because it dropped a frame. Its next frame is then
+  // encoded in full.
+  std::vector<bool> active_maps_valid_;
 };
 
 class VP8DecoderImpl : public VP8Decoder {
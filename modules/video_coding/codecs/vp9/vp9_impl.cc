@@ -33,6 +33,11 @@
 
 namespace webrtc {
 
+namespace {
+// Frames encoded with an active map between two frames encoded in full.
+const int kMaxFramesBetweenFullEncodes = 60;
+}  // namespace
+
 // Only positive speeds, range for real-time coding currently is: 5 - 8.
 // Lower means slower/better quality, higher means fastest/lower quality.
 int GetCpuSpeed(int width, int height) {
@@ -79,7 +84,9 @@ VP9EncoderImpl::VP9EncoderImpl()
       is_flexible_mode_(false),
       frames_encoded_(0),
       // Use two spatial when screensharing with flexible mode.
-      spatial_layer_(new ScreenshareLayersVP9(2)) {
+      spatial_layer_(new ScreenshareLayersVP9(2)),
+      active_map_valid_(false),
+      frames_since_full_encode_(0) {
   memset(&codec_, 0, sizeof(codec_));
   memset(&svc_params_, 0, sizeof(vpx_svc_extra_cfg_t));
 
@@ -112,6 +119,7 @@ int VP9EncoderImpl::Release() {
     vpx_img_free(raw_);
     raw_ = NULL;
   }
+  active_map_.reset();
   inited_ = false;
   return WEBRTC_VIDEO_CODEC_OK;
 }
@@ -289,6 +297,12 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
   // (actual memory is not allocated).
   raw_ = vpx_img_wrap(NULL, VPX_IMG_FMT_I420, codec_.width, codec_.height, 1,
                       NULL);
+  if (num_spatial_layers_ <= 1 && num_temporal_layers_ == 1 &&
+      !inst->VP9().flexibleMode) {
+    active_map_.reset(new ActiveMap(codec_.width, codec_.height));
+  }
+  active_map_valid_ = false;
+  frames_since_full_encode_ = 0;
   // Populate encoder configuration with default values.
   if (vpx_codec_enc_config_default(vpx_codec_vp9_cx(), config_, 0)) {
     return WEBRTC_VIDEO_CODEC_ERROR;
@@ -550,6 +564,10 @@ int VP9EncoderImpl::Encode(const VideoFrame& input_image,
     vpx_codec_control(encoder_, VP9E_SET_SVC_REF_FRAME_CONFIG, &enc_layer_conf);
   }
 
+  SetActiveMap(input_image, send_keyframe);
+  // Set again by GetEncodedLayerFrame() unless the frame is dropped.
+  active_map_valid_ = false;
+
   assert(codec_.maxFramerate > 0);
   uint32_t duration = 90000 / codec_.maxFramerate;
   if (vpx_codec_encode(encoder_, raw_, timestamp_, duration, flags,
@@ -561,6 +579,27 @@ int VP9EncoderImpl::Encode(const VideoFrame& input_image,
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+void VP9EncoderImpl::SetActiveMap(const VideoFrame& input_image,
+                                  bool key_frame) {
+  if (!active_map_)
+    return;
+  // Encode in full now and then, so that the quality of static content keeps
+  // improving.
+  const bool full_encode =
+      key_frame || !active_map_valid_ ||
+      frames_since_full_encode_ >= kMaxFramesBetweenFullEncodes;
+  if (full_encode || !active_map_->Update(input_image))
+    active_map_->SetAllActive();
+  frames_since_full_encode_ =
+      active_map_->all_active() ? 0 : frames_since_full_encode_ + 1;
+  // A null map disables the active map.
+  vpx_active_map_t map;
+  map.active_map = active_map_->all_active() ? nullptr : active_map_->data();
+  map.rows = active_map_->rows();
+  map.cols = active_map_->cols();
+  vpx_codec_control(encoder_, VP8E_SET_ACTIVEMAP, &map);
+}
+
 void VP9EncoderImpl::PopulateCodecSpecific(CodecSpecificInfo* codec_specific,
                                            const vpx_codec_cx_pkt& pkt,
                                            uint32_t timestamp) {
@@ -703,6 +742,7 @@ int VP9EncoderImpl::GetEncodedLayerFrame(const vpx_codec_cx_pkt* pkt) {
   CodecSpecificInfo codec_specific;
   PopulateCodecSpecific(&codec_specific, *pkt, input_image_->timestamp());
 
+  active_map_valid_ = encoded_image_._length > 0;
   if (encoded_image_._length > 0) {
     TRACE_COUNTER1("webrtc", "EncodedFrameSize", encoded_image_._length);
     encoded_image_._timeStamp = input_image_->timestamp();
@@ -881,8 +921,13 @@ int VP9DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
     decoder_ = new vpx_codec_ctx_t;
   }
   vpx_codec_dec_cfg_t cfg;
-  // Setting number of threads to a constant value (1)
-  cfg.threads = 1;
+  // Single threaded by default. libvpx only threads within a frame (tiles and
+  // loop filter rows), so frame threading is treated as slice threading and
+  // adds no latency.
+  VideoDecoderThreadingSettings threading = inst->decoder_threading;
+  if (threading.mode == VideoDecoderThreading::kFrame)
+    threading.mode = VideoDecoderThreading::kSlice;
+  cfg.threads = GetDecoderThreadCount(threading, number_of_cores);
   cfg.h = cfg.w = 0;  // set after decode
   vpx_codec_flags_t flags = 0;
   if (vpx_codec_dec_init(decoder_, vpx_codec_vp9_dx(), &cfg, flags)) {
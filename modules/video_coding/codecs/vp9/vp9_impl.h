@@ -17,6 +17,7 @@
 
 #include "webrtc/modules/video_coding/codecs/vp9/include/vp9.h"
 #include "webrtc/modules/video_coding/codecs/vp9/vp9_frame_buffer_pool.h"
+#include "webrtc/modules/video_coding/utility/active_map.h"
 
 #include "vpx/vp8cx.h"
 #include "vpx/vpx_decoder.h"
@@ -79,6 +80,10 @@ class VP9EncoderImpl : public VP9Encoder {
   bool ExplicitlyConfiguredSpatialLayers() const;
   bool SetSvcRates();
 
+  // Sets the active map of the encoder from the update rects of
+  // |input_image|, so that unchanged macroblocks are skipped.
+  void SetActiveMap(const VideoFrame& input_image, bool key_frame);
+
   // Used for flexible mode to set the flags and buffer references used
   // by the encoder. Also calculates the references used by the RTP
   // packetizer.
@@ -128,6 +133,14 @@ class VP9EncoderImpl : public VP9Encoder {
   uint8_t p_diff_[kMaxVp9NumberOfSpatialLayers][kMaxVp9RefPics];
   std::unique_ptr<ScreenshareLayersVP9> spatial_layer_;
 
+  // Only used without spatial and temporal layers, since skipped macroblocks
+  // are copied from the last frame.
+  std::unique_ptr<ActiveMap> active_map_;
+  // False if the encoder missed changes signalled by the update rects of
+  // earlier frames, e.g. because it dropped a frame.
+  bool active_map_valid_;
+  int frames_since_full_encode_;
+
   // RTP state.
   uint16_t picture_id_;
   uint8_t tl0_pic_idx_;  // Only used in non-flexible mode.
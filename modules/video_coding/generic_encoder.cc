@@ -175,6 +175,11 @@ bool VCMGenericEncoder::SupportsNativeHandle() const {
   return encoder_->SupportsNativeHandle();
 }
 
+bool VCMGenericEncoder::SupportsNV12() const {
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
+  return encoder_->SupportsNV12();
+}
+
 VCMEncodedFrameCallback::VCMEncodedFrameCallback(
     EncodedImageCallback* post_encode_callback,
     media_optimization::MediaOptimization* media_opt)
@@ -108,6 +108,7 @@ class VCMGenericEncoder {
   bool InternalSource() const;
   void OnDroppedFrame();
   bool SupportsNativeHandle() const;
+  bool SupportsNV12() const;
 
  private:
   rtc::RaceChecker race_checker_;
@@ -49,6 +49,7 @@ class MockVideoEncoder : public VideoEncoder {
                int32_t(const BitrateAllocation& newBitRate,
                        uint32_t frameRate));
   MOCK_METHOD1(SetPeriodicKeyFrames, int32_t(bool enable));
+  MOCK_CONST_METHOD0(SupportsNV12, bool());
 };
 
 class MockDecodedImageCallback : public DecodedImageCallback {
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/utility/active_map.h"
+
+#include <algorithm>
+
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+
+ActiveMap::ActiveMap(int width, int height)
+    : width_(width),
+      height_(height),
+      rows_((height + kMacroblockSize - 1) / kMacroblockSize),
+      cols_((width + kMacroblockSize - 1) / kMacroblockSize),
+      map_(rows_ * cols_, 1),
+      num_active_(rows_ * cols_) {
+  RTC_DCHECK_GT(width, 0);
+  RTC_DCHECK_GT(height, 0);
+}
+
+ActiveMap::~ActiveMap() {}
+
+bool ActiveMap::Update(const VideoFrame& frame) {
+  if (!frame.has_update_rects() || frame.width() <= 0 ||
+      frame.height() <= 0) {
+    SetAllActive();
+    return false;
+  }
+  std::fill(map_.begin(), map_.end(), 0);
+  num_active_ = 0;
+  // When scaling, a changed pixel also affects its neighbours through the
+  // scaling filter.
+  const int margin =
+      (frame.width() != width_ || frame.height() != height_) ? 1 : 0;
+  for (const VideoFrame::UpdateRect& rect : frame.update_rects()) {
+    if (rect.width <= 0 || rect.height <= 0)
+      continue;
+    // Round outwards when scaling to the size of the map.
+    const int left = std::max(0, rect.offset_x - margin);
+    const int top = std::max(0, rect.offset_y - margin);
+    const int right =
+        std::min(frame.width(), rect.offset_x + rect.width + margin);
+    const int bottom =
+        std::min(frame.height(), rect.offset_y + rect.height + margin);
+    if (left >= right || top >= bottom)
+      continue;
+    const int64_t scaled_left =
+        static_cast<int64_t>(left) * width_ / frame.width();
+    const int64_t scaled_top =
+        static_cast<int64_t>(top) * height_ / frame.height();
+    const int64_t scaled_right =
+        (static_cast<int64_t>(right) * width_ + frame.width() - 1) /
+        frame.width();
+    const int64_t scaled_bottom =
+        (static_cast<int64_t>(bottom) * height_ + frame.height() - 1) /
+        frame.height();
+    const int first_col = static_cast<int>(scaled_left / kMacroblockSize);
+    const int first_row = static_cast<int>(scaled_top / kMacroblockSize);
+    const int last_col = std::min(
+        cols_ - 1, static_cast<int>((scaled_right - 1) / kMacroblockSize));
+    const int last_row = std::min(
+        rows_ - 1, static_cast<int>((scaled_bottom - 1) / kMacroblockSize));
+    for (int row = first_row; row <= last_row; ++row) {
+      for (int col = first_col; col <= last_col; ++col) {
+        uint8_t& active = map_[row * cols_ + col];
+        if (!active) {
+          active = 1;
+          ++num_active_;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void ActiveMap::SetAllActive() {
+  std::fill(map_.begin(), map_.end(), 1);
+  num_active_ = rows_ * cols_;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_UTILITY_ACTIVE_MAP_H_
+#define WEBRTC_MODULES_VIDEO_CODING_UTILITY_ACTIVE_MAP_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "webrtc/api/video/video_frame.h"
+
+namespace webrtc {
+
+// Per-macroblock map of the parts of a frame that the encoder has to code, in
+// the format of libvpx's VP8E_SET_ACTIVEMAP. Built from the update rects of
+// the input frame, so that unchanged macroblocks of e.g. a mostly static
+// desktop are skipped.
+class ActiveMap {
+ public:
+  // Macroblock size of VP8 and VP9.
+  static const int kMacroblockSize = 16;
+
+  // A map for encoding frames of |width|x|height|. All macroblocks are active.
+  ActiveMap(int width, int height);
+  ~ActiveMap();
+
+  // Marks the macroblocks that overlap the update rects of |frame| as active,
+  // and the others as inactive. The rects are scaled from the size of |frame|
+  // to the size of the map. Returns false, with all macroblocks active, if
+  // |frame| has no update rects.
+  bool Update(const VideoFrame& frame);
+  void SetAllActive();
+
+  bool all_active() const { return num_active_ == rows_ * cols_; }
+  int num_active() const { return num_active_; }
+  int rows() const { return rows_; }
+  int cols() const { return cols_; }
+  // One byte per macroblock, row by row, 1 for active.
+  uint8_t* data() { return map_.data(); }
+  const uint8_t* data() const { return map_.data(); }
+
+ private:
+  const int width_;
+  const int height_;
+  const int rows_;
+  const int cols_;
+  std::vector<uint8_t> map_;
+  int num_active_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_UTILITY_ACTIVE_MAP_H_
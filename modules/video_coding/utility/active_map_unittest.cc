@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/utility/active_map.h"
+
+#include <utility>
+#include <vector>
+
+#include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+VideoFrame CreateFrame(int width,
+                       int height,
+                       std::vector<VideoFrame::UpdateRect> update_rects) {
+  VideoFrame frame(I420Buffer::Create(width, height), kVideoRotation_0, 0);
+  frame.set_update_rects(std::move(update_rects));
+  return frame;
+}
+
+}  // namespace
+
+TEST(ActiveMapTest, AllActiveWithoutUpdateRects) {
+  ActiveMap map(70, 40);
+  EXPECT_EQ(3, map.rows());
+  EXPECT_EQ(5, map.cols());
+  VideoFrame frame(I420Buffer::Create(70, 40), kVideoRotation_0, 0);
+  EXPECT_FALSE(map.Update(frame));
+  EXPECT_TRUE(map.all_active());
+}
+
+TEST(ActiveMapTest, NoMacroblockActiveWithoutChanges) {
+  ActiveMap map(64, 48);
+  EXPECT_TRUE(map.Update(CreateFrame(64, 48, {})));
+  EXPECT_EQ(0, map.num_active());
+  map.SetAllActive();
+  EXPECT_TRUE(map.all_active());
+}
+
+TEST(ActiveMapTest, MarksMacroblocksOverlappingUpdateRects) {
+  ActiveMap map(64, 48);
+  EXPECT_TRUE(map.Update(CreateFrame(64, 48, {{20, 0, 10, 10},
+                                              {30, 17, 4, 1},
+                                              {63, 47, 1, 1}})));
+  const std::vector<uint8_t> expected = {0, 1, 0, 0,
+                                         0, 1, 1, 0,
+                                         0, 0, 0, 1};
+  EXPECT_EQ(expected,
+            std::vector<uint8_t>(map.data(), map.data() + expected.size()));
+  EXPECT_EQ(4, map.num_active());
+}
+
+TEST(ActiveMapTest, ScalesUpdateRectsToMapSize) {
+  ActiveMap map(64, 48);
+  // Lands on the corner of four macroblocks after downscaling, with a margin
+  // for the scaling filter.
+  EXPECT_TRUE(map.Update(CreateFrame(128, 96, {{64, 64, 2, 2}})));
+  const std::vector<uint8_t> expected = {0, 0, 0, 0,
+                                         0, 1, 1, 0,
+                                         0, 1, 1, 0};
+  EXPECT_EQ(expected,
+            std::vector<uint8_t>(map.data(), map.data() + expected.size()));
+}
+
+}  // namespace webrtc
@@ -339,6 +339,8 @@ int32_t VideoSender::AddVideoFrame(const VideoFrame& videoFrame,
       converted_frame.video_frame_buffer()->type();
   const bool is_buffer_type_supported =
       buffer_type == VideoFrameBuffer::Type::kI420 ||
+      (buffer_type == VideoFrameBuffer::Type::kNV12 &&
+       _encoder->SupportsNV12()) ||
       (buffer_type == VideoFrameBuffer::Type::kNative &&
        _encoder->SupportsNativeHandle());
   if (!is_buffer_type_supported) {
@@ -355,6 +357,8 @@ int32_t VideoSender::AddVideoFrame(const VideoFrame& videoFrame,
                                  converted_frame.timestamp(),
                                  converted_frame.render_time_ms(),
                                  converted_frame.rotation());
+    if (videoFrame.has_update_rects())
+      converted_frame.set_update_rects(videoFrame.update_rects());
   }
   int32_t ret =
       _encoder->Encode(converted_frame, codecSpecificInfo, next_frame_types);
@@ -8,10 +8,13 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string.h>
+
 #include <memory>
 #include <vector>
 
 #include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/api/video/nv12_buffer.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8_common_types.h"
 #include "webrtc/modules/video_coding/codecs/vp8/simulcast_rate_allocator.h"
@@ -28,12 +31,14 @@
 
 using ::testing::_;
 using ::testing::AllOf;
+using ::testing::DoAll;
 using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
 using ::testing::Field;
 using ::testing::NiceMock;
 using ::testing::Pointee;
 using ::testing::Return;
+using ::testing::SaveArg;
 using ::testing::FloatEq;
 using std::vector;
 using webrtc::test::FrameGenerator;
@@ -392,6 +397,30 @@ TEST_F(TestVideoSenderWithMockEncoder,
   AddFrame();
 }
 
+TEST_F(TestVideoSenderWithMockEncoder, PassesNv12FramesToEncoderSupportingIt) {
+  rtc::scoped_refptr<NV12Buffer> buffer =
+      NV12Buffer::Create(settings_.width, settings_.height);
+  memset(buffer->MutableDataY(), 0x10, buffer->StrideY() * buffer->height());
+  memset(buffer->MutableDataUV(), 0x80,
+         buffer->StrideUV() * ((buffer->height() + 1) / 2));
+  const VideoFrame nv12_frame(buffer, kVideoRotation_0, 0);
+
+  VideoFrame encoded_frame(I420Buffer::Create(1, 1), kVideoRotation_0, 0);
+  EXPECT_CALL(encoder_, SupportsNV12()).WillRepeatedly(Return(true));
+  EXPECT_CALL(encoder_, Encode(_, _, _))
+      .WillOnce(DoAll(SaveArg<0>(&encoded_frame), Return(0)));
+  sender_->AddVideoFrame(nv12_frame, nullptr);
+  EXPECT_EQ(VideoFrameBuffer::Type::kNV12,
+            encoded_frame.video_frame_buffer()->type());
+
+  EXPECT_CALL(encoder_, SupportsNV12()).WillRepeatedly(Return(false));
+  EXPECT_CALL(encoder_, Encode(_, _, _))
+      .WillOnce(DoAll(SaveArg<0>(&encoded_frame), Return(0)));
+  sender_->AddVideoFrame(nv12_frame, nullptr);
+  EXPECT_EQ(VideoFrameBuffer::Type::kI420,
+            encoded_frame.video_frame_buffer()->type());
+}
+
 class TestVideoSenderWithVp8 : public TestVideoSender {
  public:
   TestVideoSenderWithVp8()
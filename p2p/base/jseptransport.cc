@@ -175,6 +175,8 @@ bool JsepTransport::HasChannels() const {
 
 void JsepTransport::SetLocalCertificate(
     const rtc::scoped_refptr<rtc::RTCCertificate>& certificate) {
+  if (certificate_.get() != certificate.get())
+    local_description_applied_ = false;
   certificate_ = certificate;
 }
 
@@ -199,6 +201,15 @@ bool JsepTransport::SetLocalTransportDescription(
                                    error_desc);
   }
 
+  const bool negotiate = (action == CA_PRANSWER || action == CA_ANSWER);
+  if (local_description_applied_ && *local_description_ == description &&
+      (!negotiate || negotiated_action_ == action)) {
+    LOG(LS_VERBOSE) << "Local transport description unchanged for " << mid();
+    return true;
+  }
+  local_description_applied_ = false;
+  negotiated_action_ = rtc::Optional<ContentAction>();
+
   bool ice_restarting =
       local_description_set_ &&
       IceCredentialsChanged(local_description_->ice_ufrag,
@@ -224,7 +235,7 @@ bool JsepTransport::SetLocalTransportDescription(
   }
 
   // If PRANSWER/ANSWER is set, we should decide transport protocol type.
-  if (action == CA_PRANSWER || action == CA_ANSWER) {
+  if (negotiate) {
     ret &= NegotiateTransportDescription(action, error_desc);
   }
   if (!ret) {
@@ -237,6 +248,7 @@ bool JsepTransport::SetLocalTransportDescription(
   }
 
   local_description_set_ = true;
+  local_description_applied_ = true;
   return true;
 }
 
@@ -251,17 +263,28 @@ bool JsepTransport::SetRemoteTransportDescription(
                                    error_desc);
   }
 
+  // The local description is the offer if this one needs negotiating.
+  const bool negotiate = (action == CA_PRANSWER || action == CA_ANSWER);
+  if (remote_description_applied_ && *remote_description_ == description &&
+      (!negotiate || negotiated_action_ == CA_OFFER)) {
+    LOG(LS_VERBOSE) << "Remote transport description unchanged for " << mid();
+    return true;
+  }
+  remote_description_applied_ = false;
+  negotiated_action_ = rtc::Optional<ContentAction>();
+
   remote_description_.reset(new TransportDescription(description));
   for (const auto& kv : channels_) {
     ret &= ApplyRemoteTransportDescription(kv.second, error_desc);
   }
 
   // If PRANSWER/ANSWER is set, we should decide transport protocol type.
-  if (action == CA_PRANSWER || action == CA_ANSWER) {
+  if (negotiate) {
     ret = NegotiateTransportDescription(CA_OFFER, error_desc);
   }
   if (ret) {
     remote_description_set_ = true;
+    remote_description_applied_ = true;
   }
 
   return ret;
@@ -404,6 +427,7 @@ bool JsepTransport::NegotiateTransportDescription(
       return false;
     }
   }
+  negotiated_action_ = rtc::Optional<ContentAction>(local_description_type);
   return true;
 }
 
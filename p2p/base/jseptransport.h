@@ -279,13 +279,16 @@ class JsepTransport : public sigslot::has_slots<> {
       rtc::scoped_refptr<rtc::RTCCertificate>* certificate) const;
 
   // Set the local TransportDescription to be used by DTLS and ICE channels
-  // that are part of this Transport.
+  // that are part of this Transport. Setting a description equal to the
+  // current one is a no-op, unless it has to be negotiated anew, so that
+  // renegotiating unchanged m= sections does not touch their transports.
   bool SetLocalTransportDescription(const TransportDescription& description,
                                     ContentAction action,
                                     std::string* error_desc);
 
   // Set the remote TransportDescription to be used by DTLS and ICE channels
-  // that are part of this Transport.
+  // that are part of this Transport. Like SetLocalTransportDescription, a
+  // no-op if nothing changed.
   bool SetRemoteTransportDescription(const TransportDescription& description,
                                      ContentAction action,
                                      std::string* error_desc);
@@ -371,6 +374,12 @@ class JsepTransport : public sigslot::has_slots<> {
   std::unique_ptr<TransportDescription> remote_description_;
   bool local_description_set_ = false;
   bool remote_description_set_ = false;
+  // Whether the current descriptions (and certificate) were successfully
+  // pushed down to the channels, and with which local description type they
+  // were negotiated, so that setting them again can be skipped.
+  bool local_description_applied_ = false;
+  bool remote_description_applied_ = false;
+  rtc::Optional<ContentAction> negotiated_action_;
 
   // Candidate component => DTLS channel
   std::map<int, DtlsTransportInternal*> channels_;
@@ -116,6 +116,42 @@ TEST_F(JsepTransportTest, NeedsIceRestart) {
   EXPECT_FALSE(transport_->NeedsIceRestart());
 }
 
+// Tests that setting descriptions equal to the applied ones doesn't push them
+// down to the channels again, while changed descriptions still are.
+TEST_F(JsepTransportTest, UnchangedDescriptionsNotReapplied) {
+  EXPECT_TRUE(SetupChannel());
+  cricket::TransportDescription local_desc(kIceUfrag1, kIcePwd1);
+  cricket::TransportDescription remote_desc(kIceUfrag1, kIcePwd1);
+  ASSERT_TRUE(transport_->SetLocalTransportDescription(
+      local_desc, cricket::CA_OFFER, nullptr));
+  ASSERT_TRUE(transport_->SetRemoteTransportDescription(
+      remote_desc, cricket::CA_ANSWER, nullptr));
+  EXPECT_EQ(kIceUfrag1, fake_ice_transport_->ice_ufrag());
+  EXPECT_EQ(kIceUfrag1, fake_ice_transport_->remote_ice_ufrag());
+
+  // Change the parameters behind the transport's back, so that reapplying
+  // the descriptions would be noticed.
+  fake_ice_transport_->SetIceParameters(
+      cricket::IceParameters(kIceUfrag2, kIcePwd2, false));
+  fake_ice_transport_->SetRemoteIceParameters(
+      cricket::IceParameters(kIceUfrag2, kIcePwd2, false));
+
+  ASSERT_TRUE(transport_->SetLocalTransportDescription(
+      local_desc, cricket::CA_OFFER, nullptr));
+  ASSERT_TRUE(transport_->SetRemoteTransportDescription(
+      remote_desc, cricket::CA_ANSWER, nullptr));
+  EXPECT_EQ(kIceUfrag2, fake_ice_transport_->ice_ufrag());
+  EXPECT_EQ(kIceUfrag2, fake_ice_transport_->remote_ice_ufrag());
+
+  // A changed remote description is applied, and renegotiated with the
+  // unchanged local one.
+  remote_desc.connection_role = cricket::CONNECTIONROLE_ACTIVE;
+  ASSERT_TRUE(transport_->SetRemoteTransportDescription(
+      remote_desc, cricket::CA_ANSWER, nullptr));
+  EXPECT_EQ(kIceUfrag1, fake_ice_transport_->remote_ice_ufrag());
+  EXPECT_EQ(kIceUfrag2, fake_ice_transport_->ice_ufrag());
+}
+
 TEST_F(JsepTransportTest, TestGetStats) {
   EXPECT_TRUE(SetupChannel());
   cricket::TransportStats stats;
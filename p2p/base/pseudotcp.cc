@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 #include <set>
 
@@ -116,6 +117,9 @@ const uint32_t DEF_ACK_DELAY = 100;  // 100 milliseconds
 
 const uint8_t FLAG_CTL = 0x02;
 const uint8_t FLAG_RST = 0x04;
+// Set on ACKs whose payload is a list of SACK blocks instead of data. Only
+// sent to peers that offered TCP_OPT_SACK_PERMITTED.
+const uint8_t FLAG_SACK = 0x08;
 
 const uint8_t CTL_CONNECT = 0;
 
@@ -124,6 +128,16 @@ const uint8_t TCP_OPT_EOL = 0;        // End of list.
 const uint8_t TCP_OPT_NOOP = 1;       // No-op.
 const uint8_t TCP_OPT_MSS = 2;        // Maximum segment size.
 const uint8_t TCP_OPT_WND_SCALE = 3;  // Window scale factor.
+const uint8_t TCP_OPT_SACK_PERMITTED = 4;  // Selective acknowledgements.
+
+// Each SACK block is a pair of 32-bit sequence numbers [start, end).
+const uint32_t SACK_BLOCK_SIZE = 8;
+const uint32_t MAX_SACK_BLOCKS = 8;
+
+// CUBIC scaling constant, in segments/s^3, and multiplicative window
+// decrease factor (RFC 8312, Sec 5).
+const double CUBIC_C = 0.4;
+const double CUBIC_BETA = 0.7;
 
 const long DEFAULT_TIMEOUT = 4000; // If there are no pending clocks, wake up every 4 seconds
 const long CLOSED_TIMEOUT = 60 * 1000; // If the connection is closed, once per minute
@@ -246,6 +260,12 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32_t conv)
   m_dup_acks = 0;
   m_recover = 0;
 
+  m_sack_permitted = false;
+  m_sack_high = m_sack_rexmit = 0;
+
+  m_cubic_wmax = m_cubic_epoch = m_cubic_origin = 0;
+  m_cubic_k = m_cubic_west = 0;
+
   m_ts_recent = m_ts_lastack = 0;
 
   m_rx_rto = DEF_RTO;
@@ -253,6 +273,8 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32_t conv)
 
   m_use_nagling = true;
   m_ack_delay = DEF_ACK_DELAY;
+  m_use_sack = true;
+  m_congestion_control = CC_NEW_RENO;
   m_support_wnd_scale = true;
 }
 
@@ -304,9 +326,7 @@ void PseudoTcp::NotifyClock(uint32_t now) {
         return;
       }
 
-      uint32_t nInFlight = m_snd_nxt - m_snd_una;
-      m_ssthresh = std::max(nInFlight / 2, 2 * m_mss);
-      //LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: " << nInFlight << "  m_mss: " << m_mss;
+      m_ssthresh = onCongestionEvent();
       m_cwnd = m_mss;
 
       // Back off retransmit timer.  Note: the limit is lower when connecting.
@@ -374,6 +394,10 @@ void PseudoTcp::GetOption(Option opt, int* value) {
     *value = m_sbuf_len;
   } else if (opt == OPT_RCVBUF) {
     *value = m_rbuf_len;
+  } else if (opt == OPT_SACK) {
+    *value = m_use_sack ? 1 : 0;
+  } else if (opt == OPT_CONGESTION_CONTROL) {
+    *value = m_congestion_control;
   } else {
     RTC_NOTREACHED();
   }
@@ -389,6 +413,12 @@ void PseudoTcp::SetOption(Option opt, int value) {
   } else if (opt == OPT_RCVBUF) {
     RTC_DCHECK(m_state == TCP_LISTEN);
     resizeReceiveBuffer(value);
+  } else if (opt == OPT_SACK) {
+    RTC_DCHECK(m_state == TCP_LISTEN);
+    m_use_sack = value != 0;
+  } else if (opt == OPT_CONGESTION_CONTROL) {
+    RTC_DCHECK(value == CC_NEW_RENO || value == CC_CUBIC);
+    m_congestion_control = static_cast<CongestionControl>(value);
   } else {
     RTC_NOTREACHED();
   }
@@ -518,6 +548,15 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
   uint32_t now = Now();
 
   std::unique_ptr<uint8_t[]> buffer(new uint8_t[MAX_PACKET]);
+
+  // Tell the peer about the out-of-order data we hold, so that it only
+  // retransmits what is missing.
+  uint32_t sack_len = 0;
+  if (len == 0 && m_sack_permitted && !m_rlist.empty()) {
+    sack_len = writeSackBlocks(buffer.get() + HEADER_SIZE);
+    flags |= FLAG_SACK;
+  }
+
   long_to_bytes(m_conv, buffer.get());
   long_to_bytes(seq, buffer.get() + 4);
   long_to_bytes(m_rcv_nxt, buffer.get() + 8);
@@ -551,7 +590,8 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
 #endif // _DEBUGMSG
 
   IPseudoTcpNotify::WriteResult wres = m_notify->TcpWritePacket(
-      this, reinterpret_cast<char *>(buffer.get()), len + HEADER_SIZE);
+      this, reinterpret_cast<char *>(buffer.get()),
+      len + sack_len + HEADER_SIZE);
   // Note: When len is 0, this is an ACK packet.  We don't read the return value for those,
   // and thus we won't retry.  So go ahead and treat the packet as a success (basically simulate
   // as if it were dropped), which will prevent our timers from being messed up.
@@ -585,6 +625,14 @@ bool PseudoTcp::parse(const uint8_t* buffer, uint32_t size) {
   seg.data = reinterpret_cast<const char *>(buffer) + HEADER_SIZE;
   seg.len = size - HEADER_SIZE;
 
+  seg.sack = NULL;
+  seg.sack_len = 0;
+  if (seg.flags & FLAG_SACK) {
+    seg.sack = seg.data;
+    seg.sack_len = seg.len;
+    seg.len = 0;
+  }
+
 #if _DEBUGMSG >= _DBG_VERBOSE
   LOG(LS_INFO) << "--> <CONV=" << seg.conv
                << "><FLG=" << static_cast<unsigned>(seg.flags)
@@ -705,6 +753,10 @@ bool PseudoTcp::process(Segment& seg) {
     m_ts_recent = seg.tsval;
   }
 
+  if (seg.sack_len > 0) {
+    processSackBlocks(seg);
+  }
+
   // Check if this is a valuable ack
   if ((seg.ack > m_snd_una) && (seg.ack <= m_snd_nxt)) {
     // Calculate round-trip time
@@ -769,7 +821,14 @@ bool PseudoTcp::process(Segment& seg) {
 #if _DEBUGMSG >= _DBG_NORMAL
         LOG(LS_INFO) << "recovery retransmit";
 #endif // _DEBUGMSG
-        if (!transmit(m_slist.begin(), now)) {
+        // Partial ack: repair the next hole. Without SACK that is the first
+        // unacknowledged segment (NewReno), unless SACK already resent it.
+        SList::iterator lost = nextLostSegment();
+        if ((lost == m_slist.end()) &&
+            (!m_sack_permitted || m_slist.front().seq >= m_sack_rexmit)) {
+          lost = m_slist.begin();
+        }
+        if ((lost != m_slist.end()) && !retransmit(lost, now)) {
           closedown(ECONNABORTED);
           return false;
         }
@@ -777,12 +836,7 @@ bool PseudoTcp::process(Segment& seg) {
       }
     } else {
       m_dup_acks = 0;
-      // Slow start, congestion avoidance
-      if (m_cwnd < m_ssthresh) {
-        m_cwnd += m_mss;
-      } else {
-        m_cwnd += std::max<uint32_t>(1, m_mss * m_mss / m_cwnd);
-      }
+      growCongestionWindow(nAcked, now);
     }
   } else if (seg.ack == m_snd_una) {
     // !?! Note, tcp says don't do this... but otherwise how does a closed window become open?
@@ -798,17 +852,24 @@ bool PseudoTcp::process(Segment& seg) {
         LOG(LS_INFO) << "enter recovery";
         LOG(LS_INFO) << "recovery retransmit";
 #endif // _DEBUGMSG
-        if (!transmit(m_slist.begin(), now)) {
+        m_sack_rexmit = 0;
+        if (!retransmit(m_slist.begin(), now)) {
           closedown(ECONNABORTED);
           return false;
         }
         m_recover = m_snd_nxt;
-        uint32_t nInFlight = m_snd_nxt - m_snd_una;
-        m_ssthresh = std::max(nInFlight / 2, 2 * m_mss);
-        //LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: " << nInFlight << "  m_mss: " << m_mss;
+        m_ssthresh = onCongestionEvent();
         m_cwnd = m_ssthresh + 3 * m_mss;
       } else if (m_dup_acks > 3) {
-        m_cwnd += m_mss;
+        // Each dup ack means a segment left the network. With SACK, use that
+        // room to repair the next hole, otherwise to send new data.
+        SList::iterator lost = nextLostSegment();
+        if (lost == m_slist.end()) {
+          m_cwnd += m_mss;
+        } else if (!retransmit(lost, now)) {
+          closedown(ECONNABORTED);
+          return false;
+        }
       }
     } else {
       m_dup_acks = 0;
@@ -1037,6 +1098,7 @@ void PseudoTcp::attemptSend(SendFlags sflags) {
 
   if (rtc::TimeDiff32(now, m_lastsend) > static_cast<long>(m_rx_rto)) {
     m_cwnd = m_mss;
+    m_cubic_epoch = 0;
   }
 
 #if _DEBUGMSG
@@ -1128,6 +1190,130 @@ void PseudoTcp::attemptSend(SendFlags sflags) {
   }
 }
 
+bool PseudoTcp::retransmit(const SList::iterator& seg, uint32_t now) {
+  if (!transmit(seg, now)) {
+    return false;
+  }
+  m_sack_rexmit = std::max(m_sack_rexmit, seg->seq + seg->len);
+  return true;
+}
+
+PseudoTcp::SList::iterator PseudoTcp::nextLostSegment() {
+  if (!m_sack_permitted) {
+    return m_slist.end();
+  }
+  // Sent segments below the highest SACK block that weren't acknowledged
+  // themselves are considered lost.
+  for (SList::iterator it = m_slist.begin();
+       (it != m_slist.end()) && (it->xmit > 0) && (it->seq < m_sack_high);
+       ++it) {
+    if (!it->bSacked && (it->seq >= m_sack_rexmit)) {
+      return it;
+    }
+  }
+  return m_slist.end();
+}
+
+uint32_t PseudoTcp::writeSackBlocks(uint8_t* buffer) const {
+  uint32_t blocks = 0;
+  RList::const_iterator it = m_rlist.begin();
+  while ((it != m_rlist.end()) && (blocks < MAX_SACK_BLOCKS)) {
+    // |m_rlist| is sorted by sequence number; merge the segments that overlap
+    // or are adjacent into one block.
+    uint32_t start = it->seq;
+    uint32_t end = it->seq + it->len;
+    for (++it; (it != m_rlist.end()) && (it->seq <= end); ++it) {
+      end = std::max(end, it->seq + it->len);
+    }
+    long_to_bytes(start, buffer + blocks * SACK_BLOCK_SIZE);
+    long_to_bytes(end, buffer + blocks * SACK_BLOCK_SIZE + 4);
+    ++blocks;
+  }
+  return blocks * SACK_BLOCK_SIZE;
+}
+
+void PseudoTcp::processSackBlocks(const Segment& seg) {
+  SList::iterator it = m_slist.begin();
+  uint32_t prev_end = 0;
+  for (uint32_t i = 0; i + SACK_BLOCK_SIZE <= seg.sack_len;
+       i += SACK_BLOCK_SIZE) {
+    uint32_t start = bytes_to_long(seg.sack + i);
+    uint32_t end = bytes_to_long(seg.sack + i + 4);
+    if ((start >= end) || (start < m_snd_una) || (end > m_snd_nxt)) {
+      // Stale or invalid block.
+      continue;
+    }
+    m_sack_high = std::max(m_sack_high, end);
+
+    // Blocks normally arrive in ascending order, so continue the walk over
+    // |m_slist| where the previous block ended.
+    if (start < prev_end) {
+      it = m_slist.begin();
+    }
+    prev_end = end;
+    while ((it != m_slist.end()) && (it->seq < start)) {
+      ++it;
+    }
+    for (; (it != m_slist.end()) && (it->seq + it->len <= end); ++it) {
+      it->bSacked = true;
+    }
+  }
+}
+
+uint32_t PseudoTcp::onCongestionEvent() {
+  if (m_congestion_control == CC_CUBIC) {
+    // Fast convergence: if the window didn't get back to its previous
+    // maximum, aim lower to leave room for competing flows.
+    m_cubic_wmax = (m_cwnd < m_cubic_wmax)
+                       ? static_cast<uint32_t>(m_cwnd * (1 + CUBIC_BETA) / 2)
+                       : m_cwnd;
+    m_cubic_epoch = 0;
+    return std::max(static_cast<uint32_t>(m_cwnd * CUBIC_BETA), 2 * m_mss);
+  }
+  uint32_t nInFlight = m_snd_nxt - m_snd_una;
+  return std::max(nInFlight / 2, 2 * m_mss);
+}
+
+void PseudoTcp::growCongestionWindow(uint32_t acked, uint32_t now) {
+  // Slow start
+  if (m_cwnd < m_ssthresh) {
+    m_cwnd += m_mss;
+    return;
+  }
+
+  // Congestion avoidance
+  if (m_congestion_control != CC_CUBIC) {
+    m_cwnd += std::max<uint32_t>(1, m_mss * m_mss / m_cwnd);
+    return;
+  }
+
+  if (m_cubic_epoch == 0) {
+    m_cubic_epoch = std::max<uint32_t>(now, 1);
+    m_cubic_west = m_cwnd;
+    if (m_cwnd < m_cubic_wmax) {
+      m_cubic_k = std::cbrt((m_cubic_wmax - m_cwnd) / (CUBIC_C * m_mss));
+      m_cubic_origin = m_cubic_wmax;
+    } else {
+      m_cubic_k = 0;
+      m_cubic_origin = m_cwnd;
+    }
+  }
+
+  // The window the cubic function reaches one RTT from now, in bytes.
+  double t = (rtc::TimeDiff32(now, m_cubic_epoch) +
+              static_cast<int32_t>(m_rx_srtt)) / 1000.0 - m_cubic_k;
+  double target = m_cubic_origin + CUBIC_C * t * t * t * m_mss;
+  // Never grow slower than NewReno would (the "TCP-friendly region"), nor
+  // faster than 1.5 times the window per RTT.
+  m_cubic_west += 3 * (1 - CUBIC_BETA) / (1 + CUBIC_BETA) * m_mss * acked /
+                  m_cwnd;
+  target = std::min(std::max(target, m_cubic_west), 1.5 * m_cwnd);
+  if (target > m_cwnd) {
+    m_cwnd += std::max<uint32_t>(
+        1, static_cast<uint32_t>((target - m_cwnd) * acked / m_cwnd));
+  }
+}
+
 void PseudoTcp::closedown(uint32_t err) {
   LOG(LS_INFO) << "State: TCP_CLOSED";
   m_state = TCP_CLOSED;
@@ -1167,6 +1353,11 @@ PseudoTcp::disableWindowScale() {
   m_support_wnd_scale = false;
 }
 
+bool
+PseudoTcp::isSackPermitted() const {
+  return m_sack_permitted;
+}
+
 void
 PseudoTcp::queueConnectMessage() {
   rtc::ByteBufferWriter buf(rtc::ByteBuffer::ORDER_NETWORK);
@@ -1177,6 +1368,10 @@ PseudoTcp::queueConnectMessage() {
     buf.WriteUInt8(1);
     buf.WriteUInt8(m_rwnd_scale);
   }
+  if (m_use_sack) {
+    buf.WriteUInt8(TCP_OPT_SACK_PERMITTED);
+    buf.WriteUInt8(0);
+  }
   m_snd_wnd = static_cast<uint32_t>(buf.Length());
   queue(buf.Data(), static_cast<uint32_t>(buf.Length()), true);
 }
@@ -1239,6 +1434,14 @@ void PseudoTcp::applyOption(char kind, const char* data, uint32_t len) {
       return;
     }
     applyWindowScaleOption(data[0]);
+  } else if (kind == TCP_OPT_SACK_PERMITTED) {
+    // Selective acknowledgements.
+    // https://tools.ietf.org/html/rfc2018
+    if (len != 0) {
+      LOG_F(WARNING) << "Invalid SACK permitted option received.";
+      return;
+    }
+    applySackPermittedOption();
   }
 }
 
@@ -1246,6 +1449,10 @@ void PseudoTcp::applyWindowScaleOption(uint8_t scale_factor) {
   m_swnd_scale = scale_factor;
 }
 
+void PseudoTcp::applySackPermittedOption() {
+  m_sack_permitted = m_use_sack;
+}
+
 void PseudoTcp::resizeSendBuffer(uint32_t new_size) {
   m_sbuf_len = new_size;
   m_sbuf.SetCapacity(new_size);
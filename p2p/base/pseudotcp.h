@@ -82,17 +82,25 @@ class PseudoTcp {
   // instance's behaviour for the kind of data it will carry.
   // If an unrecognized option is set or got, an assertion will fire.
   //
-  // Setting options for OPT_RCVBUF or OPT_SNDBUF after Connect() is called
-  // will result in an assertion.
+  // Setting options for OPT_RCVBUF, OPT_SNDBUF or OPT_SACK after Connect() is
+  // called will result in an assertion.
   enum Option {
     OPT_NODELAY,      // Whether to enable Nagle's algorithm (0 == off)
     OPT_ACKDELAY,     // The Delayed ACK timeout (0 == off).
     OPT_RCVBUF,       // Set the receive buffer size, in bytes.
     OPT_SNDBUF,       // Set the send buffer size, in bytes.
+    OPT_SACK,         // Whether to offer selective acknowledgements (0 == off).
+    OPT_CONGESTION_CONTROL,  // A CongestionControl value.
   };
   void GetOption(Option opt, int* value);
   void SetOption(Option opt, int value);
 
+  // Congestion control algorithms, set with OPT_CONGESTION_CONTROL.
+  enum CongestionControl {
+    CC_NEW_RENO,  // RFC 6582, the default.
+    CC_CUBIC,     // RFC 8312, for paths with a large bandwidth-delay product.
+  };
+
   // Returns current congestion window in bytes.
   uint32_t GetCongestionWindow() const;
 
@@ -117,15 +125,20 @@ class PseudoTcp {
     const char * data;
     uint32_t len;
     uint32_t tsval, tsecr;
+    // SACK blocks carried by an ACK, see parse().
+    const char* sack;
+    uint32_t sack_len;
   };
 
   struct SSegment {
     SSegment(uint32_t s, uint32_t l, bool c)
-        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c) {}
+        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c), bSacked(false) {}
     uint32_t seq, len;
     // uint32_t tstamp;
     uint8_t xmit;
     bool bCtrl;
+    // Whether the peer selectively acknowledged this segment.
+    bool bSacked;
   };
   typedef std::list<SSegment> SList;
 
@@ -158,6 +171,23 @@ class PseudoTcp {
   bool process(Segment& seg);
   bool transmit(const SList::iterator& seg, uint32_t now);
 
+  // Writes the SACK blocks describing |m_rlist| to |buffer|, and returns the
+  // number of bytes written.
+  uint32_t writeSackBlocks(uint8_t* buffer) const;
+  // Marks the segments covered by the SACK blocks of |seg| as received.
+  void processSackBlocks(const Segment& seg);
+  // Returns the first segment that the SACK blocks show as lost and that
+  // hasn't been retransmitted in the current recovery yet, or m_slist.end().
+  SList::iterator nextLostSegment();
+  // Transmits |seg| again during recovery.
+  bool retransmit(const SList::iterator& seg, uint32_t now);
+
+  // Returns the new slow start threshold after a loss, and updates the state
+  // of the congestion controller.
+  uint32_t onCongestionEvent();
+  // Grows the congestion window when |acked| new bytes are acknowledged.
+  void growCongestionWindow(uint32_t acked, uint32_t now);
+
   void adjustMTU();
 
  protected:
@@ -168,6 +198,10 @@ class PseudoTcp {
   // support for testing backward compatibility.
   void disableWindowScale();
 
+  // This method is used in test only to query whether both sides offered
+  // selective acknowledgements.
+  bool isSackPermitted() const;
+
  private:
   // Queue the connect message with TCP options.
   void queueConnectMessage();
@@ -181,6 +215,9 @@ class PseudoTcp {
   // Apply window scale option.
   void applyWindowScaleOption(uint8_t scale_factor);
 
+  // Apply SACK permitted option.
+  void applySackPermittedOption();
+
   // Resize the send buffer with |new_size| in bytes.
   void resizeSendBuffer(uint32_t new_size);
 
@@ -224,13 +261,31 @@ class PseudoTcp {
 
   // Congestion avoidance, Fast retransmit/recovery, Delayed ACKs
   uint32_t m_ssthresh, m_cwnd;
-  uint8_t m_dup_acks;
+  // Not a uint8_t, since a large window can produce hundreds of dup acks in a
+  // single recovery.
+  uint32_t m_dup_acks;
   uint32_t m_recover;
   uint32_t m_t_ack;
 
+  // Selective acknowledgements (RFC 2018). |m_sack_high| is the end of the
+  // highest block the peer acknowledged, and |m_sack_rexmit| the sequence
+  // number below which lost segments were already retransmitted in the
+  // current recovery.
+  bool m_sack_permitted;
+  uint32_t m_sack_high, m_sack_rexmit;
+
+  // CUBIC state (RFC 8312): the window before the last reduction, the start
+  // of the current congestion avoidance epoch (0 if none), the window the
+  // cubic function grows towards, the time to reach it, and the window
+  // NewReno would have.
+  uint32_t m_cubic_wmax, m_cubic_epoch, m_cubic_origin;
+  double m_cubic_k, m_cubic_west;
+
   // Configuration options
   bool m_use_nagling;
   uint32_t m_ack_delay;
+  bool m_use_sack;
+  CongestionControl m_congestion_control;
 
   // This is used by unit tests to test backward compatibility of
   // PseudoTcp implementations that don't support window scaling.
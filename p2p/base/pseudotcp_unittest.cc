@@ -9,9 +9,12 @@
  */
 
 #include <algorithm>
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "webrtc/p2p/base/pseudotcp.h"
+#include "webrtc/rtc_base/byteorder.h"
 #include "webrtc/rtc_base/gunit.h"
 #include "webrtc/rtc_base/helpers.h"
 #include "webrtc/rtc_base/messagehandler.h"
@@ -25,6 +28,12 @@ static const int kConnectTimeoutMs = 10000;  // ~3 * default RTO of 3000ms
 static const int kTransferTimeoutMs = 15000;
 static const int kBlockSize = 4096;
 
+// Wire format details of PseudoTcp packets, see pseudotcp.cc.
+static const size_t kHeaderSize = 24;
+static const uint8_t kFlagCtl = 0x02;
+static const uint8_t kFlagSack = 0x08;
+static const size_t kSackBlockSize = 8;
+
 class PseudoTcpForTest : public cricket::PseudoTcp {
  public:
   PseudoTcpForTest(cricket::IPseudoTcpNotify* notify, uint32_t conv)
@@ -37,6 +46,10 @@ class PseudoTcpForTest : public cricket::PseudoTcp {
   void disableWindowScale() {
     PseudoTcp::disableWindowScale();
   }
+
+  bool isSackPermitted() const {
+    return PseudoTcp::isSackPermitted();
+  }
 };
 
 class PseudoTcpTestBase : public testing::Test,
@@ -91,11 +104,34 @@ class PseudoTcpTestBase : public testing::Test,
   void SetLocalOptRcvBuf(int size) {
     local_.SetOption(PseudoTcp::OPT_RCVBUF, size);
   }
+  void SetOptSack(bool enable_sack) {
+    local_.SetOption(PseudoTcp::OPT_SACK, enable_sack);
+    remote_.SetOption(PseudoTcp::OPT_SACK, enable_sack);
+  }
+  void SetLocalOptSack(bool enable_sack) {
+    local_.SetOption(PseudoTcp::OPT_SACK, enable_sack);
+  }
+  void SetRemoteOptSack(bool enable_sack) {
+    remote_.SetOption(PseudoTcp::OPT_SACK, enable_sack);
+  }
+  void SetOptCongestionControl(PseudoTcp::CongestionControl cc) {
+    local_.SetOption(PseudoTcp::OPT_CONGESTION_CONTROL, cc);
+    remote_.SetOption(PseudoTcp::OPT_CONGESTION_CONTROL, cc);
+  }
+  // Makes a side behave like a peer that predates TCP options, which supports
+  // neither window scaling nor selective acknowledgements.
   void DisableRemoteWindowScale() {
     remote_.disableWindowScale();
+    remote_.SetOption(PseudoTcp::OPT_SACK, 0);
   }
   void DisableLocalWindowScale() {
     local_.disableWindowScale();
+    local_.SetOption(PseudoTcp::OPT_SACK, 0);
+  }
+  // Drops the first transmission of the |index|th data segment sent by the
+  // local side, counting from 0.
+  void DropLocalDataSegment(int index) {
+    dropped_local_segments_.insert(index);
   }
 
  protected:
@@ -138,9 +174,12 @@ class PseudoTcpTestBase : public testing::Test,
   }
   virtual WriteResult TcpWritePacket(PseudoTcp* tcp,
                                      const char* buffer, size_t len) {
-    // Randomly drop the desired percentage of packets.
-    // Also drop packets that are larger than the configured MTU.
-    if (rtc::CreateRandomId() % 100 < static_cast<uint32_t>(loss_)) {
+    // Drop the segments selected by DropLocalDataSegment(), randomly drop the
+    // desired percentage of packets, and drop packets that are larger than
+    // the configured MTU.
+    if (InspectPacket(tcp, buffer, len)) {
+      LOG(LS_VERBOSE) << "Dropping selected packet, size=" << len;
+    } else if (rtc::CreateRandomId() % 100 < static_cast<uint32_t>(loss_)) {
       LOG(LS_VERBOSE) << "Randomly dropping packet, size=" << len;
     } else if (len > static_cast<size_t>(std::min(local_mtu_, remote_mtu_))) {
       LOG(LS_VERBOSE) << "Dropping packet that exceeds path MTU, size=" << len;
@@ -153,6 +192,39 @@ class PseudoTcpTestBase : public testing::Test,
     return WR_SUCCESS;
   }
 
+  // Records the data segments sent by the local side and the SACK blocks sent
+  // by the remote side. Returns true if the packet should be dropped.
+  bool InspectPacket(PseudoTcp* tcp, const char* buffer, size_t len) {
+    if (len < kHeaderSize)
+      return false;
+    const uint32_t seq = rtc::GetBE32(buffer + 4);
+    const uint32_t ack = rtc::GetBE32(buffer + 8);
+    const uint8_t flags = static_cast<uint8_t>(buffer[13]);
+    if (tcp == &remote_ && (flags & kFlagSack)) {
+      SackAck sack_ack;
+      sack_ack.ack = ack;
+      for (size_t i = kHeaderSize; i + kSackBlockSize <= len;
+           i += kSackBlockSize) {
+        sack_ack.blocks.push_back(std::make_pair(
+            rtc::GetBE32(buffer + i), rtc::GetBE32(buffer + i + 4)));
+      }
+      remote_sack_acks_.push_back(sack_ack);
+      return false;
+    }
+    if (tcp != &local_ || (flags & kFlagCtl) || len == kHeaderSize)
+      return false;
+    const uint32_t data_len = static_cast<uint32_t>(len - kHeaderSize);
+    if (!local_segments_.empty() && seq < local_snd_max_) {
+      retransmitted_seqs_.push_back(seq);
+      retransmit_times_ms_.push_back(rtc::TimeMillis());
+      return false;
+    }
+    local_segments_.push_back(std::make_pair(seq, data_len));
+    local_snd_max_ = seq + data_len;
+    return dropped_local_segments_.count(
+               static_cast<int>(local_segments_.size() - 1)) > 0;
+  }
+
   void UpdateLocalClock() { UpdateClock(&local_, MSG_LCLOCK); }
   void UpdateRemoteClock() { UpdateClock(&remote_, MSG_RCLOCK); }
   void UpdateClock(PseudoTcp* tcp, uint32_t message) {
@@ -203,6 +275,20 @@ class PseudoTcpTestBase : public testing::Test,
   int remote_mtu_;
   int delay_;
   int loss_;
+
+  // An ACK carrying SACK blocks, each a [start, end) sequence number range.
+  struct SackAck {
+    uint32_t ack;
+    std::vector<std::pair<uint32_t, uint32_t>> blocks;
+  };
+  std::set<int> dropped_local_segments_;
+  // The sequence number and length of each data segment the local side
+  // transmitted for the first time, in order.
+  std::vector<std::pair<uint32_t, uint32_t>> local_segments_;
+  uint32_t local_snd_max_ = 0;
+  std::vector<uint32_t> retransmitted_seqs_;
+  std::vector<int64_t> retransmit_times_ms_;
+  std::vector<SackAck> remote_sack_acks_;
 };
 
 class PseudoTcpTest : public PseudoTcpTestBase {
@@ -668,6 +754,8 @@ TEST_F(PseudoTcpTest, TestSendRemoteNoWindowScale) {
   SetLocalOptRcvBuf(100000);
   DisableRemoteWindowScale();
   TestTransfer(1000000);
+  EXPECT_FALSE(local_.isSackPermitted());
+  EXPECT_FALSE(remote_.isSackPermitted());
 }
 
 // Test a large sender-side receive buffer with a receiver that doesn't support
@@ -678,6 +766,8 @@ TEST_F(PseudoTcpTest, TestSendLocalNoWindowScale) {
   SetRemoteOptRcvBuf(100000);
   DisableLocalWindowScale();
   TestTransfer(1000000);
+  EXPECT_FALSE(local_.isSackPermitted());
+  EXPECT_FALSE(remote_.isSackPermitted());
 }
 
 // Test when both sides use window scaling.
@@ -707,6 +797,147 @@ TEST_F(PseudoTcpTest, TestSendBothUseLargeWindowScale) {
   TestTransfer(10000000);
 }
 
+// Bulk transfer tests over a 100 ms RTT link with 1% packet loss, with
+// buffers well above the bandwidth-delay product so that congestion control
+// and loss recovery, not the window, limit the throughput.
+TEST_F(PseudoTcpTest, TestThroughputWithDelayAndLossNewReno) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  SetLoss(1);
+  SetRemoteOptRcvBuf(1000000);
+  SetLocalOptRcvBuf(1000000);
+  SetOptSndBuf(1500000);
+  SetOptSack(false);
+  TestTransfer(500000);
+}
+
+TEST_F(PseudoTcpTest, TestThroughputWithDelayAndLossNewRenoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  SetLoss(1);
+  SetRemoteOptRcvBuf(1000000);
+  SetLocalOptRcvBuf(1000000);
+  SetOptSndBuf(1500000);
+  TestTransfer(500000);
+}
+
+TEST_F(PseudoTcpTest, TestThroughputWithDelayAndLossCubicSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  SetLoss(1);
+  SetRemoteOptRcvBuf(1000000);
+  SetLocalOptRcvBuf(1000000);
+  SetOptSndBuf(1500000);
+  SetOptCongestionControl(PseudoTcp::CC_CUBIC);
+  TestTransfer(500000);
+}
+
+// Test that SACK is only used when both sides offer it, and that a lossy
+// transfer falls back to NewReno when the receiver doesn't.
+TEST_F(PseudoTcpTest, TestSendWithLossRemoteNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  SetRemoteOptSack(false);
+  DropLocalDataSegment(40);
+  DropLocalDataSegment(42);
+  TestTransfer(500000);
+  EXPECT_FALSE(local_.isSackPermitted());
+  EXPECT_FALSE(remote_.isSackPermitted());
+  EXPECT_TRUE(remote_sack_acks_.empty());
+  EXPECT_EQ(2U, retransmitted_seqs_.size());
+}
+
+// Same as above, with SACK disabled on the sender.
+TEST_F(PseudoTcpTest, TestSendWithLossLocalNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  SetLocalOptSack(false);
+  DropLocalDataSegment(40);
+  DropLocalDataSegment(42);
+  TestTransfer(500000);
+  EXPECT_FALSE(local_.isSackPermitted());
+  EXPECT_FALSE(remote_.isSackPermitted());
+  EXPECT_TRUE(remote_sack_acks_.empty());
+  EXPECT_EQ(2U, retransmitted_seqs_.size());
+}
+
+// Test that the receiver describes the out-of-order data it holds with SACK
+// blocks, and that the sender retransmits only the segments they show as lost.
+TEST_F(PseudoTcpTest, TestSackBlocks) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  DropLocalDataSegment(40);
+  DropLocalDataSegment(42);
+  TestTransfer(500000);
+  EXPECT_TRUE(local_.isSackPermitted());
+  EXPECT_TRUE(remote_.isSackPermitted());
+  ASSERT_GT(local_segments_.size(), 43U);
+
+  // Every block lies above the cumulative ACK, and the blocks are disjoint
+  // and sorted.
+  ASSERT_FALSE(remote_sack_acks_.empty());
+  for (const SackAck& sack_ack : remote_sack_acks_) {
+    ASSERT_FALSE(sack_ack.blocks.empty());
+    uint32_t prev_end = sack_ack.ack;
+    for (const auto& block : sack_ack.blocks) {
+      EXPECT_LT(prev_end, block.first);
+      EXPECT_LT(block.first, block.second);
+      prev_end = block.second;
+    }
+  }
+
+  // Once segment 43 arrives, the receiver reports the two holes.
+  bool found_both_holes = false;
+  for (const SackAck& sack_ack : remote_sack_acks_) {
+    if (sack_ack.ack == local_segments_[40].first &&
+        sack_ack.blocks.size() == 2 &&
+        sack_ack.blocks[0].first == local_segments_[41].first &&
+        sack_ack.blocks[0].second == local_segments_[42].first &&
+        sack_ack.blocks[1].first == local_segments_[43].first) {
+      found_both_holes = true;
+    }
+  }
+  EXPECT_TRUE(found_both_holes);
+
+  std::vector<uint32_t> expected_retransmits = {local_segments_[40].first,
+                                                local_segments_[42].first};
+  EXPECT_EQ(expected_retransmits, retransmitted_seqs_);
+}
+
+// Test losing three segments from one window over a 100 ms RTT link. SACK
+// retransmits all of them within one round trip, while NewReno learns about
+// one hole per round trip from the partial ACKs.
+TEST_F(PseudoTcpTest, TestSackRepairsHolesWithinOneRoundTrip) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  DropLocalDataSegment(40);
+  DropLocalDataSegment(43);
+  DropLocalDataSegment(46);
+  TestTransfer(500000);
+  ASSERT_EQ(3U, retransmit_times_ms_.size());
+  EXPECT_LT(retransmit_times_ms_.back() - retransmit_times_ms_.front(), 100);
+}
+
+TEST_F(PseudoTcpTest, TestNewRenoRepairsOneHolePerRoundTrip) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  SetOptSack(false);
+  DropLocalDataSegment(40);
+  DropLocalDataSegment(43);
+  DropLocalDataSegment(46);
+  TestTransfer(500000);
+  ASSERT_EQ(3U, retransmit_times_ms_.size());
+  EXPECT_GE(retransmit_times_ms_.back() - retransmit_times_ms_.front(), 150);
+}
+
 // Test using a small receive buffer.
 TEST_F(PseudoTcpTest, TestSendSmallReceiveBuffer) {
   SetLocalMtu(1500);
@@ -177,6 +177,26 @@ bool TransportController::SetRemoteTransportDescription(
                 transport_name, tdesc, action, err));
 }
 
+bool TransportController::SetLocalTransportDescriptions(
+    const TransportInfos& transport_infos,
+    ContentAction action,
+    std::string* err) {
+  return network_thread_->Invoke<bool>(
+      RTC_FROM_HERE,
+      rtc::Bind(&TransportController::SetLocalTransportDescriptions_n, this,
+                transport_infos, action, err));
+}
+
+bool TransportController::SetRemoteTransportDescriptions(
+    const TransportInfos& transport_infos,
+    ContentAction action,
+    std::string* err) {
+  return network_thread_->Invoke<bool>(
+      RTC_FROM_HERE,
+      rtc::Bind(&TransportController::SetRemoteTransportDescriptions_n, this,
+                transport_infos, action, err));
+}
+
 void TransportController::MaybeStartGathering() {
   network_thread_->Invoke<void>(
       RTC_FROM_HERE,
@@ -639,6 +659,34 @@ bool TransportController::SetRemoteTransportDescription_n(
   return transport->SetRemoteTransportDescription(tdesc, action, err);
 }
 
+bool TransportController::SetLocalTransportDescriptions_n(
+    const TransportInfos& transport_infos,
+    ContentAction action,
+    std::string* err) {
+  RTC_DCHECK(network_thread_->IsCurrent());
+  for (const TransportInfo& tinfo : transport_infos) {
+    if (!SetLocalTransportDescription_n(tinfo.content_name,
+                                        tinfo.description, action, err)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TransportController::SetRemoteTransportDescriptions_n(
+    const TransportInfos& transport_infos,
+    ContentAction action,
+    std::string* err) {
+  RTC_DCHECK(network_thread_->IsCurrent());
+  for (const TransportInfo& tinfo : transport_infos) {
+    if (!SetRemoteTransportDescription_n(tinfo.content_name,
+                                         tinfo.description, action, err)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void TransportController::MaybeStartGathering_n() {
   for (auto& channel : channels_) {
     channel->dtls()->ice_transport()->MaybeStartGathering();
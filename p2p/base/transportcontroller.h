@@ -97,6 +97,14 @@ class TransportController : public sigslot::has_slots<>,
                                      const TransportDescription& tdesc,
                                      ContentAction action,
                                      std::string* err);
+  // Like the above, but sets the descriptions of all |transport_infos| with a
+  // single hop to the network thread, stopping at the first failure.
+  bool SetLocalTransportDescriptions(const TransportInfos& transport_infos,
+                                     ContentAction action,
+                                     std::string* err);
+  bool SetRemoteTransportDescriptions(const TransportInfos& transport_infos,
+                                      ContentAction action,
+                                      std::string* err);
   // Start gathering candidates for any new transports, or transports doing an
   // ICE restart.
   void MaybeStartGathering();
@@ -221,6 +229,12 @@ class TransportController : public sigslot::has_slots<>,
                                        const TransportDescription& tdesc,
                                        ContentAction action,
                                        std::string* err);
+  bool SetLocalTransportDescriptions_n(const TransportInfos& transport_infos,
+                                       ContentAction action,
+                                       std::string* err);
+  bool SetRemoteTransportDescriptions_n(const TransportInfos& transport_infos,
+                                        ContentAction action,
+                                        std::string* err);
   void MaybeStartGathering_n();
   bool AddRemoteCandidates_n(const std::string& transport_name,
                              const Candidates& candidates,
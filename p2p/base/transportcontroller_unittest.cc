@@ -10,6 +10,7 @@
 
 #include <map>
 #include <memory>
+#include <utility>
 
 #include "webrtc/p2p/base/dtlstransportchannel.h"
 #include "webrtc/p2p/base/fakeportallocator.h"
@@ -394,6 +395,37 @@ TEST_F(TransportControllerTest, TestSetRemoteTransportDescription) {
   EXPECT_EQ(kIcePwd1, transport->fake_ice_transport()->remote_ice_pwd());
 }
 
+TEST_F(TransportControllerTest, TestSetTransportDescriptions) {
+  CreateTransportControllerWithNetworkThread();
+  FakeDtlsTransport* transport1 = network_thread_->Invoke<FakeDtlsTransport*>(
+      RTC_FROM_HERE, [this] { return CreateFakeDtlsTransport("audio", 1); });
+  ASSERT_NE(nullptr, transport1);
+  FakeDtlsTransport* transport2 = network_thread_->Invoke<FakeDtlsTransport*>(
+      RTC_FROM_HERE, [this] { return CreateFakeDtlsTransport("video", 1); });
+  ASSERT_NE(nullptr, transport2);
+
+  TransportInfos local_infos;
+  local_infos.push_back(TransportInfo(
+      "audio", TransportDescription(kIceUfrag1, kIcePwd1)));
+  local_infos.push_back(TransportInfo(
+      "video", TransportDescription(kIceUfrag2, kIcePwd2)));
+  // A transport that was deleted as a result of bundling is ignored.
+  local_infos.push_back(TransportInfo(
+      "data", TransportDescription(kIceUfrag3, kIcePwd3)));
+  TransportInfos remote_infos = local_infos;
+  std::swap(remote_infos[0].description, remote_infos[1].description);
+
+  std::string err;
+  EXPECT_TRUE(transport_controller_->SetLocalTransportDescriptions(
+      local_infos, CA_OFFER, &err));
+  EXPECT_TRUE(transport_controller_->SetRemoteTransportDescriptions(
+      remote_infos, CA_ANSWER, &err));
+  EXPECT_EQ(kIceUfrag1, transport1->fake_ice_transport()->ice_ufrag());
+  EXPECT_EQ(kIceUfrag2, transport1->fake_ice_transport()->remote_ice_ufrag());
+  EXPECT_EQ(kIceUfrag2, transport2->fake_ice_transport()->ice_ufrag());
+  EXPECT_EQ(kIceUfrag1, transport2->fake_ice_transport()->remote_ice_ufrag());
+}
+
 TEST_F(TransportControllerTest, TestAddRemoteCandidates) {
   FakeDtlsTransport* transport = CreateFakeDtlsTransport("audio", 1);
   ASSERT_NE(nullptr, transport);
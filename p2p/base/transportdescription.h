@@ -141,6 +141,20 @@ struct TransportDescription {
     return *this;
   }
 
+  bool operator==(const TransportDescription& other) const {
+    return transport_options == other.transport_options &&
+           ice_ufrag == other.ice_ufrag && ice_pwd == other.ice_pwd &&
+           ice_mode == other.ice_mode &&
+           connection_role == other.connection_role &&
+           (identity_fingerprint
+                ? other.identity_fingerprint &&
+                      *identity_fingerprint == *other.identity_fingerprint
+                : !other.identity_fingerprint);
+  }
+  bool operator!=(const TransportDescription& other) const {
+    return !(*this == other);
+  }
+
   // TODO(deadbeef): Rename to HasIceOption, etc.
   bool HasOption(const std::string& option) const {
     return (std::find(transport_options.begin(), transport_options.end(),
@@ -0,0 +1,109 @@
+/*
+ *  Copyright 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/pc/channelcommandbatch.h"
+
+#include <utility>
+
+#include "webrtc/pc/channel.h"
+#include "webrtc/rtc_base/bind.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/trace_event.h"
+
+namespace cricket {
+
+ChannelCommandBatch::ChannelCommandBatch(rtc::Thread* worker_thread)
+    : worker_thread_(worker_thread) {
+  RTC_DCHECK(worker_thread_);
+}
+
+ChannelCommandBatch::~ChannelCommandBatch() {
+  RTC_DCHECK(commands_.empty()) << "Dropping unexecuted channel commands.";
+}
+
+void ChannelCommandBatch::Add(std::function<bool()> command) {
+  commands_.push_back(std::move(command));
+}
+
+void ChannelCommandBatch::SetLocalContent(
+    BaseChannel* channel,
+    const MediaContentDescription* content,
+    ContentAction action,
+    std::string* error_desc) {
+  if (!channel)
+    return;
+  Add([channel, content, action, error_desc] {
+    return channel->SetLocalContent(content, action, error_desc);
+  });
+}
+
+void ChannelCommandBatch::SetRemoteContent(
+    BaseChannel* channel,
+    const MediaContentDescription* content,
+    ContentAction action,
+    std::string* error_desc) {
+  if (!channel)
+    return;
+  Add([channel, content, action, error_desc] {
+    return channel->SetRemoteContent(content, action, error_desc);
+  });
+}
+
+void ChannelCommandBatch::PushdownLocalDescription(
+    BaseChannel* channel,
+    const SessionDescription* local_desc,
+    ContentAction action,
+    std::string* error_desc) {
+  if (!channel)
+    return;
+  Add([channel, local_desc, action, error_desc] {
+    return channel->PushdownLocalDescription(local_desc, action, error_desc);
+  });
+}
+
+void ChannelCommandBatch::PushdownRemoteDescription(
+    BaseChannel* channel,
+    const SessionDescription* remote_desc,
+    ContentAction action,
+    std::string* error_desc) {
+  if (!channel)
+    return;
+  Add([channel, remote_desc, action, error_desc] {
+    return channel->PushdownRemoteDescription(remote_desc, action, error_desc);
+  });
+}
+
+void ChannelCommandBatch::Enable(BaseChannel* channel, bool enable) {
+  if (!channel)
+    return;
+  Add([channel, enable] { return channel->Enable(enable); });
+}
+
+bool ChannelCommandBatch::Execute() {
+  if (commands_.empty())
+    return true;
+  TRACE_EVENT1("webrtc", "ChannelCommandBatch::Execute", "commands",
+               commands_.size());
+  return worker_thread_->Invoke<bool>(
+      RTC_FROM_HERE, rtc::Bind(&ChannelCommandBatch::Execute_w, this));
+}
+
+bool ChannelCommandBatch::Execute_w() {
+  RTC_DCHECK(worker_thread_->IsCurrent());
+  std::vector<std::function<bool()>> commands;
+  commands.swap(commands_);
+  for (const auto& command : commands) {
+    if (!command())
+      return false;
+  }
+  return true;
+}
+
+}  // namespace cricket
@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_PC_CHANNELCOMMANDBATCH_H_
+#define WEBRTC_PC_CHANNELCOMMANDBATCH_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "webrtc/p2p/base/sessiondescription.h"
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/thread.h"
+
+namespace cricket {
+
+class BaseChannel;
+class MediaContentDescription;
+
+// Queues operations on channels (and on the ChannelManager creating them) so
+// that they are executed with a single worker thread hop, instead of one hop
+// per operation. The commands use the regular signaling thread API; since the
+// channels marshal calls with rtc::Thread::Invoke, which runs synchronously on
+// the target thread, none of them hops again to the worker thread.
+//
+// Example:
+//   ChannelCommandBatch batch(channel_manager->worker_thread());
+//   batch.SetLocalContent(voice_channel, audio_content, CA_OFFER, &err);
+//   batch.SetLocalContent(video_channel, video_content, CA_OFFER, &err);
+//   bool ok = batch.Execute();
+class ChannelCommandBatch {
+ public:
+  explicit ChannelCommandBatch(rtc::Thread* worker_thread);
+  ~ChannelCommandBatch();
+
+  // Queues |command|, which returns false on failure. Pointers it captures
+  // must stay valid until Execute is called.
+  void Add(std::function<bool()> command);
+
+  // Shorthands for queueing common operations. A null |channel| is ignored,
+  // like a channel that was never created.
+  void SetLocalContent(BaseChannel* channel,
+                       const MediaContentDescription* content,
+                       ContentAction action,
+                       std::string* error_desc);
+  void SetRemoteContent(BaseChannel* channel,
+                        const MediaContentDescription* content,
+                        ContentAction action,
+                        std::string* error_desc);
+  void PushdownLocalDescription(BaseChannel* channel,
+                                const SessionDescription* local_desc,
+                                ContentAction action,
+                                std::string* error_desc);
+  void PushdownRemoteDescription(BaseChannel* channel,
+                                 const SessionDescription* remote_desc,
+                                 ContentAction action,
+                                 std::string* error_desc);
+  void Enable(BaseChannel* channel, bool enable);
+
+  // Executes the queued commands in order on the worker thread, stopping at
+  // the first one that fails, and clears the queue. Returns true if all
+  // commands succeeded.
+  bool Execute();
+
+  size_t size() const { return commands_.size(); }
+  bool empty() const { return commands_.empty(); }
+
+ private:
+  bool Execute_w();
+
+  rtc::Thread* const worker_thread_;
+  std::vector<std::function<bool()>> commands_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ChannelCommandBatch);
+};
+
+}  // namespace cricket
+
+#endif  // WEBRTC_PC_CHANNELCOMMANDBATCH_H_
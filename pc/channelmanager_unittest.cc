@@ -9,6 +9,8 @@
  */
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "webrtc/logging/rtc_event_log/rtc_event_log.h"
 #include "webrtc/media/base/fakemediaengine.h"
@@ -16,14 +18,43 @@
 #include "webrtc/media/base/testutils.h"
 #include "webrtc/media/engine/fakewebrtccall.h"
 #include "webrtc/p2p/base/faketransportcontroller.h"
+#include "webrtc/pc/channelcommandbatch.h"
 #include "webrtc/pc/channelmanager.h"
+#include "webrtc/rtc_base/atomicops.h"
 #include "webrtc/rtc_base/gunit.h"
 #include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/nullsocketserver.h"
 #include "webrtc/rtc_base/thread.h"
+#include "webrtc/rtc_base/timeutils.h"
 
 namespace {
 const bool kDefaultSrtpRequired = true;
-}
+const int kNumChannels = 100;
+
+// A thread counting the synchronous calls made to it from other threads.
+class HopCountingThread : public rtc::Thread {
+ public:
+  HopCountingThread()
+      : rtc::Thread(std::unique_ptr<rtc::SocketServer>(
+            new rtc::NullSocketServer())) {}
+  ~HopCountingThread() override { Stop(); }
+
+  void Send(const rtc::Location& posted_from,
+            rtc::MessageHandler* phandler,
+            uint32_t id,
+            rtc::MessageData* pdata) override {
+    if (!IsCurrent())
+      rtc::AtomicOps::Increment(&hops_);
+    rtc::Thread::Send(posted_from, phandler, id, pdata);
+  }
+
+  int hops() const { return rtc::AtomicOps::AcquireLoad(&hops_); }
+  void reset_hops() { rtc::AtomicOps::ReleaseStore(&hops_, 0); }
+
+ private:
+  volatile int hops_ = 0;
+};
+}  // namespace
 
 namespace cricket {
 
@@ -155,6 +186,105 @@ TEST_F(ChannelManagerTest, CreateDestroyChannelsOnThread) {
   cm_->Terminate();
 }
 
+// Creates, configures and destroys |kNumChannels| channels one call at a time
+// and with ChannelCommandBatch, and reports the thread hops and time taken.
+TEST_F(ChannelManagerTest, CreateDestroyChannelsWithCommandBatch) {
+  HopCountingThread network;
+  HopCountingThread worker;
+  network.Start();
+  worker.Start();
+  EXPECT_TRUE(cm_->set_worker_thread(&worker));
+  EXPECT_TRUE(cm_->set_network_thread(&network));
+  EXPECT_TRUE(cm_->Init());
+  transport_controller_.reset(
+      new cricket::FakeTransportController(&network, ICEROLE_CONTROLLING));
+  std::vector<cricket::DtlsTransportInternal*> rtp_transports;
+  for (int i = 0; i < kNumChannels; ++i) {
+    rtp_transports.push_back(transport_controller_->CreateDtlsTransport(
+        std::to_string(i), cricket::ICE_CANDIDATE_COMPONENT_RTP));
+  }
+
+  // The batched commands run on the worker thread, so the signaling thread
+  // has to be looked up here.
+  rtc::Thread* signaling_thread = rtc::Thread::Current();
+  auto create_channel = [this, &rtp_transports,
+                         signaling_thread](int i) -> BaseChannel* {
+    if (i % 2 == 0) {
+      return cm_->CreateVoiceChannel(
+          &fake_call_, cricket::MediaConfig(), rtp_transports[i],
+          nullptr /*rtcp_transport*/, signaling_thread, std::to_string(i),
+          kDefaultSrtpRequired, AudioOptions());
+    }
+    return cm_->CreateVideoChannel(
+        &fake_call_, cricket::MediaConfig(), rtp_transports[i],
+        nullptr /*rtcp_transport*/, signaling_thread, std::to_string(i),
+        kDefaultSrtpRequired, VideoOptions());
+  };
+  auto destroy_channel = [this](int i, BaseChannel* channel) {
+    if (i % 2 == 0)
+      cm_->DestroyVoiceChannel(static_cast<VoiceChannel*>(channel));
+    else
+      cm_->DestroyVideoChannel(static_cast<VideoChannel*>(channel));
+  };
+
+  // One call, and hence one worker thread hop, per operation.
+  worker.reset_hops();
+  network.reset_hops();
+  int64_t start_time_us = rtc::TimeMicros();
+  std::vector<BaseChannel*> channels;
+  for (int i = 0; i < kNumChannels; ++i) {
+    channels.push_back(create_channel(i));
+    ASSERT_TRUE(channels.back() != nullptr);
+    EXPECT_TRUE(channels.back()->Enable(true));
+  }
+  for (int i = 0; i < kNumChannels; ++i)
+    destroy_channel(i, channels[i]);
+  const int64_t unbatched_time_us = rtc::TimeMicros() - start_time_us;
+  const int unbatched_worker_hops = worker.hops();
+  const int unbatched_network_hops = network.hops();
+  EXPECT_EQ(3 * kNumChannels, unbatched_worker_hops);
+
+  // The same operations, in one batch for setup and one for teardown.
+  worker.reset_hops();
+  network.reset_hops();
+  start_time_us = rtc::TimeMicros();
+  channels.clear();
+  ChannelCommandBatch batch(cm_->worker_thread());
+  for (int i = 0; i < kNumChannels; ++i) {
+    batch.Add([&channels, &create_channel, i] {
+      channels.push_back(create_channel(i));
+      return channels.back() != nullptr;
+    });
+    batch.Add([&channels] { return channels.back()->Enable(true); });
+  }
+  EXPECT_EQ(2u * kNumChannels, batch.size());
+  ASSERT_TRUE(batch.Execute());
+  EXPECT_TRUE(batch.empty());
+  ASSERT_EQ(static_cast<size_t>(kNumChannels), channels.size());
+  for (int i = 0; i < kNumChannels; ++i) {
+    batch.Add([&channels, &destroy_channel, i] {
+      destroy_channel(i, channels[i]);
+      return true;
+    });
+  }
+  ASSERT_TRUE(batch.Execute());
+  const int64_t batched_time_us = rtc::TimeMicros() - start_time_us;
+  EXPECT_EQ(2, worker.hops());
+  // Hops from the worker to the network thread are not batched.
+  EXPECT_EQ(unbatched_network_hops, network.hops());
+
+  LOG(LS_INFO) << "Creating and destroying " << kNumChannels << " channels: "
+               << unbatched_worker_hops << " worker thread hops in "
+               << unbatched_time_us << " us unbatched, " << worker.hops()
+               << " in " << batched_time_us << " us batched; "
+               << network.hops() << " network thread hops.";
+  cm_->Terminate();
+  // |network| and |worker| go away before the fixture, so release everything
+  // using them now.
+  transport_controller_.reset();
+  cm_.reset();
+}
+
 TEST_F(ChannelManagerTest, SetVideoRtxEnabled) {
   std::vector<VideoCodec> codecs;
   const VideoCodec rtx_codec(96, "rtx");
@@ -28,6 +28,19 @@ enum {
   MSG_CHANNELREADY,
 };
 
+size_t DataChannelProviderInterface::SendDataBatch(
+    const std::vector<OutgoingDataMessage>& messages,
+    cricket::SendDataResult* result) {
+  size_t sent = 0;
+  for (const OutgoingDataMessage& message : messages) {
+    if (!SendData(message.params, message.payload, result)) {
+      break;
+    }
+    ++sent;
+  }
+  return sent;
+}
+
 bool SctpSidAllocator::AllocateSid(rtc::SSLRole role, int* sid) {
   int potential_sid = (role == rtc::SSL_CLIENT) ? 0 : 1;
   while (!IsSidAvailable(potential_sid)) {
@@ -75,10 +88,18 @@ bool DataChannel::PacketQueue::Empty() const {
   return packets_.empty();
 }
 
+size_t DataChannel::PacketQueue::Size() const {
+  return packets_.size();
+}
+
 DataBuffer* DataChannel::PacketQueue::Front() {
   return packets_.front();
 }
 
+const DataBuffer* DataChannel::PacketQueue::At(size_t index) const {
+  return packets_[index];
+}
+
 void DataChannel::PacketQueue::Pop() {
   if (packets_.empty()) {
     return;
@@ -522,16 +543,34 @@ void DataChannel::SendQueuedDataMessages() {
   RTC_DCHECK(state_ == kOpen || state_ == kClosing);
 
   uint64_t start_buffered_amount = buffered_amount();
-  while (!queued_send_data_.Empty()) {
+  // Hand the whole queue to the provider at once, so that it can reach the
+  // transport with one thread hop instead of one per message. The payloads
+  // are shared, not copied.
+  std::vector<OutgoingDataMessage> messages(queued_send_data_.Size());
+  for (size_t i = 0; i < messages.size(); ++i) {
+    const DataBuffer* buffer = queued_send_data_.At(i);
+    messages[i].params = GetSendDataParams(*buffer);
+    messages[i].payload = buffer->data;
+  }
+
+  cricket::SendDataResult send_result = cricket::SDR_SUCCESS;
+  size_t sent = provider_->SendDataBatch(messages, &send_result);
+  for (size_t i = 0; i < sent; ++i) {
     DataBuffer* buffer = queued_send_data_.Front();
-    if (!SendDataMessage(*buffer, false)) {
-      // Leave the message in the queue if sending is aborted.
-      break;
-    }
+    ++messages_sent_;
+    bytes_sent_ += buffer->size();
     queued_send_data_.Pop();
     delete buffer;
   }
 
+  // Unsent messages stay in the queue; if the transport is only blocked they
+  // are sent on the next OnChannelReady.
+  if (sent < messages.size() && send_result != cricket::SDR_BLOCK) {
+    LOG(LS_ERROR) << "Closing the DataChannel due to a failure to send data, "
+                  << "send_result = " << send_result;
+    Close();
+  }
+
   if (observer_ && buffered_amount() < start_buffered_amount) {
     observer_->OnBufferedAmountChange(start_buffered_amount);
   }
@@ -539,25 +578,7 @@ void DataChannel::SendQueuedDataMessages() {
 
 bool DataChannel::SendDataMessage(const DataBuffer& buffer,
                                   bool queue_if_blocked) {
-  cricket::SendDataParams send_params;
-
-  if (data_channel_type_ == cricket::DCT_SCTP) {
-    send_params.ordered = config_.ordered;
-    // Send as ordered if it is still going through OPEN/ACK signaling.
-    if (handshake_state_ != kHandshakeReady && !config_.ordered) {
-      send_params.ordered = true;
-      LOG(LS_VERBOSE) << "Sending data as ordered for unordered DataChannel "
-                      << "because the OPEN_ACK message has not been received.";
-    }
-
-    send_params.max_rtx_count = config_.maxRetransmits;
-    send_params.max_rtx_ms = config_.maxRetransmitTime;
-    send_params.sid = config_.id;
-  } else {
-    send_params.ssrc = send_ssrc_;
-  }
-  send_params.type = buffer.binary ? cricket::DMT_BINARY : cricket::DMT_TEXT;
-
+  cricket::SendDataParams send_params = GetSendDataParams(buffer);
   cricket::SendDataResult send_result = cricket::SDR_SUCCESS;
   bool success = provider_->SendData(send_params, buffer.data, &send_result);
 
@@ -585,6 +606,29 @@ bool DataChannel::SendDataMessage(const DataBuffer& buffer,
   return false;
 }
 
+cricket::SendDataParams DataChannel::GetSendDataParams(
+    const DataBuffer& buffer) const {
+  cricket::SendDataParams send_params;
+
+  if (data_channel_type_ == cricket::DCT_SCTP) {
+    send_params.ordered = config_.ordered;
+    // Send as ordered if it is still going through OPEN/ACK signaling.
+    if (handshake_state_ != kHandshakeReady && !config_.ordered) {
+      send_params.ordered = true;
+      LOG(LS_VERBOSE) << "Sending data as ordered for unordered DataChannel "
+                      << "because the OPEN_ACK message has not been received.";
+    }
+
+    send_params.max_rtx_count = config_.maxRetransmits;
+    send_params.max_rtx_ms = config_.maxRetransmitTime;
+    send_params.sid = config_.id;
+  } else {
+    send_params.ssrc = send_ssrc_;
+  }
+  send_params.type = buffer.binary ? cricket::DMT_BINARY : cricket::DMT_TEXT;
+  return send_params;
+}
+
 bool DataChannel::QueueSendDataMessage(const DataBuffer& buffer) {
   size_t start_buffered_amount = buffered_amount();
   if (start_buffered_amount >= kMaxQueuedSendDataBytes) {
@@ -14,6 +14,7 @@
 #include <deque>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "webrtc/api/datachannelinterface.h"
 #include "webrtc/api/proxy.h"
@@ -27,12 +28,26 @@ namespace webrtc {
 
 class DataChannel;
 
+// A message handed to DataChannelProviderInterface::SendDataBatch.
+struct OutgoingDataMessage {
+  cricket::SendDataParams params;
+  rtc::CopyOnWriteBuffer payload;
+};
+
 class DataChannelProviderInterface {
  public:
   // Sends the data to the transport.
   virtual bool SendData(const cricket::SendDataParams& params,
                         const rtc::CopyOnWriteBuffer& payload,
                         cricket::SendDataResult* result) = 0;
+  // Sends |messages| to the transport in order, stopping at the first message
+  // that can't be sent, and returns the number of messages sent. If that is
+  // less than |messages.size()|, |result| is set to the reason the next
+  // message failed. The default implementation calls SendData for each
+  // message; providers whose transport lives on another thread should override
+  // it to send the whole batch with a single thread hop.
+  virtual size_t SendDataBatch(const std::vector<OutgoingDataMessage>& messages,
+                               cricket::SendDataResult* result);
   // Connects to the transport signals.
   virtual bool ConnectDataChannel(DataChannel* data_channel) = 0;
   // Disconnects from the transport signals.
@@ -206,8 +221,13 @@ class DataChannel : public DataChannelInterface,
 
     bool Empty() const;
 
+    size_t Size() const;
+
     DataBuffer* Front();
 
+    // Returns the packet at |index|, counting from the front.
+    const DataBuffer* At(size_t index) const;
+
     void Pop();
 
     void Push(DataBuffer* packet);
@@ -240,6 +260,7 @@ class DataChannel : public DataChannelInterface,
 
   void SendQueuedDataMessages();
   bool SendDataMessage(const DataBuffer& buffer, bool queue_if_blocked);
+  cricket::SendDataParams GetSendDataParams(const DataBuffer& buffer) const;
   bool QueueSendDataMessage(const DataBuffer& buffer);
 
   void SendQueuedControlMessages();
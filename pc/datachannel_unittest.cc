@@ -202,6 +202,25 @@ TEST_F(SctpDataChannelTest, QueuedDataSentWhenUnblocked) {
   EXPECT_EQ(2U, observer_->on_buffered_amount_change_count());
 }
 
+// Tests that all the queued data is handed to the provider in a single batch
+// when the channel is unblocked.
+TEST_F(SctpDataChannelTest, QueuedDataSentInOneBatch) {
+  SetChannelReady();
+  provider_->set_send_blocked(true);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(webrtc_data_channel_->Send(webrtc::DataBuffer("abcd")));
+  }
+  EXPECT_EQ(40U, webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(0U, webrtc_data_channel_->messages_sent());
+
+  int batches_before = provider_->send_batch_count();
+  provider_->set_send_blocked(false);
+  EXPECT_EQ(0U, webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(10U, webrtc_data_channel_->messages_sent());
+  EXPECT_EQ(40U, webrtc_data_channel_->bytes_sent());
+  EXPECT_EQ(batches_before + 1, provider_->send_batch_count());
+}
+
 // Tests that no crash when the channel is blocked right away while trying to
 // send queued data.
 TEST_F(SctpDataChannelTest, BlockedWhenSendQueuedDataNoCrash) {
@@ -260,6 +260,8 @@ bool PeerConnectionInterface::RTCConfiguration::operator==(
     bool redetermine_role_on_ice_restart;
     rtc::Optional<int> ice_check_min_interval;
     rtc::Optional<rtc::IntervalRange> ice_regather_interval_range;
+    rtc::Optional<int> sctp_send_buffer_size;
+    rtc::Optional<int> sctp_receive_buffer_size;
   };
   static_assert(sizeof(stuff_being_tested_for_equality) == sizeof(*this),
                 "Did you add something to RTCConfiguration and forget to "
@@ -294,7 +296,9 @@ bool PeerConnectionInterface::RTCConfiguration::operator==(
          enable_ice_renomination == o.enable_ice_renomination &&
          redetermine_role_on_ice_restart == o.redetermine_role_on_ice_restart &&
          ice_check_min_interval == o.ice_check_min_interval &&
-         ice_regather_interval_range == o.ice_regather_interval_range;
+         ice_regather_interval_range == o.ice_regather_interval_range &&
+         sctp_send_buffer_size == o.sctp_send_buffer_size &&
+         sctp_receive_buffer_size == o.sctp_receive_buffer_size;
 }
 
 bool PeerConnectionInterface::RTCConfiguration::operator!=(
@@ -493,7 +497,10 @@ bool PeerConnection::Initialize(
               configuration.redetermine_role_on_ice_restart)),
 #ifdef HAVE_SCTP
       std::unique_ptr<cricket::SctpTransportInternalFactory>(
-          new cricket::SctpTransportFactory(factory_->network_thread()))
+          new cricket::SctpTransportFactory(
+              factory_->network_thread(),
+              configuration.sctp_send_buffer_size.value_or(0),
+              configuration.sctp_receive_buffer_size.value_or(0)))
 #else
       nullptr
 #endif
@@ -539,6 +546,12 @@ RTCError PeerConnection::ValidateConfiguration(
                     "ice_regather_interval_range specified but continual "
                     "gathering policy is GATHER_ONCE");
   }
+  if ((config.sctp_send_buffer_size && *config.sctp_send_buffer_size <= 0) ||
+      (config.sctp_receive_buffer_size &&
+       *config.sctp_receive_buffer_size <= 0)) {
+    return RTCError(RTCErrorType::INVALID_RANGE,
+                    "SCTP buffer sizes must be positive");
+  }
   return RTCError::OK();
 }
 
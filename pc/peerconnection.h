@@ -162,6 +162,12 @@ class PeerConnection : public PeerConnectionInterface,
     return sctp_data_channels_;
   }
 
+  // For gathering the stats of many PeerConnections at once with
+  // RTCStatsCollector::GetStatsReports(). Null before Initialize().
+  const rtc::scoped_refptr<RTCStatsCollector>& stats_collector() const {
+    return stats_collector_;
+  }
+
  protected:
   ~PeerConnection() override;
 
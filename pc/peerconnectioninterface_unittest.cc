@@ -2406,6 +2406,12 @@ TEST_F(PeerConnectionInterfaceTest,
   error.set_type(RTCErrorType::NONE);
   EXPECT_FALSE(pc_->SetConfiguration(modified_config, &error));
   EXPECT_EQ(RTCErrorType::INVALID_MODIFICATION, error.type());
+
+  modified_config = config;
+  modified_config.sctp_send_buffer_size = rtc::Optional<int>(1024 * 1024);
+  error.set_type(RTCErrorType::NONE);
+  EXPECT_FALSE(pc_->SetConfiguration(modified_config, &error));
+  EXPECT_EQ(RTCErrorType::INVALID_MODIFICATION, error.type());
 }
 
 // Test that SetConfiguration returns a range error if the candidate pool size
@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/p2p/base/faketransportcontroller.h"
+#include "webrtc/p2p/base/transportinfo.h"
+#include "webrtc/rtc_base/gunit.h"
+#include "webrtc/rtc_base/thread.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+namespace {
+
+const char kIcePwd[] = "TESTICEPWD00000000000001";
+
+int NumIterations() {
+  return field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 5 : 100;
+}
+
+// Creates the transport infos of a description with |num_m_lines| unbundled
+// m= sections, each with its own ICE credentials.
+cricket::TransportInfos CreateTransportInfos(int num_m_lines,
+                                             const std::string& ufrag_prefix,
+                                             cricket::ConnectionRole role) {
+  cricket::TransportInfos infos;
+  for (int i = 0; i < num_m_lines; ++i) {
+    cricket::TransportDescription desc(
+        std::vector<std::string>(), ufrag_prefix + std::to_string(i), kIcePwd,
+        cricket::ICEMODE_FULL, role, nullptr);
+    infos.push_back(cricket::TransportInfo(std::to_string(i), desc));
+  }
+  return infos;
+}
+
+// Times a renegotiation of |num_m_lines| m= sections where nothing changed,
+// pushing the transport descriptions down the way WebRtcSession used to (one
+// network thread hop per transport) and in a single batch.
+void RunRenegotiationTest(int num_m_lines) {
+  std::unique_ptr<rtc::Thread> network_thread =
+      rtc::Thread::CreateWithSocketServer();
+  network_thread->Start();
+  cricket::FakeTransportController controller(network_thread.get(),
+                                              cricket::ICEROLE_CONTROLLING);
+  for (int i = 0; i < num_m_lines; ++i) {
+    ASSERT_TRUE(controller.CreateDtlsTransport(
+        std::to_string(i), cricket::ICE_CANDIDATE_COMPONENT_RTP));
+  }
+
+  const cricket::TransportInfos local_infos = CreateTransportInfos(
+      num_m_lines, "local", cricket::CONNECTIONROLE_ACTPASS);
+  const cricket::TransportInfos remote_infos = CreateTransportInfos(
+      num_m_lines, "remote", cricket::CONNECTIONROLE_ACTIVE);
+  std::string err;
+  ASSERT_TRUE(controller.SetLocalTransportDescriptions(
+      local_infos, cricket::CA_OFFER, &err)) << err;
+  ASSERT_TRUE(controller.SetRemoteTransportDescriptions(
+      remote_infos, cricket::CA_ANSWER, &err)) << err;
+
+  const int iterations = NumIterations();
+  int64_t per_transport_time_ns = 0;
+  int64_t batched_time_ns = 0;
+  for (int i = 0; i < iterations; ++i) {
+    int64_t start_time_ns = rtc::TimeNanos();
+    for (const cricket::TransportInfo& tinfo : local_infos) {
+      ASSERT_TRUE(controller.SetLocalTransportDescription(
+          tinfo.content_name, tinfo.description, cricket::CA_OFFER, &err));
+    }
+    for (const cricket::TransportInfo& tinfo : remote_infos) {
+      ASSERT_TRUE(controller.SetRemoteTransportDescription(
+          tinfo.content_name, tinfo.description, cricket::CA_ANSWER, &err));
+    }
+    per_transport_time_ns += rtc::TimeNanos() - start_time_ns;
+
+    start_time_ns = rtc::TimeNanos();
+    ASSERT_TRUE(controller.SetLocalTransportDescriptions(
+        local_infos, cricket::CA_OFFER, &err));
+    ASSERT_TRUE(controller.SetRemoteTransportDescriptions(
+        remote_infos, cricket::CA_ANSWER, &err));
+    batched_time_ns += rtc::TimeNanos() - start_time_ns;
+  }
+
+  const std::string label = std::to_string(num_m_lines) + "_m_lines";
+  test::PrintResult(
+      "renegotiation_per_transport_time", "", label,
+      std::to_string(static_cast<double>(per_transport_time_ns) /
+                     (iterations * rtc::kNumNanosecsPerMicrosec)),
+      "us", false);
+  test::PrintResult("renegotiation_batched_time", "", label,
+                    std::to_string(static_cast<double>(batched_time_ns) /
+                                   (iterations * rtc::kNumNanosecsPerMicrosec)),
+                    "us", true);
+}
+
+}  // namespace
+
+TEST(RenegotiationPerformanceTest, TenMLines) {
+  RunRenegotiationTest(10);
+}
+
+TEST(RenegotiationPerformanceTest, FiftyMLines) {
+  RunRenegotiationTest(50);
+}
+
+TEST(RenegotiationPerformanceTest, HundredMLines) {
+  RunRenegotiationTest(100);
+}
+
+}  // namespace webrtc
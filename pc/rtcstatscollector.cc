@@ -601,6 +601,71 @@ RTCStatsCollector::~RTCStatsCollector() {
   RTC_DCHECK_EQ(num_pending_partial_reports_, 0);
 }
 
+// The state of a |GetStatsReports| request. Each collector delivers its report
+// into the request like to any other callback, the batch callback is invoked
+// once all reports have been delivered.
+class RTCStatsCollector::BatchRequest : public rtc::RefCountInterface {
+ public:
+  BatchRequest(
+      const std::vector<rtc::scoped_refptr<RTCStatsCollector>>& collectors,
+      rtc::scoped_refptr<RTCStatsBatchCallback> callback)
+      : collectors_(collectors),
+        callback_(callback),
+        reports_(collectors.size()),
+        num_pending_reports_(collectors.size()) {}
+
+  const std::vector<rtc::scoped_refptr<RTCStatsCollector>>& collectors()
+      const {
+    return collectors_;
+  }
+  // The collectors that gather stats as part of this request.
+  std::vector<RTCStatsCollector*>& gathering_collectors() {
+    return gathering_collectors_;
+  }
+
+  rtc::scoped_refptr<RTCStatsCollectorCallback> CreateReportCallback(
+      size_t index) {
+    return rtc::scoped_refptr<RTCStatsCollectorCallback>(
+        new rtc::RefCountedObject<ReportCallback>(this, index));
+  }
+
+ protected:
+  ~BatchRequest() override {}
+
+ private:
+  class ReportCallback : public RTCStatsCollectorCallback {
+   public:
+    ReportCallback(BatchRequest* batch, size_t index)
+        : batch_(batch), index_(index) {}
+
+    void OnStatsDelivered(
+        const rtc::scoped_refptr<const RTCStatsReport>& report) override {
+      batch_->OnReportDelivered(index_, report);
+    }
+
+   private:
+    const rtc::scoped_refptr<BatchRequest> batch_;
+    const size_t index_;
+  };
+
+  void OnReportDelivered(size_t index,
+                         const rtc::scoped_refptr<const RTCStatsReport>& report) {
+    RTC_DCHECK(!reports_[index]);
+    RTC_DCHECK_GT(num_pending_reports_, 0u);
+    reports_[index] = report;
+    if (!--num_pending_reports_) {
+      callback_->OnStatsDelivered(reports_);
+      reports_.clear();
+    }
+  }
+
+  const std::vector<rtc::scoped_refptr<RTCStatsCollector>> collectors_;
+  std::vector<RTCStatsCollector*> gathering_collectors_;
+  const rtc::scoped_refptr<RTCStatsBatchCallback> callback_;
+  std::vector<rtc::scoped_refptr<const RTCStatsReport>> reports_;
+  size_t num_pending_reports_;
+};
+
 void RTCStatsCollector::GetStatsReport(
     rtc::scoped_refptr<RTCStatsCollectorCallback> callback) {
   RTC_DCHECK(signaling_thread_->IsCurrent());
@@ -609,8 +674,7 @@ void RTCStatsCollector::GetStatsReport(
 
   // "Now" using a monotonically increasing timer.
   int64_t cache_now_us = rtc::TimeMicros();
-  if (cached_report_ &&
-      cache_now_us - cache_timestamp_us_ <= cache_lifetime_us_) {
+  if (HasFreshCachedReport(cache_now_us)) {
     // We have a fresh cached report to deliver.
     DeliverCachedReport();
   } else if (!num_pending_partial_reports_) {
@@ -623,47 +687,13 @@ void RTCStatsCollector::GetStatsReport(
     // necessarily monotonically increasing.
     int64_t timestamp_us = rtc::TimeUTCMicros();
 
-    num_pending_partial_reports_ = 2;
-    partial_report_timestamp_us_ = cache_now_us;
-
-    // Prepare |channel_name_pairs_| for use in
-    // |ProducePartialResultsOnNetworkThread|.
-    channel_name_pairs_.reset(new ChannelNamePairs());
-    if (pc_->session()->voice_channel()) {
-      channel_name_pairs_->voice = rtc::Optional<ChannelNamePair>(
-          ChannelNamePair(pc_->session()->voice_channel()->content_name(),
-                          pc_->session()->voice_channel()->transport_name()));
-    }
-    if (pc_->session()->video_channel()) {
-      channel_name_pairs_->video = rtc::Optional<ChannelNamePair>(
-          ChannelNamePair(pc_->session()->video_channel()->content_name(),
-                          pc_->session()->video_channel()->transport_name()));
-    }
-    if (pc_->session()->rtp_data_channel()) {
-      channel_name_pairs_->data =
-          rtc::Optional<ChannelNamePair>(ChannelNamePair(
-              pc_->session()->rtp_data_channel()->content_name(),
-              pc_->session()->rtp_data_channel()->transport_name()));
-    }
-    if (pc_->session()->sctp_content_name()) {
-      channel_name_pairs_->data = rtc::Optional<ChannelNamePair>(
-          ChannelNamePair(*pc_->session()->sctp_content_name(),
-                          *pc_->session()->sctp_transport_name()));
-    }
-    // Prepare |track_media_info_map_| for use in
-    // |ProducePartialResultsOnNetworkThread| and
-    // |ProducePartialResultsOnSignalingThread|.
-    track_media_info_map_.reset(PrepareTrackMediaInfoMap_s().release());
-    // Prepare |track_to_id_| for use in |ProducePartialResultsOnNetworkThread|.
-    // This avoids a possible deadlock if |MediaStreamTrackInterface::id| is
-    // implemented to invoke on the signaling thread.
-    track_to_id_ = PrepareTrackToID_s();
-
-    // Prepare |call_stats_| here since GetCallStats() will hop to the worker
-    // thread.
-    // TODO(holmer): To avoid the hop we could move BWE and BWE stats to the
-    // network thread, where it more naturally belongs.
-    call_stats_ = pc_->session()->GetCallStats();
+    PrepareGathering_s(cache_now_us);
+    // All stats needed from the worker thread are gathered in one hop.
+    worker_thread_->Invoke<void>(
+        RTC_FROM_HERE,
+        rtc::Bind(&RTCStatsCollector::GatherMediaInfo_w,
+                  rtc::scoped_refptr<RTCStatsCollector>(this)));
+    PrepareTrackMediaInfoMap_s();
 
     invoker_.AsyncInvoke<void>(
         RTC_FROM_HERE, network_thread_,
@@ -673,6 +703,55 @@ void RTCStatsCollector::GetStatsReport(
   }
 }
 
+// static
+void RTCStatsCollector::GetStatsReports(
+    const std::vector<rtc::scoped_refptr<RTCStatsCollector>>& collectors,
+    rtc::scoped_refptr<RTCStatsBatchCallback> callback) {
+  RTC_DCHECK(callback);
+  if (collectors.empty()) {
+    callback->OnStatsDelivered(
+        std::vector<rtc::scoped_refptr<const RTCStatsReport>>());
+    return;
+  }
+  RTCStatsCollector* first = collectors[0].get();
+  RTC_DCHECK(first->signaling_thread_->IsCurrent());
+  rtc::scoped_refptr<BatchRequest> batch(
+      new rtc::RefCountedObject<BatchRequest>(collectors, callback));
+
+  int64_t cache_now_us = rtc::TimeMicros();
+  int64_t timestamp_us = rtc::TimeUTCMicros();
+  for (size_t i = 0; i < collectors.size(); ++i) {
+    RTCStatsCollector* collector = collectors[i].get();
+    RTC_DCHECK(collector->signaling_thread_ == first->signaling_thread_);
+    RTC_DCHECK(collector->worker_thread_ == first->worker_thread_);
+    RTC_DCHECK(collector->network_thread_ == first->network_thread_);
+    collector->callbacks_.push_back(batch->CreateReportCallback(i));
+    if (collector->HasFreshCachedReport(cache_now_us)) {
+      collector->DeliverCachedReport();
+    } else if (!collector->num_pending_partial_reports_) {
+      // Collectors with a request in flight deliver when that completes.
+      collector->PrepareGathering_s(cache_now_us);
+      batch->gathering_collectors().push_back(collector);
+    }
+  }
+  if (batch->gathering_collectors().empty())
+    return;
+
+  first->worker_thread_->Invoke<void>(
+      RTC_FROM_HERE,
+      rtc::Bind(&RTCStatsCollector::GatherBatchMediaInfo_w, batch));
+  for (RTCStatsCollector* collector : batch->gathering_collectors())
+    collector->PrepareTrackMediaInfoMap_s();
+
+  // |batch| keeps the collectors and with them |invoker_| alive.
+  first->invoker_.AsyncInvoke<void>(
+      RTC_FROM_HERE, first->network_thread_,
+      rtc::Bind(&RTCStatsCollector::ProduceBatchOnNetworkThread, batch,
+                timestamp_us));
+  for (RTCStatsCollector* collector : batch->gathering_collectors())
+    collector->ProducePartialResultsOnSignalingThread(timestamp_us);
+}
+
 void RTCStatsCollector::ClearCachedStatsReport() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
   cached_report_ = nullptr;
@@ -704,6 +783,11 @@ void RTCStatsCollector::ProducePartialResultsOnSignalingThread(
 
 void RTCStatsCollector::ProducePartialResultsOnNetworkThread(
     int64_t timestamp_us) {
+  AddPartialResults(ProduceReportOnNetworkThread(timestamp_us));
+}
+
+rtc::scoped_refptr<RTCStatsReport>
+RTCStatsCollector::ProduceReportOnNetworkThread(int64_t timestamp_us) {
   RTC_DCHECK(network_thread_->IsCurrent());
   rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(
       timestamp_us);
@@ -726,8 +810,41 @@ void RTCStatsCollector::ProducePartialResultsOnNetworkThread(
     ProduceTransportStats_n(
         timestamp_us, *session_stats, transport_cert_stats, report.get());
   }
+  return report;
+}
 
-  AddPartialResults(report);
+// static
+void RTCStatsCollector::GatherBatchMediaInfo_w(
+    rtc::scoped_refptr<BatchRequest> batch) {
+  for (RTCStatsCollector* collector : batch->gathering_collectors())
+    collector->GatherMediaInfo_w();
+}
+
+// static
+void RTCStatsCollector::ProduceBatchOnNetworkThread(
+    rtc::scoped_refptr<BatchRequest> batch,
+    int64_t timestamp_us) {
+  std::vector<rtc::scoped_refptr<RTCStatsReport>> partial_reports;
+  partial_reports.reserve(batch->gathering_collectors().size());
+  for (RTCStatsCollector* collector : batch->gathering_collectors()) {
+    partial_reports.push_back(
+        collector->ProduceReportOnNetworkThread(timestamp_us));
+  }
+  // Return all partial reports to the signaling thread in one hop.
+  RTCStatsCollector* first = batch->gathering_collectors()[0];
+  first->invoker_.AsyncInvoke<void>(
+      RTC_FROM_HERE, first->signaling_thread_,
+      rtc::Bind(&RTCStatsCollector::AddBatchPartialResults_s, batch,
+                std::move(partial_reports)));
+}
+
+// static
+void RTCStatsCollector::AddBatchPartialResults_s(
+    rtc::scoped_refptr<BatchRequest> batch,
+    std::vector<rtc::scoped_refptr<RTCStatsReport>> partial_reports) {
+  RTC_DCHECK_EQ(partial_reports.size(), batch->gathering_collectors().size());
+  for (size_t i = 0; i < partial_reports.size(); ++i)
+    batch->gathering_collectors()[i]->AddPartialResults_s(partial_reports[i]);
 }
 
 void RTCStatsCollector::AddPartialResults(
@@ -1179,29 +1296,74 @@ RTCStatsCollector::PrepareTransportCertificateStats_n(
   return transport_cert_stats;
 }
 
-std::unique_ptr<TrackMediaInfoMap>
-RTCStatsCollector::PrepareTrackMediaInfoMap_s() const {
+bool RTCStatsCollector::HasFreshCachedReport(int64_t cache_now_us) const {
+  return cached_report_ &&
+         cache_now_us - cache_timestamp_us_ <= cache_lifetime_us_;
+}
+
+void RTCStatsCollector::PrepareGathering_s(int64_t cache_now_us) {
   RTC_DCHECK(signaling_thread_->IsCurrent());
-  std::unique_ptr<cricket::VoiceMediaInfo> voice_media_info;
+  RTC_DCHECK(!num_pending_partial_reports_);
+  num_pending_partial_reports_ = 2;
+  partial_report_timestamp_us_ = cache_now_us;
+
+  // Prepare |channel_name_pairs_| for use in
+  // |ProducePartialResultsOnNetworkThread|.
+  channel_name_pairs_.reset(new ChannelNamePairs());
   if (pc_->session()->voice_channel()) {
-    voice_media_info.reset(new cricket::VoiceMediaInfo());
-    if (!pc_->session()->voice_channel()->GetStats(voice_media_info.get())) {
-      voice_media_info.reset();
-    }
+    channel_name_pairs_->voice = rtc::Optional<ChannelNamePair>(
+        ChannelNamePair(pc_->session()->voice_channel()->content_name(),
+                        pc_->session()->voice_channel()->transport_name()));
   }
-  std::unique_ptr<cricket::VideoMediaInfo> video_media_info;
   if (pc_->session()->video_channel()) {
-    video_media_info.reset(new cricket::VideoMediaInfo());
-    if (!pc_->session()->video_channel()->GetStats(video_media_info.get())) {
-      video_media_info.reset();
-    }
+    channel_name_pairs_->video = rtc::Optional<ChannelNamePair>(
+        ChannelNamePair(pc_->session()->video_channel()->content_name(),
+                        pc_->session()->video_channel()->transport_name()));
+  }
+  if (pc_->session()->rtp_data_channel()) {
+    channel_name_pairs_->data =
+        rtc::Optional<ChannelNamePair>(ChannelNamePair(
+            pc_->session()->rtp_data_channel()->content_name(),
+            pc_->session()->rtp_data_channel()->transport_name()));
+  }
+  if (pc_->session()->sctp_content_name()) {
+    channel_name_pairs_->data = rtc::Optional<ChannelNamePair>(
+        ChannelNamePair(*pc_->session()->sctp_content_name(),
+                        *pc_->session()->sctp_transport_name()));
+  }
+  // Prepare |track_to_id_| for use in |ProducePartialResultsOnNetworkThread|.
+  // This avoids a possible deadlock if |MediaStreamTrackInterface::id| is
+  // implemented to invoke on the signaling thread.
+  track_to_id_ = PrepareTrackToID_s();
+}
+
+void RTCStatsCollector::GatherMediaInfo_w() {
+  RTC_DCHECK(worker_thread_->IsCurrent());
+  // The channels' |GetStats| invoke on the worker thread, which is free when
+  // already on it.
+  if (pc_->session()->voice_channel()) {
+    voice_media_info_.reset(new cricket::VoiceMediaInfo());
+    if (!pc_->session()->voice_channel()->GetStats(voice_media_info_.get()))
+      voice_media_info_.reset();
+  }
+  if (pc_->session()->video_channel()) {
+    video_media_info_.reset(new cricket::VideoMediaInfo());
+    if (!pc_->session()->video_channel()->GetStats(video_media_info_.get()))
+      video_media_info_.reset();
   }
-  std::unique_ptr<TrackMediaInfoMap> track_media_info_map(
-      new TrackMediaInfoMap(std::move(voice_media_info),
-                            std::move(video_media_info),
-                            pc_->GetSenders(),
-                            pc_->GetReceivers()));
-  return track_media_info_map;
+  // TODO(holmer): To avoid the hop we could move BWE and BWE stats to the
+  // network thread, where it more naturally belongs.
+  call_stats_ = pc_->session()->GetCallStats();
+}
+
+void RTCStatsCollector::PrepareTrackMediaInfoMap_s() {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  // Prepare |track_media_info_map_| for use in
+  // |ProducePartialResultsOnNetworkThread| and
+  // |ProducePartialResultsOnSignalingThread|.
+  track_media_info_map_.reset(new TrackMediaInfoMap(
+      std::move(voice_media_info_), std::move(video_media_info_),
+      pc_->GetSenders(), pc_->GetReceivers()));
 }
 
 std::map<MediaStreamTrackInterface*, std::string>
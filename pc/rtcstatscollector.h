@@ -45,6 +45,18 @@ class PeerConnection;
 struct SessionStats;
 struct ChannelNamePairs;
 
+// Receives the reports gathered by RTCStatsCollector::GetStatsReports().
+class RTCStatsBatchCallback : public virtual rtc::RefCountInterface {
+ public:
+  virtual ~RTCStatsBatchCallback() {}
+
+  // |reports| are in the order of the collectors that were passed to
+  // |GetStatsReports|.
+  virtual void OnStatsDelivered(
+      const std::vector<rtc::scoped_refptr<const RTCStatsReport>>&
+          reports) = 0;
+};
+
 // All public methods of the collector are to be called on the signaling thread.
 // Stats are gathered on the signaling, worker and network threads
 // asynchronously. The callback is invoked on the signaling thread. Resulting
@@ -61,6 +73,16 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   // considered fresh for |cache_lifetime_| ms. const RTCStatsReports are safe
   // to use across multiple threads and may be destructed on any thread.
   void GetStatsReport(rtc::scoped_refptr<RTCStatsCollectorCallback> callback);
+  // Gets a recent stats report from each of |collectors|, like
+  // |GetStatsReport|, and delivers them all at once. Stats of all collectors
+  // that need fresh reports are gathered in a single pass on the worker thread
+  // and a single pass on the network thread, instead of a pass per collector,
+  // which is cheaper when polling many PeerConnections. The collectors must
+  // share their signaling, worker and network threads, e.g. by belonging to
+  // PeerConnections of the same PeerConnectionFactory.
+  static void GetStatsReports(
+      const std::vector<rtc::scoped_refptr<RTCStatsCollector>>& collectors,
+      rtc::scoped_refptr<RTCStatsBatchCallback> callback);
   // Clears the cache's reference to the most recent stats report. Subsequently
   // calling |GetStatsReport| guarantees fresh stats.
   void ClearCachedStatsReport();
@@ -87,6 +109,28 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
     std::unique_ptr<rtc::SSLCertificateStats> local;
     std::unique_ptr<rtc::SSLCertificateStats> remote;
   };
+  class BatchRequest;
+
+  // Whether |cached_report_| can be delivered without gathering stats.
+  bool HasFreshCachedReport(int64_t cache_now_us) const;
+  // The stages of gathering stats, in order. |PrepareGathering_s| starts a
+  // request and collects what is needed from the signaling thread,
+  // |GatherMediaInfo_w| the media stats from the worker thread and
+  // |PrepareTrackMediaInfoMap_s| pairs those up with the tracks. Then the
+  // partial results are produced on the signaling and network threads.
+  void PrepareGathering_s(int64_t cache_now_us);
+  void GatherMediaInfo_w();
+  void PrepareTrackMediaInfoMap_s();
+  rtc::scoped_refptr<RTCStatsReport> ProduceReportOnNetworkThread(
+      int64_t timestamp_us);
+
+  static void GatherBatchMediaInfo_w(rtc::scoped_refptr<BatchRequest> batch);
+  static void ProduceBatchOnNetworkThread(
+      rtc::scoped_refptr<BatchRequest> batch,
+      int64_t timestamp_us);
+  static void AddBatchPartialResults_s(
+      rtc::scoped_refptr<BatchRequest> batch,
+      std::vector<rtc::scoped_refptr<RTCStatsReport>> partial_reports);
 
   void AddPartialResults_s(rtc::scoped_refptr<RTCStatsReport> partial_report);
   void DeliverCachedReport();
@@ -130,7 +174,6 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   // Helper function to stats-producing functions.
   std::map<std::string, CertificateStatsPair>
   PrepareTransportCertificateStats_n(const SessionStats& session_stats) const;
-  std::unique_ptr<TrackMediaInfoMap> PrepareTrackMediaInfoMap_s() const;
   std::map<MediaStreamTrackInterface*, std::string> PrepareTrackToID_s() const;
 
   // Slots for signals (sigslot) that are wired up to |pc_|.
@@ -155,6 +198,10 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   // passed as arguments to avoid copies. This is thread safe - when we
   // set/reset we know there are no pending stats requests in progress.
   std::unique_ptr<ChannelNamePairs> channel_name_pairs_;
+  // Set in |GatherMediaInfo_w|, moved into |track_media_info_map_| by
+  // |PrepareTrackMediaInfoMap_s|.
+  std::unique_ptr<cricket::VoiceMediaInfo> voice_media_info_;
+  std::unique_ptr<cricket::VideoMediaInfo> video_media_info_;
   std::unique_ptr<TrackMediaInfoMap> track_media_info_map_;
   std::map<MediaStreamTrackInterface*, std::string> track_to_id_;
   Call::Stats call_stats_;
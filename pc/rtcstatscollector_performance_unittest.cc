@@ -0,0 +1,150 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/media/base/fakemediaengine.h"
+#include "webrtc/pc/channelmanager.h"
+#include "webrtc/pc/rtcstatscollector.h"
+#include "webrtc/pc/test/mock_peerconnection.h"
+#include "webrtc/pc/test/mock_webrtcsession.h"
+#include "webrtc/pc/test/rtcstatsobtainer.h"
+#include "webrtc/rtc_base/gunit.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/test/gmock.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+using testing::Return;
+using testing::ReturnNull;
+using testing::ReturnRef;
+using testing::_;
+
+namespace webrtc {
+
+namespace {
+
+const int64_t kGetStatsReportTimeoutMs = 10000;
+
+// A PeerConnection without media channels, so that collecting its stats is
+// dominated by the per-PeerConnection overhead of the collector.
+class StatsPeerConnection {
+ public:
+  explicit StatsPeerConnection(cricket::ChannelManager* channel_manager)
+      : session_(channel_manager, cricket::MediaConfig()) {
+    EXPECT_CALL(pc_, local_streams()).WillRepeatedly(Return(nullptr));
+    EXPECT_CALL(pc_, remote_streams()).WillRepeatedly(Return(nullptr));
+    EXPECT_CALL(pc_, session()).WillRepeatedly(Return(&session_));
+    EXPECT_CALL(pc_, GetSenders()).WillRepeatedly(Return(
+        std::vector<rtc::scoped_refptr<RtpSenderInterface>>()));
+    EXPECT_CALL(pc_, GetReceivers()).WillRepeatedly(Return(
+        std::vector<rtc::scoped_refptr<RtpReceiverInterface>>()));
+    EXPECT_CALL(pc_, sctp_data_channels()).WillRepeatedly(
+        ReturnRef(data_channels_));
+    EXPECT_CALL(session_, video_channel()).WillRepeatedly(ReturnNull());
+    EXPECT_CALL(session_, voice_channel()).WillRepeatedly(ReturnNull());
+    EXPECT_CALL(session_, GetCallStats()).WillRepeatedly(
+        Return(Call::Stats()));
+    EXPECT_CALL(session_, GetStats(_)).WillRepeatedly(ReturnNull());
+    collector_ = RTCStatsCollector::Create(&pc_);
+  }
+
+  const rtc::scoped_refptr<RTCStatsCollector>& collector() const {
+    return collector_;
+  }
+
+ private:
+  MockWebRtcSession session_;
+  MockPeerConnection pc_;
+  std::vector<rtc::scoped_refptr<DataChannel>> data_channels_;
+  rtc::scoped_refptr<RTCStatsCollector> collector_;
+};
+
+int NumPolls() {
+  return field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 3 : 20;
+}
+
+// Polls the stats of |num_pcs| PeerConnections, either through one
+// |GetStatsReport| per PeerConnection or one batched |GetStatsReports|, and
+// reports the time per poll and the number of stats objects allocated per
+// poll.
+void RunStatsCollectionTest(int num_pcs, bool batched) {
+  cricket::ChannelManager channel_manager(
+      std::unique_ptr<cricket::MediaEngineInterface>(
+          new cricket::FakeMediaEngine()),
+      rtc::Thread::Current(), rtc::Thread::Current());
+  std::vector<std::unique_ptr<StatsPeerConnection>> pcs;
+  std::vector<rtc::scoped_refptr<RTCStatsCollector>> collectors;
+  for (int i = 0; i < num_pcs; ++i) {
+    pcs.emplace_back(new StatsPeerConnection(&channel_manager));
+    collectors.push_back(pcs.back()->collector());
+  }
+
+  const int num_polls = NumPolls();
+  size_t num_stats = 0;
+  const int64_t start_time_ns = rtc::TimeNanos();
+  for (int poll = 0; poll < num_polls; ++poll) {
+    for (const auto& collector : collectors)
+      collector->ClearCachedStatsReport();
+    std::vector<rtc::scoped_refptr<const RTCStatsReport>> reports;
+    if (batched) {
+      rtc::scoped_refptr<RTCStatsBatchObtainer> callback =
+          RTCStatsBatchObtainer::Create();
+      RTCStatsCollector::GetStatsReports(collectors, callback);
+      EXPECT_TRUE_WAIT(callback->delivered(), kGetStatsReportTimeoutMs);
+      reports = callback->reports();
+    } else {
+      std::vector<rtc::scoped_refptr<RTCStatsObtainer>> callbacks;
+      for (const auto& collector : collectors) {
+        callbacks.push_back(RTCStatsObtainer::Create());
+        collector->GetStatsReport(callbacks.back());
+      }
+      for (const auto& callback : callbacks) {
+        EXPECT_TRUE_WAIT(callback->report(), kGetStatsReportTimeoutMs);
+        reports.push_back(callback->report());
+      }
+    }
+    ASSERT_EQ(collectors.size(), reports.size());
+    for (const auto& report : reports)
+      num_stats += report->size();
+  }
+  const int64_t elapsed_ns = rtc::TimeNanos() - start_time_ns;
+
+  const std::string label = std::to_string(num_pcs) + "_pcs_" +
+                            (batched ? "batched" : "per_pc");
+  test::PrintResult("rtc_stats_collection_time", "", label,
+                    std::to_string(static_cast<double>(elapsed_ns) /
+                                   (num_polls * rtc::kNumNanosecsPerMillisec)),
+                    "ms", true);
+  test::PrintResult("rtc_stats_objects", "", label,
+                    std::to_string(num_stats / num_polls), "objects", false);
+}
+
+}  // namespace
+
+TEST(RTCStatsCollectorPerformanceTest, PerPeerConnection100) {
+  RunStatsCollectionTest(100, false);
+}
+
+TEST(RTCStatsCollectorPerformanceTest, Batched100) {
+  RunStatsCollectionTest(100, true);
+}
+
+TEST(RTCStatsCollectorPerformanceTest, PerPeerConnection1000) {
+  RunStatsCollectionTest(1000, false);
+}
+
+TEST(RTCStatsCollectorPerformanceTest, Batched1000) {
+  RunStatsCollectionTest(1000, true);
+}
+
+}  // namespace webrtc
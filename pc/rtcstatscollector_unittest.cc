@@ -706,6 +706,54 @@ TEST_F(RTCStatsCollectorTest, MultipleCallbacksWithInvalidatedCacheInBetween) {
   EXPECT_NE(c.get(), b.get());
 }
 
+TEST_F(RTCStatsCollectorTest, BatchedStatsReports) {
+  rtc::scoped_refptr<RTCStatsCollectorTestHelper> other_test(
+      new rtc::RefCountedObject<RTCStatsCollectorTestHelper>());
+  rtc::scoped_refptr<RTCStatsCollector> other_collector =
+      RTCStatsCollector::Create(&other_test->pc(),
+                                50 * rtc::kNumMicrosecsPerMillisec);
+  rtc::scoped_refptr<RTCStatsBatchObtainer> callback =
+      RTCStatsBatchObtainer::Create();
+  RTCStatsCollector::GetStatsReports({collector_, other_collector}, callback);
+  EXPECT_TRUE_WAIT(callback->delivered(), kGetStatsReportTimeoutMs);
+  ASSERT_EQ(2u, callback->reports().size());
+  EXPECT_TRUE(callback->reports()[0]);
+  EXPECT_TRUE(callback->reports()[0]->Get("RTCPeerConnection"));
+  EXPECT_TRUE(callback->reports()[1]);
+  EXPECT_NE(callback->reports()[0].get(), callback->reports()[1].get());
+
+  // The batched reports are cached like other reports.
+  EXPECT_EQ(callback->reports()[0].get(), GetStatsReport().get());
+  rtc::scoped_refptr<RTCStatsObtainer> other_callback =
+      RTCStatsObtainer::Create();
+  other_collector->GetStatsReport(other_callback);
+  EXPECT_EQ(callback->reports()[1].get(), other_callback->report().get());
+}
+
+TEST_F(RTCStatsCollectorTest, BatchedStatsReportsReuseCachedAndPending) {
+  rtc::scoped_refptr<const RTCStatsReport> cached = GetStatsReport();
+  rtc::scoped_refptr<RTCStatsBatchObtainer> callback =
+      RTCStatsBatchObtainer::Create();
+  RTCStatsCollector::GetStatsReports({collector_}, callback);
+  // Delivered right away from the cache.
+  EXPECT_TRUE(callback->delivered());
+  ASSERT_EQ(1u, callback->reports().size());
+  EXPECT_EQ(cached.get(), callback->reports()[0].get());
+
+  // A collector that is already gathering delivers its pending report to the
+  // batch, also when listed more than once.
+  collector_->ClearCachedStatsReport();
+  rtc::scoped_refptr<const RTCStatsReport> pending;
+  collector_->GetStatsReport(RTCStatsObtainer::Create(&pending));
+  callback = RTCStatsBatchObtainer::Create();
+  RTCStatsCollector::GetStatsReports({collector_, collector_}, callback);
+  EXPECT_TRUE_WAIT(callback->delivered(), kGetStatsReportTimeoutMs);
+  ASSERT_EQ(2u, callback->reports().size());
+  EXPECT_TRUE(pending);
+  EXPECT_EQ(pending.get(), callback->reports()[0].get());
+  EXPECT_EQ(pending.get(), callback->reports()[1].get());
+}
+
 TEST_F(RTCStatsCollectorTest, CollectRTCCertificateStatsSingle) {
   std::unique_ptr<CertificateInfo> local_certinfo =
       CreateFakeCertificateAndInfoFromDers(
@@ -41,6 +41,13 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
     return true;
   }
 
+  size_t SendDataBatch(const std::vector<webrtc::OutgoingDataMessage>& messages,
+                       cricket::SendDataResult* result) override {
+    ++send_batch_count_;
+    return webrtc::DataChannelProviderInterface::SendDataBatch(messages,
+                                                               result);
+  }
+
   bool ConnectDataChannel(webrtc::DataChannel* data_channel) override {
     RTC_CHECK(connected_channels_.find(data_channel) ==
               connected_channels_.end());
@@ -118,6 +125,8 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
     transport_error_ = true;
   }
 
+  int send_batch_count() const { return send_batch_count_; }
+
   cricket::SendDataParams last_send_data_params() const {
     return last_send_data_params_;
   }
@@ -140,6 +149,7 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
   bool transport_available_;
   bool ready_to_send_;
   bool transport_error_;
+  int send_batch_count_ = 0;
   std::set<webrtc::DataChannel*> connected_channels_;
   std::set<uint32_t> send_ssrcs_;
   std::set<uint32_t> recv_ssrcs_;
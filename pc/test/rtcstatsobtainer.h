@@ -11,7 +11,10 @@
 #ifndef WEBRTC_PC_TEST_RTCSTATSOBTAINER_H_
 #define WEBRTC_PC_TEST_RTCSTATSOBTAINER_H_
 
+#include <vector>
+
 #include "webrtc/api/stats/rtcstatsreport.h"
+#include "webrtc/pc/rtcstatscollector.h"
 #include "webrtc/rtc_base/gunit.h"
 
 namespace webrtc {
@@ -48,6 +51,41 @@ class RTCStatsObtainer : public RTCStatsCollectorCallback {
   rtc::scoped_refptr<const RTCStatsReport>* report_ptr_;
 };
 
+class RTCStatsBatchObtainer : public RTCStatsBatchCallback {
+ public:
+  static rtc::scoped_refptr<RTCStatsBatchObtainer> Create() {
+    return rtc::scoped_refptr<RTCStatsBatchObtainer>(
+        new rtc::RefCountedObject<RTCStatsBatchObtainer>());
+  }
+
+  void OnStatsDelivered(
+      const std::vector<rtc::scoped_refptr<const RTCStatsReport>>& reports)
+      override {
+    EXPECT_TRUE(thread_checker_.CalledOnValidThread());
+    EXPECT_FALSE(delivered_);
+    reports_ = reports;
+    delivered_ = true;
+  }
+
+  bool delivered() const {
+    EXPECT_TRUE(thread_checker_.CalledOnValidThread());
+    return delivered_;
+  }
+  const std::vector<rtc::scoped_refptr<const RTCStatsReport>>& reports()
+      const {
+    EXPECT_TRUE(thread_checker_.CalledOnValidThread());
+    return reports_;
+  }
+
+ protected:
+  RTCStatsBatchObtainer() {}
+
+ private:
+  rtc::ThreadChecker thread_checker_;
+  bool delivered_ = false;
+  std::vector<rtc::scoped_refptr<const RTCStatsReport>> reports_;
+};
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_PC_TEST_RTCSTATSOBTAINER_H_
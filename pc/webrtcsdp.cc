@@ -13,10 +13,12 @@
 #include <ctype.h>
 #include <limits.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -210,6 +212,56 @@ static const char kDefaultSctpmapProtocol[] = "webrtc-datachannel";
 // types.
 const int kWildcardPayloadType = -1;
 
+// Rough size of the serialized SDP, used to reserve the output buffer.
+static const size_t kSessionLinesSize = 128;
+static const size_t kMediaLinesSize = 384;
+static const size_t kCodecLinesSize = 96;
+static const size_t kStreamLinesSize = 256;
+static const size_t kCandidateLineSize = 96;
+
+namespace {
+
+// Builds a single SDP line. Replaces std::ostringstream in the serializer,
+// which is costly to construct and copies the line on every str() call;
+// InitLine() clears the line but keeps its buffer for the next one.
+class SdpLineBuilder {
+ public:
+  void Clear() { line_.clear(); }
+  const std::string& str() const { return line_; }
+
+  SdpLineBuilder& operator<<(char c) {
+    line_.push_back(c);
+    return *this;
+  }
+  SdpLineBuilder& operator<<(const char* s) {
+    line_.append(s);
+    return *this;
+  }
+  SdpLineBuilder& operator<<(const std::string& s) {
+    line_.append(s);
+    return *this;
+  }
+  template <typename T>
+  typename std::enable_if<std::is_integral<T>::value, SdpLineBuilder&>::type
+  operator<<(T value) {
+    static_assert(sizeof(T) > 1, "Would not be formatted as by ostream.");
+    char buffer[24];
+    const int length =
+        std::is_signed<T>::value
+            ? snprintf(buffer, sizeof(buffer), "%lld",
+                       static_cast<long long>(value))
+            : snprintf(buffer, sizeof(buffer), "%llu",
+                       static_cast<unsigned long long>(value));
+    line_.append(buffer, length);
+    return *this;
+  }
+
+ private:
+  std::string line_;
+};
+
+}  // namespace
+
 struct SsrcInfo {
   uint32_t ssrc_id;
   std::string cname;
@@ -442,7 +494,8 @@ static bool GetLine(const std::string& message,
   if (line_end > 0 && (message.at(line_end - 1) == kReturn)) {
     --line_end;
   }
-  *line = message.substr(line_begin, (line_end - line_begin));
+  // Reuses the buffer of |line|, which the callers keep across lines.
+  line->assign(message, line_begin, line_end - line_begin);
   const char* cline = line->c_str();
   // RFC 4566
   // An SDP session description consists of a number of lines of text of
@@ -463,21 +516,21 @@ static bool GetLine(const std::string& message,
 
 // Init |os| to "|type|=|value|".
 static void InitLine(const char type,
-                     const std::string& value,
-                     std::ostringstream* os) {
-  os->str("");
+                     const char* value,
+                     SdpLineBuilder* os) {
+  os->Clear();
   *os << type << kSdpDelimiterEqual << value;
 }
 
 // Init |os| to "a=|attribute|".
-static void InitAttrLine(const std::string& attribute, std::ostringstream* os) {
+static void InitAttrLine(const char* attribute, SdpLineBuilder* os) {
   InitLine(kLineTypeAttributes, attribute, os);
 }
 
 // Writes a SDP attribute line based on |attribute| and |value| to |message|.
-static void AddAttributeLine(const std::string& attribute, int value,
+static void AddAttributeLine(const char* attribute, int value,
                              std::string* message) {
-  std::ostringstream os;
+  SdpLineBuilder os;
   InitAttrLine(attribute, &os);
   os << kSdpDelimiterColon << value;
   AddLine(os.str(), message);
@@ -511,9 +564,56 @@ static bool GetLineWithType(const std::string& message, size_t* pos,
   return true;
 }
 
-static bool HasAttribute(const std::string& line,
-                         const std::string& attribute) {
-  return (line.compare(kLinePrefixLength, attribute.size(), attribute) == 0);
+static bool HasAttribute(const std::string& line, const char* attribute) {
+  const size_t length = strlen(attribute);
+  return line.size() >= kLinePrefixLength + length &&
+         line.compare(kLinePrefixLength, length, attribute) == 0;
+}
+
+// Same as rtc::split(source.substr(start), ...), but without copying |source|,
+// and reusing the strings already in |fields|.
+static size_t SplitLine(const std::string& source,
+                        size_t start,
+                        char delimiter,
+                        std::vector<std::string>* fields) {
+  RTC_DCHECK_LE(start, source.size());
+  size_t count = 0;
+  size_t last = start;
+  while (true) {
+    size_t end = source.find(delimiter, last);
+    if (end == std::string::npos)
+      end = source.size();
+    if (count < fields->size())
+      (*fields)[count].assign(source, last, end - last);
+    else
+      fields->emplace_back(source, last, end - last);
+    ++count;
+    if (end == source.size())
+      break;
+    last = end + 1;
+  }
+  fields->resize(count);
+  return count;
+}
+
+// Same as rtc::tokenize_first(source.substr(start), ...), without the copy.
+static bool TokenizeFirst(const std::string& source,
+                          size_t start,
+                          char delimiter,
+                          std::string* token,
+                          std::string* rest) {
+  RTC_DCHECK_LE(start, source.size());
+  const size_t left_pos = source.find(delimiter, start);
+  if (left_pos == std::string::npos) {
+    return false;
+  }
+  size_t right_pos = left_pos + 1;
+  while (right_pos < source.size() && source[right_pos] == delimiter) {
+    right_pos++;
+  }
+  token->assign(source, start, left_pos - start);
+  rest->assign(source, right_pos, std::string::npos);
+  return true;
 }
 
 static bool AddSsrcLine(uint32_t ssrc_id,
@@ -522,7 +622,7 @@ static bool AddSsrcLine(uint32_t ssrc_id,
                         std::string* message) {
   // RFC 5576
   // a=ssrc:<ssrc-id> <attribute>:<value>
-  std::ostringstream os;
+  SdpLineBuilder os;
   InitAttrLine(kAttributeSsrc, &os);
   os << kSdpDelimiterColon << ssrc_id << kSdpDelimiterSpace
      << attribute << kSdpDelimiterColon << value;
@@ -730,7 +830,7 @@ static std::string GetRtcpLine(const std::vector<Candidate>& candidates) {
   // RFC 3605
   // rtcp-attribute =  "a=rtcp:" port  [nettype space addrtype space
   // connection-address] CRLF
-  std::ostringstream os;
+  SdpLineBuilder os;
   InitAttrLine(kAttributeRtcp, &os);
   os << kSdpDelimiterColon
      << rtcp_port << " "
@@ -759,6 +859,36 @@ static bool IsValidPort(int port) {
   return port >= 0 && port <= 65535;
 }
 
+// Estimates the size of the serialized |jdesc|, so that the message can be
+// built without reallocating it for every line.
+static size_t EstimateSdpSize(const JsepSessionDescription& jdesc) {
+  const cricket::SessionDescription* desc = jdesc.description();
+  size_t size = kSessionLinesSize;
+  for (size_t i = 0; i < desc->contents().size(); ++i) {
+    const MediaContentDescription* mdesc =
+        static_cast<const MediaContentDescription*>(
+            desc->contents()[i].description);
+    size += kMediaLinesSize;
+    if (mdesc->type() == cricket::MEDIA_TYPE_AUDIO) {
+      size += kCodecLinesSize *
+              static_cast<const AudioContentDescription*>(mdesc)
+                  ->codecs()
+                  .size();
+    } else if (mdesc->type() == cricket::MEDIA_TYPE_VIDEO) {
+      size += kCodecLinesSize *
+              static_cast<const VideoContentDescription*>(mdesc)
+                  ->codecs()
+                  .size();
+    }
+    for (const StreamParams& stream : mdesc->streams())
+      size += kStreamLinesSize * stream.ssrcs.size();
+    const IceCandidateCollection* candidates = jdesc.candidates(i);
+    if (candidates)
+      size += kCandidateLineSize * candidates->count();
+  }
+  return size;
+}
+
 std::string SdpSerialize(const JsepSessionDescription& jdesc,
                          bool unified_plan_sdp) {
   const cricket::SessionDescription* desc = jdesc.description();
@@ -767,6 +897,7 @@ std::string SdpSerialize(const JsepSessionDescription& jdesc,
   }
 
   std::string message;
+  message.reserve(EstimateSdpSize(jdesc));
 
   // Session Description.
   AddLine(kSessionVersion, &message);
@@ -774,7 +905,7 @@ std::string SdpSerialize(const JsepSessionDescription& jdesc,
   // RFC 4566
   // o=<username> <sess-id> <sess-version> <nettype> <addrtype>
   // <unicast-address>
-  std::ostringstream os;
+  SdpLineBuilder os;
   InitLine(kLineTypeOrigin, kSessionOriginUsername, &os);
   const std::string& session_id = jdesc.session_id().empty() ?
       kSessionOriginSessionId : jdesc.session_id();
@@ -1137,10 +1268,10 @@ bool ParseSctpPort(const std::string& line,
   // a=sctp-port
   std::vector<std::string> fields;
   const size_t expected_min_fields = 2;
-  rtc::split(line.substr(kLinePrefixLength), kSdpDelimiterColon, &fields);
+  SplitLine(line, kLinePrefixLength, kSdpDelimiterColon, &fields);
   if (fields.size() < expected_min_fields) {
     fields.resize(0);
-    rtc::split(line.substr(kLinePrefixLength), kSdpDelimiterSpace, &fields);
+    SplitLine(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   }
   if (fields.size() < expected_min_fields) {
     return ParseFailedExpectMinFieldNum(line, expected_min_fields, error);
@@ -1157,8 +1288,7 @@ bool ParseExtmap(const std::string& line,
   // RFC 5285
   // a=extmap:<value>["/"<direction>] <URI> <extensionattributes>
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitLine(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   const size_t expected_min_fields = 2;
   if (fields.size() < expected_min_fields) {
     return ParseFailedExpectMinFieldNum(line, expected_min_fields, error);
@@ -1207,11 +1337,7 @@ void BuildMediaDescription(const ContentInfo* content_info,
   if (content_info == NULL || message == NULL) {
     return;
   }
-  // TODO: Rethink if we should use sprintfn instead of stringstream.
-  // According to the style guide, streams should only be used for logging.
-  // http://google-styleguide.googlecode.com/svn/
-  // trunk/cppguide.xml?showone=Streams#Streams
-  std::ostringstream os;
+  SdpLineBuilder os;
   const MediaContentDescription* media_desc =
       static_cast<const MediaContentDescription*>(
           content_info->description);
@@ -1421,7 +1547,7 @@ void BuildMediaDescription(const ContentInfo* content_info,
 void BuildSctpContentAttributes(std::string* message,
                                 int sctp_port,
                                 bool use_sctpmap) {
-  std::ostringstream os;
+  SdpLineBuilder os;
   if (use_sctpmap) {
     // draft-ietf-mmusic-sctp-sdp-04
     // a=sctpmap:sctpmap-number  protocol  [streams]
@@ -1444,7 +1570,7 @@ void BuildRtpContentAttributes(const MediaContentDescription* media_desc,
                                const MediaType media_type,
                                bool unified_plan_sdp,
                                std::string* message) {
-  std::ostringstream os;
+  SdpLineBuilder os;
   // RFC 5285
   // a=extmap:<value>["/"<direction>] <URI> <extensionattributes>
   // The definitions MUST be either all session level or all media level. This
@@ -1547,7 +1673,7 @@ void BuildRtpContentAttributes(const MediaContentDescription* media_desc,
       std::vector<uint32_t>::const_iterator ssrc =
           track->ssrc_groups[i].ssrcs.begin();
       for (; ssrc != track->ssrc_groups[i].ssrcs.end(); ++ssrc) {
-        os << kSdpDelimiterSpace << rtc::ToString<uint32_t>(*ssrc);
+        os << kSdpDelimiterSpace << *ssrc;
       }
       AddLine(os.str(), message);
     }
@@ -1582,7 +1708,7 @@ void BuildRtpContentAttributes(const MediaContentDescription* media_desc,
   }
 }
 
-void WriteFmtpHeader(int payload_type, std::ostringstream* os) {
+void WriteFmtpHeader(int payload_type, SdpLineBuilder* os) {
   // fmtp header: a=fmtp:|payload_type| <parameters>
   // Add a=fmtp
   InitAttrLine(kAttributeFmtp, os);
@@ -1590,7 +1716,7 @@ void WriteFmtpHeader(int payload_type, std::ostringstream* os) {
   *os << kSdpDelimiterColon << payload_type;
 }
 
-void WriteRtcpFbHeader(int payload_type, std::ostringstream* os) {
+void WriteRtcpFbHeader(int payload_type, SdpLineBuilder* os) {
   // rtcp-fb header: a=rtcp-fb:|payload_type|
   // <parameters>/<ccm <ccm_parameters>>
   // Add a=rtcp-fb
@@ -1606,13 +1732,13 @@ void WriteRtcpFbHeader(int payload_type, std::ostringstream* os) {
 
 void WriteFmtpParameter(const std::string& parameter_name,
                         const std::string& parameter_value,
-                        std::ostringstream* os) {
+                        SdpLineBuilder* os) {
   // fmtp parameters: |parameter_name|=|parameter_value|
   *os << parameter_name << kSdpDelimiterEqual << parameter_value;
 }
 
 void WriteFmtpParameters(const cricket::CodecParameterMap& parameters,
-                         std::ostringstream* os) {
+                         SdpLineBuilder* os) {
   for (cricket::CodecParameterMap::const_iterator fmtp = parameters.begin();
        fmtp != parameters.end(); ++fmtp) {
     // Parameters are a semicolon-separated list, no spaces.
@@ -1654,7 +1780,7 @@ void AddFmtpLine(const T& codec, std::string* message) {
     // No need to add an fmtp if it will have no (optional) parameters.
     return;
   }
-  std::ostringstream os;
+  SdpLineBuilder os;
   WriteFmtpHeader(codec.id, &os);
   WriteFmtpParameters(fmtp_parameters, &os);
   AddLine(os.str(), message);
@@ -1663,10 +1789,10 @@ void AddFmtpLine(const T& codec, std::string* message) {
 
 template <class T>
 void AddRtcpFbLines(const T& codec, std::string* message) {
+  SdpLineBuilder os;
   for (std::vector<cricket::FeedbackParam>::const_iterator iter =
            codec.feedback_params.params().begin();
        iter != codec.feedback_params.params().end(); ++iter) {
-    std::ostringstream os;
     WriteRtcpFbHeader(codec.id, &os);
     os << " " << iter->id();
     if (!iter->param().empty()) {
@@ -1723,7 +1849,7 @@ void BuildRtpMap(const MediaContentDescription* media_desc,
                  std::string* message) {
   RTC_DCHECK(message != NULL);
   RTC_DCHECK(media_desc != NULL);
-  std::ostringstream os;
+  SdpLineBuilder os;
   if (media_type == cricket::MEDIA_TYPE_VIDEO) {
     const VideoContentDescription* video_desc =
         static_cast<const VideoContentDescription*>(media_desc);
@@ -1812,7 +1938,7 @@ void BuildRtpMap(const MediaContentDescription* media_desc,
 void BuildCandidate(const std::vector<Candidate>& candidates,
                     bool include_ufrag,
                     std::string* message) {
-  std::ostringstream os;
+  SdpLineBuilder os;
 
   for (std::vector<Candidate>::const_iterator it = candidates.begin();
        it != candidates.end(); ++it) {
@@ -1880,7 +2006,7 @@ void BuildCandidate(const std::vector<Candidate>& candidates,
 void BuildIceOptions(const std::vector<std::string>& transport_options,
                      std::string* message) {
   if (!transport_options.empty()) {
-    std::ostringstream os;
+    SdpLineBuilder os;
     InitAttrLine(kAttributeIceOption, &os);
     os << kSdpDelimiterColon << transport_options[0];
     for (size_t i = 1; i < transport_options.size(); ++i) {
@@ -1976,8 +2102,7 @@ bool ParseSessionDescription(const std::string& message,
                                  std::string(), error);
   }
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitLine(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   const size_t expected_fields = 6;
   if (fields.size() != expected_fields) {
     return ParseFailedExpectFieldNum(line, expected_fields, error);
@@ -2119,8 +2244,7 @@ bool ParseGroupAttribute(const std::string& line,
   // RFC 5888 and draft-holmberg-mmusic-sdp-bundle-negotiation-00
   // a=group:BUNDLE video voice
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitLine(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   std::string semantics;
   if (!GetValue(fields[0], kAttributeGroup, &semantics, error)) {
     return false;
@@ -2143,8 +2267,7 @@ static bool ParseFingerprintAttribute(const std::string& line,
   }
 
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitLine(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   const size_t expected_fields = 2;
   if (fields.size() != expected_fields) {
     return ParseFailedExpectFieldNum(line, expected_fields, error);
@@ -2179,7 +2302,7 @@ static bool ParseDtlsSetup(const std::string& line,
   // setup-attr           =  "a=setup:" role
   // role                 =  "active" / "passive" / "actpass" / "holdconn"
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength), kSdpDelimiterColon, &fields);
+  SplitLine(line, kLinePrefixLength, kSdpDelimiterColon, &fields);
   const size_t expected_fields = 2;
   if (fields.size() != expected_fields) {
     return ParseFailedExpectFieldNum(line, expected_fields, error);
@@ -2201,8 +2324,8 @@ static bool ParseMsidAttribute(const std::string& line,
   // msid-id = 1*64token-char ; see RFC 4566
   // msid-appdata = 1*64token-char  ; see RFC 4566
   std::string field1;
-  if (!rtc::tokenize_first(line.substr(kLinePrefixLength), kSdpDelimiterSpace,
-                           &field1, track_id)) {
+  if (!TokenizeFirst(line, kLinePrefixLength, kSdpDelimiterSpace,
+                     &field1, track_id)) {
     const size_t expected_fields = 2;
     return ParseFailedExpectFieldNum(line, expected_fields, error);
   }
@@ -2361,8 +2484,7 @@ bool ParseMediaDescription(const std::string& message,
     ++mline_index;
 
     std::vector<std::string> fields;
-    rtc::split(line.substr(kLinePrefixLength),
-                     kSdpDelimiterSpace, &fields);
+    SplitLine(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
 
     const size_t expected_min_fields = 4;
     if (fields.size() < expected_min_fields) {
@@ -2965,8 +3087,8 @@ bool ParseSsrcAttribute(const std::string& line, SsrcInfoVec* ssrc_infos,
   // a=ssrc:<ssrc-id> <attribute>
   // a=ssrc:<ssrc-id> <attribute>:<value>
   std::string field1, field2;
-  if (!rtc::tokenize_first(line.substr(kLinePrefixLength), kSdpDelimiterSpace,
-                           &field1, &field2)) {
+  if (!TokenizeFirst(line, kLinePrefixLength, kSdpDelimiterSpace,
+                     &field1, &field2)) {
     const size_t expected_fields = 2;
     return ParseFailedExpectFieldNum(line, expected_fields, error);
   }
@@ -3043,8 +3165,7 @@ bool ParseSsrcGroupAttribute(const std::string& line,
   // RFC 5576
   // a=ssrc-group:<semantics> <ssrc-id> ...
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitLine(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   const size_t expected_min_fields = 2;
   if (fields.size() < expected_min_fields) {
     return ParseFailedExpectMinFieldNum(line, expected_min_fields, error);
@@ -3069,8 +3190,7 @@ bool ParseCryptoAttribute(const std::string& line,
                           MediaContentDescription* media_desc,
                           SdpParseError* error) {
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitLine(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   // RFC 4568
   // a=crypto:<tag> <crypto-suite> <key-params> [<session-params>]
   const size_t expected_min_fields = 3;
@@ -3136,8 +3256,7 @@ bool ParseRtpmapAttribute(const std::string& line,
                           MediaContentDescription* media_desc,
                           SdpParseError* error) {
   std::vector<std::string> fields;
-  rtc::split(line.substr(kLinePrefixLength),
-                   kSdpDelimiterSpace, &fields);
+  SplitLine(line, kLinePrefixLength, kSdpDelimiterSpace, &fields);
   // RFC 4566
   // a=rtpmap:<payload type> <encoding name>/<clock rate>[/<encodingparameters>]
   const size_t expected_min_fields = 2;
@@ -3230,8 +3349,8 @@ bool ParseFmtpAttributes(const std::string& line, const MediaType media_type,
   // a=fmtp:<format> <format specific parameters>
   // At least two fields, whereas the second one is any of the optional
   // parameters.
-  if (!rtc::tokenize_first(line.substr(kLinePrefixLength), kSdpDelimiterSpace,
-                           &line_payload, &line_params)) {
+  if (!TokenizeFirst(line, kLinePrefixLength, kSdpDelimiterSpace,
+                     &line_payload, &line_params)) {
     ParseFailedExpectMinFieldNum(line, 2, error);
     return false;
   }
@@ -3286,7 +3405,7 @@ bool ParseRtcpFbAttribute(const std::string& line, const MediaType media_type,
     return true;
   }
   std::vector<std::string> rtcp_fb_fields;
-  rtc::split(line.c_str(), kSdpDelimiterSpace, &rtcp_fb_fields);
+  SplitLine(line, 0, kSdpDelimiterSpace, &rtcp_fb_fields);
   if (rtcp_fb_fields.size() < 2) {
     return ParseFailedGetValue(line, kAttributeRtcpFb, error);
   }
@@ -0,0 +1,193 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+
+#include "webrtc/api/jsepsessiondescription.h"
+#include "webrtc/pc/webrtcsdp.h"
+#include "webrtc/rtc_base/gunit.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+namespace {
+
+const char kFingerprint[] =
+    "a=fingerprint:sha-256 "
+    "58:AB:6E:F5:F1:E4:57:B7:E9:46:F4:86:04:28:F9:A7:ED:BD:AB:AE:40:EF:CE:9A:"
+    "51:2C:2A:B1:9B:8B:78:84\r\n";
+
+int NumIterations() {
+  return field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 5 : 100;
+}
+
+void AppendTransportLines(int index, std::string* sdp) {
+  const std::string port = std::to_string(50000 + index);
+  *sdp += "c=IN IP4 203.0.113.7\r\n"
+          "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+          "a=candidate:1467250027 1 udp 2122260223 192.168.0.196 " + port +
+          " typ host generation 0 network-id 1\r\n"
+          "a=candidate:435653019 1 tcp 1845501695 192.168.0.196 9 typ host "
+          "tcptype active generation 0 network-id 1\r\n"
+          "a=candidate:1853887674 1 udp 1518280447 203.0.113.7 " + port +
+          " typ srflx raddr 192.168.0.196 rport " + port +
+          " generation 0 network-id 1\r\n"
+          "a=ice-ufrag:ETEn\r\n"
+          "a=ice-pwd:OtSK0WpNtpUjkY4+86js7ZQl\r\n" +
+          kFingerprint +
+          "a=setup:actpass\r\n"
+          "a=mid:" + std::to_string(index) + "\r\n";
+}
+
+void AppendSsrcLines(int index, uint32_t ssrc, std::string* sdp) {
+  const std::string track = "track_" + std::to_string(index);
+  const std::string prefix = "a=ssrc:" + std::to_string(ssrc) + " ";
+  *sdp += prefix + "cname:0nSlxLJmbIatmV8x\r\n" +
+          prefix + "msid:stream " + track + "\r\n" +
+          prefix + "mslabel:stream\r\n" +
+          prefix + "label:" + track + "\r\n";
+}
+
+void AppendAudioSection(int index, std::string* sdp) {
+  *sdp += "m=audio 9 UDP/TLS/RTP/SAVPF 111 103 104 9 0 8 106 105 13 126\r\n";
+  AppendTransportLines(index, sdp);
+  *sdp += "a=extmap:1 urn:ietf:params:rtp-hdrext:ssrc-audio-level\r\n"
+          "a=extmap:3 http://www.webrtc.org/experiments/rtp-hdrext/"
+          "abs-send-time\r\n"
+          "a=sendrecv\r\n"
+          "a=rtcp-mux\r\n"
+          "a=rtpmap:111 opus/48000/2\r\n"
+          "a=rtcp-fb:111 transport-cc\r\n"
+          "a=fmtp:111 minptime=10;useinbandfec=1\r\n"
+          "a=rtpmap:103 ISAC/16000\r\n"
+          "a=rtpmap:104 ISAC/32000\r\n"
+          "a=rtpmap:9 G722/8000\r\n"
+          "a=rtpmap:0 PCMU/8000\r\n"
+          "a=rtpmap:8 PCMA/8000\r\n"
+          "a=rtpmap:106 CN/32000\r\n"
+          "a=rtpmap:105 CN/16000\r\n"
+          "a=rtpmap:13 CN/8000\r\n"
+          "a=rtpmap:126 telephone-event/8000\r\n";
+  AppendSsrcLines(index, 1000 + index, sdp);
+}
+
+void AppendVideoSection(int index, std::string* sdp) {
+  *sdp += "m=video 9 UDP/TLS/RTP/SAVPF 96 97 98 99 100 101 102\r\n";
+  AppendTransportLines(index, sdp);
+  *sdp += "a=extmap:2 urn:ietf:params:rtp-hdrext:toffset\r\n"
+          "a=extmap:3 http://www.webrtc.org/experiments/rtp-hdrext/"
+          "abs-send-time\r\n"
+          "a=extmap:4 urn:3gpp:video-orientation\r\n"
+          "a=sendrecv\r\n"
+          "a=rtcp-mux\r\n"
+          "a=rtcp-rsize\r\n";
+  const char* const kCodecs[] = {"VP8", "VP9", "H264"};
+  for (int i = 0; i < 3; ++i) {
+    const std::string pt = std::to_string(96 + 2 * i);
+    const std::string rtx_pt = std::to_string(97 + 2 * i);
+    *sdp += "a=rtpmap:" + pt + " " + kCodecs[i] + "/90000\r\n"
+            "a=rtcp-fb:" + pt + " goog-remb\r\n"
+            "a=rtcp-fb:" + pt + " transport-cc\r\n"
+            "a=rtcp-fb:" + pt + " ccm fir\r\n"
+            "a=rtcp-fb:" + pt + " nack\r\n"
+            "a=rtcp-fb:" + pt + " nack pli\r\n"
+            "a=rtpmap:" + rtx_pt + " rtx/90000\r\n"
+            "a=fmtp:" + rtx_pt + " apt=" + pt + "\r\n";
+  }
+  *sdp += "a=fmtp:100 level-asymmetry-allowed=1;packetization-mode=1;"
+          "profile-level-id=42e01f\r\n"
+          "a=rtpmap:102 red/90000\r\n";
+  const uint32_t ssrc = 2000 + 2 * index;
+  *sdp += "a=ssrc-group:FID " + std::to_string(ssrc) + " " +
+          std::to_string(ssrc + 1) + "\r\n";
+  AppendSsrcLines(index, ssrc, sdp);
+  AppendSsrcLines(index, ssrc + 1, sdp);
+}
+
+// Creates an offer with |num_m_lines| audio and video sections, as received
+// by a client joining a room where every participant has its own sections.
+std::string CreateSdp(int num_m_lines) {
+  std::string sdp =
+      "v=0\r\n"
+      "o=- 7876428616131049926 2 IN IP4 127.0.0.1\r\n"
+      "s=-\r\n"
+      "t=0 0\r\n"
+      "a=group:BUNDLE";
+  for (int i = 0; i < num_m_lines; ++i)
+    sdp += " " + std::to_string(i);
+  sdp += "\r\na=msid-semantic: WMS stream\r\n";
+  for (int i = 0; i < num_m_lines; ++i) {
+    if (i % 2 == 0)
+      AppendAudioSection(i, &sdp);
+    else
+      AppendVideoSection(i, &sdp);
+  }
+  return sdp;
+}
+
+// Parses and serializes an SDP with |num_m_lines| sections, and reports the
+// time per SDP of each.
+void RunSdpTest(int num_m_lines) {
+  const std::string sdp = CreateSdp(num_m_lines);
+  const int iterations = NumIterations();
+
+  int64_t parse_time_ns = 0;
+  int64_t serialize_time_ns = 0;
+  std::string serialized;
+  for (int i = 0; i < iterations; ++i) {
+    JsepSessionDescription desc(SessionDescriptionInterface::kOffer);
+    SdpParseError error;
+    int64_t start_time_ns = rtc::TimeNanos();
+    ASSERT_TRUE(SdpDeserialize(sdp, &desc, &error)) << error.description;
+    parse_time_ns += rtc::TimeNanos() - start_time_ns;
+    ASSERT_EQ(static_cast<size_t>(num_m_lines),
+              desc.number_of_mediasections());
+
+    start_time_ns = rtc::TimeNanos();
+    serialized = SdpSerialize(desc, false);
+    serialize_time_ns += rtc::TimeNanos() - start_time_ns;
+  }
+
+  // The serialized SDP must be stable across a parse and serialize.
+  JsepSessionDescription reparsed(SessionDescriptionInterface::kOffer);
+  ASSERT_TRUE(SdpDeserialize(serialized, &reparsed, nullptr));
+  EXPECT_EQ(serialized, SdpSerialize(reparsed, false));
+
+  const std::string label = std::to_string(num_m_lines) + "_m_lines";
+  test::PrintResult("sdp_parse_time", "", label,
+                    std::to_string(static_cast<double>(parse_time_ns) /
+                                   (iterations * rtc::kNumNanosecsPerMicrosec)),
+                    "us", true);
+  test::PrintResult(
+      "sdp_serialize_time", "", label,
+      std::to_string(static_cast<double>(serialize_time_ns) /
+                     (iterations * rtc::kNumNanosecsPerMicrosec)),
+      "us", true);
+  test::PrintResult("sdp_size", "", label, std::to_string(sdp.size()),
+                    "bytes", false);
+}
+
+}  // namespace
+
+TEST(WebRtcSdpPerformanceTest, TenMLines) {
+  RunSdpTest(10);
+}
+
+TEST(WebRtcSdpPerformanceTest, FiftyMLines) {
+  RunSdpTest(50);
+}
+
+TEST(WebRtcSdpPerformanceTest, HundredFiftyMLines) {
+  RunSdpTest(150);
+}
+
+}  // namespace webrtc
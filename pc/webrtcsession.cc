@@ -27,6 +27,7 @@
 #include "webrtc/media/sctp/sctptransportinternal.h"
 #include "webrtc/p2p/base/portallocator.h"
 #include "webrtc/pc/channel.h"
+#include "webrtc/pc/channelcommandbatch.h"
 #include "webrtc/pc/channelmanager.h"
 #include "webrtc/pc/mediasession.h"
 #include "webrtc/pc/sctputils.h"
@@ -954,20 +955,23 @@ bool WebRtcSession::PushdownMediaDescription(
     cricket::ContentAction action,
     cricket::ContentSource source,
     std::string* err) {
-  auto set_content = [this, action, source, err](cricket::BaseChannel* ch) {
-    if (!ch) {
-      return true;
-    } else if (source == cricket::CS_LOCAL) {
-      return ch->PushdownLocalDescription(local_description()->description(),
-                                          action, err);
+  // All channels share the worker thread, so push the contents down with a
+  // single hop rather than one per channel.
+  cricket::ChannelCommandBatch batch(worker_thread());
+  auto set_content = [this, &batch, action, source,
+                      err](cricket::BaseChannel* ch) {
+    if (source == cricket::CS_LOCAL) {
+      batch.PushdownLocalDescription(ch, local_description()->description(),
+                                     action, err);
     } else {
-      return ch->PushdownRemoteDescription(remote_description()->description(),
-                                           action, err);
+      batch.PushdownRemoteDescription(ch, remote_description()->description(),
+                                      action, err);
     }
   };
-
-  bool ret = (set_content(voice_channel()) && set_content(video_channel()) &&
-              set_content(rtp_data_channel()));
+  set_content(voice_channel());
+  set_content(video_channel());
+  set_content(rtp_data_channel());
+  bool ret = batch.Execute();
   // Need complete offer/answer with an SCTP m= section before starting SCTP,
   // according to https://tools.ietf.org/html/draft-ietf-mmusic-sctp-sdp-19
   if (sctp_transport_ && local_description() && remote_description() &&
@@ -1014,14 +1018,8 @@ bool WebRtcSession::PushdownLocalTransportDescription(
     return false;
   }
 
-  for (const TransportInfo& tinfo : sdesc->transport_infos()) {
-    if (!transport_controller_->SetLocalTransportDescription(
-            tinfo.content_name, tinfo.description, action, err)) {
-      return false;
-    }
-  }
-
-  return true;
+  return transport_controller_->SetLocalTransportDescriptions(
+      sdesc->transport_infos(), action, err);
 }
 
 bool WebRtcSession::PushdownRemoteTransportDescription(
@@ -1034,14 +1032,8 @@ bool WebRtcSession::PushdownRemoteTransportDescription(
     return false;
   }
 
-  for (const TransportInfo& tinfo : sdesc->transport_infos()) {
-    if (!transport_controller_->SetRemoteTransportDescription(
-            tinfo.content_name, tinfo.description, action, err)) {
-      return false;
-    }
-  }
-
-  return true;
+  return transport_controller_->SetRemoteTransportDescriptions(
+      sdesc->transport_infos(), action, err);
 }
 
 bool WebRtcSession::GetTransportDescription(
@@ -1275,6 +1267,17 @@ bool WebRtcSession::SendData(const cricket::SendDataParams& params,
                         sctp_transport_.get(), params, payload, result));
 }
 
+size_t WebRtcSession::SendDataBatch(
+    const std::vector<OutgoingDataMessage>& messages,
+    cricket::SendDataResult* result) {
+  if (!sctp_transport_) {
+    return DataChannelProviderInterface::SendDataBatch(messages, result);
+  }
+  return network_thread_->Invoke<size_t>(
+      RTC_FROM_HERE,
+      rtc::Bind(&WebRtcSession::SendSctpDataBatch_n, this, &messages, result));
+}
+
 bool WebRtcSession::ConnectDataChannel(DataChannel* webrtc_data_channel) {
   if (!rtp_data_channel_ && !sctp_transport_) {
     // Don't log an error here, because DataChannels are expected to call
@@ -1977,6 +1980,21 @@ void WebRtcSession::DestroySctpTransport_n() {
   sctp_ready_to_send_data_ = false;
 }
 
+size_t WebRtcSession::SendSctpDataBatch_n(
+    const std::vector<OutgoingDataMessage>* messages,
+    cricket::SendDataResult* result) {
+  RTC_DCHECK(network_thread_->IsCurrent());
+  RTC_DCHECK(sctp_transport_);
+  size_t sent = 0;
+  for (const OutgoingDataMessage& message : *messages) {
+    if (!sctp_transport_->SendData(message.params, message.payload, result)) {
+      break;
+    }
+    ++sent;
+  }
+  return sent;
+}
+
 void WebRtcSession::OnSctpTransportReadyToSendData_n() {
   RTC_DCHECK(data_channel_type_ == cricket::DCT_SCTP);
   RTC_DCHECK(network_thread_->IsCurrent());
@@ -288,6 +288,8 @@ class WebRtcSession :
   bool SendData(const cricket::SendDataParams& params,
                 const rtc::CopyOnWriteBuffer& payload,
                 cricket::SendDataResult* result) override;
+  size_t SendDataBatch(const std::vector<OutgoingDataMessage>& messages,
+                       cricket::SendDataResult* result) override;
   bool ConnectDataChannel(DataChannel* webrtc_data_channel) override;
   void DisconnectDataChannel(DataChannel* webrtc_data_channel) override;
   void AddSctpDataStream(int sid) override;
@@ -475,6 +477,8 @@ class WebRtcSession :
   // For bundling.
   void ChangeSctpTransport_n(const std::string& transport_name);
   void DestroySctpTransport_n();
+  size_t SendSctpDataBatch_n(const std::vector<OutgoingDataMessage>* messages,
+                             cricket::SendDataResult* result);
   // SctpTransport signal handlers. Needed to marshal signals from the network
   // to signaling thread.
   void OnSctpTransportReadyToSendData_n();
@@ -21,6 +21,7 @@
 #include <mach/thread_info.h>
 #include <mach/thread_act.h>
 #include <mach/mach_init.h>
+#include <mach/mach_port.h>
 #include <unistd.h>
 #elif defined(WEBRTC_WIN)
 #include <windows.h>
@@ -83,8 +84,13 @@ int64_t GetThreadCpuTimeNanos() {
 #elif defined(WEBRTC_MAC)
   thread_basic_info_data_t info;
   mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
-  if (thread_info(mach_thread_self(), THREAD_BASIC_INFO, (thread_info_t)&info,
-                  &count) == KERN_SUCCESS) {
+  // mach_thread_self() adds a reference to the port, which must be released
+  // to not leak one per call.
+  mach_port_t thread = mach_thread_self();
+  kern_return_t result =
+      thread_info(thread, THREAD_BASIC_INFO, (thread_info_t)&info, &count);
+  mach_port_deallocate(mach_task_self(), thread);
+  if (result == KERN_SUCCESS) {
     return info.user_time.seconds * kNumNanosecsPerSec +
            info.user_time.microseconds * kNumNanosecsPerMicrosec;
   } else {
@@ -105,8 +111,6 @@ int64_t GetThreadCpuTimeNanos() {
   }
 #else
   // Not implemented yet.
-  static_assert(
-      false, "GetProcessCpuTimeNanos() platform support not yet implemented.");
 #endif
   return -1;
 }
@@ -21,6 +21,7 @@ int64_t GetProcessCpuTimeNanos();
 
 // Returns total CPU time of a current thread in nanoseconds.
 // Time base is unknown, therefore use only to calculate deltas.
+// Returns -1 on failure and on platforms without support.
 int64_t GetThreadCpuTimeNanos();
 
 }  // namespace rtc
@@ -0,0 +1,94 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_base/worker_pool.h"
+
+#include <algorithm>
+
+#include "webrtc/rtc_base/atomicops.h"
+#include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/safe_conversions.h"
+
+namespace rtc {
+
+struct WorkerPool::Worker {
+  explicit Worker(WorkerPool* pool) : pool(pool), wake_up(false, false) {}
+
+  WorkerPool* const pool;
+  Event wake_up;
+};
+
+WorkerPool::WorkerPool(size_t num_threads, const char* thread_name)
+    : batch_done_(false, false) {
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(new Worker(this));
+    threads_.emplace_back(new PlatformThread(
+        &WorkerPool::WorkerThread, workers_.back().get(), thread_name,
+        kHighPriority));
+    threads_.back()->Start();
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  AtomicOps::ReleaseStore(&stop_, 1);
+  for (auto& worker : workers_)
+    worker->wake_up.Set();
+  for (auto& thread : threads_)
+    thread->Stop();
+}
+
+void WorkerPool::ParallelFor(size_t num_items,
+                             const std::function<void(size_t)>& work) {
+  CritScope lock(&batch_crit_);
+  if (num_items == 0)
+    return;
+  work_ = &work;
+  num_items_ = rtc::checked_cast<int>(num_items);
+  AtomicOps::ReleaseStore(&next_item_, 0);
+
+  // Only wake up as many workers as there are items left for them; the
+  // calling thread takes care of one item itself.
+  const size_t num_woken = std::min(workers_.size(), num_items - 1);
+  AtomicOps::ReleaseStore(&active_workers_, static_cast<int>(num_woken));
+  for (size_t i = 0; i < num_woken; ++i)
+    workers_[i]->wake_up.Set();
+
+  RunItems();
+
+  if (num_woken > 0)
+    batch_done_.Wait(Event::kForever);
+  work_ = nullptr;
+}
+
+// static
+void WorkerPool::WorkerThread(void* obj) {
+  Worker* worker = static_cast<Worker*>(obj);
+  WorkerPool* pool = worker->pool;
+  while (true) {
+    worker->wake_up.Wait(Event::kForever);
+    if (AtomicOps::AcquireLoad(&pool->stop_))
+      return;
+    pool->RunItems();
+    if (AtomicOps::Decrement(&pool->active_workers_) == 0)
+      pool->batch_done_.Set();
+  }
+}
+
+void WorkerPool::RunItems() {
+  while (true) {
+    // Increment() returns the new value, so the claimed item is one less.
+    const int item = AtomicOps::Increment(&next_item_) - 1;
+    if (item >= num_items_)
+      return;
+    (*work_)(static_cast<size_t>(item));
+  }
+}
+
+}  // namespace rtc
@@ -0,0 +1,72 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_RTC_BASE_WORKER_POOL_H_
+#define WEBRTC_RTC_BASE_WORKER_POOL_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/rtc_base/constructormagic.h"
+#include "webrtc/rtc_base/criticalsection.h"
+#include "webrtc/rtc_base/event.h"
+#include "webrtc/rtc_base/platform_thread.h"
+
+namespace rtc {
+
+// A fixed set of threads that process batches of independent work items.
+// ParallelFor() hands out the items of a batch to the worker threads and the
+// calling thread, and returns once all of them have been processed. Batches
+// are serialized; the pool is meant for fork/join style work such as
+// processing many streams on a common tick, not as a general task queue.
+//
+// The pool must be created and destroyed on the same thread.
+class WorkerPool {
+ public:
+  // Creates |num_threads| worker threads named |thread_name|. With zero
+  // threads all work is done on the calling thread.
+  WorkerPool(size_t num_threads, const char* thread_name);
+  ~WorkerPool();
+
+  size_t num_threads() const { return threads_.size(); }
+
+  // Calls |work(i)| for every i in [0, num_items), spread over the worker
+  // threads and the calling thread. Blocks until all calls have returned.
+  // Calls for different items may run concurrently, and in any order.
+  void ParallelFor(size_t num_items, const std::function<void(size_t)>& work);
+
+ private:
+  struct Worker;
+
+  static void WorkerThread(void* obj);
+  // Processes items of the current batch until there are none left.
+  void RunItems();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::unique_ptr<PlatformThread>> threads_;
+  // Serializes calls to ParallelFor().
+  CriticalSection batch_crit_;
+  // The current batch. Written by ParallelFor() before the workers are woken
+  // up, and only read by them afterwards.
+  const std::function<void(size_t)>* work_ = nullptr;
+  int num_items_ = 0;
+  volatile int next_item_ = 0;
+  volatile int active_workers_ = 0;
+  volatile int stop_ = 0;
+  Event batch_done_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(WorkerPool);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_RTC_BASE_WORKER_POOL_H_
@@ -0,0 +1,56 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/rtc_base/worker_pool.h"
+
+#include <vector>
+
+#include "webrtc/rtc_base/atomicops.h"
+#include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/test/gtest.h"
+
+namespace rtc {
+
+TEST(WorkerPoolTest, RunsEveryItemOnce) {
+  WorkerPool pool(3, "WorkerPoolTest");
+  EXPECT_EQ(3u, pool.num_threads());
+  std::vector<int> counts(100, 0);
+  pool.ParallelFor(counts.size(), [&counts](size_t i) { ++counts[i]; });
+  for (int count : counts)
+    EXPECT_EQ(1, count);
+}
+
+TEST(WorkerPoolTest, WithoutThreadsRunsOnCallingThread) {
+  WorkerPool pool(0, "WorkerPoolTest");
+  const PlatformThreadRef caller = CurrentThreadRef();
+  int num_calls = 0;
+  pool.ParallelFor(10, [&](size_t i) {
+    EXPECT_TRUE(IsThreadRefEqual(caller, CurrentThreadRef()));
+    ++num_calls;
+  });
+  EXPECT_EQ(10, num_calls);
+}
+
+TEST(WorkerPoolTest, HandlesEmptyAndRepeatedBatches) {
+  WorkerPool pool(4, "WorkerPoolTest");
+  pool.ParallelFor(0, [](size_t i) { ADD_FAILURE(); });
+  volatile int sum = 0;
+  for (size_t num_items = 1; num_items < 50; ++num_items) {
+    AtomicOps::ReleaseStore(&sum, 0);
+    pool.ParallelFor(num_items, [&sum](size_t i) {
+      for (size_t j = 0; j <= i; ++j)
+        AtomicOps::Increment(&sum);
+    });
+    EXPECT_EQ(static_cast<int>(num_items * (num_items + 1) / 2),
+              AtomicOps::AcquireLoad(&sum));
+  }
+}
+
+}  // namespace rtc
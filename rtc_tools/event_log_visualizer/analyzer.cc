@@ -289,6 +289,11 @@ void MovingAverage(
   }
 }
 
+template <typename PacketType>
+bool EarlierPacket(const PacketType* a, const PacketType* b) {
+  return a->timestamp < b->timestamp;
+}
+
 }  // namespace
 
 EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
@@ -514,6 +519,58 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
     // The log was missing the last LOG_END event. Fake it.
     log_segments_.push_back(std::make_pair(*last_log_start, end_time_));
   }
+
+  // Index the packets of each direction by time, once for all graphs.
+  for (PacketDirection direction : {kIncomingPacket, kOutgoingPacket}) {
+    rtp_packets_by_time_[direction];
+    rtcp_packets_by_time_[direction];
+  }
+  for (const auto& kv : rtp_packets_) {
+    std::vector<const LoggedRtpPacket*>& packets =
+        rtp_packets_by_time_[kv.first.GetDirection()];
+    for (const LoggedRtpPacket& rtp_packet : kv.second)
+      packets.push_back(&rtp_packet);
+  }
+  for (const auto& kv : rtcp_packets_) {
+    std::vector<const LoggedRtcpPacket*>& packets =
+        rtcp_packets_by_time_[kv.first.GetDirection()];
+    for (const LoggedRtcpPacket& rtcp_packet : kv.second)
+      packets.push_back(&rtcp_packet);
+  }
+  for (auto& kv : rtp_packets_by_time_) {
+    std::stable_sort(kv.second.begin(), kv.second.end(),
+                     EarlierPacket<LoggedRtpPacket>);
+  }
+  for (auto& kv : rtcp_packets_by_time_) {
+    std::stable_sort(kv.second.begin(), kv.second.end(),
+                     EarlierPacket<LoggedRtcpPacket>);
+  }
+}
+
+EventLogAnalyzer::~EventLogAnalyzer() = default;
+
+const std::vector<EventLogAnalyzer::DelayChange>&
+EventLogAnalyzer::GetDelayChanges(StreamId stream_id) {
+  rtc::CritScope cs(&cache_crit_);
+  auto it = delay_changes_.find(stream_id);
+  if (it != delay_changes_.end())
+    return it->second;
+
+  std::vector<DelayChange>& delay_changes = delay_changes_[stream_id];
+  auto packets_it = rtp_packets_.find(stream_id);
+  if (packets_it == rtp_packets_.end())
+    return delay_changes;
+  const std::vector<LoggedRtpPacket>& packet_stream = packets_it->second;
+  for (size_t i = 1; i < packet_stream.size(); i++) {
+    DelayChange delay_change;
+    delay_change.timestamp = packet_stream[i].timestamp;
+    delay_change.capture_time_ms =
+        *NetworkDelayDiff_CaptureTime(packet_stream[i - 1], packet_stream[i]);
+    delay_change.abs_send_time_ms =
+        NetworkDelayDiff_AbsSendTime(packet_stream[i - 1], packet_stream[i]);
+    delay_changes.push_back(delay_change);
+  }
+  return delay_changes;
 }
 
 class BitrateObserver : public CongestionController::Observer,
@@ -656,35 +713,24 @@ void EventLogAnalyzer::CreateAccumulatedPacketsGraph(
 
 // For each SSRC, plot the time between the consecutive playouts.
 void EventLogAnalyzer::CreatePlayoutGraph(Plot* plot) {
-  std::map<uint32_t, TimeSeries> time_series;
-  std::map<uint32_t, uint64_t> last_playout;
-
-  uint32_t ssrc;
-
-  for (size_t i = 0; i < parsed_log_.GetNumberOfEvents(); i++) {
-    ParsedRtcEventLog::EventType event_type = parsed_log_.GetEventType(i);
-    if (event_type == ParsedRtcEventLog::AUDIO_PLAYOUT_EVENT) {
-      parsed_log_.GetAudioPlayout(i, &ssrc);
-      uint64_t timestamp = parsed_log_.GetTimestamp(i);
-      if (MatchingSsrc(ssrc, desired_ssrc_)) {
-        float x = static_cast<float>(timestamp - begin_time_) / 1000000;
-        float y = static_cast<float>(timestamp - last_playout[ssrc]) / 1000;
-        if (time_series[ssrc].points.size() == 0) {
-          // There were no previusly logged playout for this SSRC.
-          // Generate a point, but place it on the x-axis.
-          y = 0;
-        }
-        time_series[ssrc].points.push_back(TimeSeriesPoint(x, y));
-        last_playout[ssrc] = timestamp;
+  for (const auto& kv : audio_playout_events_) {
+    const uint32_t ssrc = kv.first;
+    if (!MatchingSsrc(ssrc, desired_ssrc_))
+      continue;
+    TimeSeries time_series(SsrcToString(ssrc), BAR_GRAPH);
+    uint64_t last_playout = 0;
+    for (uint64_t timestamp : kv.second) {
+      float x = static_cast<float>(timestamp - begin_time_) / 1000000;
+      float y = static_cast<float>(timestamp - last_playout) / 1000;
+      if (time_series.points.size() == 0) {
+        // There were no previusly logged playout for this SSRC.
+        // Generate a point, but place it on the x-axis.
+        y = 0;
       }
+      time_series.points.push_back(TimeSeriesPoint(x, y));
+      last_playout = timestamp;
     }
-  }
-
-  // Set labels and put in graph.
-  for (auto& kv : time_series) {
-    kv.second.label = SsrcToString(kv.first);
-    kv.second.style = BAR_GRAPH;
-    plot->AppendTimeSeries(std::move(kv.second));
+    plot->AppendTimeSeries(std::move(time_series));
   }
 
   plot->SetXAxis(0, call_duration_s_, "Time (s)", kLeftMargin, kRightMargin);
@@ -816,7 +862,6 @@ void EventLogAnalyzer::CreateIncomingPacketLossGraph(Plot* plot) {
 void EventLogAnalyzer::CreateDelayChangeGraph(Plot* plot) {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
-    const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
     // Filter on direction and SSRC.
     if (stream_id.GetDirection() != kIncomingPacket ||
         !MatchingSsrc(stream_id.GetSsrc(), desired_ssrc_) ||
@@ -827,16 +872,19 @@ void EventLogAnalyzer::CreateDelayChangeGraph(Plot* plot) {
 
     TimeSeries capture_time_data(GetStreamName(stream_id) + " capture-time",
                                  BAR_GRAPH);
-    ProcessPairs<LoggedRtpPacket, double>(NetworkDelayDiff_CaptureTime,
-                                          packet_stream, begin_time_,
-                                          &capture_time_data);
-    plot->AppendTimeSeries(std::move(capture_time_data));
-
     TimeSeries send_time_data(GetStreamName(stream_id) + " abs-send-time",
                               BAR_GRAPH);
-    ProcessPairs<LoggedRtpPacket, double>(NetworkDelayDiff_AbsSendTime,
-                                          packet_stream, begin_time_,
-                                          &send_time_data);
+    for (const DelayChange& delay_change : GetDelayChanges(stream_id)) {
+      float x = static_cast<float>(delay_change.timestamp - begin_time_) /
+                1000000;
+      capture_time_data.points.emplace_back(
+          x, static_cast<float>(delay_change.capture_time_ms));
+      if (delay_change.abs_send_time_ms) {
+        send_time_data.points.emplace_back(
+            x, static_cast<float>(*delay_change.abs_send_time_ms));
+      }
+    }
+    plot->AppendTimeSeries(std::move(capture_time_data));
     plot->AppendTimeSeries(std::move(send_time_data));
   }
 
@@ -849,7 +897,6 @@ void EventLogAnalyzer::CreateDelayChangeGraph(Plot* plot) {
 void EventLogAnalyzer::CreateAccumulatedDelayChangeGraph(Plot* plot) {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
-    const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
     // Filter on direction and SSRC.
     if (stream_id.GetDirection() != kIncomingPacket ||
         !MatchingSsrc(stream_id.GetSsrc(), desired_ssrc_) ||
@@ -860,16 +907,21 @@ void EventLogAnalyzer::CreateAccumulatedDelayChangeGraph(Plot* plot) {
 
     TimeSeries capture_time_data(GetStreamName(stream_id) + " capture-time",
                                  LINE_GRAPH);
-    AccumulatePairs<LoggedRtpPacket, double>(NetworkDelayDiff_CaptureTime,
-                                             packet_stream, begin_time_,
-                                             &capture_time_data);
-    plot->AppendTimeSeries(std::move(capture_time_data));
-
     TimeSeries send_time_data(GetStreamName(stream_id) + " abs-send-time",
                               LINE_GRAPH);
-    AccumulatePairs<LoggedRtpPacket, double>(NetworkDelayDiff_AbsSendTime,
-                                             packet_stream, begin_time_,
-                                             &send_time_data);
+    double capture_time_sum = 0;
+    double send_time_sum = 0;
+    for (const DelayChange& delay_change : GetDelayChanges(stream_id)) {
+      float x = static_cast<float>(delay_change.timestamp - begin_time_) /
+                1000000;
+      capture_time_sum += delay_change.capture_time_ms;
+      capture_time_data.points.emplace_back(
+          x, static_cast<float>(capture_time_sum));
+      if (delay_change.abs_send_time_ms)
+        send_time_sum += *delay_change.abs_send_time_ms;
+      send_time_data.points.emplace_back(x, static_cast<float>(send_time_sum));
+    }
+    plot->AppendTimeSeries(std::move(capture_time_data));
     plot->AppendTimeSeries(std::move(send_time_data));
   }
 
@@ -907,20 +959,13 @@ void EventLogAnalyzer::CreateTotalBitrateGraph(
   };
   std::vector<TimestampSize> packets;
 
-  PacketDirection direction;
-  size_t total_length;
-
   // Extract timestamps and sizes for the relevant packets.
-  for (size_t i = 0; i < parsed_log_.GetNumberOfEvents(); i++) {
-    ParsedRtcEventLog::EventType event_type = parsed_log_.GetEventType(i);
-    if (event_type == ParsedRtcEventLog::RTP_EVENT) {
-      parsed_log_.GetRtpHeader(i, &direction, nullptr, nullptr, &total_length);
-      if (direction == desired_direction) {
-        uint64_t timestamp = parsed_log_.GetTimestamp(i);
-        packets.push_back(TimestampSize(timestamp, total_length));
-      }
-    }
-  }
+  const std::vector<const LoggedRtpPacket*>& rtp_packets =
+      rtp_packets_by_time_.at(desired_direction);
+  packets.reserve(rtp_packets.size());
+  for (const LoggedRtpPacket* rtp_packet : rtp_packets)
+    packets.push_back(TimestampSize(rtp_packet->timestamp,
+                                    rtp_packet->total_length));
 
   size_t window_index_begin = 0;
   size_t window_index_end = 0;
@@ -1033,20 +1078,9 @@ void EventLogAnalyzer::CreateTotalBitrateGraph(
   PacketDirection remb_direction =
       desired_direction == kOutgoingPacket ? kIncomingPacket : kOutgoingPacket;
   TimeSeries remb_series("Remb", LINE_STEP_GRAPH);
-  std::multimap<uint64_t, const LoggedRtcpPacket*> remb_packets;
-  for (const auto& kv : rtcp_packets_) {
-    if (kv.first.GetDirection() == remb_direction) {
-      for (const LoggedRtcpPacket& rtcp_packet : kv.second) {
-        if (rtcp_packet.type == kRtcpRemb) {
-          remb_packets.insert(
-              std::make_pair(rtcp_packet.timestamp, &rtcp_packet));
-        }
-      }
-    }
-  }
-
-  for (const auto& kv : remb_packets) {
-    const LoggedRtcpPacket* const rtcp = kv.second;
+  for (const LoggedRtcpPacket* rtcp : rtcp_packets_by_time_.at(remb_direction)) {
+    if (rtcp->type != kRtcpRemb)
+      continue;
     const rtcp::Remb* const remb = static_cast<rtcp::Remb*>(rtcp->packet.get());
     float x = static_cast<float>(rtcp->timestamp - begin_time_) / 1000000;
     float y = static_cast<float>(remb->bitrate_bps()) / 1000;
@@ -1096,23 +1130,10 @@ void EventLogAnalyzer::CreateStreamBitrateGraph(
 }
 
 void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) {
-  std::multimap<uint64_t, const LoggedRtpPacket*> outgoing_rtp;
-  std::multimap<uint64_t, const LoggedRtcpPacket*> incoming_rtcp;
-
-  for (const auto& kv : rtp_packets_) {
-    if (kv.first.GetDirection() == PacketDirection::kOutgoingPacket) {
-      for (const LoggedRtpPacket& rtp_packet : kv.second)
-        outgoing_rtp.insert(std::make_pair(rtp_packet.timestamp, &rtp_packet));
-    }
-  }
-
-  for (const auto& kv : rtcp_packets_) {
-    if (kv.first.GetDirection() == PacketDirection::kIncomingPacket) {
-      for (const LoggedRtcpPacket& rtcp_packet : kv.second)
-        incoming_rtcp.insert(
-            std::make_pair(rtcp_packet.timestamp, &rtcp_packet));
-    }
-  }
+  const std::vector<const LoggedRtpPacket*>& outgoing_rtp =
+      rtp_packets_by_time_.at(kOutgoingPacket);
+  const std::vector<const LoggedRtcpPacket*>& incoming_rtcp =
+      rtcp_packets_by_time_.at(kIncomingPacket);
 
   SimulatedClock clock(0);
   BitrateObserver observer;
@@ -1132,13 +1153,13 @@ void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) {
 
   auto NextRtpTime = [&]() {
     if (rtp_iterator != outgoing_rtp.end())
-      return static_cast<int64_t>(rtp_iterator->first);
+      return static_cast<int64_t>((*rtp_iterator)->timestamp);
     return std::numeric_limits<int64_t>::max();
   };
 
   auto NextRtcpTime = [&]() {
     if (rtcp_iterator != incoming_rtcp.end())
-      return static_cast<int64_t>(rtcp_iterator->first);
+      return static_cast<int64_t>((*rtcp_iterator)->timestamp);
     return std::numeric_limits<int64_t>::max();
   };
 
@@ -1159,7 +1180,7 @@ void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) {
     clock.AdvanceTimeMicroseconds(time_us - clock.TimeInMicroseconds());
     if (clock.TimeInMicroseconds() >= NextRtcpTime()) {
       RTC_DCHECK_EQ(clock.TimeInMicroseconds(), NextRtcpTime());
-      const LoggedRtcpPacket& rtcp = *rtcp_iterator->second;
+      const LoggedRtcpPacket& rtcp = **rtcp_iterator;
       if (rtcp.type == kRtcpTransportFeedback) {
         cc.OnTransportFeedback(
             *static_cast<rtcp::TransportFeedback*>(rtcp.packet.get()));
@@ -1182,7 +1203,7 @@ void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) {
     }
     if (clock.TimeInMicroseconds() >= NextRtpTime()) {
       RTC_DCHECK_EQ(clock.TimeInMicroseconds(), NextRtpTime());
-      const LoggedRtpPacket& rtp = *rtp_iterator->second;
+      const LoggedRtpPacket& rtp = **rtp_iterator;
       if (rtp.header.extension.hasTransportSequenceNumber) {
         RTC_DCHECK(rtp.header.extension.hasTransportSequenceNumber);
         cc.AddPacket(rtp.header.ssrc,
@@ -1218,23 +1239,10 @@ void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) {
 }
 
 void EventLogAnalyzer::CreateNetworkDelayFeedbackGraph(Plot* plot) {
-  std::multimap<uint64_t, const LoggedRtpPacket*> outgoing_rtp;
-  std::multimap<uint64_t, const LoggedRtcpPacket*> incoming_rtcp;
-
-  for (const auto& kv : rtp_packets_) {
-    if (kv.first.GetDirection() == PacketDirection::kOutgoingPacket) {
-      for (const LoggedRtpPacket& rtp_packet : kv.second)
-        outgoing_rtp.insert(std::make_pair(rtp_packet.timestamp, &rtp_packet));
-    }
-  }
-
-  for (const auto& kv : rtcp_packets_) {
-    if (kv.first.GetDirection() == PacketDirection::kIncomingPacket) {
-      for (const LoggedRtcpPacket& rtcp_packet : kv.second)
-        incoming_rtcp.insert(
-            std::make_pair(rtcp_packet.timestamp, &rtcp_packet));
-    }
-  }
+  const std::vector<const LoggedRtpPacket*>& outgoing_rtp =
+      rtp_packets_by_time_.at(kOutgoingPacket);
+  const std::vector<const LoggedRtcpPacket*>& incoming_rtcp =
+      rtcp_packets_by_time_.at(kIncomingPacket);
 
   SimulatedClock clock(0);
   TransportFeedbackAdapter feedback_adapter(&clock);
@@ -1247,13 +1255,13 @@ void EventLogAnalyzer::CreateNetworkDelayFeedbackGraph(Plot* plot) {
 
   auto NextRtpTime = [&]() {
     if (rtp_iterator != outgoing_rtp.end())
-      return static_cast<int64_t>(rtp_iterator->first);
+      return static_cast<int64_t>((*rtp_iterator)->timestamp);
     return std::numeric_limits<int64_t>::max();
   };
 
   auto NextRtcpTime = [&]() {
     if (rtcp_iterator != incoming_rtcp.end())
-      return static_cast<int64_t>(rtcp_iterator->first);
+      return static_cast<int64_t>((*rtcp_iterator)->timestamp);
     return std::numeric_limits<int64_t>::max();
   };
 
@@ -1262,7 +1270,7 @@ void EventLogAnalyzer::CreateNetworkDelayFeedbackGraph(Plot* plot) {
     clock.AdvanceTimeMicroseconds(time_us - clock.TimeInMicroseconds());
     if (clock.TimeInMicroseconds() >= NextRtcpTime()) {
       RTC_DCHECK_EQ(clock.TimeInMicroseconds(), NextRtcpTime());
-      const LoggedRtcpPacket& rtcp = *rtcp_iterator->second;
+      const LoggedRtcpPacket& rtcp = **rtcp_iterator;
       if (rtcp.type == kRtcpTransportFeedback) {
         feedback_adapter.OnTransportFeedback(
             *static_cast<rtcp::TransportFeedback*>(rtcp.packet.get()));
@@ -1282,7 +1290,7 @@ void EventLogAnalyzer::CreateNetworkDelayFeedbackGraph(Plot* plot) {
     }
     if (clock.TimeInMicroseconds() >= NextRtpTime()) {
       RTC_DCHECK_EQ(clock.TimeInMicroseconds(), NextRtpTime());
-      const LoggedRtpPacket& rtp = *rtp_iterator->second;
+      const LoggedRtpPacket& rtp = **rtp_iterator;
       if (rtp.header.extension.hasTransportSequenceNumber) {
         RTC_DCHECK(rtp.header.extension.hasTransportSequenceNumber);
         feedback_adapter.AddPacket(rtp.header.ssrc,
@@ -22,7 +22,10 @@
 #include "webrtc/modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet.h"
+#include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/function_view.h"
+#include "webrtc/rtc_base/optional.h"
+#include "webrtc/rtc_base/thread_annotations.h"
 #include "webrtc/rtc_tools/event_log_visualizer/plot_base.h"
 
 namespace webrtc {
@@ -59,12 +62,17 @@ struct AudioNetworkAdaptationEvent {
   AudioEncoderRuntimeConfig config;
 };
 
+// The Create*Graph methods may be called concurrently from several threads as
+// long as each call gets its own Plot. They read the state that the constructor
+// extracts from the log, and the delay changes that GetDelayChanges() computes
+// on first use. |cache_crit_| makes that cache thread-safe.
 class EventLogAnalyzer {
  public:
   // The EventLogAnalyzer keeps a reference to the ParsedRtcEventLog for the
   // duration of its lifetime. The ParsedRtcEventLog must not be destroyed or
   // modified while the EventLogAnalyzer is being used.
   explicit EventLogAnalyzer(const ParsedRtcEventLog& log);
+  ~EventLogAnalyzer();
 
   void CreatePacketGraph(PacketDirection desired_direction, Plot* plot);
 
@@ -131,6 +139,21 @@ class EventLogAnalyzer {
     webrtc::PacketDirection direction_;
   };
 
+  // Change in network delay between a packet and the previous packet of the
+  // same stream, estimated from the capture time and from the absolute send
+  // time of the packets.
+  struct DelayChange {
+    uint64_t timestamp;
+    double capture_time_ms;
+    rtc::Optional<double> abs_send_time_ms;
+  };
+
+  // Returns the delay changes of the packets in |stream_id|, which are
+  // computed on first use and then shared by all graphs that need them. The
+  // returned vector is complete and never modified afterwards, so it may be
+  // read without holding |cache_crit_|.
+  const std::vector<DelayChange>& GetDelayChanges(StreamId stream_id);
+
   template <typename T>
   void CreateAccumulatedPacketsTimeSeries(
       PacketDirection desired_direction,
@@ -168,6 +191,15 @@ class EventLogAnalyzer {
 
   std::map<StreamId, std::vector<LoggedRtcpPacket>> rtcp_packets_;
 
+  // The packets of |rtp_packets_| and |rtcp_packets_| of all streams in each
+  // direction, in the order they were logged. Graphs that look at all streams
+  // at once, e.g. the total bitrate or the BWE simulation, iterate over these
+  // instead of merging the streams themselves.
+  std::map<PacketDirection, std::vector<const LoggedRtpPacket*>>
+      rtp_packets_by_time_;
+  std::map<PacketDirection, std::vector<const LoggedRtcpPacket*>>
+      rtcp_packets_by_time_;
+
   // Maps an SSRC to the timestamps of parsed audio playout events.
   std::map<uint32_t, std::vector<uint64_t>> audio_playout_events_;
 
@@ -200,6 +232,12 @@ class EventLogAnalyzer {
 
   // Duration (in seconds) of log file.
   float call_duration_s_;
+
+  // Guards the lazily computed delay changes. std::map keeps references to
+  // its values valid when other streams are inserted.
+  rtc::CriticalSection cache_crit_;
+  std::map<StreamId, std::vector<DelayChange>> delay_changes_
+      GUARDED_BY(cache_crit_);
 };
 
 }  // namespace plotting
@@ -8,13 +8,24 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "webrtc/logging/rtc_event_log/rtc_event_log_parser.h"
+#include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/flags.h"
+#include "webrtc/rtc_base/platform_thread.h"
+#include "webrtc/rtc_base/thread_annotations.h"
+#include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/rtc_tools/event_log_visualizer/analyzer.h"
 #include "webrtc/rtc_tools/event_log_visualizer/plot_base.h"
 #include "webrtc/rtc_tools/event_log_visualizer/plot_python.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 #include "webrtc/test/field_trial.h"
 #include "webrtc/test/testsupport/fileutils.h"
 
@@ -95,6 +106,73 @@ DEFINE_bool(
     false,
     "Mark the delay based bwe detector state on the total bitrate graph");
 
+DEFINE_int(threads,
+           0,
+           "Number of threads used to create the graphs. 0 means one thread "
+           "per CPU core.");
+DEFINE_bool(print_graph_time,
+            true,
+            "Print the wall time spent creating each graph to stderr.");
+
+namespace {
+
+struct Graph {
+  Graph(const std::string& name,
+        webrtc::plotting::Plot* plot,
+        std::function<void(webrtc::plotting::Plot*)> create)
+      : name(name), plot(plot), create(std::move(create)) {}
+  std::string name;
+  // The plots are appended to the collection when the graphs are added, so
+  // the order of the output doesn't depend on which graph finishes first.
+  webrtc::plotting::Plot* plot;
+  std::function<void(webrtc::plotting::Plot*)> create;
+  int64_t time_us = 0;
+};
+
+// Creates a list of graphs on a number of threads. Each thread repeatedly
+// takes the next graph that nobody has started on, so a few slow graphs, e.g.
+// the BWE simulation or the jitter buffer, don't hold up the others.
+class GraphCreator {
+ public:
+  explicit GraphCreator(std::vector<Graph>* graphs)
+      : graphs_(graphs), next_graph_(0) {}
+
+  // Returns when all graphs have been created.
+  void Run(size_t num_threads) {
+    std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+      threads.emplace_back(
+          new rtc::PlatformThread(&GraphCreator::ThreadFunc, this, "graphs"));
+      threads.back()->Start();
+    }
+    for (const auto& thread : threads)
+      thread->Stop();
+  }
+
+ private:
+  static void ThreadFunc(void* obj) {
+    GraphCreator* creator = static_cast<GraphCreator*>(obj);
+    while (Graph* graph = creator->NextGraph()) {
+      int64_t start_time_us = rtc::TimeMicros();
+      graph->create(graph->plot);
+      graph->time_us = rtc::TimeMicros() - start_time_us;
+    }
+  }
+
+  Graph* NextGraph() {
+    rtc::CritScope lock(&crit_);
+    if (next_graph_ == graphs_->size())
+      return nullptr;
+    return &(*graphs_)[next_graph_++];
+  }
+
+  rtc::CriticalSection crit_;
+  std::vector<Graph>* const graphs_;
+  size_t next_graph_ GUARDED_BY(crit_);
+};
+
+}  // namespace
+
 int main(int argc, char* argv[]) {
   std::string program_name = argv[0];
   std::string usage =
@@ -121,7 +199,7 @@ int main(int argc, char* argv[]) {
 
   webrtc::ParsedRtcEventLog parsed_log;
 
-  if (!parsed_log.ParseFile(filename)) {
+  if (!parsed_log.MapFile(filename)) {
     std::cerr << "Could not parse the entire log file." << std::endl;
     std::cerr << "Proceeding to analyze the first "
               << parsed_log.GetNumberOfEvents() << " events in the file."
@@ -132,123 +210,178 @@ int main(int argc, char* argv[]) {
   std::unique_ptr<webrtc::plotting::PlotCollection> collection(
       new webrtc::plotting::PythonPlotCollection());
 
+  std::vector<Graph> graphs;
+  auto add_graph = [&graphs, &collection](
+      const std::string& name,
+      std::function<void(webrtc::plotting::Plot*)> create) {
+    graphs.emplace_back(name, collection->AppendNewPlot(), std::move(create));
+  };
+  const webrtc::PacketDirection kIncoming = webrtc::kIncomingPacket;
+  const webrtc::PacketDirection kOutgoing = webrtc::kOutgoingPacket;
+  using webrtc::plotting::Plot;
+
   if (FLAG_plot_all || FLAG_plot_packets) {
     if (FLAG_incoming) {
-      analyzer.CreatePacketGraph(webrtc::PacketDirection::kIncomingPacket,
-                                 collection->AppendNewPlot());
-      analyzer.CreateAccumulatedPacketsGraph(
-          webrtc::PacketDirection::kIncomingPacket,
-          collection->AppendNewPlot());
+      add_graph("incoming_packets", [&](Plot* plot) {
+        analyzer.CreatePacketGraph(kIncoming, plot);
+      });
+      add_graph("incoming_accumulated_packets", [&](Plot* plot) {
+        analyzer.CreateAccumulatedPacketsGraph(kIncoming, plot);
+      });
     }
     if (FLAG_outgoing) {
-      analyzer.CreatePacketGraph(webrtc::PacketDirection::kOutgoingPacket,
-                                 collection->AppendNewPlot());
-      analyzer.CreateAccumulatedPacketsGraph(
-          webrtc::PacketDirection::kOutgoingPacket,
-          collection->AppendNewPlot());
+      add_graph("outgoing_packets", [&](Plot* plot) {
+        analyzer.CreatePacketGraph(kOutgoing, plot);
+      });
+      add_graph("outgoing_accumulated_packets", [&](Plot* plot) {
+        analyzer.CreateAccumulatedPacketsGraph(kOutgoing, plot);
+      });
     }
   }
 
   if (FLAG_plot_all || FLAG_plot_audio_playout) {
-    analyzer.CreatePlayoutGraph(collection->AppendNewPlot());
+    add_graph("audio_playout",
+              [&](Plot* plot) { analyzer.CreatePlayoutGraph(plot); });
   }
 
   if (FLAG_plot_all || FLAG_plot_audio_level) {
-    analyzer.CreateAudioLevelGraph(collection->AppendNewPlot());
+    add_graph("audio_level",
+              [&](Plot* plot) { analyzer.CreateAudioLevelGraph(plot); });
   }
 
   if (FLAG_plot_all || FLAG_plot_sequence_number) {
     if (FLAG_incoming) {
-      analyzer.CreateSequenceNumberGraph(collection->AppendNewPlot());
+      add_graph("sequence_number",
+                [&](Plot* plot) { analyzer.CreateSequenceNumberGraph(plot); });
     }
   }
 
   if (FLAG_plot_all || FLAG_plot_delay_change) {
     if (FLAG_incoming) {
-      analyzer.CreateDelayChangeGraph(collection->AppendNewPlot());
+      add_graph("delay_change",
+                [&](Plot* plot) { analyzer.CreateDelayChangeGraph(plot); });
     }
   }
 
   if (FLAG_plot_all || FLAG_plot_accumulated_delay_change) {
     if (FLAG_incoming) {
-      analyzer.CreateAccumulatedDelayChangeGraph(collection->AppendNewPlot());
+      add_graph("accumulated_delay_change", [&](Plot* plot) {
+        analyzer.CreateAccumulatedDelayChangeGraph(plot);
+      });
     }
   }
 
   if (FLAG_plot_all || FLAG_plot_fraction_loss) {
-    analyzer.CreateFractionLossGraph(collection->AppendNewPlot());
-    analyzer.CreateIncomingPacketLossGraph(collection->AppendNewPlot());
+    add_graph("fraction_loss",
+              [&](Plot* plot) { analyzer.CreateFractionLossGraph(plot); });
+    add_graph("incoming_packet_loss", [&](Plot* plot) {
+      analyzer.CreateIncomingPacketLossGraph(plot);
+    });
   }
 
   if (FLAG_plot_all || FLAG_plot_total_bitrate) {
     if (FLAG_incoming) {
-      analyzer.CreateTotalBitrateGraph(webrtc::PacketDirection::kIncomingPacket,
-                                       collection->AppendNewPlot(),
-                                       FLAG_show_detector_state);
+      add_graph("incoming_total_bitrate", [&](Plot* plot) {
+        analyzer.CreateTotalBitrateGraph(kIncoming, plot,
+                                         FLAG_show_detector_state);
+      });
     }
     if (FLAG_outgoing) {
-      analyzer.CreateTotalBitrateGraph(webrtc::PacketDirection::kOutgoingPacket,
-                                       collection->AppendNewPlot(),
-                                       FLAG_show_detector_state);
+      add_graph("outgoing_total_bitrate", [&](Plot* plot) {
+        analyzer.CreateTotalBitrateGraph(kOutgoing, plot,
+                                         FLAG_show_detector_state);
+      });
     }
   }
 
   if (FLAG_plot_all || FLAG_plot_stream_bitrate) {
     if (FLAG_incoming) {
-      analyzer.CreateStreamBitrateGraph(
-          webrtc::PacketDirection::kIncomingPacket,
-          collection->AppendNewPlot());
+      add_graph("incoming_stream_bitrate", [&](Plot* plot) {
+        analyzer.CreateStreamBitrateGraph(kIncoming, plot);
+      });
     }
     if (FLAG_outgoing) {
-      analyzer.CreateStreamBitrateGraph(
-          webrtc::PacketDirection::kOutgoingPacket,
-          collection->AppendNewPlot());
+      add_graph("outgoing_stream_bitrate", [&](Plot* plot) {
+        analyzer.CreateStreamBitrateGraph(kOutgoing, plot);
+      });
     }
   }
 
   if (FLAG_plot_all || FLAG_plot_bwe) {
-    analyzer.CreateBweSimulationGraph(collection->AppendNewPlot());
+    add_graph("bwe",
+              [&](Plot* plot) { analyzer.CreateBweSimulationGraph(plot); });
   }
 
   if (FLAG_plot_all || FLAG_plot_network_delay_feedback) {
-    analyzer.CreateNetworkDelayFeedbackGraph(collection->AppendNewPlot());
+    add_graph("network_delay_feedback", [&](Plot* plot) {
+      analyzer.CreateNetworkDelayFeedbackGraph(plot);
+    });
   }
 
   if (FLAG_plot_all || FLAG_plot_timestamps) {
-    analyzer.CreateTimestampGraph(collection->AppendNewPlot());
+    add_graph("timestamps",
+              [&](Plot* plot) { analyzer.CreateTimestampGraph(plot); });
   }
 
   if (FLAG_plot_all || FLAG_audio_encoder_bitrate_bps) {
-    analyzer.CreateAudioEncoderTargetBitrateGraph(collection->AppendNewPlot());
+    add_graph("audio_encoder_bitrate_bps", [&](Plot* plot) {
+      analyzer.CreateAudioEncoderTargetBitrateGraph(plot);
+    });
   }
 
   if (FLAG_plot_all || FLAG_audio_encoder_frame_length_ms) {
-    analyzer.CreateAudioEncoderFrameLengthGraph(collection->AppendNewPlot());
+    add_graph("audio_encoder_frame_length_ms", [&](Plot* plot) {
+      analyzer.CreateAudioEncoderFrameLengthGraph(plot);
+    });
   }
 
   if (FLAG_plot_all || FLAG_audio_encoder_uplink_packet_loss_fraction) {
-    analyzer.CreateAudioEncoderUplinkPacketLossFractionGraph(
-        collection->AppendNewPlot());
+    add_graph("audio_encoder_uplink_packet_loss_fraction", [&](Plot* plot) {
+      analyzer.CreateAudioEncoderUplinkPacketLossFractionGraph(plot);
+    });
   }
 
   if (FLAG_plot_all || FLAG_audio_encoder_fec) {
-    analyzer.CreateAudioEncoderEnableFecGraph(collection->AppendNewPlot());
+    add_graph("audio_encoder_fec", [&](Plot* plot) {
+      analyzer.CreateAudioEncoderEnableFecGraph(plot);
+    });
   }
 
   if (FLAG_plot_all || FLAG_audio_encoder_dtx) {
-    analyzer.CreateAudioEncoderEnableDtxGraph(collection->AppendNewPlot());
+    add_graph("audio_encoder_dtx", [&](Plot* plot) {
+      analyzer.CreateAudioEncoderEnableDtxGraph(plot);
+    });
   }
 
   if (FLAG_plot_all || FLAG_audio_encoder_num_channels) {
-    analyzer.CreateAudioEncoderNumChannelsGraph(collection->AppendNewPlot());
+    add_graph("audio_encoder_num_channels", [&](Plot* plot) {
+      analyzer.CreateAudioEncoderNumChannelsGraph(plot);
+    });
   }
 
   if (FLAG_plot_all || FLAG_plot_audio_jitter_buffer) {
-    analyzer.CreateAudioJitterBufferGraph(
-        webrtc::test::ResourcePath(
-            "audio_processing/conversational_speech/EN_script2_F_sp2_B1",
-            "wav"),
-        48000, collection->AppendNewPlot());
+    const std::string replacement_file_name = webrtc::test::ResourcePath(
+        "audio_processing/conversational_speech/EN_script2_F_sp2_B1", "wav");
+    add_graph("audio_jitter_buffer", [&, replacement_file_name](Plot* plot) {
+      analyzer.CreateAudioJitterBufferGraph(replacement_file_name, 48000, plot);
+    });
+  }
+
+  size_t num_threads = FLAG_threads > 0
+                           ? static_cast<size_t>(FLAG_threads)
+                           : webrtc::CpuInfo::DetectNumberOfCores();
+  num_threads = std::max<size_t>(1, std::min(num_threads, graphs.size()));
+  int64_t start_time_us = rtc::TimeMicros();
+  GraphCreator(&graphs).Run(num_threads);
+  int64_t total_time_us = rtc::TimeMicros() - start_time_us;
+
+  if (FLAG_print_graph_time) {
+    for (const Graph& graph : graphs) {
+      std::cerr << graph.name << ": " << graph.time_us / 1000 << " ms"
+                << std::endl;
+    }
+    std::cerr << "Created " << graphs.size() << " graphs on " << num_threads
+              << " threads in " << total_time_us / 1000 << " ms" << std::endl;
   }
 
   collection->Draw();
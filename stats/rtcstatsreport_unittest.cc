@@ -11,8 +11,12 @@
 #include "webrtc/api/stats/rtcstatsreport.h"
 
 #include "webrtc/api/stats/rtcstats.h"
+#include "webrtc/api/stats/rtcstats_objects.h"
+#include "webrtc/api/stats/rtcstatsreportserializer.h"
+#include "webrtc/rtc_base/bytebuffer.h"
 #include "webrtc/rtc_base/checks.h"
 #include "webrtc/rtc_base/gunit.h"
+#include "webrtc/stats/test/rtcteststats.h"
 
 namespace webrtc {
 
@@ -132,4 +136,193 @@ TEST(RTCStatsReport, TakeMembersFrom) {
   EXPECT_EQ(i, static_cast<int64_t>(6));
 }
 
+namespace {
+
+std::string Serialize(const RTCStatsReport& report,
+                      const RTCStatsReport* previous) {
+  rtc::ByteBufferWriter buffer;
+  SerializeRTCStatsReport(report, previous, &buffer);
+  return std::string(buffer.Data(), buffer.Length());
+}
+
+void ExpectReportsEqual(const RTCStatsReport& expected,
+                        const RTCStatsReport& actual) {
+  EXPECT_EQ(expected.timestamp_us(), actual.timestamp_us());
+  ASSERT_EQ(expected.size(), actual.size());
+  for (const RTCStats& stats : expected) {
+    const RTCStats* parsed = actual.Get(stats.id());
+    ASSERT_TRUE(parsed) << stats.id();
+    EXPECT_EQ(stats.timestamp_us(), parsed->timestamp_us());
+    EXPECT_TRUE(stats == *parsed) << stats.ToString() << parsed->ToString();
+  }
+}
+
+std::unique_ptr<RTCTestStats> CreateTestStats(const std::string& id,
+                                              int64_t timestamp_us,
+                                              int64_t seed) {
+  std::unique_ptr<RTCTestStats> stats(new RTCTestStats(id, timestamp_us));
+  stats->m_bool = seed % 2 == 0;
+  stats->m_int32 = static_cast<int32_t>(-seed);
+  stats->m_uint32 = static_cast<uint32_t>(seed);
+  stats->m_int64 = std::numeric_limits<int64_t>::min() + seed;
+  stats->m_uint64 = std::numeric_limits<uint64_t>::max() - seed;
+  stats->m_double = seed / 3.0;
+  stats->m_string = "string " + std::to_string(seed);
+  stats->m_sequence_bool = std::vector<bool>({true, false, seed % 2 == 1});
+  stats->m_sequence_int32 = std::vector<int32_t>(
+      {std::numeric_limits<int32_t>::min(), 0, static_cast<int32_t>(seed)});
+  stats->m_sequence_uint32 = std::vector<uint32_t>(
+      {std::numeric_limits<uint32_t>::max(), static_cast<uint32_t>(seed)});
+  stats->m_sequence_int64 = std::vector<int64_t>({-seed, seed});
+  stats->m_sequence_uint64 = std::vector<uint64_t>(
+      {static_cast<uint64_t>(seed), std::numeric_limits<uint64_t>::max()});
+  stats->m_sequence_double = std::vector<double>({-0.5, seed * 1.5});
+  stats->m_sequence_string = std::vector<std::string>({"", "a", "bc"});
+  return stats;
+}
+
+class RTCStatsReportSerializerTest : public testing::Test {
+ public:
+  RTCStatsReportSerializerTest() {
+    parser_.RegisterStatsType<RTCTestStats>();
+    parser_.RegisterStatsType<RTCTestStats1>();
+    parser_.RegisterStatsType<RTCTestStats2>();
+    parser_.RegisterStatsType<RTCTestStats3>();
+  }
+
+  rtc::scoped_refptr<RTCStatsReport> Parse(const std::string& data,
+                                           const RTCStatsReport* previous) {
+    return parser_.Parse(data.data(), data.size(), previous);
+  }
+
+ protected:
+  RTCStatsReportParser parser_;
+};
+
+}  // namespace
+
+TEST_F(RTCStatsReportSerializerTest, SerializeAndParseReport) {
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(1337);
+  report->AddStats(CreateTestStats("test0", 1337, 0));
+  report->AddStats(CreateTestStats("test1", 1000, 12345));
+  // Undefined members.
+  report->AddStats(std::unique_ptr<RTCStats>(new RTCTestStats("test2", 0)));
+  report->AddStats(std::unique_ptr<RTCStats>(new RTCTestStats1("a", 2000)));
+  std::unique_ptr<RTCTestStats2> stats2(new RTCTestStats2("b", 1337));
+  stats2->number = -1.25;
+  report->AddStats(std::move(stats2));
+  std::unique_ptr<RTCMediaStreamTrackStats> track(new RTCMediaStreamTrackStats(
+      "track", 1337, RTCMediaStreamTrackKind::kVideo));
+  track->track_identifier = "track id";
+  track->frame_width = 640;
+  report->AddStats(std::move(track));
+
+  rtc::scoped_refptr<RTCStatsReport> parsed =
+      Parse(Serialize(*report, nullptr), nullptr);
+  ASSERT_TRUE(parsed);
+  ExpectReportsEqual(*report, *parsed);
+}
+
+TEST_F(RTCStatsReportSerializerTest, SerializeAndParseDelta) {
+  rtc::scoped_refptr<RTCStatsReport> previous = RTCStatsReport::Create(1000);
+  previous->AddStats(CreateTestStats("changed", 1000, 1));
+  previous->AddStats(CreateTestStats("removed", 1000, 2));
+  previous->AddStats(CreateTestStats("unchanged", 900, 3));
+  std::unique_ptr<RTCTestStats1> replaced(new RTCTestStats1("replaced", 1000));
+  replaced->integer = 7;
+  previous->AddStats(std::move(replaced));
+
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(2000);
+  std::unique_ptr<RTCTestStats> changed = CreateTestStats("changed", 2000, 1);
+  changed->m_int32 = std::numeric_limits<int32_t>::max();
+  changed->m_uint32 = 0u;
+  changed->m_int64 = std::numeric_limits<int64_t>::max();
+  changed->m_uint64 = 0u;
+  changed->m_string = "new string";
+  changed->m_sequence_int32 = std::vector<int32_t>();
+  report->AddStats(std::move(changed));
+  // Members that become undefined.
+  std::unique_ptr<RTCTestStats> undefined(new RTCTestStats("unchanged", 1900));
+  undefined->m_bool = *CreateTestStats("unchanged", 900, 3)->m_bool;
+  report->AddStats(std::move(undefined));
+  report->AddStats(CreateTestStats("added", 2000, 4));
+  // Same id, different type.
+  std::unique_ptr<RTCTestStats3> replacement(
+      new RTCTestStats3("replaced", 2000));
+  replacement->string = "replacement";
+  report->AddStats(std::move(replacement));
+
+  std::string delta = Serialize(*report, previous.get());
+  rtc::scoped_refptr<RTCStatsReport> parsed = Parse(delta, previous.get());
+  ASSERT_TRUE(parsed);
+  ExpectReportsEqual(*report, *parsed);
+
+  // A delta can not be parsed without the previous report.
+  EXPECT_FALSE(Parse(delta, nullptr));
+  EXPECT_FALSE(Parse(delta, report.get()));
+}
+
+TEST_F(RTCStatsReportSerializerTest, DeltaOfSlowlyChangingReportIsSmall) {
+  auto create_stats = [](int i, int64_t timestamp_us, uint32_t packets) {
+    std::unique_ptr<RTCInboundRTPStreamStats> stats(
+        new RTCInboundRTPStreamStats(
+            "RTCInboundRTPVideoStream_" + std::to_string(i), timestamp_us));
+    stats->ssrc = 1234u + i;
+    stats->media_type = "video";
+    stats->codec_id = "RTCCodec_InboundVideo_96";
+    stats->transport_id = "RTCTransport_0_1";
+    stats->packets_received = packets;
+    stats->bytes_received = packets * 1200ull;
+    stats->packets_lost = 10u;
+    stats->jitter = 0.01;
+    stats->fraction_lost = 0.0;
+    return stats;
+  };
+  rtc::scoped_refptr<RTCStatsReport> previous = RTCStatsReport::Create(1000);
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(2000);
+  for (int i = 0; i < 10; ++i) {
+    previous->AddStats(create_stats(i, 1000, 100000u));
+    report->AddStats(create_stats(i, 2000, 100100u));
+  }
+
+  const std::string full = Serialize(*report, nullptr);
+  const std::string delta = Serialize(*report, previous.get());
+  EXPECT_LT(full.size(), report->ToString().size());
+  // Only the packet and byte counters changed, by a few bytes each.
+  EXPECT_LT(delta.size(), full.size() / 4);
+
+  // The standard stats types are registered by default.
+  RTCStatsReportParser parser;
+  const std::string full_previous = Serialize(*previous, nullptr);
+  rtc::scoped_refptr<RTCStatsReport> parsed_previous =
+      parser.Parse(full_previous.data(), full_previous.size(), nullptr);
+  ASSERT_TRUE(parsed_previous);
+  ExpectReportsEqual(*previous, *parsed_previous);
+  rtc::scoped_refptr<RTCStatsReport> parsed =
+      parser.Parse(delta.data(), delta.size(), parsed_previous.get());
+  ASSERT_TRUE(parsed);
+  ExpectReportsEqual(*report, *parsed);
+}
+
+TEST_F(RTCStatsReportSerializerTest, ParseMalformedReport) {
+  rtc::scoped_refptr<RTCStatsReport> previous = RTCStatsReport::Create(1000);
+  previous->AddStats(CreateTestStats("a", 1000, 1));
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(2000);
+  report->AddStats(CreateTestStats("a", 2000, 2));
+  report->AddStats(CreateTestStats("b", 2000, 3));
+
+  const std::string full = Serialize(*report, nullptr);
+  const std::string delta = Serialize(*report, previous.get());
+  for (size_t size = 0; size < full.size(); ++size)
+    EXPECT_FALSE(Parse(full.substr(0, size), nullptr)) << size;
+  for (size_t size = 0; size < delta.size(); ++size)
+    EXPECT_FALSE(Parse(delta.substr(0, size), previous.get())) << size;
+  EXPECT_FALSE(Parse(full + '\0', nullptr));
+  EXPECT_FALSE(Parse('\x7f' + full.substr(1), nullptr));
+
+  // Unregistered types.
+  RTCStatsReportParser parser;
+  EXPECT_FALSE(parser.Parse(full.data(), full.size(), nullptr));
+}
+
 }  // namespace webrtc
@@ -0,0 +1,571 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/api/stats/rtcstatsreportserializer.h"
+
+#include <string.h>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "webrtc/api/stats/rtcstats_objects.h"
+#include "webrtc/rtc_base/checks.h"
+
+namespace webrtc {
+
+// Encoding, all integers are varints unless stated otherwise:
+//
+//   report  := version(uint8) flags
+//              [previous number of stats]  if delta
+//              timestamp(signed, difference to previous report if delta)
+//              number of stats, stats*
+//   stats   := reference(0 or index of the stats in previous report + 1)
+//              [id(string) type]  if reference is 0
+//              timestamp(signed, difference to report timestamp)
+//              number of members, member*
+//   type    := 0 followed by the type name(string), or index in the table of
+//              previously encoded type names + 1
+//   member  := ((member index - previous member index - 1) << 1 | defined)
+//              [value]  if defined
+//
+// Signed integers are zigzag-encoded. Values of referenced stats are encoded
+// as the difference to their previous value if it was defined. Doubles are
+// encoded as their 64 bits, strings and sequences are length-prefixed.
+
+namespace {
+
+const uint8_t kVersion = 1;
+const uint64_t kDeltaFlag = 1;
+
+void WriteZigZag(int64_t value, rtc::ByteBufferWriter* buffer) {
+  buffer->WriteUVarint((static_cast<uint64_t>(value) << 1) ^
+                       static_cast<uint64_t>(value >> 63));
+}
+
+bool ReadZigZag(rtc::ByteBufferReader* buffer, int64_t* value) {
+  uint64_t zigzag;
+  if (!buffer->ReadUVarint(&zigzag))
+    return false;
+  *value =
+      static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+  return true;
+}
+
+void WriteLengthPrefixedString(const std::string& value,
+                               rtc::ByteBufferWriter* buffer) {
+  buffer->WriteUVarint(value.size());
+  buffer->WriteString(value);
+}
+
+bool ReadLengthPrefixedString(rtc::ByteBufferReader* buffer,
+                              std::string* value) {
+  uint64_t size;
+  return buffer->ReadUVarint(&size) && size <= buffer->Length() &&
+         buffer->ReadString(value, static_cast<size_t>(size));
+}
+
+// Difference of two 64-bit values with wrap-around, which makes it reversible
+// for all values.
+int64_t Difference(uint64_t value, uint64_t base) {
+  return static_cast<int64_t>(value - base);
+}
+
+// |WriteValue| and |ReadValue| encode a single value, as the difference to
+// |base| if it is not null.
+void WriteValue(bool value, const bool* base, rtc::ByteBufferWriter* buffer) {
+  buffer->WriteUInt8(value ? 1 : 0);
+}
+
+bool ReadValue(rtc::ByteBufferReader* buffer, const bool* base, bool* value) {
+  uint8_t byte;
+  if (!buffer->ReadUInt8(&byte) || byte > 1)
+    return false;
+  *value = byte != 0;
+  return true;
+}
+
+void WriteValue(int32_t value,
+                const int32_t* base,
+                rtc::ByteBufferWriter* buffer) {
+  WriteZigZag(static_cast<int64_t>(value) - (base ? *base : 0), buffer);
+}
+
+bool ReadValue(rtc::ByteBufferReader* buffer,
+               const int32_t* base,
+               int32_t* value) {
+  int64_t difference;
+  if (!ReadZigZag(buffer, &difference) || difference < -(1LL << 32) ||
+      difference > (1LL << 32)) {
+    return false;
+  }
+  int64_t result = (base ? *base : 0) + difference;
+  if (result < std::numeric_limits<int32_t>::min() ||
+      result > std::numeric_limits<int32_t>::max()) {
+    return false;
+  }
+  *value = static_cast<int32_t>(result);
+  return true;
+}
+
+void WriteValue(int64_t value,
+                const int64_t* base,
+                rtc::ByteBufferWriter* buffer) {
+  WriteZigZag(Difference(value, base ? *base : 0), buffer);
+}
+
+bool ReadValue(rtc::ByteBufferReader* buffer,
+               const int64_t* base,
+               int64_t* value) {
+  int64_t difference;
+  if (!ReadZigZag(buffer, &difference))
+    return false;
+  *value = static_cast<int64_t>(static_cast<uint64_t>(base ? *base : 0) +
+                                static_cast<uint64_t>(difference));
+  return true;
+}
+
+// Unsigned values without a base are encoded as is, not zigzag-encoded.
+void WriteValue(uint64_t value,
+                const uint64_t* base,
+                rtc::ByteBufferWriter* buffer) {
+  if (base)
+    WriteZigZag(Difference(value, *base), buffer);
+  else
+    buffer->WriteUVarint(value);
+}
+
+bool ReadValue(rtc::ByteBufferReader* buffer,
+               const uint64_t* base,
+               uint64_t* value) {
+  if (!base)
+    return buffer->ReadUVarint(value);
+  int64_t difference;
+  if (!ReadZigZag(buffer, &difference))
+    return false;
+  *value = *base + static_cast<uint64_t>(difference);
+  return true;
+}
+
+void WriteValue(uint32_t value,
+                const uint32_t* base,
+                rtc::ByteBufferWriter* buffer) {
+  if (base)
+    WriteZigZag(static_cast<int64_t>(value) - *base, buffer);
+  else
+    buffer->WriteUVarint(value);
+}
+
+bool ReadValue(rtc::ByteBufferReader* buffer,
+               const uint32_t* base,
+               uint32_t* value) {
+  uint64_t result;
+  if (base) {
+    int64_t difference;
+    if (!ReadZigZag(buffer, &difference) || difference < -(1LL << 32) ||
+        difference > (1LL << 32)) {
+      return false;
+    }
+    result = static_cast<uint64_t>(*base + difference);
+  } else if (!buffer->ReadUVarint(&result)) {
+    return false;
+  }
+  if (result > std::numeric_limits<uint32_t>::max())
+    return false;
+  *value = static_cast<uint32_t>(result);
+  return true;
+}
+
+void WriteValue(double value,
+                const double* base,
+                rtc::ByteBufferWriter* buffer) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  buffer->WriteUInt64(bits);
+}
+
+bool ReadValue(rtc::ByteBufferReader* buffer,
+               const double* base,
+               double* value) {
+  uint64_t bits;
+  if (!buffer->ReadUInt64(&bits))
+    return false;
+  memcpy(value, &bits, sizeof(bits));
+  return true;
+}
+
+void WriteValue(const std::string& value,
+                const std::string* base,
+                rtc::ByteBufferWriter* buffer) {
+  WriteLengthPrefixedString(value, buffer);
+}
+
+bool ReadValue(rtc::ByteBufferReader* buffer,
+               const std::string* base,
+               std::string* value) {
+  return ReadLengthPrefixedString(buffer, value);
+}
+
+// Sequence elements are encoded without a base.
+template<typename T>
+void WriteValue(const std::vector<T>& value,
+                const std::vector<T>* base,
+                rtc::ByteBufferWriter* buffer) {
+  buffer->WriteUVarint(value.size());
+  for (const T& element : value)
+    WriteValue(element, static_cast<const T*>(nullptr), buffer);
+}
+
+template<typename T>
+bool ReadValue(rtc::ByteBufferReader* buffer,
+               const std::vector<T>* base,
+               std::vector<T>* value) {
+  uint64_t size;
+  // Every element takes at least one byte, which bounds the allocation.
+  if (!buffer->ReadUVarint(&size) || size > buffer->Length())
+    return false;
+  value->clear();
+  value->reserve(static_cast<size_t>(size));
+  for (uint64_t i = 0; i < size; ++i) {
+    T element;
+    if (!ReadValue(buffer, static_cast<const T*>(nullptr), &element))
+      return false;
+    value->push_back(std::move(element));
+  }
+  return true;
+}
+
+// std::vector<bool> does not hand out references to its elements.
+void WriteValue(const std::vector<bool>& value,
+                const std::vector<bool>* base,
+                rtc::ByteBufferWriter* buffer) {
+  buffer->WriteUVarint(value.size());
+  for (bool element : value)
+    WriteValue(element, static_cast<const bool*>(nullptr), buffer);
+}
+
+// Operations on members of type |RTCStatsMember<T>|, dispatched on the type of
+// a member by |ForMemberType|.
+template<typename T>
+struct WriteMember {
+  static bool Run(const RTCStatsMemberInterface& member,
+                  const RTCStatsMemberInterface* base,
+                  rtc::ByteBufferWriter* buffer) {
+    WriteValue(*member.cast_to<RTCStatsMember<T>>(),
+               base ? &*base->cast_to<RTCStatsMember<T>>() : nullptr, buffer);
+    return true;
+  }
+};
+
+template<typename T>
+struct ReadMember {
+  static bool Run(rtc::ByteBufferReader* buffer,
+                  const RTCStatsMemberInterface* base,
+                  RTCStatsMemberInterface* member) {
+    T value;
+    if (!ReadValue(buffer,
+                   base ? &*base->cast_to<RTCStatsMember<T>>() : nullptr,
+                   &value)) {
+      return false;
+    }
+    *static_cast<RTCStatsMember<T>*>(member) = std::move(value);
+    return true;
+  }
+};
+
+template<typename T>
+struct CopyMember {
+  static bool Run(const RTCStatsMemberInterface& from,
+                  RTCStatsMemberInterface* to) {
+    *static_cast<RTCStatsMember<T>*>(to) = *from.cast_to<RTCStatsMember<T>>();
+    return true;
+  }
+};
+
+template<template<typename> class Operation, typename... Args>
+bool ForMemberType(RTCStatsMemberInterface::Type type, Args&&... args) {
+  switch (type) {
+    case RTCStatsMemberInterface::kBool:
+      return Operation<bool>::Run(std::forward<Args>(args)...);
+    case RTCStatsMemberInterface::kInt32:
+      return Operation<int32_t>::Run(std::forward<Args>(args)...);
+    case RTCStatsMemberInterface::kUint32:
+      return Operation<uint32_t>::Run(std::forward<Args>(args)...);
+    case RTCStatsMemberInterface::kInt64:
+      return Operation<int64_t>::Run(std::forward<Args>(args)...);
+    case RTCStatsMemberInterface::kUint64:
+      return Operation<uint64_t>::Run(std::forward<Args>(args)...);
+    case RTCStatsMemberInterface::kDouble:
+      return Operation<double>::Run(std::forward<Args>(args)...);
+    case RTCStatsMemberInterface::kString:
+      return Operation<std::string>::Run(std::forward<Args>(args)...);
+    case RTCStatsMemberInterface::kSequenceBool:
+      return Operation<std::vector<bool>>::Run(std::forward<Args>(args)...);
+    case RTCStatsMemberInterface::kSequenceInt32:
+      return Operation<std::vector<int32_t>>::Run(std::forward<Args>(args)...);
+    case RTCStatsMemberInterface::kSequenceUint32:
+      return Operation<std::vector<uint32_t>>::Run(
+          std::forward<Args>(args)...);
+    case RTCStatsMemberInterface::kSequenceInt64:
+      return Operation<std::vector<int64_t>>::Run(std::forward<Args>(args)...);
+    case RTCStatsMemberInterface::kSequenceUint64:
+      return Operation<std::vector<uint64_t>>::Run(
+          std::forward<Args>(args)...);
+    case RTCStatsMemberInterface::kSequenceDouble:
+      return Operation<std::vector<double>>::Run(std::forward<Args>(args)...);
+    case RTCStatsMemberInterface::kSequenceString:
+      return Operation<std::vector<std::string>>::Run(
+          std::forward<Args>(args)...);
+  }
+  RTC_NOTREACHED();
+  return false;
+}
+
+void WriteStats(const RTCStats& stats,
+                const RTCStats* previous,
+                int64_t report_timestamp_us,
+                std::map<const char*, size_t>* type_indices,
+                rtc::ByteBufferWriter* buffer) {
+  if (!previous) {
+    WriteLengthPrefixedString(stats.id(), buffer);
+    // Stats of the same class share their |type| pointer.
+    auto it = type_indices->find(stats.type());
+    if (it != type_indices->end()) {
+      buffer->WriteUVarint(it->second + 1);
+    } else {
+      buffer->WriteUVarint(0);
+      WriteLengthPrefixedString(stats.type(), buffer);
+      type_indices->insert(std::make_pair(stats.type(), type_indices->size()));
+    }
+  }
+  WriteZigZag(stats.timestamp_us() - report_timestamp_us, buffer);
+
+  std::vector<const RTCStatsMemberInterface*> members = stats.Members();
+  std::vector<const RTCStatsMemberInterface*> previous_members;
+  if (previous)
+    previous_members = previous->Members();
+  std::vector<size_t> changed_members;
+  for (size_t i = 0; i < members.size(); ++i) {
+    if (previous ? *members[i] != *previous_members[i]
+                 : members[i]->is_defined()) {
+      changed_members.push_back(i);
+    }
+  }
+  buffer->WriteUVarint(changed_members.size());
+  size_t next_index = 0;
+  for (size_t i : changed_members) {
+    const RTCStatsMemberInterface& member = *members[i];
+    buffer->WriteUVarint(((i - next_index) << 1) |
+                         (member.is_defined() ? 1 : 0));
+    next_index = i + 1;
+    if (!member.is_defined())
+      continue;
+    const RTCStatsMemberInterface* base =
+        previous && previous_members[i]->is_defined() ? previous_members[i]
+                                                      : nullptr;
+    ForMemberType<WriteMember>(member.type(), member, base, buffer);
+  }
+}
+
+}  // namespace
+
+void SerializeRTCStatsReport(const RTCStatsReport& report,
+                             const RTCStatsReport* previous,
+                             rtc::ByteBufferWriter* buffer) {
+  buffer->WriteUInt8(kVersion);
+  buffer->WriteUVarint(previous ? kDeltaFlag : 0);
+  if (previous) {
+    buffer->WriteUVarint(previous->size());
+    WriteZigZag(report.timestamp_us() - previous->timestamp_us(), buffer);
+  } else {
+    WriteZigZag(report.timestamp_us(), buffer);
+  }
+  buffer->WriteUVarint(report.size());
+
+  std::vector<const RTCStats*> previous_stats;
+  if (previous) {
+    previous_stats.reserve(previous->size());
+    for (const RTCStats& stats : *previous)
+      previous_stats.push_back(&stats);
+  }
+  std::map<const char*, size_t> type_indices;
+  // Both reports are ordered by id, which allows finding the previous stats by
+  // walking |previous_stats| alongside |report|.
+  size_t previous_index = 0;
+  for (const RTCStats& stats : report) {
+    while (previous_index < previous_stats.size() &&
+           previous_stats[previous_index]->id() < stats.id()) {
+      ++previous_index;
+    }
+    const RTCStats* previous_stats_object = nullptr;
+    if (previous_index < previous_stats.size() &&
+        previous_stats[previous_index]->id() == stats.id() &&
+        strcmp(previous_stats[previous_index]->type(), stats.type()) == 0) {
+      previous_stats_object = previous_stats[previous_index];
+    }
+    buffer->WriteUVarint(previous_stats_object ? previous_index + 1 : 0);
+    WriteStats(stats, previous_stats_object, report.timestamp_us(),
+               &type_indices, buffer);
+  }
+}
+
+RTCStatsReportParser::RTCStatsReportParser() {
+  RegisterStatsType<RTCCertificateStats>();
+  RegisterStatsType<RTCCodecStats>();
+  RegisterStatsType<RTCDataChannelStats>();
+  RegisterStatsType<RTCIceCandidatePairStats>();
+  RegisterStatsType<RTCLocalIceCandidateStats>();
+  RegisterStatsType<RTCRemoteIceCandidateStats>();
+  RegisterStatsType<RTCMediaStreamStats>();
+  // |kind| is always encoded because it is defined on construction, and
+  // overwrites the kind given here.
+  RegisterStatsType(RTCMediaStreamTrackStats::kType,
+                    [](const std::string& id, int64_t timestamp_us) {
+    return std::unique_ptr<RTCStats>(new RTCMediaStreamTrackStats(
+        id, timestamp_us, RTCMediaStreamTrackKind::kAudio));
+  });
+  RegisterStatsType<RTCPeerConnectionStats>();
+  RegisterStatsType<RTCInboundRTPStreamStats>();
+  RegisterStatsType<RTCOutboundRTPStreamStats>();
+  RegisterStatsType<RTCTransportStats>();
+}
+
+RTCStatsReportParser::~RTCStatsReportParser() {
+}
+
+void RTCStatsReportParser::RegisterStatsType(const char* type,
+                                             const StatsFactory& factory) {
+  factories_[type] = factory;
+}
+
+std::unique_ptr<RTCStats> RTCStatsReportParser::CreateStats(
+    const std::string& type,
+    const std::string& id,
+    int64_t timestamp_us) const {
+  auto it = factories_.find(type);
+  if (it == factories_.end())
+    return nullptr;
+  return it->second(id, timestamp_us);
+}
+
+rtc::scoped_refptr<RTCStatsReport> RTCStatsReportParser::Parse(
+    const char* data, size_t size, const RTCStatsReport* previous) const {
+  rtc::ByteBufferReader buffer(data, size);
+  uint8_t version;
+  uint64_t flags;
+  if (!buffer.ReadUInt8(&version) || version != kVersion ||
+      !buffer.ReadUVarint(&flags) || (flags & ~kDeltaFlag) != 0) {
+    return nullptr;
+  }
+  const bool delta = (flags & kDeltaFlag) != 0;
+  std::vector<const RTCStats*> previous_stats;
+  int64_t timestamp_us;
+  if (delta) {
+    uint64_t previous_size;
+    if (!previous || !buffer.ReadUVarint(&previous_size) ||
+        previous_size != previous->size() ||
+        !ReadZigZag(&buffer, &timestamp_us)) {
+      return nullptr;
+    }
+    timestamp_us += previous->timestamp_us();
+    previous_stats.reserve(previous->size());
+    for (const RTCStats& stats : *previous)
+      previous_stats.push_back(&stats);
+  } else if (!ReadZigZag(&buffer, &timestamp_us)) {
+    return nullptr;
+  }
+
+  rtc::scoped_refptr<RTCStatsReport> report =
+      RTCStatsReport::Create(timestamp_us);
+  std::vector<std::string> types;
+  uint64_t num_stats;
+  if (!buffer.ReadUVarint(&num_stats))
+    return nullptr;
+  for (uint64_t i = 0; i < num_stats; ++i) {
+    uint64_t reference;
+    if (!buffer.ReadUVarint(&reference) || reference > previous_stats.size())
+      return nullptr;
+    const RTCStats* previous_stats_object =
+        reference ? previous_stats[reference - 1] : nullptr;
+    std::string id;
+    std::string type;
+    if (previous_stats_object) {
+      id = previous_stats_object->id();
+      type = previous_stats_object->type();
+    } else {
+      uint64_t type_index;
+      if (!ReadLengthPrefixedString(&buffer, &id) ||
+          !buffer.ReadUVarint(&type_index) || type_index > types.size()) {
+        return nullptr;
+      }
+      if (type_index == 0) {
+        if (!ReadLengthPrefixedString(&buffer, &type))
+          return nullptr;
+        types.push_back(type);
+      } else {
+        type = types[type_index - 1];
+      }
+    }
+    int64_t stats_timestamp_us;
+    if (!ReadZigZag(&buffer, &stats_timestamp_us) || report->Get(id))
+      return nullptr;
+    std::unique_ptr<RTCStats> stats =
+        CreateStats(type, id, timestamp_us + stats_timestamp_us);
+    if (!stats)
+      return nullptr;
+
+    // |stats| is owned here, so its members may be modified.
+    std::vector<const RTCStatsMemberInterface*> members = stats->Members();
+    std::vector<const RTCStatsMemberInterface*> previous_members;
+    if (previous_stats_object) {
+      previous_members = previous_stats_object->Members();
+      if (previous_members.size() != members.size())
+        return nullptr;
+    }
+    std::vector<bool> changed(members.size(), false);
+    uint64_t num_members;
+    if (!buffer.ReadUVarint(&num_members) || num_members > members.size())
+      return nullptr;
+    uint64_t next_index = 0;
+    for (uint64_t j = 0; j < num_members; ++j) {
+      uint64_t key;
+      if (!buffer.ReadUVarint(&key))
+        return nullptr;
+      uint64_t index = next_index + (key >> 1);
+      if (index < next_index || index >= members.size())
+        return nullptr;
+      next_index = index + 1;
+      changed[index] = true;
+      if (!(key & 1))
+        continue;
+      RTCStatsMemberInterface* member =
+          const_cast<RTCStatsMemberInterface*>(members[index]);
+      const RTCStatsMemberInterface* base =
+          previous_stats_object && previous_members[index]->is_defined()
+              ? previous_members[index]
+              : nullptr;
+      if (!ForMemberType<ReadMember>(member->type(), &buffer, base, member))
+        return nullptr;
+    }
+    for (size_t j = 0; j < previous_members.size(); ++j) {
+      if (changed[j] || !previous_members[j]->is_defined())
+        continue;
+      ForMemberType<CopyMember>(
+          members[j]->type(), *previous_members[j],
+          const_cast<RTCStatsMemberInterface*>(members[j]));
+    }
+    report->AddStats(std::move(stats));
+  }
+  if (buffer.Length() != 0)
+    return nullptr;
+  return report;
+}
+
+}  // namespace webrtc
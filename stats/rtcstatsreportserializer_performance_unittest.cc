@@ -0,0 +1,150 @@
+/*
+ *  Copyright 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+
+#include "webrtc/api/stats/rtcstats_objects.h"
+#include "webrtc/api/stats/rtcstatsreport.h"
+#include "webrtc/api/stats/rtcstatsreportserializer.h"
+#include "webrtc/rtc_base/bytebuffer.h"
+#include "webrtc/rtc_base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+namespace {
+
+// Creates a report resembling the stats of a PeerConnection with
+// |num_streams| inbound video streams, after |seconds| of receiving.
+rtc::scoped_refptr<RTCStatsReport> CreateReport(int num_streams,
+                                                int seconds) {
+  const int64_t timestamp_us = seconds * rtc::kNumMicrosecsPerSec;
+  rtc::scoped_refptr<RTCStatsReport> report =
+      RTCStatsReport::Create(timestamp_us);
+  for (int i = 0; i < num_streams; ++i) {
+    const std::string index = std::to_string(i);
+    std::unique_ptr<RTCInboundRTPStreamStats> rtp(new RTCInboundRTPStreamStats(
+        "RTCInboundRTPVideoStream_" + index, timestamp_us));
+    rtp->ssrc = 1000u + i;
+    rtp->is_remote = false;
+    rtp->media_type = "video";
+    rtp->track_id = "RTCMediaStreamTrack_remote_video_" + index;
+    rtp->transport_id = "RTCTransport_0_1";
+    rtp->codec_id = "RTCCodec_InboundVideo_96";
+    rtp->fir_count = 0u;
+    rtp->pli_count = static_cast<uint32_t>(seconds / 10);
+    rtp->nack_count = static_cast<uint32_t>(seconds);
+    rtp->packets_received = static_cast<uint32_t>(seconds * 150);
+    rtp->bytes_received = static_cast<uint64_t>(seconds) * 150 * 1100;
+    rtp->packets_lost = static_cast<uint32_t>(seconds / 2);
+    rtp->jitter = 0.002;
+    rtp->fraction_lost = 0.0;
+    rtp->frames_decoded = static_cast<uint32_t>(seconds * 30);
+    report->AddStats(std::move(rtp));
+
+    std::unique_ptr<RTCMediaStreamTrackStats> track(
+        new RTCMediaStreamTrackStats(
+            "RTCMediaStreamTrack_remote_video_" + index, timestamp_us,
+            RTCMediaStreamTrackKind::kVideo));
+    track->track_identifier = "video_" + index;
+    track->remote_source = true;
+    track->ended = false;
+    track->detached = false;
+    track->frame_width = 1280u;
+    track->frame_height = 720u;
+    track->frames_received = static_cast<uint32_t>(seconds * 30);
+    track->frames_decoded = static_cast<uint32_t>(seconds * 30);
+    track->frames_dropped = 0u;
+    report->AddStats(std::move(track));
+  }
+  return report;
+}
+
+int NumIterations() {
+  return field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 10 : 1000;
+}
+
+void PrintTime(const std::string& label, int64_t elapsed_ns) {
+  test::PrintResult("rtc_stats_report_encode_time", "", label,
+                    std::to_string(static_cast<double>(elapsed_ns) /
+                                   (NumIterations() *
+                                    rtc::kNumNanosecsPerMicrosec)),
+                    "us", true);
+}
+
+void PrintSize(const std::string& label, size_t size) {
+  test::PrintResult("rtc_stats_report_encoded_size", "", label,
+                    std::to_string(size), "bytes", true);
+}
+
+// Compares the size and encoding time of |ToString|, the full binary encoding
+// and the binary delta encoding of a report with |num_streams| streams.
+void RunEncodingTest(int num_streams) {
+  rtc::scoped_refptr<RTCStatsReport> previous = CreateReport(num_streams, 10);
+  rtc::scoped_refptr<RTCStatsReport> report = CreateReport(num_streams, 11);
+  const std::string label = std::to_string(num_streams) + "_streams";
+  const int num_iterations = NumIterations();
+
+  size_t string_size = 0;
+  int64_t start_time_ns = rtc::TimeNanos();
+  for (int i = 0; i < num_iterations; ++i)
+    string_size = report->ToString().size();
+  PrintTime(label + "_string", rtc::TimeNanos() - start_time_ns);
+  PrintSize(label + "_string", string_size);
+
+  size_t full_size = 0;
+  start_time_ns = rtc::TimeNanos();
+  for (int i = 0; i < num_iterations; ++i) {
+    rtc::ByteBufferWriter buffer;
+    SerializeRTCStatsReport(*report, nullptr, &buffer);
+    full_size = buffer.Length();
+  }
+  PrintTime(label + "_binary", rtc::TimeNanos() - start_time_ns);
+  PrintSize(label + "_binary", full_size);
+
+  rtc::ByteBufferWriter delta;
+  start_time_ns = rtc::TimeNanos();
+  for (int i = 0; i < num_iterations; ++i) {
+    delta.Clear();
+    SerializeRTCStatsReport(*report, previous.get(), &delta);
+  }
+  PrintTime(label + "_binary_delta", rtc::TimeNanos() - start_time_ns);
+  PrintSize(label + "_binary_delta", delta.Length());
+
+  RTCStatsReportParser parser;
+  start_time_ns = rtc::TimeNanos();
+  for (int i = 0; i < num_iterations; ++i) {
+    ASSERT_TRUE(parser.Parse(delta.Data(), delta.Length(), previous.get()));
+  }
+  test::PrintResult("rtc_stats_report_parse_time", "", label + "_binary_delta",
+                    std::to_string(static_cast<double>(rtc::TimeNanos() -
+                                                       start_time_ns) /
+                                   (num_iterations *
+                                    rtc::kNumNanosecsPerMicrosec)),
+                    "us", true);
+
+  EXPECT_LT(full_size, string_size);
+  EXPECT_LT(delta.Length(), full_size);
+}
+
+}  // namespace
+
+TEST(RTCStatsReportSerializerPerformanceTest, Encode10Streams) {
+  RunEncodingTest(10);
+}
+
+TEST(RTCStatsReportSerializerPerformanceTest, Encode100Streams) {
+  RunEncodingTest(100);
+}
+
+}  // namespace webrtc
@@ -13,6 +13,7 @@
 #include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 #if defined(WEBRTC_ARCH_X86_FAMILY) && defined(_MSC_VER)
+#include <immintrin.h>
 #include <intrin.h>
 #endif
 
@@ -28,23 +29,37 @@ int GetCPUInfoNoASM(CPUFeature feature) {
 #ifndef _MSC_VER
 // Intrinsic for "cpuid".
 #if defined(__pic__) && defined(__i386__)
-static inline void __cpuid(int cpu_info[4], int info_type) {
+static inline void __cpuidex(int cpu_info[4], int info_type, int sub_type) {
   __asm__ volatile(
     "mov %%ebx, %%edi\n"
     "cpuid\n"
     "xchg %%edi, %%ebx\n"
     : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
-    : "a"(info_type));
+    : "a"(info_type), "c"(sub_type));
 }
 #else
-static inline void __cpuid(int cpu_info[4], int info_type) {
+static inline void __cpuidex(int cpu_info[4], int info_type, int sub_type) {
   __asm__ volatile(
     "cpuid\n"
     : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
-    : "a"(info_type));
+    : "a"(info_type), "c"(sub_type));
 }
 #endif
+static inline void __cpuid(int cpu_info[4], int info_type) {
+  __cpuidex(cpu_info, info_type, 0);
+}
 #endif  // _MSC_VER
+
+// Reads the extended control register |xcr|.
+static inline uint64_t XGetBV(uint32_t xcr) {
+#if defined(_MSC_VER)
+  return _xgetbv(xcr);
+#else
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(xcr));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
 #endif  // WEBRTC_ARCH_X86_FAMILY
 
 #if defined(WEBRTC_ARCH_X86_FAMILY)
@@ -58,6 +73,22 @@ static int GetCPUInfo(CPUFeature feature) {
   if (feature == kSSE3) {
     return 0 != (cpu_info[2] & 0x00000001);
   }
+  if (feature == kAVX2) {
+    // AVX2 requires both CPU support and the OS saving the YMM registers on
+    // context switches (OSXSAVE set and XCR0 bits 1 and 2 enabled).
+    const bool has_osxsave = 0 != (cpu_info[2] & 0x08000000);
+    const bool has_avx = 0 != (cpu_info[2] & 0x10000000);
+    if (!has_osxsave || !has_avx || (XGetBV(0) & 0x6) != 0x6) {
+      return 0;
+    }
+    int cpu_info7[4];
+    __cpuid(cpu_info7, 0);
+    if (cpu_info7[0] < 7) {
+      return 0;
+    }
+    __cpuidex(cpu_info7, 7, 0);
+    return 0 != (cpu_info7[1] & 0x00000020);
+  }
   return 0;
 }
 #else
@@ -12,6 +12,7 @@
 #include <stdint.h>
 
 #include "webrtc/api/jsepsessiondescription.h"
+#include "webrtc/rtc_base/checks.h"
 
 namespace webrtc {
 void FuzzOneInput(const uint8_t* data, size_t size) {
@@ -20,6 +21,15 @@ void FuzzOneInput(const uint8_t* data, size_t size) {
 
   std::unique_ptr<webrtc::SessionDescriptionInterface> sdp(
       CreateSessionDescription("offer", message, &error));
+  if (!sdp)
+    return;
+
+  // Serializes what was parsed and parses the result again, so that the
+  // serializer is fuzzed as well.
+  std::string serialized;
+  RTC_CHECK(sdp->ToString(&serialized));
+  std::unique_ptr<webrtc::SessionDescriptionInterface> reparsed(
+      CreateSessionDescription("offer", serialized, &error));
 }
 
 }  // namespace webrtc
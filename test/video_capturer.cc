@@ -10,6 +10,7 @@
 
 #include "webrtc/test/video_capturer.h"
 
+#include "webrtc/api/video/nv12_buffer.h"
 #include "webrtc/rtc_base/basictypes.h"
 #include "webrtc/rtc_base/constructormagic.h"
 
@@ -35,9 +36,20 @@ rtc::Optional<VideoFrame> VideoCapturer::AdaptFrame(const VideoFrame& frame) {
   if (out_height != frame.height() || out_width != frame.width()) {
     // Video adapter has requested a down-scale. Allocate a new buffer and
     // return scaled version.
-    rtc::scoped_refptr<I420Buffer> scaled_buffer =
-        I420Buffer::Create(out_width, out_height);
-    scaled_buffer->ScaleFrom(*frame.video_frame_buffer()->ToI420());
+    rtc::scoped_refptr<VideoFrameBuffer> buffer = frame.video_frame_buffer();
+    rtc::scoped_refptr<VideoFrameBuffer> scaled_buffer;
+    if (buffer->type() == VideoFrameBuffer::Type::kNV12) {
+      // Scale NV12 frames without converting them to I420.
+      rtc::scoped_refptr<NV12Buffer> nv12_buffer =
+          NV12Buffer::Create(out_width, out_height);
+      nv12_buffer->ScaleFrom(*buffer->GetNV12());
+      scaled_buffer = nv12_buffer;
+    } else {
+      rtc::scoped_refptr<I420Buffer> i420_buffer =
+          I420Buffer::Create(out_width, out_height);
+      i420_buffer->ScaleFrom(*buffer->ToI420());
+      scaled_buffer = i420_buffer;
+    }
     out_frame.emplace(
         VideoFrame(scaled_buffer, kVideoRotation_0, frame.timestamp_us()));
   } else {
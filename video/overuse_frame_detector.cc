@@ -72,7 +72,8 @@ CpuOveruseOptions::CpuOveruseOptions()
       frame_timeout_interval_ms(1500),
       min_frame_samples(120),
       min_process_count(3),
-      high_threshold_consecutive_count(2) {
+      high_threshold_consecutive_count(2),
+      use_stage_cpu_time(false) {
 #if defined(WEBRTC_MAC) && !defined(WEBRTC_IOS)
   // This is proof-of-concept code for letting the physical core count affect
   // the interval into which we attempt to scale. For now, the code is Mac OS
@@ -118,7 +119,8 @@ CpuOveruseOptions::CpuOveruseOptions()
 
 // Class for calculating the processing usage on the send-side (the average
 // processing time of a frame divided by the average time difference between
-// captured frames).
+// captured frames). The processing time is either the time from capture to
+// send, or the CPU time of the send-side stages.
 class OveruseFrameDetector::SendProcessingUsage {
  public:
   explicit SendProcessingUsage(const CpuOveruseOptions& options)
@@ -126,21 +128,34 @@ class OveruseFrameDetector::SendProcessingUsage {
         kWeightFactorProcessing(0.995f),
         kInitialSampleDiffMs(40.0f),
         count_(0),
+        stage_count_(0),
         options_(options),
         max_sample_diff_ms_(kDefaultSampleDiffMs * kMaxSampleDiffMarginFactor),
         filtered_processing_ms_(new rtc::ExpFilter(kWeightFactorProcessing)),
-        filtered_frame_diff_ms_(new rtc::ExpFilter(kWeightFactorFrameDiff)) {
+        filtered_frame_diff_ms_(new rtc::ExpFilter(kWeightFactorFrameDiff)),
+        filtered_capture_cpu_ms_(new rtc::ExpFilter(kWeightFactorProcessing)),
+        filtered_scale_cpu_ms_(new rtc::ExpFilter(kWeightFactorProcessing)),
+        filtered_encode_cpu_ms_(new rtc::ExpFilter(kWeightFactorProcessing)) {
     Reset();
   }
   virtual ~SendProcessingUsage() {}
 
   void Reset() {
     count_ = 0;
+    stage_count_ = 0;
     max_sample_diff_ms_ = kDefaultSampleDiffMs * kMaxSampleDiffMarginFactor;
     filtered_frame_diff_ms_->Reset(kWeightFactorFrameDiff);
     filtered_frame_diff_ms_->Apply(1.0f, kInitialSampleDiffMs);
     filtered_processing_ms_->Reset(kWeightFactorProcessing);
     filtered_processing_ms_->Apply(1.0f, InitialProcessingMs());
+    // Attribute the initial usage to encoding, so that the sum of the stages
+    // starts in between the thresholds too.
+    filtered_capture_cpu_ms_->Reset(kWeightFactorProcessing);
+    filtered_capture_cpu_ms_->Apply(1.0f, 0.0f);
+    filtered_scale_cpu_ms_->Reset(kWeightFactorProcessing);
+    filtered_scale_cpu_ms_->Apply(1.0f, 0.0f);
+    filtered_encode_cpu_ms_->Reset(kWeightFactorProcessing);
+    filtered_encode_cpu_ms_->Apply(1.0f, InitialProcessingMs());
   }
 
   void SetMaxSampleDiffMs(float diff_ms) { max_sample_diff_ms_ = diff_ms; }
@@ -158,18 +173,53 @@ class OveruseFrameDetector::SendProcessingUsage {
     filtered_processing_ms_->Apply(exp, processing_ms);
   }
 
+  void AddStageSample(const FrameStageCpuTimes& cpu_times,
+                      int64_t diff_last_sample_ms) {
+    ++stage_count_;
+    float exp = diff_last_sample_ms / kDefaultSampleDiffMs;
+    exp = std::min(exp, kMaxExp);
+    filtered_capture_cpu_ms_->Apply(exp, 1e-3f * cpu_times.capture_us);
+    filtered_scale_cpu_ms_->Apply(exp, 1e-3f * cpu_times.scale_us);
+    filtered_encode_cpu_ms_->Apply(exp, 1e-3f * cpu_times.encode_us);
+  }
+
   virtual int Value() {
+    if (options_.use_stage_cpu_time) {
+      if (stage_count_ < static_cast<uint32_t>(options_.min_frame_samples))
+        return static_cast<int>(InitialUsageInPercent() + 0.5f);
+      return static_cast<int>(
+          UsagePercent(filtered_capture_cpu_ms_->filtered() +
+                       filtered_scale_cpu_ms_->filtered() +
+                       filtered_encode_cpu_ms_->filtered()) +
+          0.5f);
+    }
     if (count_ < static_cast<uint32_t>(options_.min_frame_samples)) {
       return static_cast<int>(InitialUsageInPercent() + 0.5f);
     }
+    return static_cast<int>(
+        UsagePercent(filtered_processing_ms_->filtered()) + 0.5f);
+  }
+
+  // Fills in the per-stage usage of |metrics|, or leaves it at -1 until there
+  // are enough samples.
+  void GetStageUsage(CpuOveruseMetrics* metrics) const {
+    if (stage_count_ < static_cast<uint32_t>(options_.min_frame_samples))
+      return;
+    metrics->capture_cpu_usage_percent = static_cast<int>(
+        UsagePercent(filtered_capture_cpu_ms_->filtered()) + 0.5f);
+    metrics->scale_cpu_usage_percent = static_cast<int>(
+        UsagePercent(filtered_scale_cpu_ms_->filtered()) + 0.5f);
+    metrics->encode_cpu_usage_percent = static_cast<int>(
+        UsagePercent(filtered_encode_cpu_ms_->filtered()) + 0.5f);
+  }
+
+ private:
+  float UsagePercent(float processing_ms) const {
     float frame_diff_ms = std::max(filtered_frame_diff_ms_->filtered(), 1.0f);
     frame_diff_ms = std::min(frame_diff_ms, max_sample_diff_ms_);
-    float encode_usage_percent =
-        100.0f * filtered_processing_ms_->filtered() / frame_diff_ms;
-    return static_cast<int>(encode_usage_percent + 0.5);
+    return 100.0f * processing_ms / frame_diff_ms;
   }
 
- private:
   float InitialUsageInPercent() const {
     // Start in between the underuse and overuse threshold.
     return (options_.low_encode_usage_threshold_percent +
@@ -184,10 +234,14 @@ class OveruseFrameDetector::SendProcessingUsage {
   const float kWeightFactorProcessing;
   const float kInitialSampleDiffMs;
   uint64_t count_;
+  uint64_t stage_count_;
   const CpuOveruseOptions options_;
   float max_sample_diff_ms_;
   std::unique_ptr<rtc::ExpFilter> filtered_processing_ms_;
   std::unique_ptr<rtc::ExpFilter> filtered_frame_diff_ms_;
+  std::unique_ptr<rtc::ExpFilter> filtered_capture_cpu_ms_;
+  std::unique_ptr<rtc::ExpFilter> filtered_scale_cpu_ms_;
+  std::unique_ptr<rtc::ExpFilter> filtered_encode_cpu_ms_;
 };
 
 // Class used for manual testing of overuse, enabled via field trial flag.
@@ -345,6 +399,7 @@ OveruseFrameDetector::OveruseFrameDetector(
       // TODO(nisse): Use rtc::Optional
       last_capture_time_us_(-1),
       last_processed_capture_time_us_(-1),
+      last_stage_sample_time_us_(-1),
       num_pixels_(0),
       max_framerate_(kDefaultFrameRate),
       last_overuse_time_ms_(-1),
@@ -406,6 +461,7 @@ void OveruseFrameDetector::ResetAll(int num_pixels) {
   frame_timing_.clear();
   last_capture_time_us_ = -1;
   last_processed_capture_time_us_ = -1;
+  last_stage_sample_time_us_ = -1;
   num_process_times_ = 0;
   metrics_ = rtc::Optional<CpuOveruseMetrics>();
   OnTargetFramerateUpdated(max_framerate_);
@@ -487,11 +543,34 @@ void OveruseFrameDetector::FrameSent(uint32_t timestamp,
   }
 }
 
+void OveruseFrameDetector::FrameStagesProcessed(
+    const FrameStageCpuTimes& cpu_times,
+    int64_t time_when_first_seen_us) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&task_checker_);
+  if (last_stage_sample_time_us_ != -1) {
+    usage_->AddStageSample(
+        cpu_times,
+        1e-3 * (time_when_first_seen_us - last_stage_sample_time_us_));
+  }
+  last_stage_sample_time_us_ = time_when_first_seen_us;
+
+  if (!metrics_)
+    metrics_ = rtc::Optional<CpuOveruseMetrics>(CpuOveruseMetrics());
+  usage_->GetStageUsage(&*metrics_);
+  // The encode time based usage is updated when frames are sent; the CPU time
+  // based one is available right away.
+  if (options_.use_stage_cpu_time)
+    metrics_->encode_usage_percent = usage_->Value();
+}
+
 void OveruseFrameDetector::CheckForOveruse() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&task_checker_);
   ++num_process_times_;
   if (num_process_times_ <= options_.min_process_count || !metrics_)
     return;
+  // The stage usages can arrive before the first encode usage is measured.
+  if (metrics_->encode_usage_percent < 0)
+    return;
 
   int64_t now_ms = rtc::TimeMillis();
 
@@ -533,6 +612,9 @@ void OveruseFrameDetector::CheckForOveruse() {
 
   LOG(LS_VERBOSE) << " Frame stats: "
                   << " encode usage " << metrics_->encode_usage_percent
+                  << " capture cpu " << metrics_->capture_cpu_usage_percent
+                  << " scale cpu " << metrics_->scale_cpu_usage_percent
+                  << " encode cpu " << metrics_->encode_cpu_usage_percent
                   << " overuse detections " << num_overuse_detections_
                   << " rampup delay " << rampup_delay;
 }
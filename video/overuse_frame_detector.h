@@ -41,13 +41,40 @@ struct CpuOveruseOptions {
   int high_threshold_consecutive_count;  // The number of consecutive checks
                                          // above the high threshold before
                                          // triggering an overuse.
+  // If true, the usage compared against the thresholds is the CPU time spent
+  // per frame in the send-side stages (see FrameStageCpuTimes), rather than
+  // the wall-clock time from capture to send. CPU time does not grow when the
+  // encoder thread waits, e.g. for other processes competing for the cores.
+  bool use_stage_cpu_time;
 };
 
 struct CpuOveruseMetrics {
-  CpuOveruseMetrics() : encode_usage_percent(-1) {}
+  CpuOveruseMetrics()
+      : encode_usage_percent(-1),
+        capture_cpu_usage_percent(-1),
+        scale_cpu_usage_percent(-1),
+        encode_cpu_usage_percent(-1) {}
 
   int encode_usage_percent;  // Average encode time divided by the average time
                              // difference between incoming captured frames.
+                             // With CpuOveruseOptions::use_stage_cpu_time, the
+                             // sum of the stage usages below.
+  // Average CPU time per frame of each send-side stage, divided by the average
+  // time difference between incoming captured frames. -1 until measured.
+  int capture_cpu_usage_percent;
+  int scale_cpu_usage_percent;
+  int encode_cpu_usage_percent;
+};
+
+// CPU time spent on one frame by the send-side stages, each measured with
+// rtc::GetThreadCpuTimeNanos() on the thread running the stage.
+struct FrameStageCpuTimes {
+  // Handing the frame from the capture thread over to the encoder.
+  int64_t capture_us = 0;
+  // Cropping or scaling the frame to the encoder resolution.
+  int64_t scale_us = 0;
+  // Encoding the frame, as far as it is done on the encoder thread.
+  int64_t encode_us = 0;
 };
 
 class CpuOveruseMetricsObserver {
@@ -90,6 +117,11 @@ class OveruseFrameDetector {
   // Called for each sent frame.
   void FrameSent(uint32_t timestamp, int64_t time_sent_in_us);
 
+  // Called for each frame passed to the encoder, after FrameCaptured(), with
+  // the CPU time spent on it in each stage.
+  void FrameStagesProcessed(const FrameStageCpuTimes& cpu_times,
+                            int64_t time_when_first_seen_us);
+
  protected:
   void CheckForOveruse();  // Protected for test purposes.
 
@@ -139,6 +171,7 @@ class OveruseFrameDetector {
 
   int64_t last_capture_time_us_ GUARDED_BY(task_checker_);
   int64_t last_processed_capture_time_us_ GUARDED_BY(task_checker_);
+  int64_t last_stage_sample_time_us_ GUARDED_BY(task_checker_);
 
   // Number of pixels of last captured frame.
   int num_pixels_ GUARDED_BY(task_checker_);
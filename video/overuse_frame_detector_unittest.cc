@@ -110,6 +110,28 @@ class OveruseFrameDetectorTest : public ::testing::Test,
     }
   }
 
+  // Like InsertAndSendFramesWithInterval(), but also reports |cpu_times| for
+  // each frame, as ViEEncoder does after encoding it.
+  void InsertAndSendFramesWithStageCpuTimes(
+      int num_frames,
+      int interval_us,
+      int delay_us,
+      const FrameStageCpuTimes& cpu_times) {
+    VideoFrame frame(I420Buffer::Create(kWidth, kHeight),
+                     webrtc::kVideoRotation_0, 0);
+    uint32_t timestamp = 0;
+    while (num_frames-- > 0) {
+      frame.set_timestamp(timestamp);
+      const int64_t capture_time_us = rtc::TimeMicros();
+      overuse_detector_->FrameCaptured(frame, capture_time_us);
+      overuse_detector_->FrameStagesProcessed(cpu_times, capture_time_us);
+      clock_.AdvanceTimeMicros(delay_us);
+      overuse_detector_->FrameSent(timestamp, rtc::TimeMicros());
+      clock_.AdvanceTimeMicros(interval_us - delay_us);
+      timestamp += interval_us * 90 / 1000;
+    }
+  }
+
   void ForceUpdate(int width, int height) {
     // Insert one frame, wait a second and then put in another to force update
     // the usage. From the tests where these are used, adding another sample
@@ -480,4 +502,87 @@ TEST_F(OveruseFrameDetectorTest, LimitsMaxFrameInterval) {
   }
 }
 
+TEST_F(OveruseFrameDetectorTest, ReportsStageCpuUsage) {
+  FrameStageCpuTimes cpu_times;
+  cpu_times.capture_us = 330;
+  cpu_times.scale_us = 1650;
+  cpu_times.encode_us = 10000;
+  InsertAndSendFramesWithStageCpuTimes(1000, kFrameIntervalUs, kProcessTimeUs,
+                                       cpu_times);
+  EXPECT_EQ(1, metrics_.capture_cpu_usage_percent);
+  EXPECT_EQ(5, metrics_.scale_cpu_usage_percent);
+  EXPECT_EQ(30, metrics_.encode_cpu_usage_percent);
+  // The encode time still drives the usage unless configured otherwise.
+  EXPECT_EQ(kProcessTimeUs * 100 / kFrameIntervalUs, UsagePercent());
+}
+
+TEST_F(OveruseFrameDetectorTest, StageCpuUsageUnknownUntilEnoughSamples) {
+  InsertAndSendFramesWithStageCpuTimes(
+      options_.min_frame_samples - 1, kFrameIntervalUs, kProcessTimeUs,
+      FrameStageCpuTimes());
+  ForceUpdate(kWidth, kHeight);
+  EXPECT_EQ(-1, metrics_.capture_cpu_usage_percent);
+  EXPECT_EQ(-1, metrics_.scale_cpu_usage_percent);
+  EXPECT_EQ(-1, metrics_.encode_cpu_usage_percent);
+}
+
+TEST_F(OveruseFrameDetectorTest, NoAdaptationWithoutEncodeUsage) {
+  // The stage CPU times are reported before the frames are sent, so the
+  // detector can have stage usages while the encode usage is still unknown.
+  VideoFrame frame(I420Buffer::Create(kWidth, kHeight),
+                   webrtc::kVideoRotation_0, 0);
+  for (int i = 0; i < 2; ++i) {
+    const int64_t capture_time_us = rtc::TimeMicros();
+    overuse_detector_->FrameCaptured(frame, capture_time_us);
+    overuse_detector_->FrameStagesProcessed(FrameStageCpuTimes(),
+                                            capture_time_us);
+    clock_.AdvanceTimeMicros(kFrameIntervalUs);
+  }
+  EXPECT_CALL(*(observer_.get()), AdaptUp(reason_)).Times(0);
+  EXPECT_CALL(*(observer_.get()), AdaptDown(reason_)).Times(0);
+  overuse_detector_->CheckForOveruse();
+}
+
+TEST_F(OveruseFrameDetectorTest, StageCpuTimeTriggersOveruseAndRecover) {
+  options_.use_stage_cpu_time = true;
+  ReinitializeOveruseDetector();
+  // The frames are sent quickly, but take most of a core to get there, e.g.
+  // when the encoder runs at full speed on an otherwise idle machine.
+  FrameStageCpuTimes cpu_times;
+  cpu_times.scale_us = 4 * rtc::kNumMicrosecsPerMillisec;
+  cpu_times.encode_us = 28 * rtc::kNumMicrosecsPerMillisec;
+  EXPECT_CALL(*(observer_.get()), AdaptDown(reason_)).Times(1);
+  for (int i = 0; i < options_.high_threshold_consecutive_count; ++i) {
+    InsertAndSendFramesWithStageCpuTimes(1000, kFrameIntervalUs,
+                                         kProcessTimeUs, cpu_times);
+    overuse_detector_->CheckForOveruse();
+  }
+  EXPECT_EQ(97, UsagePercent());
+
+  cpu_times.scale_us = 1 * rtc::kNumMicrosecsPerMillisec;
+  cpu_times.encode_us = 4 * rtc::kNumMicrosecsPerMillisec;
+  EXPECT_CALL(*(observer_.get()), AdaptUp(reason_)).Times(testing::AtLeast(1));
+  InsertAndSendFramesWithStageCpuTimes(1300, kFrameIntervalUs, kProcessTimeUs,
+                                       cpu_times);
+  overuse_detector_->CheckForOveruse();
+}
+
+TEST_F(OveruseFrameDetectorTest, StageCpuTimeIgnoresWaitingForTheCpu) {
+  options_.use_stage_cpu_time = true;
+  ReinitializeOveruseDetector();
+  // Each frame takes 32 ms from capture to send, which is an overuse when
+  // measuring encode time, but only a fraction of that is spent on the CPU by
+  // the send-side stages, e.g. when other processes compete for the cores.
+  const int kDelayUs = 32 * rtc::kNumMicrosecsPerMillisec;
+  FrameStageCpuTimes cpu_times;
+  cpu_times.encode_us = 10 * rtc::kNumMicrosecsPerMillisec;
+  EXPECT_CALL(*(observer_.get()), AdaptDown(reason_)).Times(0);
+  for (int i = 0; i < options_.high_threshold_consecutive_count; ++i) {
+    InsertAndSendFramesWithStageCpuTimes(1000, kFrameIntervalUs, kDelayUs,
+                                         cpu_times);
+    overuse_detector_->CheckForOveruse();
+  }
+  EXPECT_EQ(30, UsagePercent());
+}
+
 }  // namespace webrtc
@@ -484,6 +484,9 @@ void SendStatisticsProxy::OnEncodedFrameTimeMeasured(
   encode_time_.Apply(1.0f, encode_time_ms);
   stats_.avg_encode_time_ms = round(encode_time_.filtered());
   stats_.encode_usage_percent = metrics.encode_usage_percent;
+  stats_.capture_cpu_usage_percent = metrics.capture_cpu_usage_percent;
+  stats_.scale_cpu_usage_percent = metrics.scale_cpu_usage_percent;
+  stats_.encode_cpu_usage_percent = metrics.encode_cpu_usage_percent;
   TRACE_EVENT_INSTANT2("webrtc_stats", "WebRTC.Video.EncodeTimeInMs",
       "encode_time_ms", stats_.avg_encode_time_ms,
       "ssrc", rtp_config_.ssrcs[0]);
@@ -322,6 +322,21 @@ TEST_F(SendStatisticsProxyTest, OnEncodedFrameTimeMeasured) {
   VideoSendStream::Stats stats = statistics_proxy_->GetStats();
   EXPECT_EQ(kEncodeTimeMs, stats.avg_encode_time_ms);
   EXPECT_EQ(metrics.encode_usage_percent, stats.encode_usage_percent);
+  EXPECT_EQ(-1, stats.capture_cpu_usage_percent);
+}
+
+TEST_F(SendStatisticsProxyTest, OnEncodedFrameTimeMeasuredWithStageCpuUsage) {
+  CpuOveruseMetrics metrics;
+  metrics.encode_usage_percent = 40;
+  metrics.capture_cpu_usage_percent = 2;
+  metrics.scale_cpu_usage_percent = 8;
+  metrics.encode_cpu_usage_percent = 30;
+  statistics_proxy_->OnEncodedFrameTimeMeasured(11, metrics);
+
+  VideoSendStream::Stats stats = statistics_proxy_->GetStats();
+  EXPECT_EQ(2, stats.capture_cpu_usage_percent);
+  EXPECT_EQ(8, stats.scale_cpu_usage_percent);
+  EXPECT_EQ(30, stats.encode_cpu_usage_percent);
 }
 
 TEST_F(SendStatisticsProxyTest, OnEncoderReconfiguredChangePreferredBitrate) {
@@ -50,6 +50,10 @@ std::string VideoReceiveStream::Decoder::ToString() const {
   for (const auto& it : codec_params)
     ss << it.first << ": " << it.second;
   ss << '}';
+  ss << ", threading: {mode: " << static_cast<int>(threading.mode);
+  ss << ", max_threads: " << threading.max_threads;
+  ss << ", max_latency_frames: " << threading.max_latency_frames;
+  ss << '}';
   ss << '}';
 
   return ss.str();
@@ -157,6 +161,8 @@ VideoCodec CreateDecoderVideoCodec(const VideoReceiveStream::Decoder& decoder) {
         H264::ParseSdpProfileLevelId(decoder.codec_params)->profile;
   }
 
+  codec.decoder_threading = decoder.threading;
+
   codec.width = 320;
   codec.height = 180;
   const int kDefaultStartBitrate = 300;
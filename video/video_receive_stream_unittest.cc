@@ -83,6 +83,7 @@ class VideoReceiveStreamTest : public testing::Test {
     h264_decoder.codec_params.insert(
         {"sprop-parameter-sets", "Z0IACpZTBYmI,aMljiA=="});
     h264_decoder.decoder = &mock_h264_video_decoder_;
+    h264_decoder.threading = {VideoDecoderThreading::kSlice, 2, 0};
     config_.decoders.push_back(h264_decoder);
     VideoReceiveStream::Decoder null_decoder;
     null_decoder.payload_type = 98;
@@ -123,6 +124,9 @@ TEST_F(VideoReceiveStreamTest, CreateFrameFromH264FmtpSpropAndIdr) {
   EXPECT_CALL(mock_h264_video_decoder_, InitDecode(_, _))
       .WillOnce(Invoke([&init_decode_event_](const VideoCodec* config,
                                              int32_t number_of_cores) {
+        EXPECT_EQ(VideoDecoderThreading::kSlice,
+                  config->decoder_threading.mode);
+        EXPECT_EQ(2, config->decoder_threading.max_threads);
         init_decode_event_.Set();
         return 0;
       }));
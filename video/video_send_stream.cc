@@ -153,6 +153,8 @@ VideoSendStream::Config::EncoderSettings::ToString() const {
   ss << "{payload_name: " << payload_name;
   ss << ", payload_type: " << payload_type;
   ss << ", encoder: " << (encoder ? "(VideoEncoder)" : "nullptr");
+  ss << ", pipelined_packetization: "
+     << (pipelined_packetization ? "true" : "false");
   ss << '}';
   return ss.str();
 }
@@ -236,6 +238,9 @@ std::string VideoSendStream::Stats::ToString(int64_t time_ms) const {
   ss << "encode_fps: " << encode_frame_rate << ", ";
   ss << "encode_ms: " << avg_encode_time_ms << ", ";
   ss << "encode_usage_perc: " << encode_usage_percent << ", ";
+  ss << "capture_cpu_perc: " << capture_cpu_usage_percent << ", ";
+  ss << "scale_cpu_perc: " << scale_cpu_usage_percent << ", ";
+  ss << "encode_cpu_perc: " << encode_cpu_usage_percent << ", ";
   ss << "target_bps: " << target_media_bitrate_bps << ", ";
   ss << "media_bps: " << media_bitrate_bps << ", ";
   ss << "preferred_media_bitrate_bps: " << preferred_media_bitrate_bps << ", ";
@@ -8,7 +8,9 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 #include <algorithm>  // max
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "webrtc/call/call.h"
@@ -25,6 +27,7 @@
 #include "webrtc/rtc_base/criticalsection.h"
 #include "webrtc/rtc_base/event.h"
 #include "webrtc/rtc_base/logging.h"
+#include "webrtc/rtc_base/optional.h"
 #include "webrtc/rtc_base/platform_thread.h"
 #include "webrtc/rtc_base/rate_limiter.h"
 #include "webrtc/rtc_base/timeutils.h"
@@ -63,6 +66,8 @@ class VideoSendStreamTest : public test::CallTest {
                           uint8_t num_spatial_layers);
 
   void TestRequestSourceRotateVideo(bool support_orientation_ext);
+
+  void TestCaptureToSendLatency(bool pipelined_packetization);
 };
 
 TEST_F(VideoSendStreamTest, CanStartStartedStream) {
@@ -374,6 +379,128 @@ TEST_F(VideoSendStreamTest, SupportsVideoTimingFrames) {
   RunBaseTest(&test);
 }
 
+// Sends 60 fps video with FEC through an encoder that takes half the frame
+// interval, and reports the time from capture until the last packet of each
+// frame has been sent.
+void VideoSendStreamTest::TestCaptureToSendLatency(
+    bool pipelined_packetization) {
+  static const int kFramerate = 60;
+  static const int kEncodeDelayMs = 8;
+  static const int kBitrateBps = 15000000;
+  static const size_t kNumFrames = 180;
+  class LatencyObserver : public test::SendTest,
+                          public rtc::VideoSinkInterface<VideoFrame> {
+   public:
+    explicit LatencyObserver(bool pipelined_packetization)
+        : SendTest(kDefaultTimeoutMs),
+          pipelined_packetization_(pipelined_packetization),
+          clock_(Clock::GetRealTimeClock()),
+          encoder_(clock_, kEncodeDelayMs) {}
+
+   private:
+    // Called before each frame is encoded.
+    void OnFrame(const VideoFrame& frame) override {
+      rtc::CritScope lock(&crit_);
+      capture_times_ms_[frame.timestamp()] = frame.render_time_ms();
+    }
+
+    Action OnSendRtp(const uint8_t* packet, size_t length) override {
+      RTPHeader header;
+      EXPECT_TRUE(parser_->Parse(packet, length, &header));
+      if (!header.markerBit)
+        return SEND_PACKET;
+      const int64_t now_ms = clock_->TimeInMilliseconds();
+      rtc::CritScope lock(&crit_);
+      // The RTP timestamps have a random offset from those of the frames.
+      // The first frame is always sent, so use it to find the offset.
+      if (!timestamp_offset_ && !capture_times_ms_.empty()) {
+        timestamp_offset_.emplace(header.timestamp -
+                                  capture_times_ms_.begin()->first);
+      }
+      if (!timestamp_offset_)
+        return SEND_PACKET;
+      auto it = capture_times_ms_.find(header.timestamp - *timestamp_offset_);
+      if (it == capture_times_ms_.end())
+        return SEND_PACKET;
+      latencies_ms_.push_back(now_ms - it->second);
+      capture_times_ms_.erase(capture_times_ms_.begin(), ++it);
+      if (latencies_ms_.size() == kNumFrames)
+        observation_complete_.Set();
+      return SEND_PACKET;
+    }
+
+    Call::Config GetSenderCallConfig() override {
+      Call::Config config = SendTest::GetSenderCallConfig();
+      config.bitrate_config.start_bitrate_bps = kBitrateBps;
+      config.bitrate_config.max_bitrate_bps = kBitrateBps;
+      return config;
+    }
+
+    void ModifyVideoConfigs(
+        VideoSendStream::Config* send_config,
+        std::vector<VideoReceiveStream::Config>* receive_configs,
+        VideoEncoderConfig* encoder_config) override {
+      send_config->encoder_settings.encoder = &encoder_;
+      send_config->encoder_settings.pipelined_packetization =
+          pipelined_packetization_;
+      send_config->pre_encode_callback = this;
+      send_config->rtp.ulpfec.red_payload_type = kRedPayloadType;
+      send_config->rtp.ulpfec.ulpfec_payload_type = kUlpfecPayloadType;
+      encoder_config->max_bitrate_bps = kBitrateBps;
+    }
+
+    void ModifyVideoCaptureStartResolution(int* width,
+                                           int* height,
+                                           int* frame_rate) override {
+      *width = 1280;
+      *height = 720;
+      *frame_rate = kFramerate;
+    }
+
+    void PerformTest() override {
+      EXPECT_TRUE(Wait()) << "Timed out while waiting for frames to be sent.";
+      rtc::CritScope lock(&crit_);
+      ASSERT_FALSE(latencies_ms_.empty());
+      std::vector<int64_t> sorted_latencies_ms = latencies_ms_;
+      std::sort(sorted_latencies_ms.begin(), sorted_latencies_ms.end());
+      int64_t sum_ms = 0;
+      for (int64_t latency_ms : sorted_latencies_ms)
+        sum_ms += latency_ms;
+      const std::string label =
+          pipelined_packetization_ ? "pipelined" : "not_pipelined";
+      test::PrintResult(
+          "capture_to_send_latency", "", label,
+          std::to_string(static_cast<double>(sum_ms) /
+                         sorted_latencies_ms.size()),
+          "ms", true);
+      test::PrintResult(
+          "capture_to_send_latency_p95", "", label,
+          std::to_string(
+              sorted_latencies_ms[sorted_latencies_ms.size() * 95 / 100]),
+          "ms", false);
+    }
+
+    const bool pipelined_packetization_;
+    Clock* const clock_;
+    test::DelayedEncoder encoder_;
+    rtc::CriticalSection crit_;
+    // Capture time of the frames that have not been sent yet, by timestamp.
+    std::map<uint32_t, int64_t> capture_times_ms_ GUARDED_BY(crit_);
+    rtc::Optional<uint32_t> timestamp_offset_ GUARDED_BY(crit_);
+    std::vector<int64_t> latencies_ms_ GUARDED_BY(crit_);
+  } test(pipelined_packetization);
+
+  RunBaseTest(&test);
+}
+
+TEST_F(VideoSendStreamTest, CaptureToSendLatencyAt60Fps) {
+  TestCaptureToSendLatency(false);
+}
+
+TEST_F(VideoSendStreamTest, CaptureToSendLatencyAt60FpsWhenPipelined) {
+  TestCaptureToSendLatency(true);
+}
+
 class FakeReceiveStatistics : public NullReceiveStatistics {
  public:
   FakeReceiveStatistics(uint32_t send_ssrc,
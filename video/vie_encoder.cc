@@ -10,12 +10,17 @@
 
 #include "webrtc/video/vie_encoder.h"
 
+#include <stdio.h>
+#include <string.h>
+
 #include <algorithm>
 #include <limits>
 #include <numeric>
+#include <string>
 #include <utility>
 
 #include "webrtc/api/video/i420_buffer.h"
+#include "webrtc/api/video/nv12_buffer.h"
 #include "webrtc/common_video/include/video_bitrate_allocator.h"
 #include "webrtc/common_video/include/video_frame.h"
 #include "webrtc/modules/pacing/paced_sender.h"
@@ -25,10 +30,12 @@
 #include "webrtc/modules/video_coding/include/video_coding_defines.h"
 #include "webrtc/rtc_base/arraysize.h"
 #include "webrtc/rtc_base/checks.h"
+#include "webrtc/rtc_base/cpu_time.h"
 #include "webrtc/rtc_base/location.h"
 #include "webrtc/rtc_base/logging.h"
 #include "webrtc/rtc_base/timeutils.h"
 #include "webrtc/rtc_base/trace_event.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 #include "webrtc/video/overuse_frame_detector.h"
 #include "webrtc/video/send_statistics_proxy.h"
 
@@ -51,6 +58,16 @@ const int kMaxFramerateFps = 120;
 // to try and achieve desired bitrate.
 const int kMaxInitialFramedrop = 4;
 
+const char kStageCpuTimeOveruseFieldTrial[] = "WebRTC-StageCpuTimeOveruse";
+
+// Returns the CPU time between two rtc::GetThreadCpuTimeNanos() readings in
+// microseconds, or -1 if the platform doesn't support reading it.
+int64_t CpuTimeDeltaUs(int64_t start_cpu_time_ns, int64_t end_cpu_time_ns) {
+  if (start_cpu_time_ns == -1 || end_cpu_time_ns == -1)
+    return -1;
+  return (end_cpu_time_ns - start_cpu_time_ns) / rtc::kNumNanosecsPerMicrosec;
+}
+
 uint32_t MaximumFrameSizeForBitrate(uint32_t kbps) {
   if (kbps > 0) {
     if (kbps < 300 /* qvga */) {
@@ -132,10 +149,12 @@ class ViEEncoder::EncodeTask : public rtc::QueuedTask {
   EncodeTask(const VideoFrame& frame,
              ViEEncoder* vie_encoder,
              int64_t time_when_posted_us,
+             int64_t capture_cpu_time_us,
              bool log_stats)
       : frame_(frame),
         vie_encoder_(vie_encoder),
         time_when_posted_us_(time_when_posted_us),
+        capture_cpu_time_us_(capture_cpu_time_us),
         log_stats_(log_stats) {
     ++vie_encoder_->posted_frames_waiting_for_encode_;
   }
@@ -148,12 +167,14 @@ class ViEEncoder::EncodeTask : public rtc::QueuedTask {
                                                 frame_.height());
     ++vie_encoder_->captured_frame_count_;
     if (--vie_encoder_->posted_frames_waiting_for_encode_ == 0) {
-      vie_encoder_->EncodeVideoFrame(frame_, time_when_posted_us_);
+      vie_encoder_->EncodeVideoFrame(frame_, time_when_posted_us_,
+                                     capture_cpu_time_us_);
     } else {
       // There is a newer frame in flight. Do not encode this frame.
       LOG(LS_VERBOSE)
           << "Incoming frame dropped due to that the encoder is blocked.";
       ++vie_encoder_->dropped_frame_count_;
+      vie_encoder_->AccumulateDroppedFrameUpdateRects(frame_);
     }
     if (log_stats_) {
       LOG(LS_INFO) << "Number of frames: captured "
@@ -169,9 +190,52 @@ class ViEEncoder::EncodeTask : public rtc::QueuedTask {
   VideoFrame frame_;
   ViEEncoder* const vie_encoder_;
   const int64_t time_when_posted_us_;
+  const int64_t capture_cpu_time_us_;
   const bool log_stats_;
 };
 
+// Owns a copy of an encoded frame, which the encoder may overwrite as soon as
+// OnEncodedImage() returns, until it has been sent on |packetization_queue_|.
+class ViEEncoder::PacketizeTask : public rtc::QueuedTask {
+ public:
+  PacketizeTask(ViEEncoder* vie_encoder,
+                const EncodedImage& encoded_image,
+                const CodecSpecificInfo* codec_specific_info,
+                const RTPFragmentationHeader* fragmentation)
+      : vie_encoder_(vie_encoder),
+        encoded_image_(encoded_image),
+        buffer_(new uint8_t[encoded_image._length]),
+        has_codec_specific_info_(codec_specific_info != nullptr),
+        has_fragmentation_(fragmentation != nullptr) {
+    memcpy(buffer_.get(), encoded_image._buffer, encoded_image._length);
+    encoded_image_._buffer = buffer_.get();
+    encoded_image_._size = encoded_image._length;
+    if (codec_specific_info)
+      codec_specific_info_ = *codec_specific_info;
+    if (fragmentation)
+      fragmentation_.CopyFrom(*fragmentation);
+  }
+
+ private:
+  bool Run() override {
+    RTC_DCHECK(vie_encoder_->packetization_queue_->IsCurrent());
+    const EncodedImageCallback::Result result = vie_encoder_->SendEncodedImage(
+        encoded_image_,
+        has_codec_specific_info_ ? &codec_specific_info_ : nullptr,
+        has_fragmentation_ ? &fragmentation_ : nullptr);
+    vie_encoder_->OnFramePacketized(result);
+    return true;
+  }
+
+  ViEEncoder* const vie_encoder_;
+  EncodedImage encoded_image_;
+  const std::unique_ptr<uint8_t[]> buffer_;
+  const bool has_codec_specific_info_;
+  CodecSpecificInfo codec_specific_info_;
+  const bool has_fragmentation_;
+  RTPFragmentationHeader fragmentation_;
+};
+
 // VideoSourceProxy is responsible ensuring thread safety between calls to
 // ViEEncoder::SetSource that will happen on libjingle's worker thread when a
 // video capturer is connected to the encoder and the encoder task queue
@@ -417,8 +481,17 @@ ViEEncoder::ViEEncoder(uint32_t number_of_cores,
       last_frame_log_ms_(clock_->TimeInMilliseconds()),
       captured_frame_count_(0),
       dropped_frame_count_(0),
+      dropped_frame_without_update_rects_(false),
+      frame_being_encoded_(nullptr),
       bitrate_observer_(nullptr),
-      encoder_queue_("EncoderQueue") {
+      pending_packetization_frames_(0),
+      last_packetization_error_(EncodedImageCallback::Result::OK),
+      packetization_drop_next_frame_(false),
+      packetization_done_event_(false /* manual_reset */, false),
+      encoder_queue_("EncoderQueue"),
+      packetization_queue_(settings.pipelined_packetization
+                               ? new rtc::TaskQueue("PacketizationQueue")
+                               : nullptr) {
   RTC_DCHECK(stats_proxy);
   encoder_queue_.PostTask([this] {
     RTC_DCHECK_RUN_ON(&encoder_queue_);
@@ -444,6 +517,25 @@ CpuOveruseOptions ViEEncoder::GetCpuOveruseOptions(bool full_overuse_time) {
     options.low_encode_usage_threshold_percent = 150;
     options.high_encode_usage_threshold_percent = 200;
   }
+  // Adapt on the CPU time of the send-side stages. The thresholds can be
+  // overridden with "Enabled-<low>-<high>", in percent of one core.
+  const std::string group =
+      field_trial::FindFullName(kStageCpuTimeOveruseFieldTrial);
+  if (group.find("Enabled") == 0) {
+    options.use_stage_cpu_time = true;
+    int low_percent = 0;
+    int high_percent = 0;
+    if (sscanf(group.c_str(), "Enabled-%d-%d", &low_percent,
+               &high_percent) == 2) {
+      if (low_percent > 0 && low_percent < high_percent) {
+        options.low_encode_usage_threshold_percent = low_percent;
+        options.high_encode_usage_threshold_percent = high_percent;
+      } else {
+        LOG(LS_WARNING) << "Invalid thresholds for "
+                        << kStageCpuTimeOveruseFieldTrial << ": " << group;
+      }
+    }
+  }
   return options;
 }
 
@@ -462,6 +554,13 @@ void ViEEncoder::Stop() {
   });
 
   shutdown_event_.Wait(rtc::Event::kForever);
+
+  if (packetization_queue_) {
+    // Send the frames that were encoded before the encoder was released.
+    rtc::Event flushed_event(false, false);
+    packetization_queue_->PostTask([&flushed_event] { flushed_event.Set(); });
+    flushed_event.Wait(rtc::Event::kForever);
+  }
 }
 
 void ViEEncoder::RegisterProcessThread(ProcessThread* module_process_thread) {
@@ -672,6 +771,7 @@ void ViEEncoder::ConfigureQualityScaler() {
 
 void ViEEncoder::OnFrame(const VideoFrame& video_frame) {
   RTC_DCHECK_RUNS_SERIALIZED(&incoming_frame_race_checker_);
+  const int64_t start_cpu_time_ns = rtc::GetThreadCpuTimeNanos();
   VideoFrame incoming_frame = video_frame;
 
   // Local time in webrtc time base.
@@ -706,6 +806,10 @@ void ViEEncoder::OnFrame(const VideoFrame& video_frame) {
                     << incoming_frame.ntp_time_ms()
                     << " <= " << last_captured_timestamp_
                     << ") for incoming frame. Dropping.";
+    encoder_queue_.PostTask([this] {
+      RTC_DCHECK_RUN_ON(&encoder_queue_);
+      dropped_frame_without_update_rects_ = true;
+    });
     return;
   }
 
@@ -716,8 +820,11 @@ void ViEEncoder::OnFrame(const VideoFrame& video_frame) {
   }
 
   last_captured_timestamp_ = incoming_frame.ntp_time_ms();
-  encoder_queue_.PostTask(std::unique_ptr<rtc::QueuedTask>(new EncodeTask(
-      incoming_frame, this, rtc::TimeMicros(), log_stats)));
+  const int64_t capture_cpu_time_us =
+      CpuTimeDeltaUs(start_cpu_time_ns, rtc::GetThreadCpuTimeNanos());
+  encoder_queue_.PostTask(std::unique_ptr<rtc::QueuedTask>(
+      new EncodeTask(incoming_frame, this, rtc::TimeMicros(),
+                     capture_cpu_time_us, log_stats)));
 }
 
 bool ViEEncoder::EncoderPaused() const {
@@ -747,8 +854,36 @@ void ViEEncoder::TraceFrameDropEnd() {
   encoder_paused_and_dropped_frame_ = false;
 }
 
+void ViEEncoder::AccumulateDroppedFrameUpdateRects(const VideoFrame& frame) {
+  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  if (!frame.has_update_rects()) {
+    dropped_frame_without_update_rects_ = true;
+    return;
+  }
+  dropped_frames_update_rects_.insert(dropped_frames_update_rects_.end(),
+                                      frame.update_rects().begin(),
+                                      frame.update_rects().end());
+}
+
+void ViEEncoder::MergeDroppedFrameUpdateRects(VideoFrame* frame) {
+  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  if (dropped_frame_without_update_rects_) {
+    frame->clear_update_rects();
+  } else if (frame->has_update_rects() &&
+             !dropped_frames_update_rects_.empty()) {
+    std::vector<VideoFrame::UpdateRect> update_rects = frame->update_rects();
+    update_rects.insert(update_rects.end(),
+                        dropped_frames_update_rects_.begin(),
+                        dropped_frames_update_rects_.end());
+    frame->set_update_rects(std::move(update_rects));
+  }
+  dropped_frames_update_rects_.clear();
+  dropped_frame_without_update_rects_ = false;
+}
+
 void ViEEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
-                                  int64_t time_when_posted_us) {
+                                  int64_t time_when_posted_us,
+                                  int64_t capture_cpu_time_us) {
   RTC_DCHECK_RUN_ON(&encoder_queue_);
 
   if (pre_encode_callback_)
@@ -760,6 +895,10 @@ void ViEEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
     pending_encoder_reconfiguration_ = true;
     last_frame_info_ = rtc::Optional<VideoFrameInfo>(VideoFrameInfo(
         video_frame.width(), video_frame.height(), video_frame.is_texture()));
+    // The encoder is reinitialized and codes the next frame in full, so the
+    // update rects of dropped frames of the old size don't matter.
+    dropped_frames_update_rects_.clear();
+    dropped_frame_without_update_rects_ = false;
     LOG(LS_INFO) << "Video frame parameters changed: dimensions="
                  << last_frame_info_->width << "x" << last_frame_info_->height
                  << ", texture=" << last_frame_info_->is_texture << ".";
@@ -769,6 +908,7 @@ void ViEEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
       video_frame.size() >
           MaximumFrameSizeForBitrate(encoder_start_bitrate_bps_ / 1000)) {
     LOG(LS_INFO) << "Dropping frame. Too large for target bitrate.";
+    AccumulateDroppedFrameUpdateRects(video_frame);
     AdaptDown(kQuality);
     ++initial_rampup_;
     return;
@@ -789,26 +929,51 @@ void ViEEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
 
   if (EncoderPaused()) {
     TraceFrameDropStart();
+    AccumulateDroppedFrameUpdateRects(video_frame);
     return;
   }
   TraceFrameDropEnd();
 
+  FrameStageCpuTimes cpu_times;
+  cpu_times.capture_us = capture_cpu_time_us;
+  int64_t stage_start_cpu_time_ns = rtc::GetThreadCpuTimeNanos();
+
   VideoFrame out_frame(video_frame);
-  // Crop frame if needed.
+  MergeDroppedFrameUpdateRects(&out_frame);
+  // Crop frame if needed. The new frame has no update rects, since the
+  // encoder would have to map them through the scaling.
   if (crop_width_ > 0 || crop_height_ > 0) {
     int cropped_width = video_frame.width() - crop_width_;
     int cropped_height = video_frame.height() - crop_height_;
-    rtc::scoped_refptr<I420Buffer> cropped_buffer =
-        I420Buffer::Create(cropped_width, cropped_height);
+    rtc::scoped_refptr<VideoFrameBuffer> cropped_buffer;
     // TODO(ilnik): Remove scaling if cropping is too big, as it should never
     // happen after SinkWants signaled correctly from ReconfigureEncoder.
-    if (crop_width_ < 4 && crop_height_ < 4) {
-      cropped_buffer->CropAndScaleFrom(
-          *video_frame.video_frame_buffer()->ToI420(), crop_width_ / 2,
-          crop_height_ / 2, cropped_width, cropped_height);
+    if (video_frame.video_frame_buffer()->type() ==
+        VideoFrameBuffer::Type::kNV12) {
+      // Keep NV12 frames in NV12; the encoder converts them if it has to.
+      const NV12BufferInterface& src =
+          *video_frame.video_frame_buffer()->GetNV12();
+      rtc::scoped_refptr<NV12Buffer> nv12_buffer =
+          NV12Buffer::Create(cropped_width, cropped_height);
+      if (crop_width_ < 4 && crop_height_ < 4) {
+        nv12_buffer->CropAndScaleFrom(src, crop_width_ / 2, crop_height_ / 2,
+                                      cropped_width, cropped_height);
+      } else {
+        nv12_buffer->ScaleFrom(src);
+      }
+      cropped_buffer = nv12_buffer;
     } else {
-      cropped_buffer->ScaleFrom(
-          *video_frame.video_frame_buffer()->ToI420().get());
+      rtc::scoped_refptr<I420Buffer> i420_buffer =
+          I420Buffer::Create(cropped_width, cropped_height);
+      if (crop_width_ < 4 && crop_height_ < 4) {
+        i420_buffer->CropAndScaleFrom(
+            *video_frame.video_frame_buffer()->ToI420(), crop_width_ / 2,
+            crop_height_ / 2, cropped_width, cropped_height);
+      } else {
+        i420_buffer->ScaleFrom(
+            *video_frame.video_frame_buffer()->ToI420().get());
+      }
+      cropped_buffer = i420_buffer;
     }
     out_frame =
         VideoFrame(cropped_buffer, video_frame.timestamp(),
@@ -821,7 +986,21 @@ void ViEEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
 
   overuse_detector_->FrameCaptured(out_frame, time_when_posted_us);
 
+  int64_t now_cpu_time_ns = rtc::GetThreadCpuTimeNanos();
+  cpu_times.scale_us =
+      CpuTimeDeltaUs(stage_start_cpu_time_ns, now_cpu_time_ns);
+  stage_start_cpu_time_ns = now_cpu_time_ns;
+
+  frame_being_encoded_ = &out_frame;
   video_sender_.AddVideoFrame(out_frame, nullptr);
+  frame_being_encoded_ = nullptr;
+
+  cpu_times.encode_us =
+      CpuTimeDeltaUs(stage_start_cpu_time_ns, rtc::GetThreadCpuTimeNanos());
+  if (cpu_times.capture_us != -1 && cpu_times.scale_us != -1 &&
+      cpu_times.encode_us != -1) {
+    overuse_detector_->FrameStagesProcessed(cpu_times, time_when_posted_us);
+  }
 }
 
 void ViEEncoder::SendKeyFrame() {
@@ -840,6 +1019,32 @@ EncodedImageCallback::Result ViEEncoder::OnEncodedImage(
   // Encoded is called on whatever thread the real encoder implementation run
   // on. In the case of hardware encoders, there might be several encoders
   // running in parallel on different threads.
+  if (!packetization_queue_)
+    return SendEncodedImage(encoded_image, codec_specific_info, fragmentation);
+
+  WaitForPacketizationSlot();
+  packetization_queue_->PostTask(std::unique_ptr<rtc::QueuedTask>(
+      new PacketizeTask(this, encoded_image, codec_specific_info,
+                        fragmentation)));
+  // The RTP timestamp is not known until the frame has been packetized, so
+  // use the capture timestamp as frame ID.
+  EncodedImageCallback::Result result(EncodedImageCallback::Result::OK,
+                                      encoded_image._timeStamp);
+  // The sink's result for this frame isn't known yet either, so return what it
+  // returned for the previous one. It only fails to send while the stream is
+  // inactive, which most likely still holds for this frame, and a request to
+  // drop a frame still applies to the upcoming ones.
+  rtc::CritScope lock(&packetization_crit_);
+  result.error = last_packetization_error_;
+  result.drop_next_frame = packetization_drop_next_frame_;
+  packetization_drop_next_frame_ = false;
+  return result;
+}
+
+EncodedImageCallback::Result ViEEncoder::SendEncodedImage(
+    const EncodedImage& encoded_image,
+    const CodecSpecificInfo* codec_specific_info,
+    const RTPFragmentationHeader* fragmentation) {
   stats_proxy_->OnSendEncodedImage(encoded_image, codec_specific_info);
 
   EncodedImageCallback::Result result =
@@ -858,12 +1063,42 @@ EncodedImageCallback::Result ViEEncoder::OnEncodedImage(
   return result;
 }
 
+void ViEEncoder::WaitForPacketizationSlot() {
+  while (true) {
+    {
+      rtc::CritScope lock(&packetization_crit_);
+      if (pending_packetization_frames_ < kMaxPendingPacketizationFrames) {
+        ++pending_packetization_frames_;
+        return;
+      }
+    }
+    packetization_done_event_.Wait(rtc::Event::kForever);
+  }
+}
+
+void ViEEncoder::OnFramePacketized(
+    const EncodedImageCallback::Result& result) {
+  {
+    rtc::CritScope lock(&packetization_crit_);
+    RTC_DCHECK_GT(pending_packetization_frames_, 0);
+    --pending_packetization_frames_;
+    last_packetization_error_ = result.error;
+    packetization_drop_next_frame_ |= result.drop_next_frame;
+  }
+  packetization_done_event_.Set();
+}
+
 void ViEEncoder::OnDroppedFrame() {
-  encoder_queue_.PostTask([this] {
-    RTC_DCHECK_RUN_ON(&encoder_queue_);
-    if (quality_scaler_)
-      quality_scaler_->ReportDroppedFrame();
-  });
+  if (!encoder_queue_.IsCurrent()) {
+    encoder_queue_.PostTask([this] { OnDroppedFrame(); });
+    return;
+  }
+  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  if (quality_scaler_)
+    quality_scaler_->ReportDroppedFrame();
+  // Dropped by |video_sender_| before reaching the encoder.
+  if (frame_being_encoded_)
+    AccumulateDroppedFrameUpdateRects(*frame_being_encoded_);
 }
 
 void ViEEncoder::SendStatistics(uint32_t bit_rate, uint32_t frame_rate) {
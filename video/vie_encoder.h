@@ -72,6 +72,9 @@ class ViEEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   static const int kMaxCpuResolutionDowngrades = 2;
   // Downscale framerate at most 4 times.
   static const int kMaxCpuFramerateDowngrades = 4;
+  // Encoded frames that may wait for packetization in pipelined mode before
+  // the encoder is blocked.
+  static const int kMaxPendingPacketizationFrames = 2;
 
   ViEEncoder(uint32_t number_of_cores,
              SendStatisticsProxy* stats_proxy,
@@ -135,6 +138,7 @@ class ViEEncoder : public rtc::VideoSinkInterface<VideoFrame>,
  private:
   class ConfigureEncoderTask;
   class EncodeTask;
+  class PacketizeTask;
   class VideoSourceProxy;
 
   class VideoFrameInfo {
@@ -165,8 +169,11 @@ class ViEEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   void SendStatistics(uint32_t bit_rate,
                       uint32_t frame_rate) override;
 
+  // |capture_cpu_time_us| is the CPU time OnFrame() spent on the frame, or -1
+  // if the thread CPU time can't be read on this platform.
   void EncodeVideoFrame(const VideoFrame& frame,
-                        int64_t time_when_posted_in_ms);
+                        int64_t time_when_posted_in_ms,
+                        int64_t capture_cpu_time_us);
 
   // Implements EncodedImageCallback.
   EncodedImageCallback::Result OnEncodedImage(
@@ -176,10 +183,30 @@ class ViEEncoder : public rtc::VideoSinkInterface<VideoFrame>,
 
   void OnDroppedFrame() override;
 
+  // Delivers an encoded frame to |sink_| and reports it to the overuse
+  // detector and quality scaler. Runs on the thread of the encoder, or on
+  // |packetization_queue_| in pipelined mode.
+  EncodedImageCallback::Result SendEncodedImage(
+      const EncodedImage& encoded_image,
+      const CodecSpecificInfo* codec_specific_info,
+      const RTPFragmentationHeader* fragmentation);
+  // Blocks until fewer than |kMaxPendingPacketizationFrames| frames wait for
+  // |packetization_queue_|, and reserves a slot for one more.
+  void WaitForPacketizationSlot();
+  // Releases the slot of a frame sent from |packetization_queue_|, and keeps
+  // |result| for the next OnEncodedImage() call to return.
+  void OnFramePacketized(const EncodedImageCallback::Result& result);
+
   bool EncoderPaused() const;
   void TraceFrameDropStart();
   void TraceFrameDropEnd();
 
+  // Update rects of frames dropped before reaching the encoder are merged into
+  // the next frame that is encoded, so that its update rects cover all changes
+  // since the last encoded frame.
+  void AccumulateDroppedFrameUpdateRects(const VideoFrame& frame);
+  void MergeDroppedFrameUpdateRects(VideoFrame* frame);
+
   // Class holding adaptation information.
   class AdaptCounter final {
    public:
@@ -301,13 +328,37 @@ class ViEEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   int captured_frame_count_ ACCESS_ON(&encoder_queue_);
   int dropped_frame_count_ ACCESS_ON(&encoder_queue_);
 
+  std::vector<VideoFrame::UpdateRect> dropped_frames_update_rects_
+      ACCESS_ON(&encoder_queue_);
+  // Set if a dropped frame had no update rects, so the next frame may differ
+  // anywhere from the last encoded one.
+  bool dropped_frame_without_update_rects_ ACCESS_ON(&encoder_queue_);
+  // The frame passed to |video_sender_|, which may drop it.
+  const VideoFrame* frame_being_encoded_ ACCESS_ON(&encoder_queue_);
+
   VideoBitrateAllocationObserver* bitrate_observer_ ACCESS_ON(&encoder_queue_);
   rtc::Optional<int64_t> last_parameters_update_ms_ ACCESS_ON(&encoder_queue_);
 
+  rtc::CriticalSection packetization_crit_;
+  int pending_packetization_frames_ GUARDED_BY(packetization_crit_);
+  // What |sink_| returned for the last frame sent from |packetization_queue_|,
+  // and whether it asked to drop a frame since the last OnEncodedImage() call.
+  EncodedImageCallback::Result::Error last_packetization_error_
+      GUARDED_BY(packetization_crit_);
+  bool packetization_drop_next_frame_ GUARDED_BY(packetization_crit_);
+  // Signaled each time a frame has been sent from |packetization_queue_|.
+  rtc::Event packetization_done_event_;
+
   // All public methods are proxied to |encoder_queue_|. It must must be
   // destroyed first to make sure no tasks are run that use other members.
   rtc::TaskQueue encoder_queue_;
 
+  // Set if |settings_.pipelined_packetization| is. Encoded frames are sent to
+  // |sink_| on this queue, in encode order, so that packetization and FEC
+  // generation of one frame overlap with encoding of the next. Destroyed
+  // before |encoder_queue_|, which its tasks post to.
+  std::unique_ptr<rtc::TaskQueue> packetization_queue_;
+
   RTC_DISALLOW_COPY_AND_ASSIGN(ViEEncoder);
 };
 
@@ -485,6 +485,12 @@ class ViEEncoderTest : public ::testing::Test {
       EXPECT_EQ(ntp_time_ms_, ntp_time_ms);
     }
 
+    rtc::Optional<std::vector<VideoFrame::UpdateRect>> last_update_rects()
+        const {
+      rtc::CritScope lock(&local_crit_sect_);
+      return last_update_rects_;
+    }
+
     void SetQualityScaling(bool b) {
       rtc::CritScope lock(&local_crit_sect_);
       quality_scaling_ = b;
@@ -510,6 +516,11 @@ class ViEEncoderTest : public ::testing::Test {
         ntp_time_ms_ = input_image.ntp_time_ms();
         last_input_width_ = input_image.width();
         last_input_height_ = input_image.height();
+        last_update_rects_ =
+            input_image.has_update_rects()
+                ? rtc::Optional<std::vector<VideoFrame::UpdateRect>>(
+                      input_image.update_rects())
+                : rtc::Optional<std::vector<VideoFrame::UpdateRect>>();
         block_encode = block_next_encode_;
         block_next_encode_ = false;
       }
@@ -549,6 +560,8 @@ class ViEEncoderTest : public ::testing::Test {
     int64_t ntp_time_ms_ GUARDED_BY(local_crit_sect_) = 0;
     int last_input_width_ GUARDED_BY(local_crit_sect_) = 0;
     int last_input_height_ GUARDED_BY(local_crit_sect_) = 0;
+    rtc::Optional<std::vector<VideoFrame::UpdateRect>> last_update_rects_
+        GUARDED_BY(local_crit_sect_);
     bool quality_scaling_ GUARDED_BY(local_crit_sect_) = true;
     std::vector<std::unique_ptr<TemporalLayers>> allocated_temporal_layers_
         GUARDED_BY(local_crit_sect_);
@@ -672,6 +685,18 @@ TEST_F(ViEEncoderTest, EncodeOneFrame) {
   vie_encoder_->Stop();
 }
 
+TEST_F(ViEEncoderTest, EncodesFramesWithPipelinedPacketization) {
+  video_send_config_.encoder_settings.pipelined_packetization = true;
+  ConfigureEncoder(video_encoder_config_.Copy(), true /* nack_enabled */);
+  vie_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+
+  for (int64_t ntp_time_ms = 1; ntp_time_ms <= 3; ++ntp_time_ms) {
+    video_source_.IncomingCapturedFrame(CreateFrame(ntp_time_ms, nullptr));
+    WaitForEncodedFrame(ntp_time_ms);
+  }
+  vie_encoder_->Stop();
+}
+
 TEST_F(ViEEncoderTest, DropsFramesBeforeFirstOnBitrateUpdated) {
   // Dropped since no target bitrate has been set.
   rtc::Event frame_destroyed_event(false, false);
@@ -700,6 +725,53 @@ TEST_F(ViEEncoderTest, DropsFramesWhenRateSetToZero) {
   vie_encoder_->Stop();
 }
 
+TEST_F(ViEEncoderTest, MergesUpdateRectsOfDroppedFrames) {
+  vie_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+  VideoFrame frame = CreateFrame(1, nullptr);
+  frame.set_update_rects({{0, 0, 16, 16}});
+  video_source_.IncomingCapturedFrame(frame);
+  WaitForEncodedFrame(1);
+  ASSERT_TRUE(fake_encoder_.last_update_rects());
+  EXPECT_EQ(1u, fake_encoder_.last_update_rects()->size());
+
+  vie_encoder_->OnBitrateUpdated(0, 0, 0);
+  // Dropped since bitrate is zero.
+  frame = CreateFrame(2, nullptr);
+  frame.set_update_rects({{32, 16, 8, 8}});
+  video_source_.IncomingCapturedFrame(frame);
+
+  vie_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+  frame = CreateFrame(3, nullptr);
+  frame.set_update_rects({{64, 32, 4, 4}});
+  video_source_.IncomingCapturedFrame(frame);
+  WaitForEncodedFrame(3);
+  rtc::Optional<std::vector<VideoFrame::UpdateRect>> update_rects =
+      fake_encoder_.last_update_rects();
+  ASSERT_TRUE(update_rects);
+  ASSERT_EQ(2u, update_rects->size());
+  EXPECT_EQ(64, (*update_rects)[0].offset_x);
+  EXPECT_EQ(32, (*update_rects)[1].offset_x);
+  vie_encoder_->Stop();
+}
+
+TEST_F(ViEEncoderTest, DropsUpdateRectsAfterDroppedFrameWithoutUpdateRects) {
+  vie_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+  video_source_.IncomingCapturedFrame(CreateFrame(1, nullptr));
+  WaitForEncodedFrame(1);
+
+  vie_encoder_->OnBitrateUpdated(0, 0, 0);
+  // Dropped since bitrate is zero, and may have changed anywhere.
+  video_source_.IncomingCapturedFrame(CreateFrame(2, nullptr));
+
+  vie_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+  VideoFrame frame = CreateFrame(3, nullptr);
+  frame.set_update_rects({{64, 32, 4, 4}});
+  video_source_.IncomingCapturedFrame(frame);
+  WaitForEncodedFrame(3);
+  EXPECT_FALSE(fake_encoder_.last_update_rects());
+  vie_encoder_->Stop();
+}
+
 TEST_F(ViEEncoderTest, DropsFramesWithSameOrOldNtpTimestamp) {
   vie_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
   video_source_.IncomingCapturedFrame(CreateFrame(1, nullptr));
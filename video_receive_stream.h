@@ -49,6 +49,11 @@ class VideoReceiveStream {
     // parameters. It is the same as cricket::CodecParameterMap used in
     // cricket::VideoCodec.
     std::map<std::string, std::string> codec_params;
+
+    // How the decoder may spread its work over several threads, passed to
+    // VideoDecoder::InitDecode() in VideoCodec::decoder_threading.
+    VideoDecoderThreadingSettings threading = {VideoDecoderThreading::kNone, 0,
+                                               0};
   };
 
   struct Stats {
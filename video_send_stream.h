@@ -56,6 +56,11 @@ class VideoSendStream {
     int encode_frame_rate = 0;
     int avg_encode_time_ms = 0;
     int encode_usage_percent = 0;
+    // CPU usage of the send-side stages, in percent of one core per frame
+    // interval. -1 until measured.
+    int capture_cpu_usage_percent = -1;
+    int scale_cpu_usage_percent = -1;
+    int encode_cpu_usage_percent = -1;
     uint32_t frames_encoded = 0;
     rtc::Optional<uint64_t> qp_sum;
     // Bitrate the encoder is currently configured to use due to bandwidth
@@ -115,6 +120,12 @@ class VideoSendStream {
       // 30fps (for example) exactly.
       bool full_overuse_time = false;
 
+      // Packetize and protect encoded frames on a separate task queue, so
+      // that sending one frame overlaps with encoding the next. Useful at high
+      // frame rates, e.g. 60 fps screen sharing, where packetization and FEC
+      // otherwise delay the next frame.
+      bool pipelined_packetization = false;
+
       // Uninitialized VideoEncoder instance to be used for encoding. Will be
       // initialized from inside the VideoSendStream.
       VideoEncoder* encoder = nullptr;